@@ -0,0 +1,153 @@
+#include "ConflictExplainer.hh"
+#include "ConstraintEngine.hh"
+#include "ConstrainedVariable.hh"
+#include "Constraint.hh"
+#include "Domain.hh"
+#include "Debug.hh"
+#include "Error.hh"
+
+namespace EUROPA {
+
+  ConflictExplainer::ConflictExplainer(const ConstraintEngineId ce)
+    : m_ce(ce), m_candidates(), m_probes(0) {
+    check_error(m_ce.isValid());
+  }
+
+  bool ConflictExplainer::explain(ConstraintSet& constraints, ConstrainedVariableSet& facts) {
+    checkRuntimeError(!m_ce->getAllowViolations(),
+                      "Conflicts can only be explained when violations are not allowed");
+    checkRuntimeError(!m_ce->isPropagating(), "Conflicts can't be explained during propagation");
+
+    m_candidates.clear();
+    m_probes = 0;
+    for(ConstraintSet::const_iterator it = constraints.begin(); it != constraints.end(); ++it) {
+      const ConstraintId constraint = *it;
+      check_error(constraint.isValid());
+      if(!constraint->isActive() || constraint->isRedundant())
+        continue;
+      Candidate candidate = {constraint->getKey(), constraint, ConstrainedVariableId::noId(), 0, true};
+      m_candidates.push_back(candidate);
+    }
+    for(ConstrainedVariableSet::const_iterator it = facts.begin(); it != facts.end(); ++it) {
+      const ConstrainedVariableId var = *it;
+      check_error(var.isValid());
+      if(!var->isActive() || !var->isSpecified() || !var->canBeSpecified() || var->baseDomain().isSingleton())
+        continue;
+      Candidate candidate = {var->getKey(), ConstraintId::noId(), var, var->getSpecifiedValue(), true};
+      m_candidates.push_back(candidate);
+    }
+    constraints.clear();
+    facts.clear();
+
+    Subset all;
+    for(unsigned int i = 0; i < m_candidates.size(); i++)
+      all.push_back(i);
+    if(isConsistent(all)) {
+      debugMsg("ConflictExplainer:explain", "Consistent with all " << all.size() << " candidates");
+      return false;
+    }
+
+    Subset conflict = quickXplain(Subset(), true, all);
+    restore();
+
+    for(Subset::const_iterator it = conflict.begin(); it != conflict.end(); ++it) {
+      const Candidate& candidate = m_candidates[*it];
+      if(candidate.constraint.isId())
+        constraints.insert(candidate.constraint);
+      else
+        facts.insert(candidate.fact);
+    }
+    debugMsg("ConflictExplainer:explain",
+             conflict.size() << " of " << all.size() << " candidates conflict, found in " << m_probes <<
+             " propagations");
+    return true;
+  }
+
+  ConflictExplainer::Subset ConflictExplainer::quickXplain(const Subset& background, const bool tested,
+                                                           const Subset& candidates) {
+    if(tested && !isConsistent(background))
+      return Subset();
+    if(candidates.size() == 1)
+      return candidates;
+
+    const Subset first(candidates.begin(), candidates.begin() + candidates.size() / 2);
+    const Subset second(candidates.begin() + candidates.size() / 2, candidates.end());
+
+    Subset withFirst(background);
+    withFirst.insert(withFirst.end(), first.begin(), first.end());
+    Subset fromSecond = quickXplain(withFirst, !first.empty(), second);
+
+    Subset withSecond(background);
+    withSecond.insert(withSecond.end(), fromSecond.begin(), fromSecond.end());
+    Subset result = quickXplain(withSecond, !fromSecond.empty(), first);
+
+    result.insert(result.end(), fromSecond.begin(), fromSecond.end());
+    return result;
+  }
+
+  bool ConflictExplainer::isConsistent(const Subset& enabled) {
+    std::vector<bool> target(m_candidates.size(), false);
+    for(Subset::const_iterator it = enabled.begin(); it != enabled.end(); ++it)
+      target[*it] = true;
+
+    for(std::vector<Candidate>::const_iterator it = m_candidates.begin(); it != m_candidates.end(); ++it) {
+      if(!isDeleted(*it))
+        continue;
+      restore();
+      checkRuntimeError(ALWAYS_FAILS,
+                        "Candidate " << it->key << " was deleted by propagation while explaining a conflict. " <<
+                        "Only constraints and values that propagation does not retract can be explained.");
+    }
+
+    // Relax before restricting, so the restrictions propagate from the relaxed network
+    for(unsigned int i = 0; i < m_candidates.size(); i++)
+      if(m_candidates[i].enabled && !target[i])
+        disable(m_candidates[i]);
+    for(unsigned int i = 0; i < m_candidates.size(); i++)
+      if(!m_candidates[i].enabled && target[i])
+        enable(m_candidates[i]);
+
+    m_probes++;
+    bool result = m_ce->propagate();
+    debugMsg("ConflictExplainer:isConsistent",
+             enabled.size() << " of " << m_candidates.size() << " candidates are " <<
+             (result ? "consistent" : "inconsistent"));
+    return result;
+  }
+
+  void ConflictExplainer::enable(Candidate& candidate) {
+    check_error(!candidate.enabled);
+    if(candidate.constraint.isId())
+      candidate.constraint->undoDeactivation();
+    else
+      candidate.fact->specify(candidate.value);
+    candidate.enabled = true;
+  }
+
+  void ConflictExplainer::disable(Candidate& candidate) {
+    check_error(candidate.enabled);
+    if(candidate.constraint.isId()) {
+      // As for a deleted constraint, what it derived goes with it
+      candidate.constraint->deactivate();
+      const std::vector<ConstrainedVariableId>& scope = candidate.constraint->getScope();
+      for(std::vector<ConstrainedVariableId>::const_iterator it = scope.begin(); it != scope.end(); ++it)
+        if((*it)->isActive())
+          (*it)->relax();
+    }
+    else
+      candidate.fact->reset();
+    candidate.enabled = false;
+  }
+
+  bool ConflictExplainer::isDeleted(const Candidate& candidate) const {
+    EntityId entity = Entity::getEntity(candidate.key);
+    return entity.isNoId() || entity->isDiscarded();
+  }
+
+  void ConflictExplainer::restore() {
+    for(std::vector<Candidate>::iterator it = m_candidates.begin(); it != m_candidates.end(); ++it)
+      if(!it->enabled && !isDeleted(*it))
+        enable(*it);
+    m_ce->propagate();
+  }
+}
@@ -0,0 +1,90 @@
+#ifndef _H_ConflictExplainer
+#define _H_ConflictExplainer
+
+#include "ConstraintEngineDefs.hh"
+
+#include <vector>
+
+namespace EUROPA {
+
+  /**
+   * @class ConflictExplainer
+   * @brief Finds a minimal set of constraints and specified values that can't all hold together: removing
+   *        any one of them would leave the network consistent.
+   *
+   * Uses QuickXplain (Junker 2004, "QuickXplain: Preferred Explanations and Relaxations for Over-Constrained
+   * Problems").  The candidates are split in halves recursively, and each half is tested against the
+   * candidates kept so far, so a conflict of k candidates out of n takes O(k log(n/k)) propagations rather
+   * than the n of taking candidates out one at a time.
+   *
+   * The network is never rebuilt.  Each probe changes only the candidates whose state differs from the last
+   * probe: constraints are deactivated and their scope relaxed, or activated again, and specified values are
+   * reset, or specified again.  The constraint engine then propagates incrementally from there.  Whatever is not
+   * a candidate stays in place throughout, so a conflict among non-candidates alone is explained by an
+   * empty set.
+   * @see ConstraintEngine::explainInconsistency
+   * @ingroup ConstraintEngine
+   */
+  class ConflictExplainer {
+  public:
+    ConflictExplainer(const ConstraintEngineId ce);
+
+    /**
+     * @brief Find a minimal conflict among the candidates.  Every candidate is put back before returning.
+     * @param constraints The candidate constraints; replaced by those in the conflict. Constraints that are
+     * inactive, or redundant since their base domains are singletons, can't be taken out and are left out.
+     * @param facts The variables whose specified values are candidates; replaced by those in the conflict.
+     * Variables that are not specified, or have singleton base domains, are left out.
+     * @return false if the network is consistent with every candidate in place, so there is no conflict.
+     * @throws if violations are allowed, or if propagation deletes a candidate, as when a rule is undone.
+     */
+    bool explain(ConstraintSet& constraints, ConstrainedVariableSet& facts);
+
+    /**
+     * @brief The number of propagations the last explanation took.
+     */
+    unsigned int getProbeCount() const {return m_probes;}
+
+  private:
+    ConflictExplainer(const ConflictExplainer&);
+    ConflictExplainer& operator=(const ConflictExplainer&);
+
+    struct Candidate {
+      eint key; /*!< To tell if propagation has deleted it */
+      ConstraintId constraint;
+      ConstrainedVariableId fact;
+      edouble value; /*!< The specified value, for a fact */
+      bool enabled;
+    };
+
+    typedef std::vector<unsigned int> Subset; /*!< Positions in m_candidates */
+
+    /**
+     * @brief A minimal subset of candidates which conflicts with the background, given that the background
+     * and the candidates together conflict.
+     * @param tested false if the background is known to be consistent, so it needn't be propagated.
+     */
+    Subset quickXplain(const Subset& background, const bool tested, const Subset& candidates);
+
+    /**
+     * @brief Test if the network is consistent with exactly the given candidates in place.
+     */
+    bool isConsistent(const Subset& enabled);
+
+    void enable(Candidate& candidate);
+    void disable(Candidate& candidate);
+
+    bool isDeleted(const Candidate& candidate) const;
+
+    /**
+     * @brief Put back every candidate that is still there, and propagate.
+     */
+    void restore();
+
+    const ConstraintEngineId m_ce;
+    std::vector<Candidate> m_candidates;
+    unsigned int m_probes;
+  };
+}
+
+#endif
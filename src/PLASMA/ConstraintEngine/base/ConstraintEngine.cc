@@ -11,9 +11,11 @@
 #include "DomainListener.hh"
 #include "ConstraintType.hh"
 #include "CESchema.hh"
+#include "ConflictExplainer.hh"
 
 #include <string>
 #include <iterator>
+#include <boost/cast.hpp>
 
 namespace EUROPA
 {
@@ -160,9 +162,9 @@ PSList<PSConstraint*> ViolationMgrImpl::getAllViolations() const {
 
     // restore all constraints attached to v to propagation
     // as long as all the vars in the constraint are now non-empty
-    std::set<ConstraintId> constraints;
+    ConstraintSet constraints;
     v->constraints(constraints);
-    for (std::set<ConstraintId>::iterator it = constraints.begin(); it != constraints.end(); ++it) {
+    for (ConstraintSet::iterator it = constraints.begin(); it != constraints.end(); ++it) {
       ConstraintId c = *it;
       if (isViolated(c))
         c->notifyNoLongerViolated();
@@ -623,9 +625,9 @@ void ConstraintEngine::add(const PropagatorId propagator){
       PropagatorId propagator = *it;
       os << propagator->getName() << "(";
 
-      const std::set<ConstraintId>& constraints = propagator->getConstraints();
+      const ConstraintSet& constraints = propagator->getConstraints();
       int i=0;
-      for(std::set<ConstraintId>::const_iterator cit = constraints.begin(); cit != constraints.end(); ++cit){
+      for(ConstraintSet::const_iterator cit = constraints.begin(); cit != constraints.end(); ++cit){
 	if (i>0)
 	  os << ",";
 	i++;
@@ -1083,6 +1085,35 @@ const PropagatorId ConstraintEngine::getPropagatorByName(const std::string& name
 
   bool ConstraintEngine::isRelaxed() const {return !m_relaxed.empty();}
 
+  bool ConstraintEngine::explainInconsistency(ConstraintSet& constraints, ConstrainedVariableSet& facts) {
+    ConflictExplainer explainer(m_id);
+    return explainer.explain(constraints, facts);
+  }
+
+  bool ConstraintEngine::explainInconsistency(PSList<PSConstraint*>& constraints, PSList<PSVariable*>& facts) {
+    ConstraintSet constraintIds;
+    ConstrainedVariableSet factIds;
+    if(constraints.size() == 0 && facts.size() == 0) {
+      constraintIds.insert(m_constraints.begin(), m_constraints.end());
+      for(ConstrainedVariableSet::const_iterator it = m_variables.begin(); it != m_variables.end(); ++it)
+        if((*it)->isSpecified())
+          factIds.insert(*it);
+    }
+    for(int i = 0; i < constraints.size(); i++)
+      constraintIds.insert(boost::polymorphic_cast<Constraint*>(constraints.get(i))->getId());
+    for(int i = 0; i < facts.size(); i++)
+      factIds.insert(boost::polymorphic_cast<ConstrainedVariable*>(facts.get(i))->getId());
+
+    bool result = explainInconsistency(constraintIds, factIds);
+    constraints.clear();
+    facts.clear();
+    for(ConstraintSet::const_iterator it = constraintIds.begin(); it != constraintIds.end(); ++it)
+      constraints.push_back(id_cast<PSConstraint>(*it));
+    for(ConstrainedVariableSet::const_iterator it = factIds.begin(); it != factIds.end(); ++it)
+      facts.push_back(id_cast<PSVariable>(*it));
+    return result;
+  }
+
   PSVariable* ConstraintEngine::getVariableByKey(PSEntityKey id)
   {
     ConstrainedVariableId entity = Entity::getEntity(id);
@@ -301,6 +301,21 @@ typedef Id<ConstraintEngineListener> ConstraintEngineListenerId;
      */
     bool isViolated(ConstraintId c) const;
 
+    /**
+     * @brief Find a minimal set of the given constraints and specified values that can't hold together with
+     * the rest of the network.  The network is left as it was found, then propagated.
+     * @param constraints The candidate constraints; replaced by those in the conflict.
+     * @param facts The variables whose specified values are candidates; replaced by those in the conflict.
+     * @return false if the network is consistent, so there is no conflict.
+     * @see ConflictExplainer
+     */
+    bool explainInconsistency(ConstraintSet& constraints, ConstrainedVariableSet& facts);
+
+    /**
+     * @brief As above, with every active constraint and specified variable as a candidate if both lists are empty.
+     */
+    virtual bool explainInconsistency(PSList<PSConstraint*>& constraints, PSList<PSVariable*>& facts);
+
     /**
      * @brief Test of the network is in a relaxed state
      */
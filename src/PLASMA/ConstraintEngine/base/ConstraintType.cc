@@ -29,6 +29,8 @@ const ConstraintTypeId ConstraintType::getId() const {return m_id;}
 
 const std::string& ConstraintType::getName() const { return m_name; }
 
+const std::string& ConstraintType::getPropagatorName() const { return m_propagatorName; }
+
 bool ConstraintType::isSystemDefined() const { return m_systemDefined;  }
 
 }
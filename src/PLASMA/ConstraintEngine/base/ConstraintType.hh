@@ -27,6 +27,8 @@ namespace EUROPA {
 
     const std::string& getName() const;
 
+    const std::string& getPropagatorName() const;
+
     bool isSystemDefined() const;
 
     virtual ConstraintId createConstraint(
@@ -33,6 +33,15 @@ namespace EUROPA {
   	  virtual PSList<std::string> getViolationExpl() const = 0;
   	  virtual PSList<PSConstraint*> getAllViolations() const = 0;
 
+      /**
+       * @brief Find a minimal set of constraints and specified values that can't hold together.
+       * @param constraints The candidate constraints; replaced by those in the conflict.
+       * @param facts The variables whose specified values are candidates; replaced by those in the conflict.
+       * If both are empty, every active constraint and specified variable is a candidate.
+       * @return false if there is no conflict.
+       */
+      virtual bool explainInconsistency(PSList<PSConstraint*>& constraints, PSList<PSVariable*>& facts) = 0;
+
   };
 
   class PSVariable : public virtual PSEntity
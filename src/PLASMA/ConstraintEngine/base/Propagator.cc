@@ -38,7 +38,7 @@ const std::string& Propagator::getName() const {return m_name;}
 
   void Propagator::disable(){m_enabled = false;}
 
-  const std::set<ConstraintId>& Propagator::getConstraints() const {return m_constraints;}
+  const ConstraintSet& Propagator::getConstraints() const {return m_constraints;}
 
   void Propagator::execute(const ConstraintId constraint){
     check_error(constraint.isValid());
@@ -46,7 +46,7 @@ namespace EUROPA {
     /**
      * @brief Obtain the list of all constraints managed by this Propagator
      */
-    const std::set<ConstraintId>& getConstraints() const;
+    const ConstraintSet& getConstraints() const;
 
     /**
      * @brief tests if the propagatpr is enabled
@@ -182,7 +182,7 @@ namespace EUROPA {
   private:
     Propagator(); /**< NO IMPL - MUST HAVE A ConstraintEngine. */
 
-    std::set<ConstraintId> m_constraints; /**< The list of all constraints (should be a set) managed by this Propagator. */
+    ConstraintSet m_constraints; /**< The list of all constraints (should be a set) managed by this Propagator. */
     PropagatorId m_id; /**< Self reference. */
     const std::string m_name;
     const ConstraintEngineId m_constraintEngine; /**< The ConstraintEngine to which this Propagator belongs. Must be valid. */
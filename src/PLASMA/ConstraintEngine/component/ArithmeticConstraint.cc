@@ -0,0 +1,332 @@
+#include "ArithmeticConstraint.hh"
+#include "ConstrainedVariable.hh"
+#include "Domain.hh"
+#include "Debug.hh"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <sstream>
+
+namespace EUROPA {
+
+ArithmeticExpression::ArithmeticExpression() : m_nodes(), m_text(), m_index(), m_scopeSize(1) {}
+
+unsigned int ArithmeticExpression::variable(const unsigned int scopeIndex) {
+  std::ostringstream os;
+  os << "x" << scopeIndex;
+  std::map<std::string, unsigned int>::const_iterator it = m_index.find(os.str());
+  if(it != m_index.end())
+    return it->second;
+
+  Node node = {VARIABLE, scopeIndex, 0};
+  m_nodes.push_back(node);
+  m_text.push_back(os.str());
+  m_index.insert(std::make_pair(os.str(), m_nodes.size() - 1));
+  m_scopeSize = std::max(m_scopeSize, scopeIndex + 1);
+  return m_nodes.size() - 1;
+}
+
+unsigned int ArithmeticExpression::apply(const Operator op, const unsigned int lhs, const unsigned int rhs) {
+  checkError(op != VARIABLE && lhs < m_nodes.size() && rhs < m_nodes.size(),
+             "Can't apply " << op << " to nodes " << lhs << " and " << rhs << " of " << m_nodes.size());
+  static const char* symbols[] = {"", "+", "-", "*"};
+  std::string text = "(" + m_text[lhs] + symbols[op] + m_text[rhs] + ")";
+  std::map<std::string, unsigned int>::const_iterator it = m_index.find(text);
+  if(it != m_index.end())
+    return it->second;
+
+  Node node = {op, lhs, rhs};
+  m_nodes.push_back(node);
+  m_text.push_back(text);
+  m_index.insert(std::make_pair(text, m_nodes.size() - 1));
+  return m_nodes.size() - 1;
+}
+
+std::string ArithmeticExpression::toString() const {
+  return "x0=" + (m_text.empty() ? std::string() : m_text.back());
+}
+
+namespace {
+
+typedef ArithmeticConstraint::Bounds Bounds;
+
+double infinity() {return cast_double(PLUS_INFINITY);}
+
+bool isInfinite(const double v) {return std::abs(v) >= infinity();}
+
+// Each operation is accurate to half a unit in the last place, so moving a finite result outward by twice the
+// relative epsilon, and by the smallest normal number for results near 0, keeps it a bound
+double roundDown(const double v) {
+  if(v <= -infinity())
+    return -infinity();
+  if(v >= infinity())
+    return infinity();
+  return std::max(-infinity(), v - (std::abs(v) * 2 * DBL_EPSILON + DBL_MIN));
+}
+
+double roundUp(const double v) {
+  if(v >= infinity())
+    return infinity();
+  if(v <= -infinity())
+    return -infinity();
+  return std::min(infinity(), v + (std::abs(v) * 2 * DBL_EPSILON + DBL_MIN));
+}
+
+double product(const double x, const double y) {
+  if(x == 0 || y == 0)
+    return 0;
+  if(isInfinite(x) || isInfinite(y))
+    return ((x > 0) == (y > 0) ? infinity() : -infinity());
+  return x * y;
+}
+
+// Where both are infinite the quotient could be anything, so up says which way to bound it
+double quotient(const double n, const double d, const bool up) {
+  if(isInfinite(d))
+    return (isInfinite(n) ? (up ? infinity() : -infinity()) : 0);
+  if(isInfinite(n))
+    return ((n > 0) == (d > 0) ? infinity() : -infinity());
+  return n / d;
+}
+
+Bounds add(const Bounds& x, const Bounds& y) {
+  Bounds retval = {
+    (x.lb <= -infinity() || y.lb <= -infinity() ? -infinity() : roundDown(x.lb + y.lb)),
+    (x.ub >= infinity() || y.ub >= infinity() ? infinity() : roundUp(x.ub + y.ub))
+  };
+  return retval;
+}
+
+Bounds subtract(const Bounds& x, const Bounds& y) {
+  Bounds retval = {
+    (x.lb <= -infinity() || y.ub >= infinity() ? -infinity() : roundDown(x.lb - y.ub)),
+    (x.ub >= infinity() || y.lb <= -infinity() ? infinity() : roundUp(x.ub - y.lb))
+  };
+  return retval;
+}
+
+Bounds multiply(const Bounds& x, const Bounds& y) {
+  double a = product(x.lb, y.lb), b = product(x.lb, y.ub), c = product(x.ub, y.lb), d = product(x.ub, y.ub);
+  Bounds retval = {roundDown(std::min(std::min(a, b), std::min(c, d))),
+                   roundUp(std::max(std::max(a, b), std::max(c, d)))};
+  return retval;
+}
+
+/**
+ * The hull of { z / y }.  Where y spans 0 the quotient is two half-lines, or everything if z also spans 0.
+ */
+Bounds divide(const Bounds& z, const Bounds& y) {
+  Bounds everything = {-infinity(), infinity()};
+  if(y.lb > 0 || y.ub < 0) {
+    Bounds reciprocal = {roundDown(quotient(1, y.ub, false)), roundUp(quotient(1, y.lb, true))};
+    return multiply(z, reciprocal);
+  }
+  if(z.lb <= 0 && z.ub >= 0)
+    return everything;
+  if(y.lb == 0 && y.ub == 0) {
+    Bounds nothing = {infinity(), -infinity()};
+    return nothing;
+  }
+  if(y.lb < 0 && y.ub > 0)
+    return everything;
+  if(y.lb == 0) {
+    if(z.lb > 0)
+      everything.lb = roundDown(quotient(z.lb, y.ub, false));
+    else
+      everything.ub = roundUp(quotient(z.ub, y.ub, true));
+  }
+  else {
+    if(z.lb > 0)
+      everything.ub = roundUp(quotient(z.lb, y.lb, true));
+    else
+      everything.lb = roundDown(quotient(z.ub, y.lb, false));
+  }
+  return everything;
+}
+
+Bounds getBounds(const Domain& dom) {
+  edouble lb, ub;
+  dom.getBounds(lb, ub);
+  Bounds retval = {cast_double(lb), cast_double(ub)};
+  return retval;
+}
+
+bool differ(const Bounds& x, const Bounds& y) {return x.lb != y.lb || x.ub != y.ub;}
+
+}
+
+ArithmeticConstraint::ArithmeticConstraint(const std::string& name,
+                                           const std::string& propagatorName,
+                                           const ConstraintEngineId constraintEngine,
+                                           const std::vector<ConstrainedVariableId>& variables,
+                                           const ArithmeticExpression& expression)
+    : Constraint(name, propagatorName, constraintEngine, variables),
+      m_expression(expression), m_bounds(expression.getNodes().size()), m_narrowed(expression.getNodes().size()),
+      m_integral(true), m_tolerance(1), m_resultInExpression(false), m_revisions(0) {
+  checkError(variables.size() == expression.getScopeSize(),
+             "Expected " << expression.getScopeSize() << " variables for " << expression.toString());
+  checkError(!expression.getNodes().empty(), "Empty expression in " << name);
+
+  // Sums, differences and products of integers are integers
+  for(std::vector<ArithmeticExpression::Node>::const_iterator it = m_expression.getNodes().begin();
+      it != m_expression.getNodes().end(); ++it) {
+    if(it->op == ArithmeticExpression::VARIABLE && getCurrentDomain(m_variables[it->lhs]).minDelta() < 1)
+      m_integral = false;
+    if(it->op == ArithmeticExpression::VARIABLE && it->lhs == 0)
+      m_resultInExpression = true;
+  }
+  if(!m_integral)
+    m_tolerance = cast_double(EPSILON);
+}
+
+bool ArithmeticConstraint::narrow(Bounds& bounds, const Bounds& other) const {
+  bounds.lb = std::max(bounds.lb, other.lb);
+  bounds.ub = std::min(bounds.ub, other.ub);
+  if(m_integral) {
+    bounds.lb = std::ceil(bounds.lb);
+    bounds.ub = std::floor(bounds.ub);
+  }
+  if(bounds.ub + m_tolerance <= bounds.lb)
+    return false;
+  // Within the tolerance of each other, so equal
+  if(bounds.ub < bounds.lb)
+    std::swap(bounds.lb, bounds.ub);
+  return true;
+}
+
+bool ArithmeticConstraint::revise(bool& changed) {
+  const std::vector<ArithmeticExpression::Node>& nodes = m_expression.getNodes();
+  Bounds everything = {-infinity(), infinity()};
+
+  // Forward: evaluate each node from its children
+  for(unsigned int i = 0; i < nodes.size(); i++) {
+    const ArithmeticExpression::Node& node = nodes[i];
+    Bounds& bounds = m_bounds[i];
+    switch(node.op) {
+      case ArithmeticExpression::VARIABLE:
+        bounds = getBounds(getCurrentDomain(m_variables[node.lhs]));
+        continue;
+      case ArithmeticExpression::ADD:
+        bounds = add(m_bounds[node.lhs], m_bounds[node.rhs]);
+        break;
+      case ArithmeticExpression::SUBTRACT:
+        bounds = subtract(m_bounds[node.lhs], m_bounds[node.rhs]);
+        break;
+      case ArithmeticExpression::MULTIPLY:
+        bounds = multiply(m_bounds[node.lhs], m_bounds[node.rhs]);
+        break;
+    }
+    m_revisions++;
+    if(!narrow(bounds, everything))
+      return false;
+  }
+
+  // The root is equal to x0.  Narrowing x0 only calls for another pass if x0 is also in the expression.
+  Domain& result = getCurrentDomain(m_variables[0]);
+  const Bounds evaluated = m_bounds.back();
+  if(!narrow(m_bounds.back(), getBounds(result)))
+    return false;
+  std::fill(m_narrowed.begin(), m_narrowed.end(), false);
+  m_narrowed.back() = differ(m_bounds.back(), evaluated);
+  if(result.intersect(m_bounds.back().lb, m_bounds.back().ub) && m_resultInExpression)
+    changed = true;
+  if(result.isEmpty())
+    return false;
+
+  // Backward: project each node onto its children.  All the parents of a node come after it, so its bounds
+  // are final by the time it is reached.  A node still at the bounds evaluated from its children projects
+  // back onto at least their bounds, so only narrowed nodes are projected.
+  for(unsigned int i = nodes.size(); i > 0; i--) {
+    if(!m_narrowed[i - 1])
+      continue;
+    const ArithmeticExpression::Node& node = nodes[i - 1];
+    const Bounds& z = m_bounds[i - 1];
+    if(node.op == ArithmeticExpression::VARIABLE) {
+      Domain& dom = getCurrentDomain(m_variables[node.lhs]);
+      changed = dom.intersect(z.lb, z.ub) || changed;
+      if(dom.isEmpty())
+        return false;
+      continue;
+    }
+
+    Bounds& x = m_bounds[node.lhs];
+    Bounds& y = m_bounds[node.rhs];
+    const Bounds oldX = x;
+    const Bounds oldY = y;
+    m_revisions++;
+    switch(node.op) {
+      case ArithmeticExpression::ADD: // z = x + y
+        if(!narrow(x, subtract(z, y)) || !narrow(y, subtract(z, x)))
+          return false;
+        break;
+      case ArithmeticExpression::SUBTRACT: // z = x - y
+        if(!narrow(x, add(z, y)) || !narrow(y, subtract(x, z)))
+          return false;
+        break;
+      case ArithmeticExpression::MULTIPLY: // z = x * y
+        if(!narrow(x, divide(z, y)) || !narrow(y, divide(z, x)))
+          return false;
+        break;
+      default:
+        break;
+    }
+    m_narrowed[node.lhs] = m_narrowed[node.lhs] || differ(x, oldX);
+    m_narrowed[node.rhs] = m_narrowed[node.rhs] || differ(y, oldY);
+  }
+  return true;
+}
+
+void ArithmeticConstraint::handleExecute() {
+  for(std::vector<ConstrainedVariableId>::const_iterator it = m_variables.begin(); it != m_variables.end(); ++it)
+    if(getCurrentDomain(*it).isOpen())
+      return;
+
+  bool changed = true;
+  unsigned int passes = 0;
+  while(changed && passes < MAX_PASSES) {
+    changed = false;
+    passes++;
+    if(!revise(changed)) {
+      debugMsg("ArithmeticConstraint:handleExecute", "Emptied " << m_expression.toString() << " in pass " << passes);
+      getCurrentDomain(m_variables[0]).empty();
+      return;
+    }
+  }
+  debugMsg("ArithmeticConstraint:handleExecute", m_expression.toString() << " took " << passes << " passes");
+}
+
+ArithmeticConstraintType::ArithmeticConstraintType(const std::string& propagatorName,
+                                                   const ArithmeticExpression& expression)
+    : ConstraintType(nameOf(expression), propagatorName), m_expression(expression) {}
+
+ConstraintId ArithmeticConstraintType::createConstraint(const ConstraintEngineId constraintEngine,
+                                                        const std::vector<ConstrainedVariableId>& scope,
+                                                        const std::string& violationExpl) {
+  check_error(constraintEngine.isValid());
+  Constraint* constraint = new ArithmeticConstraint(m_name, m_propagatorName, constraintEngine, scope, m_expression);
+  if(!violationExpl.empty())
+    constraint->setViolationExpl(violationExpl);
+  return constraint->getId();
+}
+
+void ArithmeticConstraintType::checkArgTypes(const std::vector<DataTypeId>& argTypes) const {
+  if(argTypes.size() != m_expression.getScopeSize()) {
+    std::ostringstream os;
+    os << "Constraint " << m_name << " takes " << m_expression.getScopeSize() << " args, not " << argTypes.size();
+    throw os.str();
+  }
+  for(unsigned int i = 0; i < argTypes.size(); i++) {
+    if(!argTypes[i]->isNumeric()) {
+      std::ostringstream os;
+      os << "Constraint " << m_name << " can't take a " << argTypes[i]->getName() << " as parameter number " << i;
+      throw os.str();
+    }
+  }
+}
+
+std::string ArithmeticConstraintType::nameOf(const ArithmeticExpression& expression) {
+  return "arithmetic:" + expression.toString();
+}
+
+}
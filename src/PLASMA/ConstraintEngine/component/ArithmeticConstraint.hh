@@ -0,0 +1,156 @@
+#ifndef _H_ArithmeticConstraint
+#define _H_ArithmeticConstraint
+
+#include "ConstraintEngineDefs.hh"
+#include "Constraint.hh"
+#include "ConstraintType.hh"
+
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @file ArithmeticConstraint.hh
+ * @brief A constraint that propagates a whole arithmetic expression at once, rather than through a chain of
+ * addEq and mulEq constraints over auxiliary variables.
+ */
+
+namespace EUROPA {
+
+/**
+ * @brief An expression over +, - and * whose leaves are variables in a constraint's scope, held as a
+ * directed acyclic graph.  Equal subexpressions, and in particular repeated variables, share one node.
+ * Nodes are in order of creation, so the children of a node always come before it and the last node is the
+ * root.  Scope index 0 is the variable the expression is equal to.
+ */
+class ArithmeticExpression {
+ public:
+  enum Operator {
+    VARIABLE = 0, /*!< A leaf.  lhs is the index of the variable in the scope */
+    ADD,
+    SUBTRACT,
+    MULTIPLY
+  };
+
+  struct Node {
+    Operator op;
+    unsigned int lhs;
+    unsigned int rhs;
+  };
+
+  ArithmeticExpression();
+
+  /**
+   * @brief Get the node for a variable in the scope.
+   * @return The index of the node.
+   */
+  unsigned int variable(const unsigned int scopeIndex);
+
+  /**
+   * @brief Get the node for an operation on two existing nodes.
+   * @return The index of the node.
+   */
+  unsigned int apply(const Operator op, const unsigned int lhs, const unsigned int rhs);
+
+  const std::vector<Node>& getNodes() const {return m_nodes;}
+
+  /**
+   * @brief The number of variables a constraint on this expression takes, including the result.
+   */
+  unsigned int getScopeSize() const {return m_scopeSize;}
+
+  /**
+   * @brief The expression as an equation, e.g. x0=((x1*x2)+x3).  Two expressions with the same text
+   * propagate identically.
+   */
+  std::string toString() const;
+
+ private:
+  std::vector<Node> m_nodes;
+  std::vector<std::string> m_text; /*!< The text of each node */
+  std::map<std::string, unsigned int> m_index; /*!< Node index by text */
+  unsigned int m_scopeSize;
+};
+
+/**
+ * @brief Maintains x0 == e(x1, ..., xn) for an ArithmeticExpression e by HC4-revise: a forward pass
+ * evaluates the interval of each node bottom-up, the root is intersected with x0, and a backward pass
+ * projects each node's interval onto its children, top-down, restricting the variables at the leaves.
+ * Only nodes narrowed below the bounds evaluated for them are projected.  Passes are repeated while they
+ * restrict a variable in the expression, since a variable that occurs more than once, or rounding to
+ * integers, can narrow it further in a second pass.
+ *
+ * Bounds are moved outward after every floating point operation so that rounding never excludes a value.
+ * If every variable in the expression is an integer, every node is rounded inward to integers.
+ */
+class ArithmeticConstraint : public Constraint {
+ public:
+  ArithmeticConstraint(const std::string& name,
+                       const std::string& propagatorName,
+                       const ConstraintEngineId constraintEngine,
+                       const std::vector<ConstrainedVariableId>& variables,
+                       const ArithmeticExpression& expression);
+
+  void handleExecute();
+
+  const ArithmeticExpression& getExpression() const {return m_expression;}
+
+  /**
+   * @brief The number of operations evaluated forward or projected backward over all passes so far.  One
+   * execution of the constraint that an operation would be on its own does both.
+   */
+  unsigned long getRevisionCount() const {return m_revisions;}
+
+  struct Bounds {
+    double lb;
+    double ub;
+  };
+
+ private:
+  /**
+   * @brief One forward and backward pass.
+   * @return false if a domain was emptied.
+   */
+  bool revise(bool& changed);
+
+  /**
+   * @brief Intersect the bounds of a node with other bounds.
+   * @return false if the result is empty.
+   */
+  bool narrow(Bounds& bounds, const Bounds& other) const;
+
+  ArithmeticExpression m_expression;
+  std::vector<Bounds> m_bounds; /*!< Bounds of each node during execution */
+  std::vector<bool> m_narrowed; /*!< Nodes narrowed below their evaluated bounds in the current pass */
+  bool m_integral;
+  double m_tolerance; /*!< Bounds closer than this are equal */
+  bool m_resultInExpression; /*!< True if x0 is also a leaf */
+  unsigned long m_revisions; /*!< Operations evaluated or projected so far */
+
+  // A repeated variable can make the passes converge slowly, so give up on the fixed point after this many
+  static const unsigned int MAX_PASSES = 100;
+};
+
+/**
+ * @brief The type of the constraint for one expression.  These are registered as the expressions are
+ * compiled, under names given by nameOf(expression).
+ */
+class ArithmeticConstraintType : public ConstraintType {
+ public:
+  ArithmeticConstraintType(const std::string& propagatorName, const ArithmeticExpression& expression);
+
+  ConstraintId createConstraint(const ConstraintEngineId constraintEngine,
+                                const std::vector<ConstrainedVariableId>& scope,
+                                const std::string& violationExpl);
+
+  void checkArgTypes(const std::vector<DataTypeId>& argTypes) const;
+
+  static std::string nameOf(const ArithmeticExpression& expression);
+
+ private:
+  const ArithmeticExpression m_expression;
+};
+
+}
+
+#endif
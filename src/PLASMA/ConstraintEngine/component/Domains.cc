@@ -98,14 +98,9 @@ EnumeratedDomain::EnumeratedDomain(const Domain& org)
   void EnumeratedDomain::insert(edouble value) {
 	  check_error(check_value(value));
 	  checkError(isOpen(), "Cannot insert into a closed domain." << toString());
-	  std::set<edouble>::iterator it = m_values.begin();
-	  for ( ; it != m_values.end(); it++) {
-		  if (compareEqual(value, *it))
-			  return; // Already a member.
-		  if (value < *it) // Since members are sorted, value goes before *it.
-			  break;
-	  }
-	  m_values.insert(it, value);
+	  if (findMember(value) != m_values.end())
+		  return; // Already a member.
+	  m_values.insert(value);
 
 	  // CMG: Do not generate a relaxation for insertion into an open domain. The semantics of an open domain indicate that
 	  // the set of values is unbound, and we are now simply adding in another explicit member.
@@ -119,10 +114,7 @@ EnumeratedDomain::EnumeratedDomain(const Domain& org)
 
   void EnumeratedDomain::remove(edouble value) {
 	  check_error(check_value(value));
-	  std::set<edouble>::iterator it = m_values.begin();
-	  for ( ; it != m_values.end(); it++)
-		  if (compareEqual(value, *it))
-			  break;
+	  std::set<edouble>::iterator it = findMember(value);
 	  if (it == m_values.end())
 		  return; // not present: no-op
 	  m_values.erase(it);
@@ -132,6 +124,20 @@ EnumeratedDomain::EnumeratedDomain(const Domain& org)
 		  notifyChange(DomainListener::EMPTIED);
   }
 
+  std::set<edouble>::iterator EnumeratedDomain::findMember(edouble value) {
+	  // Members are sorted, so only the neighbours of the insertion point can be within minDelta.
+	  std::set<edouble>::iterator it = m_values.lower_bound(value);
+	  if (it != m_values.begin()) {
+		  std::set<edouble>::iterator prior = it;
+		  --prior;
+		  if (compareEqual(value, *prior))
+			  return prior;
+	  }
+	  if (it != m_values.end() && compareEqual(value, *it))
+		  return it;
+	  return m_values.end();
+  }
+
   void EnumeratedDomain::set(edouble value) {
 	  if(isOpen())
 		  close();
@@ -288,6 +288,12 @@ namespace EUROPA {
 	   */
 	  bool equateClosedEnumerations(EnumeratedDomain& dom);
 
+	  /**
+	   * @brief Locates the member equal to value to within minDelta.
+	   * @return The position of the member, or the end of m_values if there is none.
+	   */
+	  std::set<edouble>::iterator findMember(edouble value);
+
 	  std::set<edouble> m_values; /**< Holds the contents from which the set membership is then derived. */
   };
 
@@ -15,7 +15,7 @@ ConstraintNode::ConstraintNode(const ConstrainedVariableId variable)
 
   bool ConstraintNode::isAlone() const {return m_neighbours.empty();}
 
-  void ConstraintNode::update(int nextCycle, std::set<ConstrainedVariableId>& connectedVariables, int graph,  std::set<int>& oldGraphKeys){
+  void ConstraintNode::update(int nextCycle, ConstrainedVariableSet& connectedVariables, int graph,  std::set<int>& oldGraphKeys){
     check_error(nextCycle > m_lastUpdated);
     // Update local data and add self to set
     m_lastUpdated = nextCycle;
@@ -43,7 +43,7 @@ ConstraintNode::ConstraintNode(const ConstrainedVariableId variable)
       : m_nodesByVar(), m_graphsByKey(), m_requiresUpdate(false), m_nextCycle(0), m_nextGraph(0) {}
 
   EquivalenceClassCollection::~EquivalenceClassCollection(){
-    for(std::map<ConstrainedVariableId, ConstraintNodeId>::iterator it = m_nodesByVar.begin(); it != m_nodesByVar.end(); ++it)
+    for(NodeMap::iterator it = m_nodesByVar.begin(); it != m_nodesByVar.end(); ++it)
       it->second.release();
   }
 
@@ -96,14 +96,14 @@ unsigned long EquivalenceClassCollection::getGraphCount(){
   void EquivalenceClassCollection::getGraphKeys(std::set<int>& keys){
     keys.clear();
     recomputeIfNecessary();
-    for(std::map<int, std::set<ConstrainedVariableId> >::const_iterator it = m_graphsByKey.begin(); it != m_graphsByKey.end(); ++it)
+    for(std::map<int, ConstrainedVariableSet>::const_iterator it = m_graphsByKey.begin(); it != m_graphsByKey.end(); ++it)
       keys.insert(it->first);
   }
 
 
-  const std::set<ConstrainedVariableId>& EquivalenceClassCollection::getGraphVariables(int key) const{
-    static const std::set<ConstrainedVariableId> sl_emptySet;
-    std::map<int, std::set<ConstrainedVariableId> >::const_iterator it = m_graphsByKey.find(key);
+  const ConstrainedVariableSet& EquivalenceClassCollection::getGraphVariables(int key) const{
+    static const ConstrainedVariableSet sl_emptySet;
+    std::map<int, ConstrainedVariableSet>::const_iterator it = m_graphsByKey.find(key);
     if(it == m_graphsByKey.end())
       return sl_emptySet;
     else
@@ -121,7 +121,7 @@ unsigned long EquivalenceClassCollection::getGraphCount(){
     m_nextCycle++;
 
     // Iterate over all nodes
-    for(std::map<ConstrainedVariableId, ConstraintNodeId>::iterator it = m_nodesByVar.begin(); it != m_nodesByVar.end(); ++it){
+    for(NodeMap::iterator it = m_nodesByVar.begin(); it != m_nodesByVar.end(); ++it){
       const ConstraintNodeId node = it->second;
       check_error(node.isValid());
       if(!node->hasBeenUpdated(m_nextCycle)) // means we have a new graph to build.
@@ -134,12 +134,12 @@ unsigned long EquivalenceClassCollection::getGraphCount(){
   void EquivalenceClassCollection::recomputeSingleGraph(const ConstraintNodeId node){
     m_nextGraph++;
     // Initialize new graph with an empty set and obtain the reference to fill it up
-    std::set<ConstrainedVariableId> emptySet;
-    std::map<int, std::set<ConstrainedVariableId> >::iterator  newGraphEntry =
-      m_graphsByKey.insert(std::pair<int, std::set<ConstrainedVariableId> >(m_nextGraph, emptySet)).first;
+    ConstrainedVariableSet emptySet;
+    std::map<int, ConstrainedVariableSet>::iterator  newGraphEntry =
+      m_graphsByKey.insert(std::pair<int, ConstrainedVariableSet>(m_nextGraph, emptySet)).first;
 
     check_error(newGraphEntry->first == m_nextGraph);
-    std::set<ConstrainedVariableId>& newGraph = newGraphEntry->second;
+    ConstrainedVariableSet& newGraph = newGraphEntry->second;
 
     // Now fill it up
     std::set<int> graphKeysToRemove;
@@ -150,7 +150,7 @@ unsigned long EquivalenceClassCollection::getGraphCount(){
   }
 
   const ConstraintNodeId EquivalenceClassCollection::getNode(const ConstrainedVariableId variable){
-    std::map<ConstrainedVariableId, ConstraintNodeId>::iterator it = m_nodesByVar.find(variable);
+    NodeMap::iterator it = m_nodesByVar.find(variable);
 
     if (it == m_nodesByVar.end()){ // Not present yet, so create a new entry
       ConstraintNodeId node(new ConstraintNode(variable));
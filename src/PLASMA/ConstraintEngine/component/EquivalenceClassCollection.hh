@@ -45,7 +45,7 @@ namespace EUROPA{
      * @param graph The new graph key to become a member of.
      * @param oldGraphKeys The working set of old graph keys held by nodes visited. At the end these must be removed from the set of graphs.
      */
-    void update(int cycleCount, std::set<ConstrainedVariableId>& connectedVariables, int graph, std::set<int>& oldGraphKeys);
+    void update(int cycleCount, ConstrainedVariableSet& connectedVariables, int graph, std::set<int>& oldGraphKeys);
 
     /**
      * @brief Synonomous to the addition of an equality constraint with the given node. Creates a link in the graph.
@@ -93,8 +93,10 @@ namespace EUROPA{
     unsigned long getGraphCount();
     int getGraphKey(const ConstrainedVariableId variable);
     void getGraphKeys(std::set<int>& keys);
-    const std::set<ConstrainedVariableId>& getGraphVariables(int key) const;
+    const ConstrainedVariableSet& getGraphVariables(int key) const;
   private:
+    typedef std::map<ConstrainedVariableId, ConstraintNodeId, EntityComparator<ConstrainedVariableId> > NodeMap;
+
     const ConstraintNodeId getNode(const ConstrainedVariableId variable);
 
     /**
@@ -121,8 +123,9 @@ namespace EUROPA{
      */
     bool isValid() const;
 
-    std::map<ConstrainedVariableId, ConstraintNodeId> m_nodesByVar; /**< Table to map constrained variables to their representative node in the graph */
-    std::map<int, std::set<ConstrainedVariableId> > m_graphsByKey; /**< Map of the graph key to the set of constrained variables which are
+    NodeMap m_nodesByVar; /**< Table to map constrained variables to their representative node in the graph. Ordered by key
+                             so that graphs are numbered, and so propagated, the same way from run to run. */
+    std::map<int, ConstrainedVariableSet> m_graphsByKey; /**< Map of the graph key to the set of constrained variables which are
 								     inferred to be equivalent. This changes when constraints are added or removed. */
     bool m_requiresUpdate; /**< Indicates of we must recompute all graps. True of a constraint has been removed. Made false by recomputing. */
 
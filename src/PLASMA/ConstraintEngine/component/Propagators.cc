@@ -125,7 +125,7 @@ EqualityConstraintPropagator::EqualityConstraintPropagator(const std::string& na
 
     // Now process the agenda
     for(std::set<int>::iterator it = m_eqClassAgenda.begin(); it != m_eqClassAgenda.end(); ++it){
-      const std::set<ConstrainedVariableId>& eqClassScope = m_eqClassCollection.getGraphVariables(*it);
+      const ConstrainedVariableSet& eqClassScope = m_eqClassCollection.getGraphVariables(*it);
       equate(eqClassScope);
     }
 
@@ -182,7 +182,7 @@ EqualityConstraintPropagator::EqualityConstraintPropagator(const std::string& na
   }
 
 namespace {
-void processScope(const std::set<ConstrainedVariableId>& scope) {
+void processScope(const ConstrainedVariableSet& scope) {
   Domain& domain(EqualConstraint::getCurrentDomain(* (scope.begin())));
 
   if (domain.isOpen())
@@ -194,7 +194,7 @@ void processScope(const std::set<ConstrainedVariableId>& scope) {
   // int domainType = domain.getType(); // Unused; see below.
 
   // Iterate over, restricting domain as we go.
-  for (std::set<ConstrainedVariableId>::const_iterator it = scope.begin(); 
+  for (ConstrainedVariableSet::const_iterator it = scope.begin(); 
        it != scope.end(); ++it) {
     Domain& currentDomain = EqualConstraint::getCurrentDomain(*it);
 
@@ -232,14 +232,14 @@ void processScope(const std::set<ConstrainedVariableId>& scope) {
   // variables in the scope and we know that no domain has been
   // emptied (this could be optimized by recording the last change
   // to domain).
-  for (std::set<ConstrainedVariableId>::const_iterator it = scope.begin(); it != scope.end(); ++it) {
+  for (ConstrainedVariableSet::const_iterator it = scope.begin(); it != scope.end(); ++it) {
     Domain& currentDomain = EqualConstraint::getCurrentDomain(*it);
     currentDomain.intersect(domain);
   }
 }
 }
 
-  void EqualityConstraintPropagator::equate(const std::set<ConstrainedVariableId>& scope) {
+  void EqualityConstraintPropagator::equate(const ConstrainedVariableSet& scope) {
     check_error(!scope.empty());
     processScope(scope);
   }
@@ -83,7 +83,7 @@ namespace EUROPA {
      * @param scope the scope of variables to be equated
      * @note If the intersection is empty, only one domain is actually emptied.
      */
-    void equate(const std::set<ConstrainedVariableId>& scope);
+    void equate(const ConstrainedVariableSet& scope);
 
     bool m_fullReprop; /**< True if a constraint has been removed. Otherwise false. */
 
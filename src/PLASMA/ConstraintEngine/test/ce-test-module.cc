@@ -9,6 +9,7 @@
 #include "Utils.hh"
 #include "Variable.hh"
 #include "Constraints.hh"
+#include "ArithmeticConstraint.hh"
 #include "ConstraintType.hh"
 #include "Propagators.hh"
 #include "ConstraintEngineListener.hh"
@@ -325,6 +326,15 @@ private:
   int m_counter;
 };
 
+class ExecutionCounter : public ConstraintEngineListener {
+public:
+  ExecutionCounter(const ConstraintEngineId ce) : ConstraintEngineListener(ce), m_counter(0) {}
+  void notifyExecuted(const ConstraintId) {++m_counter;}
+  int counter() const {return m_counter;}
+private:
+  int m_counter;
+};
+
 class ConstraintEngineTest
 {
 public:
@@ -334,6 +344,7 @@ public:
     EUROPA_runCETest(testVariableLookupByIndex);
     EUROPA_runCETest(testGNATS_3133);
     EUROPA_runCETest(testPostPropagation);
+    EUROPA_runCETest(testConflictExplanation);
     return true;
   }
 
@@ -471,6 +482,100 @@ public:
 
     return true;
   }
+
+  /**
+   * Hides a known minimal conflict, a chain of <= from a value specified too high to one specified too low,
+   * among seeded noise that is consistent, and checks that exactly the chain and its ends are found.
+   */
+  static bool testConflictExplanation(){
+    for(unsigned int seed = 1; seed <= 5; seed++){
+      unsigned int random = seed;
+      std::vector<ConstrainedVariableId> variables;
+      std::vector<ConstraintId> allConstraints;
+      ConstraintSet noiseConstraints;
+      ConstrainedVariableSet noiseFacts;
+
+      // Noise: specified values, with <= between them wherever it holds
+      std::vector<int> values;
+      for(unsigned int i = 0; i < 20; i++){
+        random = random * 1103515245 + 12345;
+        values.push_back((random >> 16) % 90);
+        ConstrainedVariableId var = (new Variable<IntervalIntDomain>(ENGINE, IntervalIntDomain(0, 100)))->getId();
+        var->specify(values.back());
+        variables.push_back(var);
+        noiseFacts.insert(var);
+      }
+      for(unsigned int i = 0; i < 40; i++){
+        random = random * 1103515245 + 12345;
+        unsigned int a = (random >> 16) % 20;
+        random = random * 1103515245 + 12345;
+        unsigned int b = (random >> 16) % 20;
+        if(a == b)
+          continue;
+        if(values[a] > values[b])
+          std::swap(a, b);
+        ConstraintId c = (new LessThanEqualConstraint("LessThanEqualConstraint", "Default", ENGINE,
+                                                      makeScope(variables[a], variables[b])))->getId();
+        allConstraints.push_back(c);
+        noiseConstraints.insert(c);
+      }
+      CPPUNIT_ASSERT(ENGINE->propagate());
+
+      // The conflict, with a length set by the seed
+      ConstraintSet chain;
+      ConstrainedVariableSet ends;
+      ConstrainedVariableId first = (new Variable<IntervalIntDomain>(ENGINE, IntervalIntDomain(0, 100)))->getId();
+      ConstrainedVariableId top = (new Variable<IntervalIntDomain>(ENGINE, IntervalIntDomain(0, 100)))->getId();
+      variables.push_back(first);
+      variables.push_back(top);
+      first->specify(95);
+      top->specify(100);
+      ConstrainedVariableId last = first;
+      for(unsigned int i = 0; i <= seed; i++){
+        ConstrainedVariableId next = (new Variable<IntervalIntDomain>(ENGINE, IntervalIntDomain(0, 100)))->getId();
+        variables.push_back(next);
+        ConstraintId c = (new LessThanEqualConstraint("LessThanEqualConstraint", "Default", ENGINE,
+                                                      makeScope(last, next)))->getId();
+        allConstraints.push_back(c);
+        chain.insert(c);
+        // Joined to the noise, without making another conflict
+        allConstraints.push_back((new LessThanEqualConstraint("LessThanEqualConstraint", "Default", ENGINE,
+                                                              makeScope(next, top)))->getId());
+        allConstraints.push_back((new LessThanEqualConstraint("LessThanEqualConstraint", "Default", ENGINE,
+                                                              makeScope(variables[i], top)))->getId());
+        last = next;
+      }
+      last->specify(5);
+      ends.insert(first);
+      ends.insert(last);
+      CPPUNIT_ASSERT(!ENGINE->propagate());
+
+      ConstraintSet constraints(allConstraints.begin(), allConstraints.end());
+      ConstrainedVariableSet facts(noiseFacts);
+      facts.insert(ends.begin(), ends.end());
+      facts.insert(top);
+      CPPUNIT_ASSERT(ENGINE->explainInconsistency(constraints, facts));
+      CPPUNIT_ASSERT(constraints == chain);
+      CPPUNIT_ASSERT(facts == ends);
+      CPPUNIT_ASSERT(ENGINE->provenInconsistent());
+
+      // A conflict among the rest of the network is explained by nothing
+      CPPUNIT_ASSERT(ENGINE->explainInconsistency(noiseConstraints, noiseFacts));
+      CPPUNIT_ASSERT(noiseConstraints.empty() && noiseFacts.empty());
+
+      // Without one end there is no conflict
+      last->reset();
+      constraints.insert(allConstraints.begin(), allConstraints.end());
+      facts.insert(first);
+      CPPUNIT_ASSERT(!ENGINE->explainInconsistency(constraints, facts));
+      CPPUNIT_ASSERT(constraints.empty() && facts.empty());
+      CPPUNIT_ASSERT(ENGINE->constraintConsistent());
+
+      cleanup(allConstraints);
+      cleanup(variables);
+    }
+    return true;
+  }
 };
 
 
@@ -815,6 +920,7 @@ public:
     EUROPA_runCETest(testDelegation);
     EUROPA_runCETest(testNotEqual);
     EUROPA_runCETest(testMultEqualConstraint);
+    EUROPA_runCETest(testArithmeticConstraint);
     EUROPA_runCETest(testEqualSumConstraint);
     EUROPA_runCETest(testCondAllSameConstraint);
     EUROPA_runCETest(testCondAllDiffConstraint);
@@ -1536,6 +1642,176 @@ private:
   }
 
 
+  /**
+   * z == x1 * x2 + x3 * x4 + x5 * x6, either as one ArithmeticConstraint or as mulEq and addEq
+   * constraints over auxiliary variables, with the variables restricted one at a time.
+   * @return The number of operations evaluated forward or projected backward.  One execution of the compiled
+   * constraint may do either to each of its operations in each of many passes, while one execution of a
+   * decomposed constraint does both to its one operation.
+   */
+  static unsigned long runSumOfProducts(bool compiled, std::vector<IntervalIntDomain>& domains) {
+    Variable<IntervalIntDomain> z(ENGINE, IntervalIntDomain(0, 300));
+    Variable<IntervalIntDomain> x1(ENGINE, IntervalIntDomain(0, 10));
+    Variable<IntervalIntDomain> x2(ENGINE, IntervalIntDomain(0, 10));
+    Variable<IntervalIntDomain> x3(ENGINE, IntervalIntDomain(0, 10));
+    Variable<IntervalIntDomain> x4(ENGINE, IntervalIntDomain(0, 10));
+    Variable<IntervalIntDomain> x5(ENGINE, IntervalIntDomain(0, 10));
+    Variable<IntervalIntDomain> x6(ENGINE, IntervalIntDomain(0, 10));
+    std::vector<ConstrainedVariableId> scope;
+    scope.push_back(z.getId());
+    scope.push_back(x1.getId());
+    scope.push_back(x2.getId());
+    scope.push_back(x3.getId());
+    scope.push_back(x4.getId());
+    scope.push_back(x5.getId());
+    scope.push_back(x6.getId());
+
+    Variable<IntervalIntDomain> p1(ENGINE, IntervalIntDomain());
+    Variable<IntervalIntDomain> p2(ENGINE, IntervalIntDomain());
+    Variable<IntervalIntDomain> p3(ENGINE, IntervalIntDomain());
+    Variable<IntervalIntDomain> sum(ENGINE, IntervalIntDomain());
+    std::vector<ConstraintId> constraints;
+    ArithmeticConstraint* arithmetic = NULL;
+    if(compiled) {
+      ArithmeticExpression expr;
+      unsigned int root = expr.apply(ArithmeticExpression::MULTIPLY, expr.variable(1), expr.variable(2));
+      root = expr.apply(ArithmeticExpression::ADD, root,
+                        expr.apply(ArithmeticExpression::MULTIPLY, expr.variable(3), expr.variable(4)));
+      root = expr.apply(ArithmeticExpression::ADD, root,
+                        expr.apply(ArithmeticExpression::MULTIPLY, expr.variable(5), expr.variable(6)));
+      CPPUNIT_ASSERT(expr.toString() == "x0=(((x1*x2)+(x3*x4))+(x5*x6))");
+      arithmetic = new ArithmeticConstraint("arithmetic", "Default", ENGINE, scope, expr);
+      constraints.push_back(arithmetic->getId());
+    }
+    else {
+      constraints.push_back((new MultEqualConstraint("mulEq", "Default", ENGINE,
+                                                     makeScope(x1.getId(), x2.getId(), p1.getId())))->getId());
+      constraints.push_back((new MultEqualConstraint("mulEq", "Default", ENGINE,
+                                                     makeScope(x3.getId(), x4.getId(), p2.getId())))->getId());
+      constraints.push_back((new MultEqualConstraint("mulEq", "Default", ENGINE,
+                                                     makeScope(x5.getId(), x6.getId(), p3.getId())))->getId());
+      constraints.push_back((new AddEqualConstraint("addEq", "Default", ENGINE,
+                                                    makeScope(p1.getId(), p2.getId(), sum.getId())))->getId());
+      constraints.push_back((new AddEqualConstraint("addEq", "Default", ENGINE,
+                                                    makeScope(sum.getId(), p3.getId(), z.getId())))->getId());
+    }
+
+    unsigned long revisions;
+    {
+      ExecutionCounter counter(ENGINE);
+      CPPUNIT_ASSERT(ENGINE->propagate());
+      for(unsigned int i = 1; i < scope.size(); i++) {
+        scope[i]->restrictBaseDomain(IntervalIntDomain(1, 10 - i));
+        CPPUNIT_ASSERT(ENGINE->propagate());
+      }
+      z.restrictBaseDomain(IntervalIntDomain(40, 45));
+      CPPUNIT_ASSERT(ENGINE->propagate());
+      revisions = (compiled ? arithmetic->getRevisionCount() : 2 * static_cast<unsigned long>(counter.counter()));
+    }
+
+    for(unsigned int i = 0; i < scope.size(); i++)
+      domains.push_back(IntervalIntDomain(scope[i]->lastDomain()));
+    for(unsigned int i = 0; i < constraints.size(); i++)
+      delete static_cast<Constraint*>(constraints[i]);
+    return revisions;
+  }
+
+  static bool testArithmeticConstraint() {
+    // z == x * (y + w), which is also what mulEq(x, a, z) and addEq(y, w, a) give
+    {
+      Variable<IntervalIntDomain> z(ENGINE, IntervalIntDomain(30, 40));
+      Variable<IntervalIntDomain> x(ENGINE, IntervalIntDomain(1, 10));
+      Variable<IntervalIntDomain> y(ENGINE, IntervalIntDomain(0, 5));
+      Variable<IntervalIntDomain> w(ENGINE, IntervalIntDomain(2, 4));
+      ArithmeticExpression expr;
+      expr.apply(ArithmeticExpression::MULTIPLY, expr.variable(1),
+                 expr.apply(ArithmeticExpression::ADD, expr.variable(2), expr.variable(3)));
+      CPPUNIT_ASSERT(expr.getScopeSize() == 4);
+      std::vector<ConstrainedVariableId> scope;
+      scope.push_back(z.getId());
+      scope.push_back(x.getId());
+      scope.push_back(y.getId());
+      scope.push_back(w.getId());
+      ArithmeticConstraint c0("arithmetic", "Default", ENGINE, scope, expr);
+      CPPUNIT_ASSERT(ENGINE->propagate());
+      CPPUNIT_ASSERT_MESSAGE(x.getDerivedDomain().toString(), x.getDerivedDomain() == IntervalIntDomain(4, 10));
+      CPPUNIT_ASSERT(y.getDerivedDomain() == IntervalIntDomain(0, 5));
+      CPPUNIT_ASSERT(w.getDerivedDomain() == IntervalIntDomain(2, 4));
+      CPPUNIT_ASSERT(z.getDerivedDomain() == IntervalIntDomain(30, 40));
+    }
+
+    // z == (x - y) * w over reals
+    {
+      Variable<IntervalDomain> z(ENGINE, IntervalDomain(0, 1));
+      Variable<IntervalDomain> x(ENGINE, IntervalDomain(1, 2));
+      Variable<IntervalDomain> y(ENGINE, IntervalDomain(0.5, 1));
+      Variable<IntervalDomain> w(ENGINE, IntervalDomain(2, 3));
+      ArithmeticExpression expr;
+      expr.apply(ArithmeticExpression::MULTIPLY,
+                 expr.apply(ArithmeticExpression::SUBTRACT, expr.variable(1), expr.variable(2)),
+                 expr.variable(3));
+      ArithmeticConstraint c0("arithmetic", "Default", ENGINE, makeScope(z.getId(), x.getId(), y.getId(), w.getId()), expr);
+      CPPUNIT_ASSERT(ENGINE->propagate());
+      CPPUNIT_ASSERT_MESSAGE(x.getDerivedDomain().toString(), x.getDerivedDomain() == IntervalDomain(1, 1.5));
+      CPPUNIT_ASSERT_MESSAGE(y.getDerivedDomain().toString(), y.getDerivedDomain() == IntervalDomain(0.5, 1));
+      CPPUNIT_ASSERT(w.getDerivedDomain() == IntervalDomain(2, 3));
+    }
+
+    // A repeated variable is one leaf: z == x + x
+    {
+      Variable<IntervalIntDomain> z(ENGINE, IntervalIntDomain(0, 6));
+      Variable<IntervalIntDomain> x(ENGINE, IntervalIntDomain(0, 100));
+      ArithmeticExpression expr;
+      expr.apply(ArithmeticExpression::ADD, expr.variable(1), expr.variable(1));
+      CPPUNIT_ASSERT(expr.getNodes().size() == 2);
+      CPPUNIT_ASSERT(expr.getScopeSize() == 2);
+      ArithmeticConstraint c0("arithmetic", "Default", ENGINE, makeScope(z.getId(), x.getId()), expr);
+      CPPUNIT_ASSERT(ENGINE->propagate());
+      CPPUNIT_ASSERT_MESSAGE(x.getDerivedDomain().toString(), x.getDerivedDomain() == IntervalIntDomain(0, 6));
+    }
+
+    // Out of reach: z == x * y + w with z above the largest value
+    {
+      Variable<IntervalIntDomain> z(ENGINE, IntervalIntDomain(6, 10));
+      Variable<IntervalIntDomain> x(ENGINE, IntervalIntDomain(0, 2));
+      Variable<IntervalIntDomain> y(ENGINE, IntervalIntDomain(0, 2));
+      Variable<IntervalIntDomain> w(ENGINE, IntervalIntDomain(0, 1));
+      ArithmeticExpression expr;
+      expr.apply(ArithmeticExpression::ADD,
+                 expr.apply(ArithmeticExpression::MULTIPLY, expr.variable(1), expr.variable(2)),
+                 expr.variable(3));
+      ArithmeticConstraint c0("arithmetic", "Default", ENGINE, makeScope(z.getId(), x.getId(), y.getId(), w.getId()), expr);
+      CPPUNIT_ASSERT(!ENGINE->propagate());
+    }
+
+    // Integer operands can't reach a fraction, as with addEq
+    {
+      Variable<IntervalDomain> z(ENGINE, IntervalDomain(0.01, 0.99));
+      Variable<IntervalIntDomain> x(ENGINE, IntervalIntDomain(-10, 10));
+      Variable<IntervalIntDomain> y(ENGINE, IntervalIntDomain(-10, 10));
+      Variable<IntervalIntDomain> w(ENGINE, IntervalIntDomain(-10, 10));
+      ArithmeticExpression expr;
+      expr.apply(ArithmeticExpression::ADD, expr.variable(1),
+                 expr.apply(ArithmeticExpression::MULTIPLY, expr.variable(2), expr.variable(3)));
+      ArithmeticConstraint c0("arithmetic", "Default", ENGINE, makeScope(z.getId(), x.getId(), y.getId(), w.getId()), expr);
+      CPPUNIT_ASSERT(!ENGINE->propagate());
+    }
+
+    // Against the decomposed form: prunes at least as much, revising fewer operations
+    {
+      std::vector<IntervalIntDomain> compiledDomains, decomposedDomains;
+      unsigned long compiledRevisions = runSumOfProducts(true, compiledDomains);
+      unsigned long decomposedRevisions = runSumOfProducts(false, decomposedDomains);
+      CPPUNIT_ASSERT(compiledDomains.size() == decomposedDomains.size());
+      for(unsigned int i = 0; i < compiledDomains.size(); i++)
+        CPPUNIT_ASSERT_MESSAGE(compiledDomains[i].toString() + " is not in " + decomposedDomains[i].toString(),
+                               compiledDomains[i].isSubsetOf(decomposedDomains[i]));
+      CPPUNIT_ASSERT_MESSAGE(toString(compiledRevisions) + " revisions compiled, " + toString(decomposedRevisions) +
+                             " decomposed", compiledRevisions < decomposedRevisions);
+    }
+    return true;
+  }
+
   static bool testEqualSumConstraint() {
     Variable<IntervalIntDomain> v0(ENGINE, IntervalIntDomain(1, 10));
     Variable<IntervalIntDomain> v1(ENGINE, IntervalIntDomain(1, 1));
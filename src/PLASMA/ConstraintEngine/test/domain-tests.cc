@@ -790,6 +790,7 @@ class IntrinsicsTest {
       EUROPA_runTest(testOperatorEquals);
       EUROPA_runTest(testEmptyOnClosure);
       EUROPA_runTest(testOpenEnumerations);
+      EUROPA_runTest(testInsertAndRemoveWithinPrecision);
       return true;
     }
 
@@ -830,6 +831,45 @@ class IntrinsicsTest {
       return true;
     }
 
+    static bool testInsertAndRemoveWithinPrecision() {
+      EnumeratedDomain e1(FloatDT::instance());
+      ChangeListener l1;
+      DomainListener::ChangeType change;
+      e1.setListener(l1.getId());
+      const edouble delta = e1.minDelta() / 2;
+
+      e1.insert(5.0);
+      e1.insert(1.0);
+      e1.insert(3.0);
+      CPPUNIT_ASSERT(e1.getSize() == 3);
+      CPPUNIT_ASSERT(*e1.getValues().begin() == 1.0);
+      CPPUNIT_ASSERT(*e1.getValues().rbegin() == 5.0);
+
+      // Values within precision of a member are the member
+      e1.insert(3.0 + delta);
+      e1.insert(3.0 - delta);
+      e1.insert(5.0 + delta);
+      CPPUNIT_ASSERT(e1.getSize() == 3);
+      CPPUNIT_ASSERT(!l1.checkAndClearChange(change));
+
+      e1.remove(1.0 - delta);
+      CPPUNIT_ASSERT(l1.checkAndClearChange(change));
+      CPPUNIT_ASSERT(change == DomainListener::VALUE_REMOVED);
+      CPPUNIT_ASSERT(!e1.isMember(1.0));
+      CPPUNIT_ASSERT(e1.getSize() == 2);
+
+      e1.remove(5.0 + delta);
+      CPPUNIT_ASSERT(l1.checkAndClearChange(change));
+      CPPUNIT_ASSERT(e1.getSize() == 1);
+
+      // Removing a non-member is a no-op
+      e1.remove(4.0);
+      CPPUNIT_ASSERT(!l1.checkAndClearChange(change));
+      CPPUNIT_ASSERT(e1.getSize() == 1);
+      CPPUNIT_ASSERT(e1.isMember(3.0));
+      return true;
+    }
+
     static bool testOpenEnumerations() {
       EnumeratedDomain e1(FloatDT::instance());
       ChangeListener l1;
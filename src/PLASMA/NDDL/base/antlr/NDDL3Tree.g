@@ -585,6 +585,9 @@ tokenType[ObjectType* objType]
 
 // TODO: allow assignments to inherited parameters
 tokenStatements[InterpretedTokenType* tokenType]
+@init {
+    std::vector<Expr*> body;
+}
 	:	^('{'
             (
                 ( child=tokenParameter[tokenType] 
@@ -593,10 +596,15 @@ tokenStatements[InterpretedTokenType* tokenType]
                 | child=enforceExpression
                 )
                 {
-                    tokenType->addBodyExpr(child);
+                    body.push_back(child);
                 }
 		    )*
 		)
+		{
+		    CTX->SymbolTable->simplify(tokenType->getPredicateName(),body,false);
+		    for (unsigned int i=0;i<body.size();i++)
+		        tokenType->addBodyExpr(body[i]);
+		}
 	;
 	
 // Note: Allocations are not legal here.        
@@ -668,6 +676,7 @@ rule returns [Expr* result]
                 }
             }
 		    std::string source="\"" + filename + "," + std::string(buff) + "\"";
+		    CTX->SymbolTable->simplify(predName,ruleBody,true);
 		    InterpretedRuleFactory* rf = new InterpretedRuleFactory(predName,source,ruleBody);
 		    if (iTokenType != NULL) 
 		        iTokenType->addRule(rf);
@@ -973,7 +982,9 @@ cexpression returns [CExpr* result]
 	:	^(cop=cexprOp leftValue=cexpression rightValue=cexpression)
         {
            std::string op = c_str($cop.text->chars);
-           result = new CExprBinary(op, leftValue, rightValue);
+           CExprBinary* binary = new CExprBinary(op, leftValue, rightValue);
+           binary->setCompileArithmetic(CTX->SymbolTable->compileArithmetic());
+           result = binary;
         }
 	|	r=anyValue
         {
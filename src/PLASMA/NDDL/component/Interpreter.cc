@@ -14,6 +14,7 @@
 #include "Error.hh"
 #include "Utils.hh"
 
+#include "ArithmeticConstraint.hh"
 #include "ConstraintType.hh"
 #include "DataTypes.hh"
 #include "Domains.hh"
@@ -30,6 +31,8 @@
 #include "NddlUtils.hh"
 #include <typeinfo>
 #include <iterator>
+#include <algorithm>
+#include <set>
 
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/algorithm/string/split.hpp>
@@ -428,7 +431,7 @@ DataRef ExprVarRef::eval(EvalContext& context) const {
   }
 
   CExprBinary::CExprBinary(std::string op, CExpr* lhs, CExpr* rhs)
-    : m_operator(op), m_lhs(lhs),  m_rhs(rhs)
+    : m_operator(op), m_lhs(lhs),  m_rhs(rhs), m_compileArithmetic(false)
   {
   }
 
@@ -488,6 +491,49 @@ bool isTimepoint(DataRef var) {
   return dynamic_cast< TokenVariable<IntervalIntDomain>* >(cvar) != NULL
       && (cvar->getName() == "end" || cvar->getName() == "start");
 }
+
+bool isArithmeticBinary(const CExpr* expr) {
+  const CExprBinary* binary = dynamic_cast<const CExprBinary*>(expr);
+  return binary != NULL && binary->isArithmetic();
+}
+
+bool isTimepointRef(const CExpr* expr, EvalContext& context) {
+  const CExprValue* value = dynamic_cast<const CExprValue*>(expr);
+  return value != NULL && dynamic_cast<const ExprVarRef*>(value->getValue()) != NULL &&
+      isTimepoint(value->eval(context));
+}
+
+/**
+ * Adds the node for expr to an arithmetic expression, evaluating the operands that aren't
+ * themselves arithmetic to the variables at its leaves.  A variable that occurs more than once,
+ * including the result in scope[0], is one leaf.
+ */
+unsigned int compileArithmetic(const CExpr* expr,
+                               EvalContext& context,
+                               ArithmeticExpression& expression,
+                               std::vector<ConstrainedVariableId>& scope,
+                               DataTypeId& dataType)
+{
+  if (isArithmeticBinary(expr)) {
+    const CExprBinary* binary = static_cast<const CExprBinary*>(expr);
+    unsigned int lhs = compileArithmetic(binary->getLhs(), context, expression, scope, dataType);
+    unsigned int rhs = compileArithmetic(binary->getRhs(), context, expression, scope, dataType);
+    const std::string& op = binary->getOperator();
+    return expression.apply(op == "+" ? ArithmeticExpression::ADD :
+                            (op == "-" ? ArithmeticExpression::SUBTRACT : ArithmeticExpression::MULTIPLY),
+                            lhs, rhs);
+  }
+
+  ConstrainedVariableId var = expr->eval(context).getValue()->getId();
+  if (dataType.isNoId())
+    dataType = var->getDataType();
+  check_runtime_error(dataType->getName() == var->getDataType()->getName(), "We don't support expressions with different types going in to one var (e.g. float + int)");
+
+  std::vector<ConstrainedVariableId>::iterator it = std::find(scope.begin(), scope.end(), var);
+  if (it == scope.end())
+    it = scope.insert(scope.end(), var);
+  return expression.variable(static_cast<unsigned int>(it - scope.begin()));
+}
 }
 
   bool CExprBinary::isSingleton() {
@@ -495,10 +541,51 @@ bool isTimepoint(DataRef var) {
   }
 
   bool CExprBinary::isSingletonOptimizable() {
+    return isArithmetic();
+  }
+
+  bool CExprBinary::isArithmetic() const {
     return (m_operator == "+" || m_operator == "-" || m_operator == "*");
   }
 
+  DataRef CExprBinary::evalCompiled(EvalContext& context) const {
+      ArithmeticExpression expression;
+      std::vector<ConstrainedVariableId> scope(1);
+      DataRef output;
+      if (m_returnArgument) {
+          output = m_returnArgument->eval(context);
+          scope[0] = output.getValue()->getId();
+      }
+
+      DataTypeId data;
+      compileArithmetic(this, context, expression, scope, data);
+
+      if (!m_returnArgument) {
+          ExprVarDeclaration* var = new ExprVarDeclaration(this->createVariableName(), data, NULL, false);
+          output = var->eval(context);
+          scope[0] = output.getValue()->getId();
+          delete var;
+      }
+
+      // Each distinct expression gets its own constraint type
+      CESchemaId ceSchema = getSchema(context)->getCESchema();
+      std::string constraint = ArithmeticConstraintType::nameOf(expression);
+      if (!ceSchema->isConstraintType(constraint))
+          ceSchema->registerConstraintType((new ArithmeticConstraintType("Default", expression))->getId());
+
+      makeConstraint(context, constraint, scope, m_violationMsg.c_str());
+
+      return output;
+  }
+
   DataRef CExprBinary::eval(EvalContext& context) const {
+      // A sum that is a temporal distance is left to the temporal network
+      if (m_compileArithmetic && isArithmetic() &&
+          (isArithmeticBinary(m_lhs) || isArithmeticBinary(m_rhs)) &&
+          (m_returnArgument == NULL || m_operator == "*" ||
+           !(isTimepointRef(m_returnArgument, context) || isTimepointRef(m_lhs, context) || isTimepointRef(m_rhs, context))))
+          return evalCompiled(context);
+
       //Figure out constraint type.
       std::string constraint = "", returnType = "";
       bool flipArguments = false;
@@ -922,7 +1009,7 @@ TokenId PredicateInstanceRef::createSubgoal(EvalContext& context,
     return m_attributes;
   }
 
-  const TokenTypeId PredicateInstanceRef::getTokenType()
+  const TokenTypeId PredicateInstanceRef::getTokenType() const
   {
     return m_tokenType;
   }
@@ -958,110 +1045,107 @@ TokenId PredicateInstanceRef::createSubgoal(EvalContext& context,
 
   }
 
-#define makeRelation(relationname, origin, originvar, target, targetvar) {  \
-    std::vector<ConstrainedVariableId> vars;\
-    vars.push_back(origin->originvar());    \
-    vars.push_back(target->targetvar());    \
-    makeConstraint(context,#relationname, vars, ""); \
-  }
+namespace {
+const char* const STRICT_PRECEDENCE = "strict precedence";
+
+/**
+ * One of the constraints that relate an origin and a target token. It relates the first variable of the
+ * origin to the second of the target, or the first of the target to the second of the origin.
+ */
+struct RelationConstraint {
+  const char* relation;
+  const char* constraint; // Or STRICT_PRECEDENCE, a temporalDistance of at least 1
+  bool originFirst;
+  const char* firstVar;
+  const char* secondVar;
+};
+
+// Allen Relations according to EUROPA
+// See ConstraintLibraryReference on the wiki
+const RelationConstraint RELATION_CONSTRAINTS[] = {
+  {"meets", "concurrent", true, "end", "start"},
+  {"met_by", "concurrent", false, "end", "start"},
+  {"contains", "precedes", true, "start", "start"},
+  {"contains", "precedes", false, "end", "end"},
+  {"contains", "leq", false, "duration", "duration"},
+  {"contained_by", "precedes", false, "start", "start"},
+  {"contained_by", "precedes", true, "end", "end"},
+  {"contained_by", "leq", true, "duration", "duration"},
+  {"before", "precedes", true, "end", "start"},
+  {"after", "precedes", false, "end", "start"},
+  {"starts", "concurrent", true, "start", "start"},
+  {"ends", "concurrent", false, "end", "end"},
+  {"parallels", "precedes", true, "start", "start"},
+  {"parallels", "precedes", true, "end", "end"},
+  {"paralleled_by", "precedes", false, "start", "start"},
+  {"paralleled_by", "precedes", false, "end", "end"},
+  {"ends_after", STRICT_PRECEDENCE, false, "end", "end"},
+  {"ends_before", STRICT_PRECEDENCE, true, "end", "end"},
+  {"ends_after_start", STRICT_PRECEDENCE, false, "start", "end"},
+  {"starts_before_end", STRICT_PRECEDENCE, true, "start", "end"},
+  {"starts_during", "precedes", false, "start", "start"},
+  {"starts_during", STRICT_PRECEDENCE, true, "start", "end"},
+  {"ends_during", STRICT_PRECEDENCE, false, "start", "end"},
+  {"ends_during", "precedes", true, "end", "end"},
+  {"contains_start", "precedes", true, "start", "start"},
+  {"contains_start", STRICT_PRECEDENCE, false, "start", "end"},
+  {"contains_end", STRICT_PRECEDENCE, true, "start", "end"},
+  {"contains_end", "precedes", true, "end", "end"},
+  {"starts_after", STRICT_PRECEDENCE, false, "start", "start"},
+  {"starts_before", STRICT_PRECEDENCE, true, "start", "start"},
+  {"equals", "concurrent", true, "start", "start"},
+  {"equals", "concurrent", false, "end", "end"},
+  {"equals", "eq", true, "duration", "duration"}
+};
+
+const unsigned int RELATION_CONSTRAINT_COUNT = sizeof(RELATION_CONSTRAINTS) / sizeof(RELATION_CONSTRAINTS[0]);
 
+/**
+ * The constraints of a relation, which are next to each other in RELATION_CONSTRAINTS.
+ */
+std::pair<const RelationConstraint*, const RelationConstraint*> getRelationConstraints(const std::string& relationName) {
+  const RelationConstraint* begin = RELATION_CONSTRAINTS;
+  const RelationConstraint* end = RELATION_CONSTRAINTS + RELATION_CONSTRAINT_COUNT;
+  while (begin != end && relationName != begin->relation)
+    ++begin;
+  const RelationConstraint* last = begin;
+  while (last != end && relationName == last->relation)
+    ++last;
+  check_runtime_error(begin != end || relationName == "any",std::string("Unrecognized relation:")+relationName);
+  return std::make_pair(begin, last);
+}
 
-#define makeStrictPrecedenceRelation(origin, originvar, target, targetvar) { \
-    PlanDatabase* db = reinterpret_cast<PlanDatabase*>(context.getElement("PlanDatabase"));\
-    std::vector<ConstrainedVariableId> vars;				\
-    ConstrainedVariableId var = (new Variable<IntervalIntDomain>(db->getConstraintEngine(), IntervalIntDomain(1, PLUS_INFINITY)))->getId(); \
-    vars.push_back(origin->originvar());				\
-    vars.push_back(var);						\
-    vars.push_back(target->targetvar());				\
-    makeConstraint(context, "temporalDistance", vars, "");			\
-  }
+ConstrainedVariableId getTimeVar(const TokenId token, const char* name) {
+  if (strcmp(name, "start") == 0)
+    return token->start();
+  if (strcmp(name, "end") == 0)
+    return token->end();
+  return token->duration();
+}
 
-namespace {
 void createRelation(EvalContext& context,
                     const std::string& relationName,
                     TokenId origin,
                     TokenId target) {
-  // Allen Relations according to EUROPA
-  // See ConstraintLibraryReference on the wiki
-  if (relationName == "meets") {
-    makeRelation(concurrent, origin, end, target, start);
-  }
-  else if (relationName == "met_by") {
-    makeRelation(concurrent, target, end, origin, start);
-  }
-  else if (relationName == "contains") {
-    makeRelation(precedes, origin, start, target, start);
-    makeRelation(precedes, target, end, origin, end);
-    makeRelation(leq, target, duration, origin, duration);
-  }
-  else if (relationName == "contained_by") {
-    makeRelation(precedes, target, start, origin, start);
-    makeRelation(precedes, origin, end, target, end);
-    makeRelation(leq, origin, duration, target, duration);
-  }
-  else if (relationName == "before") {
-    makeRelation(precedes, origin, end, target, start);
-  }
-  else if (relationName == "after") {
-    makeRelation(precedes, target, end, origin, start);
-  }
-  else if (relationName == "starts") {
-    makeRelation(concurrent, origin, start, target, start);
-  }
-  else if (relationName == "ends") {
-    makeRelation(concurrent, target, end, origin, end);
-  }
-  else if (relationName ==  "parallels") {
-    makeRelation(precedes, origin, start, target, start);
-    makeRelation(precedes, origin, end, target, end);
-  }
-  else if (relationName ==  "paralleled_by") {
-    makeRelation(precedes, target, start, origin, start);
-    makeRelation(precedes, target, end, origin, end);
-  }
-  else if (relationName == "ends_after") {
-    makeStrictPrecedenceRelation(target, end, origin, end);
-  }
-  else if (relationName == "ends_before") {
-    makeStrictPrecedenceRelation(origin, end, target, end);
-  }
-  else if (relationName == "ends_after_start") {
-    makeStrictPrecedenceRelation(target, start, origin, end);
-  }
-  else if (relationName == "starts_before_end") {
-    makeStrictPrecedenceRelation(origin, start, target, end);
-  }
-  else if (relationName == "starts_during") {
-    makeRelation(precedes, target, start, origin, start);
-    makeStrictPrecedenceRelation(origin, start, target, end);
-  }
-  else if (relationName == "ends_during") {
-    makeStrictPrecedenceRelation(target, start, origin, end);
-    makeRelation(precedes, origin, end, target, end);
-  }
-  else if (relationName == "contains_start") {
-    makeRelation(precedes, origin, start, target, start);
-    makeStrictPrecedenceRelation(target, start, origin, end);
-  }
-  else if (relationName == "contains_end") {
-    makeStrictPrecedenceRelation(origin, start, target, end);
-    makeRelation(precedes, origin, end, target, end);
-  }
-  else if (relationName == "starts_after") {
-    makeStrictPrecedenceRelation(target, start, origin, start);
-  }
-  else if (relationName == "starts_before") {
-    makeStrictPrecedenceRelation(origin, start, target, start);
-  }
-  else if (relationName == "equals") {
-    makeRelation(concurrent, origin, start, target, start);
-    makeRelation(concurrent, target, end, origin, end);
-    makeRelation(eq, origin, duration, target, duration);
-  }
-  else {
-    check_runtime_error(relationName == "any",std::string("Unrecognized relation:")+relationName);
+  std::pair<const RelationConstraint*, const RelationConstraint*> constraints = getRelationConstraints(relationName);
+  for (const RelationConstraint* it = constraints.first; it != constraints.second; ++it) {
+    std::vector<ConstrainedVariableId> vars;
+    vars.push_back(getTimeVar(it->originFirst ? origin : target, it->firstVar));
+    if (it->constraint == STRICT_PRECEDENCE) {
+      PlanDatabase* db = reinterpret_cast<PlanDatabase*>(context.getElement("PlanDatabase"));
+      vars.push_back((new Variable<IntervalIntDomain>(db->getConstraintEngine(), IntervalIntDomain(1, PLUS_INFINITY)))->getId());
+    }
+    vars.push_back(getTimeVar(it->originFirst ? target : origin, it->secondVar));
+    makeConstraint(context, (it->constraint == STRICT_PRECEDENCE ? "temporalDistance" : it->constraint), vars, "");
   }
 }
+
+/**
+ * @brief The path to a time variable of a token named in a rule, "this" being the token the rule fires on.
+ */
+std::string getTimeVarPath(const std::string& token, const char* name) {
+  return (token == "this" ? std::string(name) : token + "." + name);
+}
 }
 
   DataRef ExprRelation::eval(EvalContext& context) const
@@ -1078,6 +1162,48 @@ void createRelation(EvalContext& context,
     return DataRef::null;
   }
 
+  void ExprRelation::describe(RuleBody& body) const
+  {
+    // A named instance declares a subgoal, and a bare name refers to a token already in the rule
+    std::vector<std::string> names;
+    std::vector<const PredicateInstanceRef*> refs(1, m_origin);
+    refs.insert(refs.end(), m_targets.begin(), m_targets.end());
+    for (unsigned int i=0;i<refs.size();i++) {
+        names.push_back(refs[i]->getPredicateName());
+        if (refs[i]->getPredicateInstance().empty())
+            continue;
+        if (refs[i]->getTokenType().isNoId()) {
+            body.unchecked.push_back("The " + refs[i]->getPredicateInstance() + " slave of a " + m_relation +
+                                     " relation is not described");
+            return;
+        }
+        RuleBody::Slave slave;
+        slave.name = names.back();
+        slave.predicate = refs[i]->getTokenType()->getSignature();
+        slave.relation = (i == 0 ? "any" : m_relation);
+        body.slaves.push_back(slave);
+    }
+
+    std::pair<const RelationConstraint*, const RelationConstraint*> constraints = getRelationConstraints(m_relation);
+    for (unsigned int i=1;i<names.size();i++) {
+        if (constraints.first == constraints.second)
+            continue;
+        if (names[0].empty() || names[i].empty()) {
+            body.unchecked.push_back("The " + m_relation + " relation of an unnamed slave is not described");
+            continue;
+        }
+        for (const RelationConstraint* it = constraints.first; it != constraints.second; ++it) {
+            RuleBody::ConstraintSpec constraint;
+            constraint.name = (it->constraint == STRICT_PRECEDENCE ? "temporalDistance" : it->constraint);
+            constraint.args.push_back(getTimeVarPath(it->originFirst ? names[0] : names[i], it->firstVar));
+            if (it->constraint == STRICT_PRECEDENCE)
+                constraint.args.push_back(RuleBody::Argument(IntDT::instance(), 1, PLUS_INFINITY));
+            constraint.args.push_back(getTimeVarPath(it->originFirst ? names[i] : names[0], it->secondVar));
+            body.constraints.push_back(constraint);
+        }
+    }
+  }
+
   ExprIfGuard::ExprIfGuard(const std::string& op, Expr* lhs,Expr* rhs)
     : m_op(op)
     , m_lhs(lhs)
@@ -1765,6 +1891,58 @@ InterpretedRuleFactory::InterpretedRuleFactory(const std::string& predicate,
 	  return m_body;
   }
 
+  bool InterpretedRuleFactory::describe(RuleBody& body) const
+  {
+    std::set<std::string> locals; // Rule variables, which only exist in rule instances
+    for (unsigned int i=0;i<m_body.size();i++) {
+        const Expr* expr = m_body[i];
+        const ExprVarDeclaration* declaration = dynamic_cast<const ExprVarDeclaration*>(expr);
+        if (declaration != NULL) {
+            locals.insert(declaration->getName());
+            continue;
+        }
+
+        const ExprRelation* relation = dynamic_cast<const ExprRelation*>(expr);
+        if (relation != NULL) {
+            relation->describe(body);
+            continue;
+        }
+
+        // Whether and how often guarded and looped parts fire depends on the plan, so they are not described
+        const ExprConstraint* constraint = dynamic_cast<const ExprConstraint*>(expr);
+        if (constraint == NULL) {
+            body.unchecked.push_back("The rule part " + expr->toString() + " is not described");
+            continue;
+        }
+
+        RuleBody::ConstraintSpec spec;
+        spec.name = constraint->getName();
+        for (unsigned int j=0;j<constraint->getArgs().size();j++) {
+            const Expr* arg = constraint->getArgs()[j];
+            const ExprConstant* constant = dynamic_cast<const ExprConstant*>(arg);
+            if (dynamic_cast<const ExprVarRef*>(arg) != NULL) {
+                const std::string path = arg->toString();
+                if (locals.find(path.substr(0, path.find('.'))) == locals.end())
+                    spec.args.push_back(RuleBody::Argument(path));
+            }
+            else if (constant != NULL && (constant->getDomain().isNumeric() || constant->getDomain().isSingleton())) {
+                const Domain& domain = constant->getDomain();
+                spec.args.push_back(domain.isSingleton() ?
+                                    RuleBody::Argument(domain.getDataType(), domain.getSingletonValue(),
+                                                       domain.getSingletonValue()) :
+                                    RuleBody::Argument(domain.getDataType(), domain.getLowerBound(),
+                                                       domain.getUpperBound()));
+            }
+        }
+        if (spec.args.size() == constraint->getArgs().size())
+            body.constraints.push_back(spec);
+        else
+            body.unchecked.push_back("The constraint " + constraint->toString() +
+                                     " is on rule variables or expressions, and is not described");
+    }
+    return true;
+  }
+
   ExprTypedef::ExprTypedef(const DataTypeId baseType, const std::string& name, Domain* baseDomain)
       : m_baseType(baseType)
       , m_name(name)
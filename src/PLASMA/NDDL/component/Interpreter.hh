@@ -28,6 +28,7 @@ class ExprConstant : public Expr {
   virtual const DataTypeId getDataType() const;
   virtual std::string toString() const;
   std::string getConstantValue() const;
+  const Domain& getDomain() const { return *m_domain; }
 
  protected:
   std::string m_type;
@@ -91,8 +92,8 @@ class ExprAssignment : public Expr {
   ExprAssignment(Expr* lhs, Expr* rhs);
   virtual ~ExprAssignment();
 
-  Expr* getLhs() { return m_lhs; }
-  Expr* getRhs() { return m_rhs; }
+  Expr* getLhs() const { return m_lhs; }
+  Expr* getRhs() const { return m_rhs; }
 
   virtual DataRef eval(EvalContext& context) const;
   virtual std::string toString() const;
@@ -112,6 +113,7 @@ class ExprAssignment : public Expr {
 
         const std::string getName() const { return m_name; }
         const std::vector<Expr*>& getArgs() const { return m_args; }
+        const std::string& getViolationExpl() const { return m_violationExpl; }
         virtual std::string toString() const;
 
     protected:
@@ -293,7 +295,9 @@ class PredicateInstanceRef {
   TokenId getToken(EvalContext& ctx, const std::string& relationName, bool isFact=false,
                    bool isRejectable=false);
   int     getAttributes() const;
-  const TokenTypeId getTokenType();
+  const TokenTypeId getTokenType() const;
+  const std::string& getPredicateInstance() const { return m_predicateInstance; }
+  const std::string& getPredicateName() const { return m_predicateName; }
 
  protected:
   TokenTypeId m_tokenType;
@@ -336,6 +340,14 @@ private:
 
   void populateCausality( InterpretedTokenType* container );
 
+  /**
+   * @brief Add the slaves this relation declares, and the constraints it makes, to body.
+   */
+  void describe(RuleBody& body) const;
+
+  const PredicateInstanceRef* getOrigin() const { return m_origin; }
+  const std::vector<PredicateInstanceRef*>& getTargets() const { return m_targets; }
+
  protected:
   std::string m_relation;
   PredicateInstanceRef* m_origin;
@@ -422,6 +434,8 @@ private:
 
   virtual void checkType();
 
+  const Expr* getValue() const { return m_value; }
+
  protected:
   Expr* m_value;
 };
@@ -454,10 +468,26 @@ class CExprBinary : public CExpr {
 
   virtual const CExpr* getLhs() const {return m_lhs;}
   virtual const CExpr* getRhs() const {return m_rhs;}
+  const std::string& getOperator() const {return m_operator;}
+
+  /**
+   * @brief True for +, - and *.
+   */
+  bool isArithmetic() const;
+
+  /**
+   * @brief If set, an arithmetic expression with another arithmetic expression as an operand is
+   * evaluated as a single arithmetic constraint over all its operands, rather than as a chain of
+   * addEq and mulEq constraints.
+   */
+  void setCompileArithmetic(bool compile) {m_compileArithmetic = compile;}
 
  protected:
+  DataRef evalCompiled(EvalContext& context) const;
+
   std::string m_operator;
   CExpr *m_lhs, *m_rhs;
+  bool m_compileArithmetic;
 };
 
   // InterpretedToken is the interpreted version of NddlToken
@@ -603,6 +633,12 @@ class TokenEvalContext : public EvalContext {
 
         const std::vector<Expr*>& getBody() const;
 
+        /**
+         * @brief Describe the relations and constraints the rule always makes. Guarded and looped parts, and
+         * constraints on rule variables, are listed as unchecked.
+         */
+        virtual bool describe(RuleBody& body) const;
+
     protected:
         std::vector<Expr*> m_body;
   };
@@ -678,6 +714,12 @@ private:
   virtual DataRef doEval(RuleInstanceEvalContext& context) const;
   virtual std::string toString() const;
 
+  const ExprIfGuard* getGuard() const { return m_guard; }
+  const std::vector<Expr*>& getIfBody() const { return m_ifBody; }
+  const std::vector<Expr*>& getElseBody() const { return m_elseBody; }
+  std::vector<Expr*>& getIfBody() { return m_ifBody; }
+  std::vector<Expr*>& getElseBody() { return m_elseBody; }
+
  protected:
   ExprIfGuard* m_guard;
   std::vector<Expr*> m_ifBody;
@@ -692,6 +734,11 @@ private:
 
   	    virtual DataRef doEval(RuleInstanceEvalContext& context) const;
 
+        const std::string& getVarName() const { return m_varName; }
+        const std::string& getVarValue() const { return m_varValue; }
+        const std::vector<Expr*>& getLoopBody() const { return m_loopBody; }
+        std::vector<Expr*>& getLoopBody() { return m_loopBody; }
+
     protected:
         std::string m_varName;
     std::string m_varValue;
@@ -0,0 +1,243 @@
+#include "ModelSimplifier.hh"
+#include "Debug.hh"
+#include "Domain.hh"
+
+#include <algorithm>
+
+namespace EUROPA {
+
+namespace {
+
+std::string rootName(const std::string& name) {
+  return name.substr(0, name.find('.'));
+}
+
+/**
+ * Adds the names of all the variables \a expr refers to.  Returns false if \a expr contains an
+ * expression the pass doesn't understand, in which case the set is incomplete.
+ */
+bool collectReferences(const Expr* expr, std::set<std::string>& refs);
+
+bool collectReferences(const std::vector<Expr*>& body, std::set<std::string>& refs) {
+  bool retval = true;
+  for(std::vector<Expr*>::const_iterator it = body.begin(); it != body.end(); ++it)
+    retval = collectReferences(*it, refs) && retval;
+  return retval;
+}
+
+bool collectReferences(const Expr* expr, std::set<std::string>& refs) {
+  if(expr == NULL ||
+     dynamic_cast<const ExprConstant*>(expr) != NULL ||
+     dynamic_cast<const ExprNoop*>(expr) != NULL)
+    return true;
+  if(dynamic_cast<const ExprVarRef*>(expr) != NULL) {
+    refs.insert(rootName(expr->toString()));
+    return true;
+  }
+  if(const ExprList* list = dynamic_cast<const ExprList*>(expr))
+    return collectReferences(list->getChildren(), refs);
+  if(const ExprVarDeclaration* decl = dynamic_cast<const ExprVarDeclaration*>(expr))
+    return collectReferences(decl->getInitValue(), refs);
+  if(const ExprAssignment* assign = dynamic_cast<const ExprAssignment*>(expr))
+    return collectReferences(assign->getLhs(), refs) && collectReferences(assign->getRhs(), refs);
+  if(const ExprConstraint* constr = dynamic_cast<const ExprConstraint*>(expr))
+    return collectReferences(constr->getArgs(), refs);
+  if(const CExprValue* value = dynamic_cast<const CExprValue*>(expr))
+    return collectReferences(value->getValue(), refs);
+  if(const CExprFunction* func = dynamic_cast<const CExprFunction*>(expr)) {
+    bool retval = true;
+    for(std::vector<CExpr*>::const_iterator it = func->getArgs().begin(); it != func->getArgs().end(); ++it)
+      retval = collectReferences(*it, refs) && retval;
+    return retval;
+  }
+  if(const CExprBinary* binary = dynamic_cast<const CExprBinary*>(expr))
+    return collectReferences(binary->getLhs(), refs) && collectReferences(binary->getRhs(), refs);
+  if(const ExprIfGuard* guard = dynamic_cast<const ExprIfGuard*>(expr))
+    return collectReferences(guard->getLhs(), refs) && collectReferences(guard->getRhs(), refs);
+  if(const ExprIf* exprIf = dynamic_cast<const ExprIf*>(expr))
+    return collectReferences(exprIf->getGuard(), refs) &&
+        collectReferences(exprIf->getIfBody(), refs) &&
+        collectReferences(exprIf->getElseBody(), refs);
+  if(const ExprLoop* loop = dynamic_cast<const ExprLoop*>(expr)) {
+    refs.insert(rootName(loop->getVarValue()));
+    return collectReferences(loop->getLoopBody(), refs);
+  }
+  // A slave may be placed on an object held by a rule variable
+  if(const ExprRelation* relation = dynamic_cast<const ExprRelation*>(expr)) {
+    refs.insert(rootName(relation->getOrigin()->getPredicateInstance()));
+    for(std::vector<PredicateInstanceRef*>::const_iterator it = relation->getTargets().begin();
+        it != relation->getTargets().end(); ++it)
+      refs.insert(rootName((*it)->getPredicateInstance()));
+    return true;
+  }
+  debugMsg("NddlInterpreter:simplify", "Can't analyze " << expr->toString());
+  return false;
+}
+
+/**
+ * True if \a constr relates two constants and is satisfied by them, so that posting it could
+ * neither prune nor fail.
+ */
+bool holdsForConstants(const ExprConstraint* constr) {
+  const std::vector<Expr*>& args = constr->getArgs();
+  if(args.size() != 2)
+    return false;
+  const ExprConstant* lhsExpr = dynamic_cast<const ExprConstant*>(args[0]);
+  const ExprConstant* rhsExpr = dynamic_cast<const ExprConstant*>(args[1]);
+  if(lhsExpr == NULL || rhsExpr == NULL)
+    return false;
+
+  const Domain& lhs = lhsExpr->getDomain();
+  const Domain& rhs = rhsExpr->getDomain();
+  const std::string& name = constr->getName();
+  if(name == "eq" || name == "neq") {
+    if(!lhs.isSingleton() || !rhs.isSingleton() ||
+       !(lhs.getDataType() == rhs.getDataType() || (lhs.isNumeric() && rhs.isNumeric())))
+      return false;
+    return (lhs.getSingletonValue() == rhs.getSingletonValue()) == (name == "eq");
+  }
+  if(name == "leq" || name == "lt") {
+    if(!lhs.isNumeric() || !rhs.isNumeric() || lhs.isEmpty() || rhs.isEmpty())
+      return false;
+    return (name == "leq" ?
+            lhs.getUpperBound() <= rhs.getLowerBound() :
+            lhs.getUpperBound() < rhs.getLowerBound());
+  }
+  return false;
+}
+
+/**
+ * True if \a decl is an object variable with no initial value.  Its domain is every instance of the
+ * type, which may be empty, and then the rule fails whether or not the variable is used.
+ */
+bool isObjectWithoutValue(const ExprVarDeclaration* decl) {
+  return decl->getInitValue() == NULL && decl->getDataType().isId() && decl->getDataType()->isEntity();
+}
+
+bool argumentKey(const Expr* arg, std::string& key) {
+  if(dynamic_cast<const ExprVarRef*>(arg) != NULL)
+    key = "v:" + arg->toString();
+  else if(dynamic_cast<const ExprConstant*>(arg) != NULL)
+    key = "c:" + arg->toString();
+  else
+    return false;
+  return true;
+}
+
+/**
+ * Builds a key that is the same for two constraints iff they are certain to propagate
+ * identically.  Only constraints that are known to be idempotent are keyed.
+ */
+bool constraintKey(const ExprConstraint* constr, std::string& key) {
+  static const char* idempotent[] = {"eq", "neq", "leq", "lt", "precedes", "concurrent"};
+  static const std::set<std::string> keyed(idempotent, idempotent + sizeof(idempotent) / sizeof(idempotent[0]));
+  const std::string& name = constr->getName();
+  if(keyed.find(name) == keyed.end())
+    return false;
+
+  std::vector<std::string> args;
+  for(std::vector<Expr*>::const_iterator it = constr->getArgs().begin(); it != constr->getArgs().end(); ++it) {
+    std::string arg;
+    if(!argumentKey(*it, arg))
+      return false;
+    args.push_back(arg);
+  }
+  if(name == "eq" || name == "neq" || name == "concurrent")
+    std::sort(args.begin(), args.end());
+
+  key = name + "(";
+  for(std::vector<std::string>::const_iterator it = args.begin(); it != args.end(); ++it)
+    key += *it + ",";
+  key += ")" + constr->getViolationExpl();
+  return true;
+}
+
+}
+
+ModelSimplifier::ModelSimplifier()
+    : m_removedVariables(0), m_removedConstantConstraints(0), m_removedDuplicateConstraints(0),
+      m_report() {}
+
+void ModelSimplifier::simplify(const std::string& owner, std::vector<Expr*>& body, bool isRule) {
+  removeConstraints(owner, body);
+  if(!isRule)
+    return;
+
+  std::set<std::string> referenced;
+  if(collectReferences(body, referenced))
+    removeVariables(owner, body, referenced);
+  else
+    debugMsg("NddlInterpreter:simplify", "Keeping all variables in the rule for " << owner);
+}
+
+// Duplicates are only looked for within a block, since a nested block may be guarded
+void ModelSimplifier::removeConstraints(const std::string& owner, std::vector<Expr*>& body) {
+  std::set<std::string> seen;
+  std::vector<Expr*>::iterator it = body.begin();
+  while(it != body.end()) {
+    if(ExprConstraint* constr = dynamic_cast<ExprConstraint*>(*it)) {
+      std::string key;
+      if(holdsForConstants(constr)) {
+        report(owner, "constant constraint", constr);
+        m_removedConstantConstraints++;
+      }
+      else if(constraintKey(constr, key) && !seen.insert(key).second) {
+        report(owner, "duplicate constraint", constr);
+        m_removedDuplicateConstraints++;
+      }
+      else {
+        ++it;
+        continue;
+      }
+      delete constr;
+      it = body.erase(it);
+      continue;
+    }
+    if(ExprIf* exprIf = dynamic_cast<ExprIf*>(*it)) {
+      removeConstraints(owner, exprIf->getIfBody());
+      removeConstraints(owner, exprIf->getElseBody());
+    }
+    else if(ExprLoop* loop = dynamic_cast<ExprLoop*>(*it))
+      removeConstraints(owner, loop->getLoopBody());
+    ++it;
+  }
+}
+
+void ModelSimplifier::removeVariables(const std::string& owner, std::vector<Expr*>& body,
+                                      const std::set<std::string>& referenced) {
+  std::vector<Expr*>::iterator it = body.begin();
+  while(it != body.end()) {
+    if(ExprList* list = dynamic_cast<ExprList*>(*it)) {
+      std::vector<Expr*> children(list->getChildren());
+      for(std::vector<Expr*>::const_iterator child = children.begin(); child != children.end(); ++child) {
+        const ExprVarDeclaration* decl = dynamic_cast<const ExprVarDeclaration*>(*child);
+        if(decl == NULL || referenced.find(decl->getName()) != referenced.end() ||
+           (decl->getInitValue() != NULL && dynamic_cast<const ExprConstant*>(decl->getInitValue()) == NULL) ||
+           isObjectWithoutValue(decl))
+          continue;
+        report(owner, "unused variable", decl);
+        m_removedVariables++;
+        list->removeChild(*child);
+      }
+      if(list->getChildren().empty()) {
+        delete list;
+        it = body.erase(it);
+        continue;
+      }
+    }
+    else if(ExprIf* exprIf = dynamic_cast<ExprIf*>(*it)) {
+      removeVariables(owner, exprIf->getIfBody(), referenced);
+      removeVariables(owner, exprIf->getElseBody(), referenced);
+    }
+    else if(ExprLoop* loop = dynamic_cast<ExprLoop*>(*it))
+      removeVariables(owner, loop->getLoopBody(), referenced);
+    ++it;
+  }
+}
+
+void ModelSimplifier::report(const std::string& owner, const std::string& what, const Expr* expr) {
+  m_report.push_back(owner + ": removed " + what + " " + expr->toString());
+  debugMsg("NddlInterpreter:simplify", m_report.back());
+}
+
+}
@@ -0,0 +1,54 @@
+#ifndef _H_ModelSimplifier
+#define _H_ModelSimplifier
+
+#include "Interpreter.hh"
+
+#include <set>
+#include <string>
+#include <vector>
+
+namespace EUROPA {
+
+/**
+ * @brief A static pass over interpreted predicate and rule bodies that drops statements which can
+ * never propagate anything, before any token or rule instance is created from them:
+ * constraints whose scope is all constants and which hold for those constants, constraints that
+ * repeat an earlier one in the same block, and rule variables that are declared but never used.
+ * Anything that can't be shown to be inert is left alone, including unused object variables with no
+ * initial value, since they fail the rule if there is no instance of their type.
+ */
+class ModelSimplifier {
+ public:
+  ModelSimplifier();
+
+  /**
+   * @brief Simplify \a body in place, deleting the expressions that are removed.
+   * @param owner The predicate the body belongs to, for reporting.
+   * @param isRule True if \a body is a rule body, whose local variables may be removed.
+   * Predicate parameters are always kept.
+   */
+  void simplify(const std::string& owner, std::vector<Expr*>& body, bool isRule);
+
+  unsigned int getRemovedVariableCount() const {return m_removedVariables;}
+  unsigned int getRemovedConstantConstraintCount() const {return m_removedConstantConstraints;}
+  unsigned int getRemovedDuplicateConstraintCount() const {return m_removedDuplicateConstraints;}
+  /**
+   * @brief One line for each removal, in the order they were made.
+   */
+  const std::vector<std::string>& getReport() const {return m_report;}
+
+ private:
+  void removeConstraints(const std::string& owner, std::vector<Expr*>& body);
+  void removeVariables(const std::string& owner, std::vector<Expr*>& body,
+                       const std::set<std::string>& referenced);
+  void report(const std::string& owner, const std::string& what, const Expr* expr);
+
+  unsigned int m_removedVariables;
+  unsigned int m_removedConstantConstraints;
+  unsigned int m_removedDuplicateConstraints;
+  std::vector<std::string> m_report;
+};
+
+}
+
+#endif
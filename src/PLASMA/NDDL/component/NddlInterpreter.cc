@@ -27,7 +27,7 @@
 namespace EUROPA {
 
 NddlInterpreter::NddlInterpreter(EngineId engine) 
-    : m_engine(engine), m_filesread(), m_inputstreams() {}
+    : m_engine(engine), m_filesread(), m_inputstreams(), m_simplifier() {}
 
 NddlInterpreter::~NddlInterpreter()
 {
@@ -194,6 +194,8 @@ std::string NddlInterpreter::interpret(std::istream& ins, const std::string& sou
 
     NddlSymbolTable symbolTable(m_engine);
     treeParser->SymbolTable = &symbolTable;
+    if (getEngine()->getConfig()->getProperty("nddl.simplifyModel") == "true")
+      symbolTable.setSimplifier(&m_simplifier);
 
     try {
         treeParser->nddl(treeParser);
@@ -235,6 +237,7 @@ NddlSymbolTable::NddlSymbolTable(NddlSymbolTable* parent)
     , m_errors()
     , m_localVars()
     , m_localTokens()
+    , m_simplifier(NULL)
 {
 }
 
@@ -245,6 +248,7 @@ NddlSymbolTable::NddlSymbolTable(const EngineId _engine)
     , m_errors()
     , m_localVars()
     , m_localTokens()
+    , m_simplifier(NULL)
 {
 }
 
@@ -257,6 +261,24 @@ NddlSymbolTable* NddlSymbolTable::getParentST() { return m_parentST; }
 const EngineId NddlSymbolTable::engine() const { return (m_parentST==NULL ? m_engine : m_parentST->engine()); }
 std::vector<std::string>& NddlSymbolTable::errors() { return (m_parentST==NULL ? m_errors : m_parentST->errors()); }
 const std::vector<std::string>& NddlSymbolTable::errors() const { return (m_parentST==NULL ? m_errors : m_parentST->errors()); }
+ModelSimplifier* NddlSymbolTable::simplifier() const { return (m_parentST==NULL ? m_simplifier : m_parentST->simplifier()); }
+
+void NddlSymbolTable::setSimplifier(ModelSimplifier* s)
+{
+    checkError(m_parentST==NULL, "The simplifier can only be set on the root symbol table");
+    m_simplifier = s;
+}
+
+void NddlSymbolTable::simplify(const std::string& owner, std::vector<Expr*>& body, bool isRule)
+{
+    if (simplifier() != NULL)
+        simplifier()->simplify(owner,body,isRule);
+}
+
+bool NddlSymbolTable::compileArithmetic() const
+{
+    return engine()->getConfig()->getProperty("nddl.compileArithmetic") == "true";
+}
 
 void NddlSymbolTable::addError(const std::string& msg)
 {
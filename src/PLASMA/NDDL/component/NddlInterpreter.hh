@@ -11,6 +11,8 @@
 #include <antlr3.h>
 #include <antlr3interfaces.h>
 #include "Interpreter.hh"
+#include "ModelSimplifier.hh"
+#include "PSLanguageException.hh"
 
 namespace EUROPA {
 
@@ -64,6 +66,13 @@ private:
   const std::string& getEnumForValue(const std::string& value) const;
   Expr* makeEnumRef(const std::string& value) const;
 
+  // Model simplification, done only if a simplifier has been set on the root table
+  void setSimplifier(ModelSimplifier* simplifier);
+  void simplify(const std::string& owner, std::vector<Expr*>& body, bool isRule);
+
+  // True if compound arithmetic is to be compiled into single constraints, set by nddl.compileArithmetic
+  bool compileArithmetic() const;
+
  protected:
   NddlSymbolTable* m_parentST;
 
@@ -71,10 +80,12 @@ private:
   std::vector<std::string> m_errors;
   std::map<std::string,DataTypeId> m_localVars;
   std::map<std::string,TokenTypeId> m_localTokens;
+  ModelSimplifier* m_simplifier;
 
   const EngineId engine() const;
   std::vector<std::string>& errors();
   const std::vector<std::string>& errors() const;
+  ModelSimplifier* simplifier() const;
 };
 
 class NddlClassSymbolTable : public NddlSymbolTable {
@@ -124,10 +135,14 @@ public:
     std::vector<std::string> getIncludePath();
     void addInputStream(pANTLR3_INPUT_STREAM in);
 
+    // What has been removed from the model so far, if nddl.simplifyModel is set
+    const ModelSimplifier& getSimplifier() const { return m_simplifier; }
+
 protected:
     EngineId m_engine;
     std::vector<std::string> m_filesread;
     std::vector<pANTLR3_INPUT_STREAM> m_inputstreams;
+    ModelSimplifier m_simplifier;
 };
 
 // An Interpreter that just returns the AST
@@ -139,40 +154,6 @@ public:
     virtual std::string interpret(std::istream& input, const std::string& source);
 };
 
-class PSLanguageException {
- public:
-  PSLanguageException(const char *fileName, unsigned int line, int offset,
-                      unsigned int length, const char *message);
-  friend ostream &operator<<(ostream &, const PSLanguageException &);
-  /** Prepare this exception for shipping with AST */
-  std::string asString() const;
-
-  const std::string& getFileName() const { return m_fileName; }
-  unsigned int getLine() const { return m_line; }
-  int getOffset() const { return m_offset; }
-  unsigned int getLength() const { return m_length; }
-  const std::string& getMessage() const { return m_message; }
- protected:
-  std::string m_fileName;
-  unsigned int m_line;
-  int m_offset;
-  unsigned int m_length;
-  std::string m_message;
-};
-
-class PSLanguageExceptionList
-{
-public:
-  PSLanguageExceptionList(const std::vector<PSLanguageException>& exceptions);
-  friend std::ostream &operator<<(std::ostream &, const PSLanguageExceptionList &);
-  long getExceptionCount() const { return static_cast<long>(m_exceptions.size()); }
-  const PSLanguageException& getException(int index) const {
-    return m_exceptions[static_cast<unsigned>(index)];
-  }
-protected:
-	std::vector<PSLanguageException> m_exceptions;
-};
-
 void reportParserError(pANTLR3_BASE_RECOGNIZER recognizer, pANTLR3_UINT8 *tokenNames);
 void reportLexerError(pANTLR3_BASE_RECOGNIZER recognizer, pANTLR3_UINT8 * tokenNames);
 
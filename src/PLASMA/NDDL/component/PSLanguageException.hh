@@ -0,0 +1,50 @@
+#ifndef PSLANGUAGEEXCEPTION_H_
+#define PSLANGUAGEEXCEPTION_H_
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace EUROPA {
+
+/**
+ * Errors reported by a language interpreter, kept apart from the interpreter itself so that
+ * callers can catch them without depending on the parser.
+ */
+class PSLanguageException {
+ public:
+  PSLanguageException(const char *fileName, unsigned int line, int offset,
+                      unsigned int length, const char *message);
+  friend std::ostream &operator<<(std::ostream &, const PSLanguageException &);
+  /** Prepare this exception for shipping with AST */
+  std::string asString() const;
+
+  const std::string& getFileName() const { return m_fileName; }
+  unsigned int getLine() const { return m_line; }
+  int getOffset() const { return m_offset; }
+  unsigned int getLength() const { return m_length; }
+  const std::string& getMessage() const { return m_message; }
+ protected:
+  std::string m_fileName;
+  unsigned int m_line;
+  int m_offset;
+  unsigned int m_length;
+  std::string m_message;
+};
+
+class PSLanguageExceptionList
+{
+public:
+  PSLanguageExceptionList(const std::vector<PSLanguageException>& exceptions);
+  friend std::ostream &operator<<(std::ostream &, const PSLanguageExceptionList &);
+  long getExceptionCount() const { return static_cast<long>(m_exceptions.size()); }
+  const PSLanguageException& getException(int index) const {
+    return m_exceptions[static_cast<unsigned>(index)];
+  }
+protected:
+	std::vector<PSLanguageException> m_exceptions;
+};
+
+}
+
+#endif /* PSLANGUAGEEXCEPTION_H_ */
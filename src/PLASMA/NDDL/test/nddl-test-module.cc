@@ -1,6 +1,10 @@
 
 #include "nddl-test-module.hh"
 #include <fstream>
+#include "NddlInterpreter.hh"
+#include "ConstraintEngine.hh"
+#include "PlanDatabase.hh"
+#include "Token.hh"
 #include "NddlUtils.hh"
 #include "NddlTestEngine.hh"
 #include "Utils.hh"
@@ -22,7 +26,156 @@ void NDDLModuleTests::syntaxTests()
     CPPUNIT_ASSERT_MESSAGE("Nddl3 parser reported problems :\n" + result,result.size() == 0);
 }
 
+namespace {
+const char* simplifierModel =
+    "class Foo extends Timeline {\n"
+    "  predicate bar {\n"
+    "    int x;\n"
+    "    int y;\n"
+    "    leq(x, y);\n"
+    "    leq(x, y);\n"
+    "    leq(3, 5);\n"
+    "    eq(y, 7);\n"
+    "  }\n"
+    "}\n"
+    "Foo::bar {\n"
+    "  int unused;\n"
+    "  int c = 4;\n"
+    "  int z;\n"
+    "  Foo spare;\n"
+    "  eq(x, z);\n"
+    "  eq(z, x);\n"
+    "  eq(1, 1);\n"
+    "}\n"
+    "Foo foo = new Foo();\n"
+    "close();\n"
+    "goal(Foo.bar t);\n"
+    "t.activate();\n";
+
+struct SimplifierRun {
+  unsigned long variables;
+  unsigned long constraints;
+  std::string x, y;
+};
+
+SimplifierRun runSimplifierModel(NddlTestEngine& engine, bool simplify) {
+  engine.getConfig()->setProperty("nddl.simplifyModel", (simplify ? "true" : "false"));
+  std::string result = engine.executeScript("nddl",simplifierModel,false /*isFile*/);
+  CPPUNIT_ASSERT_MESSAGE("Nddl3 parser reported problems :\n" + result,result.size() == 0);
+
+  ConstraintEngine* ce = boost::polymorphic_cast<ConstraintEngine*>(engine.getComponent("ConstraintEngine"));
+  PlanDatabase* pdb = boost::polymorphic_cast<PlanDatabase*>(engine.getComponent("PlanDatabase"));
+  CPPUNIT_ASSERT(ce->propagate());
+  CPPUNIT_ASSERT(pdb->getTokens().size() == 1);
+  TokenId t = *(pdb->getTokens().begin());
+  CPPUNIT_ASSERT(t->isActive());
+
+  SimplifierRun run;
+  run.variables = ce->getVariables().size();
+  run.constraints = ce->getConstraints().size();
+  run.x = t->getVariable("x")->lastDomain().toString();
+  run.y = t->getVariable("y")->lastDomain().toString();
+  return run;
+}
+}
+
+void NDDLModuleTests::simplifierTests()
+{
+    NddlTestEngine plainEngine;
+    plainEngine.init();
+    SimplifierRun plain = runSimplifierModel(plainEngine,false);
+
+    NddlTestEngine simplifiedEngine;
+    simplifiedEngine.init();
+    SimplifierRun simplified = runSimplifierModel(simplifiedEngine,true);
+
+    // The same domains, from fewer variables and constraints
+    CPPUNIT_ASSERT_MESSAGE(plain.x + " != " + simplified.x,plain.x == simplified.x);
+    CPPUNIT_ASSERT_MESSAGE(plain.y + " != " + simplified.y,plain.y == simplified.y);
+    CPPUNIT_ASSERT(simplified.variables < plain.variables);
+    CPPUNIT_ASSERT(simplified.constraints + 4 == plain.constraints);
+
+    const ModelSimplifier& simplifier =
+        dynamic_cast<NddlInterpreter*>(simplifiedEngine.getLanguageInterpreter("nddl"))->getSimplifier();
+    // spare is unused too, but it is kept since its type could have no instances
+    CPPUNIT_ASSERT(simplifier.getRemovedVariableCount() == 2);
+    CPPUNIT_ASSERT(simplifier.getRemovedConstantConstraintCount() == 2);
+    CPPUNIT_ASSERT(simplifier.getRemovedDuplicateConstraintCount() == 2);
+    CPPUNIT_ASSERT(simplifier.getReport().size() == 6);
+
+    const ModelSimplifier& unused =
+        dynamic_cast<NddlInterpreter*>(plainEngine.getLanguageInterpreter("nddl"))->getSimplifier();
+    CPPUNIT_ASSERT(unused.getReport().empty());
+}
+
 
+namespace {
+const char* arithmeticModel =
+    "int x;\n"
+    "int y;\n"
+    "int w;\n"
+    "int z;\n"
+    "1 <= x;\n"
+    "x <= 10;\n"
+    "0 <= y;\n"
+    "y <= 5;\n"
+    "2 <= w;\n"
+    "w <= 4;\n"
+    "30 <= z;\n"
+    "z <= 40;\n"
+    "z == x * (y + w);\n";
+
+struct ArithmeticRun {
+  unsigned long variables;
+  unsigned long constraints;
+  std::string x, y, w;
+  edouble xMin, xMax;
+  bool compiled;
+};
+
+ArithmeticRun runArithmeticModel(NddlTestEngine& engine, bool compile) {
+  engine.getConfig()->setProperty("nddl.compileArithmetic", (compile ? "true" : "false"));
+  std::string result = engine.executeScript("nddl",arithmeticModel,false /*isFile*/);
+  CPPUNIT_ASSERT_MESSAGE("Nddl3 parser reported problems :\n" + result,result.size() == 0);
+
+  ConstraintEngine* ce = boost::polymorphic_cast<ConstraintEngine*>(engine.getComponent("ConstraintEngine"));
+  PlanDatabase* pdb = boost::polymorphic_cast<PlanDatabase*>(engine.getComponent("PlanDatabase"));
+  CPPUNIT_ASSERT(ce->propagate());
+
+  ArithmeticRun run;
+  run.variables = ce->getVariables().size();
+  run.constraints = ce->getConstraints().size();
+  run.x = pdb->getGlobalVariable("x")->lastDomain().toString();
+  pdb->getGlobalVariable("x")->lastDomain().getBounds(run.xMin, run.xMax);
+  run.y = pdb->getGlobalVariable("y")->lastDomain().toString();
+  run.w = pdb->getGlobalVariable("w")->lastDomain().toString();
+  run.compiled = false;
+  for(ConstraintSet::const_iterator it = ce->getConstraints().begin(); it != ce->getConstraints().end(); ++it)
+    run.compiled = run.compiled || (*it)->getName() == "arithmetic:x0=(x1*(x2+x3))";
+  return run;
+}
+}
+
+void NDDLModuleTests::arithmeticTests()
+{
+    NddlTestEngine plainEngine;
+    plainEngine.init();
+    ArithmeticRun plain = runArithmeticModel(plainEngine,false);
+
+    NddlTestEngine compiledEngine;
+    compiledEngine.init();
+    ArithmeticRun compiled = runArithmeticModel(compiledEngine,true);
+
+    // The same domains, from one constraint in place of mulEq and addEq and without their auxiliary variable
+    CPPUNIT_ASSERT(!plain.compiled);
+    CPPUNIT_ASSERT(compiled.compiled);
+    CPPUNIT_ASSERT_MESSAGE(plain.x + " != " + compiled.x,plain.x == compiled.x);
+    CPPUNIT_ASSERT_MESSAGE(plain.y + " != " + compiled.y,plain.y == compiled.y);
+    CPPUNIT_ASSERT_MESSAGE(plain.w + " != " + compiled.w,plain.w == compiled.w);
+    CPPUNIT_ASSERT(compiled.xMin == 4 && compiled.xMax == 10);
+    CPPUNIT_ASSERT(compiled.variables + 1 == plain.variables);
+    CPPUNIT_ASSERT(compiled.constraints + 1 == plain.constraints);
+}
 
 NddlTest::NddlTest(const std::string& testName,
                    const std::string& nddlFile,
@@ -9,6 +9,8 @@
 class NDDLModuleTests : public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(NDDLModuleTests);
   CPPUNIT_TEST(syntaxTests);
+  CPPUNIT_TEST(simplifierTests);
+  CPPUNIT_TEST(arithmeticTests);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -21,6 +23,8 @@ public:
   }
 
   void syntaxTests();
+  void simplifierTests();
+  void arithmeticTests();
 };
 
 class NddlTest : public CppUnit::TestFixture
@@ -1,6 +1,6 @@
 #include "CommonAncestorConstraint.hh"
 #include "Object.hh"
-#include "CESchema.hh"
+#include "Debug.hh"
 
 namespace EUROPA{
 
@@ -45,57 +45,38 @@ CommonAncestorConstraint::CommonAncestorConstraint(const std::string& name,
   }
 
   /**
-   * Works by first generating the intersection of the restrictions and the ancestors of the singleton
-   * value. Then it iterates over each ancestor of the other objects, and removes any that do not have an
-   * encestor relation to at least one element of setOfAncesotrs.
+   * The ancestors of the singleton value form a chain, and so do those of any candidate, so the two share
+   * a prefix from the root down to their deepest common ancestor. It is enough to find the shallowest
+   * element of the singleton's chain which is in the restrictions, and keep the candidates which have it
+   * as an ancestor, or are it. Each candidate then costs a constant time test.
    */
   void CommonAncestorConstraint::apply(ObjectDomain& singleton, ObjectDomain& other){
-    static int counter(0);
-    counter++;
     check_error(singleton.isSingleton());
     ObjectId singletonObject = singleton.getObject(singleton.getSingletonValue());
-    //std::cout << counter << ":" << std::endl << singleton << ", " << other;
 
-    // Get all singleton ancestors into a set we can use
-    std::list<ObjectId> singletonAncestors;
-    singletonObject->getAncestors(singletonAncestors);
+    unsigned int depth = 0;
+    while(depth <= singletonObject->getDepth() && !m_restrictions.isMember(singletonObject->getAncestor(depth)))
+      depth++;
 
-    singletonAncestors.push_back(singletonObject); // Has at least one, itself
-
-    const DataTypeId dt = m_constraintEngine->getCESchema()->getDataType(singletonObject->getRootType().c_str());
-    ObjectDomain setOfAncestors(dt,singletonAncestors);
-
-    //std::cout << ", " << setOfAncestors ;
-    //std::cout << ", " << m_restrictions << std::endl;
-
-    // Prune this set for those elements in the set of restrictions imposed
-    setOfAncestors.intersect(m_restrictions);
-    //std::cout << "Revised set of ancestors " << setOfAncestors << std::endl;
-    if(setOfAncestors.isEmpty()){
+    if(depth > singletonObject->getDepth()){
       other.empty();
       return;
     }
 
+    const ObjectId ancestor = singletonObject->getAncestor(depth);
+    debugMsg("CommonAncestorConstraint:apply",
+             "Candidates must descend from " << ancestor->getName());
+
     // Iterate over each value in the possible non-singleton domain, and check if it has a common ancestor
     std::list<edouble> candidateValues;
     other.getValues(candidateValues);
     for(std::list<edouble>::const_iterator it = candidateValues.begin(); it != candidateValues.end(); ++it){
-      std::list<ObjectId> candidatesAncestors;
       ObjectId candidate = other.getObject(*it);
       check_error(candidate.isValid());
-      candidate->getAncestors(candidatesAncestors);
-      candidatesAncestors.push_back(candidate);
-      const DataTypeId candidateRootDT = m_constraintEngine->getCESchema()->getDataType(candidate->getRootType().c_str());
-      ObjectDomain od(candidateRootDT,candidatesAncestors);
-      //std::cout << "Candidate " << candidate->getName().toString() << " has ancestors " << od << std::endl;
-      od.intersect(setOfAncestors);
-      if(od.isEmpty()){
+      if(candidate != ancestor && !candidate->hasAncestor(ancestor)){
 	other.remove(candidate);
-	//std::cout << "Removed " << candidate->getName().toString() << ". Result = " << other << std::endl;
-	if(other.isEmpty()){
-	  //std::cout << other << " is empty" << std::endl;
+	if(other.isEmpty())
 	  return;
-	}
       }
     }
   }
@@ -60,6 +60,13 @@ bool DefaultTemporalAdvisor::canBeConcurrent(const TokenId, const TokenId){
   return true;
 }
 
+/**
+ * @brief Contingent constraints are only known to a temporal network
+ */
+bool DefaultTemporalAdvisor::isDynamicallyControllable(){
+  return true;
+}
+
   const TemporalAdvisorId DefaultTemporalAdvisor::getId() const {return m_id;}
 
 /**
@@ -22,6 +22,7 @@ namespace EUROPA{
     virtual bool canFitBetween(const TokenId token, const TokenId predecessor,
 			       const TokenId successor);
     virtual bool canBeConcurrent(const TokenId first, const TokenId second);
+    virtual bool isDynamicallyControllable();
     virtual const IntervalIntDomain getTemporalDistanceDomain(const TimeVarId first, 
 							      const TimeVarId second,
 							      const bool exact);
@@ -1,6 +1,8 @@
 #include "HasAncestorConstraint.hh"
 #include "Object.hh"
-#include "CESchema.hh"
+#include "PlanDatabase.hh"
+
+#include <algorithm>
 
 namespace EUROPA{
 
@@ -41,41 +43,35 @@ bool HasAncestorConstraint::canIgnore(const ConstrainedVariableId,
   return (false);
 }
 
+  /**
+   * Collects the object indices of the restrictions in sorted order, then keeps each candidate with an
+   * ancestor among them. Each test is a binary search per ancestor, so the cost depends on the sizes of the
+   * two domains and not on the number of objects in the database.
+   */
   void HasAncestorConstraint::apply() {
-    
-    std::list<edouble> firstValues;
-    m_first.getValues(firstValues);
-
-    // Get all the ancestors into a set we can use
-    std::list<ObjectId> allAncestors;
-    for(std::list<edouble>::const_iterator it = firstValues.begin(); it != firstValues.end(); ++it){
-      std::list<ObjectId> candidatesAncestors;
-      ObjectId candidate = m_first.getObject(*it);
-      candidate->getAncestors(candidatesAncestors);
-      allAncestors.merge(candidatesAncestors);
-    }
-
-    allAncestors.unique();
-    ObjectId object = allAncestors.front();
-    const DataTypeId dt = m_constraintEngine->getCESchema()->getDataType(object->getRootType().c_str());
-    ObjectDomain setOfAncestors(dt,allAncestors);
-    // Prune this set for those elements in the set of restrictions imposed
-    setOfAncestors.intersect(m_restrictions);
-
-    // Iterate over each value in the possible non-singleton domain, and check if it has a common ancestor
     std::list<edouble> candidateValues;
     m_first.getValues(candidateValues);
+    if(candidateValues.empty())
+      return;
+
+    std::list<edouble> restrictionValues;
+    m_restrictions.getValues(restrictionValues);
+    std::vector<unsigned int> restrictions;
+    restrictions.reserve(restrictionValues.size());
+    for(std::list<edouble>::const_iterator it = restrictionValues.begin(); it != restrictionValues.end(); ++it)
+      restrictions.push_back(m_restrictions.getObject(*it)->getIndex());
+    std::sort(restrictions.begin(), restrictions.end());
+
+    // Iterate over each value in the possible non-singleton domain, and check if it has an ancestor in the restrictions
     for(std::list<edouble>::const_iterator it = candidateValues.begin(); it != candidateValues.end(); ++it){
-      std::list<ObjectId> candidatesAncestors;
       ObjectId candidate = m_first.getObject(*it);
-      candidate->getAncestors(candidatesAncestors);
       bool removeCandidate = true;
-      for(std::list<ObjectId>::const_iterator it1 = candidatesAncestors.begin(); it1 != candidatesAncestors.end(); ++it1){
-	ObjectId ancestor = *it1;
-	if(setOfAncestors.isMember(ancestor)){ // Found common ancestor
-	  removeCandidate = false;
-	  break;
-	}
+      for(unsigned int depth = 0; depth < candidate->getDepth(); depth++){
+        if(std::binary_search(restrictions.begin(), restrictions.end(),
+                              candidate->getAncestor(depth)->getIndex())){
+          removeCandidate = false;
+          break;
+        }
       }
 
       // This could possibly be optimized to batch the removals down the road. For example, intersect operator
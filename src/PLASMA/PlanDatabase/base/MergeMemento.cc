@@ -23,7 +23,7 @@ namespace EUROPA{
     check_error(inactiveVariables.size() == activeVariables.size());
 
     std::map<eint, ConstrainedVariableId> varMap;
-    std::set<ConstraintId> deactivatedConstraints;
+    ConstraintSet deactivatedConstraints;
 
     //Exclude this for the state variable, which will necessarily conflict with the target active token
     for(unsigned long i=1; i<inactiveVariables.size(); i++){
@@ -48,7 +48,7 @@ namespace EUROPA{
     }
 
     // Iterate over all constraints and deactivate them, as well as create and store new ones where necessary
-    for(std::set<ConstraintId>::const_iterator it = deactivatedConstraints.begin(); it != deactivatedConstraints.end(); ++it){
+    for(ConstraintSet::const_iterator it = deactivatedConstraints.begin(); it != deactivatedConstraints.end(); ++it){
       ConstraintId constraint = *it;
       // Standard constraints will not be migrated as they will be built in to the target already
       if(!m_inactiveToken->isStandardConstraint(constraint))
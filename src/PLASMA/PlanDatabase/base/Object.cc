@@ -34,7 +34,9 @@ Object::Object(const PlanDatabaseId planDatabase, const std::string& type, const
       m_keyPairsByConstraintKey(),
       m_thisVar((new Variable< ObjectDomain>(m_planDatabase->getConstraintEngine(),
                                              ObjectDomain(m_planDatabase->getSchema()->getCESchema()->getDataType(type.c_str()),
-                                                          m_id)))->getId()) {
+                                                          m_id)))->getId()),
+      m_ancestry(1, m_id),
+      m_index(0) {
     check_error(m_planDatabase.isValid());
     if (!open)
       close();
@@ -55,8 +57,11 @@ Object::Object(const PlanDatabaseId planDatabase, const std::string& type, const
       m_constraintsByKeyPair(),
       m_keyPairsByConstraintKey(),
       m_thisVar((new Variable< ObjectDomain>(m_planDatabase->getConstraintEngine(),
-              ObjectDomain(m_planDatabase->getSchema()->getCESchema()->getDataType(type.c_str()),m_id)))->getId()) {
+              ObjectDomain(m_planDatabase->getSchema()->getCESchema()->getDataType(type.c_str()),m_id)))->getId()),
+      m_ancestry(parent->m_ancestry),
+      m_index(0) {
     check_error(m_parent.isValid());
+    m_ancestry.push_back(m_id);
     check_error(m_planDatabase->getSchema()->canContain(parent->getType(), type, localName),
 		"Object " + parent->getName() +
 		" cannot contain " + localName + " of type " + type);
@@ -85,6 +90,17 @@ void Object::constructor(const std::vector<const Domain*>&) {}
   {
   	m_parent = parent;
   	m_parent->add(m_id);
+  	updateAncestry();
+  }
+
+  void Object::updateAncestry() {
+    m_ancestry.clear();
+    if (m_parent.isId())
+      m_ancestry = m_parent->m_ancestry;
+    m_ancestry.push_back(m_id);
+
+    for (ObjectSet::const_iterator it = m_components.begin(); it != m_components.end(); ++it)
+      (*it)->updateAncestry();
   }
 
   void Object::handleDiscard(){
@@ -194,8 +210,8 @@ const std::string& Object::getName() const {
 
     m_tokens.erase(token);
 
-    // A set is used to avoid duplicate deletions
-    std::set<ConstraintId> constraints;
+    // A set is used to avoid duplicate deletions, ordered by key so they are deleted in the same order every run
+    ConstraintSet constraints;
 
     // Gather all the constraints and remove various index entries
     std::multimap<eint, ConstraintId>::iterator it = m_constraintsByTokenKey.find(token->getKey());
@@ -541,10 +557,27 @@ void Object::constrain(const TokenId predecessor, const TokenId successor, bool
   }
 
   void Object::getAncestors(std::list<ObjectId>& results) const {
-    if (!m_parent.isNoId()) {
-      results.push_back(m_parent);
-      m_parent->getAncestors(results);
-    }
+    for (std::vector<ObjectId>::const_reverse_iterator it = m_ancestry.rbegin() + 1; it != m_ancestry.rend(); ++it)
+      results.push_back(*it);
+  }
+
+  unsigned int Object::getDepth() const {
+    return m_ancestry.size() - 1;
+  }
+
+  const ObjectId Object::getAncestor(unsigned int depth) const {
+    check_error(depth < m_ancestry.size());
+    return m_ancestry[depth];
+  }
+
+  bool Object::hasAncestor(const ObjectId ancestor) const {
+    const unsigned int depth = ancestor->getDepth();
+    return depth < getDepth() && m_ancestry[depth] == ancestor;
+  }
+
+  unsigned int Object::getIndex() const {
+    check_error(isComplete());
+    return m_index;
   }
 
   void Object::clean(const ConstraintId constraint, eint tokenKey) {
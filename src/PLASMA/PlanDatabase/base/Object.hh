@@ -94,6 +94,27 @@ namespace EUROPA {
      */
     void getAncestors(std::list<ObjectId>& results) const;
 
+    /**
+     * @brief The number of ancestors of this object. Objects without a parent have depth 0.
+     */
+    unsigned int getDepth() const;
+
+    /**
+     * @brief The ancestor of this object at the given depth, or this object if depth == getDepth().
+     */
+    const ObjectId getAncestor(unsigned int depth) const;
+
+    /**
+     * @brief Test if the given object is a proper ancestor of this object. Constant time.
+     */
+    bool hasAncestor(const ObjectId ancestor) const;
+
+    /**
+     * @brief A dense index for this object, assigned by the plan database when the object is closed.
+     * Indices of deleted objects are reused, so all indices are below PlanDatabase::getObjectIndexLimit().
+     */
+    unsigned int getIndex() const;
+
     /**
      * @brief Retrieves all active tokens whose object variable includes this object
      */
@@ -280,6 +301,7 @@ namespace EUROPA {
 
     // Calls for managing object - token connections
     friend class ObjectTokenRelation;
+    friend class PlanDatabase;
     virtual void add(const TokenId token);
     virtual void remove(const TokenId token);
 
@@ -288,6 +310,11 @@ namespace EUROPA {
     virtual void remove(const ObjectId component);
     void cascadeDelete();
 
+    /**
+     * @brief Rebuild the ancestry of this object and its components after its parent is set.
+     */
+    void updateAncestry();
+
     /**
      * @brief Determine if this token participates in any explicit constraints on the timeline
      */
@@ -340,6 +367,8 @@ namespace EUROPA {
     std::multimap<std::pair<eint, eint>, ConstraintId> m_constraintsByKeyPair; /**< Precedence Constraints by  encoded key pair */
     std::map<eint, std::pair<eint, eint> > m_keyPairsByConstraintKey; /**< Reverse lookup to obtain the key pair */
     ConstrainedVariableId m_thisVar; /**< Used to constrain against */
+    std::vector<ObjectId> m_ancestry; /**< Ancestors from the root down, ending with this object */
+    unsigned int m_index; /**< Assigned by the plan database on close */
 
   private:
 
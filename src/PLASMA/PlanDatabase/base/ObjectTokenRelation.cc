@@ -5,6 +5,7 @@
 #include "Domains.hh"
 
 #include "Debug.hh"
+#include <algorithm>
 #include <iostream>
 /**
  * @file ObjectTokenRelation.cc
@@ -102,70 +103,82 @@ namespace EUROPA {
 
   /**
    * All members of the current domain that are not members of the current set of notified objects should
-   * be notifed of addition of a token
+   * be notifed of addition of a token. Both are ordered by key, so a single merge finds the new objects.
    */
   void ObjectTokenRelation::notifyAdditions() {
-    std::list<edouble> values;
-    m_currentDomain.getValues(values);
+    const std::set<edouble>& values = m_currentDomain.getValues();
     check_error(!values.empty());
 
-    for(std::list<edouble>::const_iterator it = values.begin(); it != values.end(); ++it){
+    const std::vector<ObjectId>& priorObjects = m_notifiedObjects;
+    std::vector<ObjectId> notifiedObjects;
+    std::vector<ObjectId> addedObjects;
+    notifiedObjects.reserve(std::max(values.size(), priorObjects.size()));
+
+    std::vector<ObjectId>::const_iterator notified = priorObjects.begin();
+    for(std::set<edouble>::const_iterator it = values.begin(); it != values.end(); ++it){
+      while(notified != priorObjects.end() && (*notified)->getKey() < *it)
+        notifiedObjects.push_back(*notified++);
+
+      if(notified != priorObjects.end() && (*notified)->getKey() == *it){
+        notifiedObjects.push_back(*notified++);
+        continue;
+      }
+
       ObjectId object = Entity::getTypedEntity<Object>(*it);
       check_error(object.isValid());
-      if(m_notifiedObjects.find(object) == m_notifiedObjects.end()){
-	m_notifiedObjects.insert(object);
-        debugMsg("ObjectTokenRelation:notifyAdditions", "Adding " << m_token->toString() << " to " << object->toString());
-	object->add(m_token);
-      }
+      notifiedObjects.push_back(object);
+      addedObjects.push_back(object);
+    }
+    notifiedObjects.insert(notifiedObjects.end(), notified, priorObjects.end());
+
+    // Record the new state before notifying, since objects may call back into this relation
+    m_notifiedObjects.swap(notifiedObjects);
+
+    for(std::vector<ObjectId>::const_iterator it = addedObjects.begin(); it != addedObjects.end(); ++it){
+      debugMsg("ObjectTokenRelation:notifyAdditions", "Adding " << m_token->toString() << " to " << (*it)->toString());
+      (*it)->add(m_token);
     }
   }
 
   /**
    * If it is not active, then notify all objects of removal and clear the set of stored notifications.
-   * Otherwise, process the difference between the current domain, and prior notified objects
+   * Otherwise, process the difference between the current domain, and prior notified objects. Since the domain
+   * can only have been restricted since the last notification, equal sizes mean there is nothing to remove.
    */
   void ObjectTokenRelation::notifyRemovals() {
-    static unsigned int sl_counter(0);
-    sl_counter++;
-
     checkError(getId().isValid(), getId());
 
-    // Remove token from objects where the domain has been restricted, and was previously notifed,
-    // or where the Token is now inactive
-    bool active = m_token->isActive();
-
-    unsigned int startIndex = 0;
-
     debugMsg("ConstraintEngine", "[" << getKey() << "]");
 
-    while (m_notifiedObjects.size() > startIndex) {
-      std::set<ObjectId>::iterator it = m_notifiedObjects.begin();
-      for (unsigned int i = 0; i < startIndex; i++) {
-	it++;
+    // The new state is recorded before notifying, since objects may call back into this relation
+    std::vector<ObjectId> removedObjects;
+    if(!m_token->isActive())
+      removedObjects.swap(m_notifiedObjects);
+    else if(m_currentDomain.getSize() < m_notifiedObjects.size()){
+      // Remove token from objects where the domain has been restricted, and was previously notifed.
+      const std::set<edouble>& values = m_currentDomain.getValues();
+      std::vector<ObjectId> notifiedObjects;
+      notifiedObjects.reserve(values.size());
+
+      std::set<edouble>::const_iterator value = values.begin();
+      for(std::vector<ObjectId>::const_iterator it = m_notifiedObjects.begin(); it != m_notifiedObjects.end(); ++it){
+        const ObjectId object = *it;
+        while(value != values.end() && *value < object->getKey())
+          ++value;
+
+        if(value != values.end() && *value == object->getKey())
+          notifiedObjects.push_back(object);
+        else
+          removedObjects.push_back(object);
       }
 
-      ObjectId object = *it;
-
-      if(!active || !m_currentDomain.isMember(object)){
-        debugMsg("ObjectTokenRelation:notifyRemovals", "Removing " << m_token->toString() << " from " << object->toString());
-	object->remove(m_token);
-	m_notifiedObjects.erase(object);
-      } else {
-	startIndex++;
-      }
-      
+      m_notifiedObjects.swap(notifiedObjects);
     }
-    
 
-    /*while(it!=m_notifiedObjects.end()){
-      ObjectId object = *it;
-      if(!isActive || !m_currentDomain.isMember(object)){
-	object->remove(m_token);
-	m_notifiedObjects.erase(it++);
-      }
-      else
-	++it;
-	}*/
+    for(std::vector<ObjectId>::const_iterator it = removedObjects.begin(); it != removedObjects.end(); ++it){
+      debugMsg("ObjectTokenRelation:notifyRemovals", "Removing " << m_token->toString() << " from " << (*it)->toString());
+      (*it)->remove(m_token);
+    }
   }
 
 const std::vector<ConstrainedVariableId>&
@@ -50,7 +50,8 @@ class ObjectDomain;
     bool isValid() const;
 
     const TokenId m_token;
-    std::set<ObjectId> m_notifiedObjects; /**< Keeps track of notified objects (of additions). Updated on each execution. */
+    std::vector<ObjectId> m_notifiedObjects; /**< Keeps track of notified objects (of additions), ordered by key like the
+                                                values of the object domain. Updated on each execution. */
     const ObjectDomain& m_currentDomain; /**< Holds a direct reference to the propagated domain of the objectVariable */
 
     static const int STATE_VAR = 0;
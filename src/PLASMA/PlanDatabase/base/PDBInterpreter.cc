@@ -13,6 +13,8 @@
 #include "Utils.hh"
 #include "Token.hh"
 
+#include <algorithm>
+
 
 namespace EUROPA {
 
@@ -151,6 +153,14 @@ ExprList::ExprList() : m_children() {}
       m_children.push_back(child);
   }
 
+  void ExprList::removeChild(Expr* child)
+  {
+      std::vector<Expr*>::iterator it = std::find(m_children.begin(), m_children.end(), child);
+      checkError(it != m_children.end(), "Not a child of this list: " << child->toString());
+      m_children.erase(it);
+      delete child;
+  }
+
   std::string ExprList::toString() const
   {
       std::ostringstream os;
@@ -69,6 +69,10 @@ class EvalContext {
 
         virtual DataRef eval(EvalContext& context) const;
         void addChild(Expr* child);
+        /**
+         * @brief Removes \a child from the list and deletes it.
+         */
+        void removeChild(Expr* child);
         const std::vector<Expr*>& getChildren() const;
 
         virtual std::string toString() const;
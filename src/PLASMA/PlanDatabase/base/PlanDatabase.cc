@@ -19,6 +19,7 @@
 #include "CommonAncestorConstraint.hh"
 #include "HasAncestorConstraint.hh"
 #include <iostream>
+#include <algorithm>
 
 
 /**
@@ -82,7 +83,13 @@ namespace EUROPA{
       , m_globalTokensByName()
       , m_tokensToOrder()
       , m_activeTokensByPredicate()
+      , m_freeObjectIndices()
+      , m_objectIndexLimit(0)
+      , m_admittingVariables()
+      , m_admittingVariablesCycle(0)
+      , m_admittingVariablesValid(false)
       , m_objectVariablesByObjectType()
+      , m_objectVariableEntries()
 
   {
       check_error(m_constraintEngine.isValid());
@@ -119,30 +126,8 @@ namespace EUROPA{
 	  check_error(m_state != PURGED);
 	  m_state = PURGED;
 
-    if(!Entity::isPurging()){ // Clean up exploiting relationships
-      // Retrieve only the tokens at the root
-      std::set<TokenId> masterTokens;
-      for(TokenSet::const_iterator it = m_tokens.begin(); it != m_tokens.end(); ++it){
-        TokenId token = *it;
-        check_error(token.isValid());
-        if(token->master().isNoId()) // It is a root object and so can be deleted
-          masterTokens.insert(token);
-      }
-
-      Entity::discardAll(masterTokens);
-
-      // Retrieve only the objects at the root
-      std::set<ObjectId> rootObjects;
-      for(ObjectSet::const_iterator it = m_objects.begin(); it != m_objects.end(); ++it){
-        ObjectId object = *it;
-        check_error(object.isValid());
-        if(object->getParent().isNoId()) // It is a root object and so can be deleted
-          rootObjects.insert(object);
-      }
-
-      // Now clean up root objects - which will cascade delete to the children
-      Entity::discardAll(rootObjects);
-    }
+    if(!Entity::isPurging()) // Clean up exploiting relationships
+      discardRoots();
     else { // Just cleanup by blasting through the tokens and objects
       Entity::discardAll(m_tokens);
       Entity::discardAll(m_objects);
@@ -154,6 +139,52 @@ namespace EUROPA{
     Entity::garbageCollect();
   }
 
+  void PlanDatabase::reset(){
+    check_error(m_state != PURGED, "Cannot reset a purged database.");
+    check_error(!Entity::isPurging(), "Cannot reset while purging.");
+
+    debugMsg("PlanDatabase:reset",
+             "Discarding " << m_tokens.size() << " tokens, " << m_objects.size() << " objects and "
+             << m_globalVariables.size() << " global variables");
+
+    discardRoots();
+    Entity::discardAll(m_globalVariables);
+    m_globalVarsByName.clear();
+    Entity::garbageCollect();
+
+    checkError(m_tokens.empty() && m_objects.empty(),
+               "Expected an empty database after reset, but found " <<
+               m_tokens.size() << " tokens and " << m_objects.size() << " objects");
+
+    m_closedObjectTypes.clear();
+    m_state = OPEN;
+  }
+
+  void PlanDatabase::discardRoots(){
+    // Retrieve only the tokens at the root
+    TokenSet masterTokens;
+    for(TokenSet::const_iterator it = m_tokens.begin(); it != m_tokens.end(); ++it){
+      TokenId token = *it;
+      check_error(token.isValid());
+      if(token->master().isNoId()) // It is a root object and so can be deleted
+        masterTokens.insert(token);
+    }
+
+    Entity::discardAll(masterTokens);
+
+    // Retrieve only the objects at the root
+    ObjectSet rootObjects;
+    for(ObjectSet::const_iterator it = m_objects.begin(); it != m_objects.end(); ++it){
+      ObjectId object = *it;
+      check_error(object.isValid());
+      if(object->getParent().isNoId()) // It is a root object and so can be deleted
+        rootObjects.insert(object);
+    }
+
+    // Now clean up root objects - which will cascade delete to the children
+    Entity::discardAll(rootObjects);
+  }
+
   void PlanDatabase::notifyAdded(const ObjectId object){
     check_error(!Entity::isPurging(), "Should not be in this method if in purgeMode.");
 
@@ -171,6 +202,14 @@ namespace EUROPA{
 
     m_objects.insert(object);
 
+    // Assign a dense index, preferring one released by a deleted object
+    if(m_freeObjectIndices.empty())
+      object->m_index = m_objectIndexLimit++;
+    else {
+      object->m_index = m_freeObjectIndices.back();
+      m_freeObjectIndices.pop_back();
+    }
+
     // Cache by name
     m_objectsByName.insert(std::make_pair(object->getName(), object));
 
@@ -207,6 +246,7 @@ namespace EUROPA{
     // Clean up cached values
     m_objects.erase(object);
     m_objectsByName.erase(object->getName());
+    m_freeObjectIndices.push_back(object->m_index);
     for(std::multimap<std::string, ObjectId>::iterator it = m_objectsByPredicate.begin(); it != m_objectsByPredicate.end();){
       if(it->second == object)
         m_objectsByPredicate.erase(it++);
@@ -318,6 +358,10 @@ namespace EUROPA{
     return m_objects;
   }
 
+  unsigned int PlanDatabase::getObjectIndexLimit() const {
+    return m_objectIndexLimit;
+  }
+
 bool PlanDatabase::hasObjectInstances(const std::string& objectType) const {
   check_error(m_schema->isObjectType(objectType));
 
@@ -408,7 +452,7 @@ bool PlanDatabase::hasObjectInstances(const std::string& objectType) const {
       return;
 
     // Draw from list of active tokens of the same predicate
-    const TokenSet& candidates = getActiveTokens(inactiveToken->getPredicateName());
+    const TokenSet& candidates = getActiveTokens(inactiveToken->getPredicateKeys().front());
 
     condDebugMsg(candidates.empty(),
 		 "PlanDatabase:getCompatibleTokens", "No candidates to evaluate for " << inactiveToken->toString());
@@ -601,6 +645,102 @@ unsigned long PlanDatabase::countCompatibleTokens(const TokenId inactiveToken,
       return false;
   }
 
+void PlanDatabase::updateAdmittingVariables() const {
+  if(m_admittingVariablesValid && !m_constraintEngine->pending() &&
+     m_admittingVariablesCycle == m_constraintEngine->cycleCount())
+    return;
+
+  // The objects' own variables are compared member by member instead
+  ConstrainedVariableSet own;
+  for(ObjectSet::const_iterator it = m_objects.begin(); it != m_objects.end(); ++it) {
+    own.insert((*it)->getThis());
+    own.insert((*it)->getVariables().begin(), (*it)->getVariables().end());
+  }
+
+  // A variable in no constraint, such as one that only names an object, can't tell objects apart
+  m_admittingVariables.clear();
+  const ConstrainedVariableSet& vars = m_constraintEngine->getVariables();
+  for(ConstrainedVariableSet::const_iterator it = vars.begin(); it != vars.end(); ++it) {
+    ConstrainedVariableId var = *it;
+    const ObjectDomain* dom = dynamic_cast<const ObjectDomain*>(&(var->lastDomain()));
+    if(dom == NULL || dom->isEmpty() || var->constraintCount() == 0 || own.find(var) != own.end())
+      continue;
+    const std::set<edouble>& values = dom->getValues();
+    for(std::set<edouble>::const_iterator value = values.begin(); value != values.end(); ++value)
+      m_admittingVariables[*value].push_back(var->getKey());
+  }
+
+  m_admittingVariablesCycle = m_constraintEngine->cycleCount();
+  m_admittingVariablesValid = !m_constraintEngine->pending();
+  debugMsg("PlanDatabase:updateAdmittingVariables",
+           "Found the variables admitting " << m_admittingVariables.size() << " objects in cycle " <<
+           m_admittingVariablesCycle);
+}
+
+bool PlanDatabase::areInterchangeable(const ObjectId o1, const ObjectId o2,
+                                      std::vector<std::pair<ObjectId, ObjectId> >& assumed) const {
+  if(o1 == o2 ||
+     std::find(assumed.begin(), assumed.end(), std::make_pair(o1, o2)) != assumed.end())
+    return true;
+  if(o1->getType() != o2->getType())
+    return false;
+
+  static const std::vector<eint> none;
+  std::map<edouble, std::vector<eint> >::const_iterator admitting1 = m_admittingVariables.find(o1->getKey());
+  std::map<edouble, std::vector<eint> >::const_iterator admitting2 = m_admittingVariables.find(o2->getKey());
+  if((admitting1 == m_admittingVariables.end() ? none : admitting1->second) !=
+     (admitting2 == m_admittingVariables.end() ? none : admitting2->second))
+    return false;
+
+  const std::vector<ConstrainedVariableId>& vars1 = o1->getVariables();
+  const std::vector<ConstrainedVariableId>& vars2 = o2->getVariables();
+  const ObjectSet& components1 = o1->getComponents();
+  const ObjectSet& components2 = o2->getComponents();
+  if(vars1.size() != vars2.size() || components1.size() != components2.size())
+    return false;
+
+  // Members and components may refer back to o1 and o2, so assume they are interchangeable meanwhile
+  assumed.push_back(std::make_pair(o1, o2));
+  bool retval = true;
+  for(unsigned long i = 0; retval && i < vars1.size(); i++) {
+    const Domain& dom1 = vars1[i]->lastDomain();
+    const Domain& dom2 = vars2[i]->lastDomain();
+    if(vars1[i]->constraintCount() > 0 || vars2[i]->constraintCount() > 0)
+      retval = false;
+    else if(dom1 != dom2) {
+      const ObjectDomain* objects1 = dynamic_cast<const ObjectDomain*>(&dom1);
+      const ObjectDomain* objects2 = dynamic_cast<const ObjectDomain*>(&dom2);
+      retval = (objects1 != NULL && objects2 != NULL && objects1->isSingleton() && objects2->isSingleton() &&
+                areInterchangeable(Entity::getTypedEntity<Object>(objects1->getSingletonValue()),
+                                   Entity::getTypedEntity<Object>(objects2->getSingletonValue()), assumed));
+    }
+  }
+  for(ObjectSet::const_iterator it1 = components1.begin(), it2 = components2.begin();
+      retval && it1 != components1.end(); ++it1, ++it2)
+    retval = areInterchangeable(*it1, *it2, assumed);
+  assumed.pop_back();
+  return retval;
+}
+
+void PlanDatabase::getInterchangeableObjects(const std::vector<ObjectId>& objects,
+                                             std::vector< std::vector<ObjectId> >& classes) const {
+  check_error(classes.empty());
+  updateAdmittingVariables();
+
+  std::vector<std::pair<ObjectId, ObjectId> > assumed;
+  for(std::vector<ObjectId>::const_iterator it = objects.begin(); it != objects.end(); ++it) {
+    unsigned long c = 0;
+    while(c < classes.size() && !areInterchangeable(classes[c].front(), *it, assumed))
+      c++;
+    if(c == classes.size())
+      classes.push_back(std::vector<ObjectId>());
+    classes[c].push_back(*it);
+  }
+
+  debugMsg("PlanDatabase:getInterchangeableObjects",
+           "Found " << classes.size() << " classes among " << objects.size() << " objects");
+}
+
 void PlanDatabase::getObjectsByPredicate(const std::string& predicate,
                                          std::list<ObjectId>& results) {
   check_error(results.empty());
@@ -638,10 +778,15 @@ void PlanDatabase::getObjectsByPredicate(const std::string& predicate,
 
 const TokenSet& PlanDatabase::getActiveTokens(const std::string& predicate) const {
   static const TokenSet sl_noTokens;
-  std::map<std::string, TokenSet>::const_iterator it =
-      m_activeTokensByPredicate.find(predicate);
-  if(it != m_activeTokensByPredicate.end())
-    return it->second;
+  if(!m_schema->isPredicate(predicate))
+    return sl_noTokens;
+  return getActiveTokens(m_schema->getPredicateId(predicate));
+}
+
+const TokenSet& PlanDatabase::getActiveTokens(unsigned int predicateId) const {
+  static const TokenSet sl_noTokens;
+  if(predicateId < m_activeTokensByPredicate.size())
+    return m_activeTokensByPredicate[predicateId];
   else
     return sl_noTokens;
 }
@@ -675,6 +820,7 @@ const TokenSet& PlanDatabase::getActiveTokens(const std::string& predicate) cons
       delete static_cast<ObjectVariableListener*>(it->second.second);
       m_objectVariablesByObjectType.erase(it++);
     }
+    m_objectVariableEntries.clear();
 
     m_state = CLOSED;
   }
@@ -698,6 +844,7 @@ void PlanDatabase::close(const std::string& objectType) {
                "Closing " << objectType << " closed " << connectedObjectVariable->toString());
     }
     delete static_cast<ObjectVariableListener*>(it->second.second);
+    eraseObjectVariableEntry(it);
     m_objectVariablesByObjectType.erase(it++);
   }
   m_closedObjectTypes.insert(objectType);
@@ -721,10 +868,6 @@ void PlanDatabase::close(const std::string& objectType) {
     publish(notifyActivated(token));
   }
 
-  /**
-   * @todo Can make thos more efficient by using the inheritance model as was donw on
-   * insertion.
-   */
   void PlanDatabase::notifyDeactivated(const TokenId token){
     check_error(!Entity::isPurging());
     check_error(token.isValid());
@@ -878,15 +1021,26 @@ void PlanDatabase::close(const std::string& objectType) {
    */
 void PlanDatabase::handleObjectVariableDeletion(const ConstrainedVariableId objectVar){
 
-  // Now iterate over objectVariables stored and remove them - should be at least one reference
-  for(ObjVarsByObjType_I it = m_objectVariablesByObjectType.begin();
-      it != m_objectVariablesByObjectType.end();){
-    if(it->second.first == objectVar){
-      delete static_cast<ObjectVariableListener*>(it->second.second);
-      m_objectVariablesByObjectType.erase(it++);
+  // Now remove the entries stored for the variable - should be at least one reference
+  std::multimap<eint, ObjVarsByObjType_I>::iterator it = m_objectVariableEntries.lower_bound(objectVar->getKey());
+  while(it != m_objectVariableEntries.end() && it->first == objectVar->getKey()){
+    ObjVarsByObjType_I entry = it->second;
+    check_error(entry->second.first == objectVar);
+    delete static_cast<ObjectVariableListener*>(entry->second.second);
+    m_objectVariablesByObjectType.erase(entry);
+    m_objectVariableEntries.erase(it++);
+  }
+}
+
+void PlanDatabase::eraseObjectVariableEntry(const ObjVarsByObjType_I entry){
+  const eint key = entry->second.first->getKey();
+  std::multimap<eint, ObjVarsByObjType_I>::iterator it = m_objectVariableEntries.lower_bound(key);
+  while(it != m_objectVariableEntries.end() && it->first == key){
+    if(it->second == entry){
+      m_objectVariableEntries.erase(it);
+      return;
     }
-    else
-      ++it;
+    ++it;
   }
 }
 
@@ -895,7 +1049,9 @@ void PlanDatabase::handleObjectVariableDeletion(const ConstrainedVariableId obje
 						  bool leaveOpen){
     if(!isClosed(objectType)){
     	ObjectVariableListener* ovl = new ObjectVariableListener(objectVar, m_id);
-    	m_objectVariablesByObjectType.insert(std::make_pair(objectType, std::make_pair(objectVar, ovl->getId())));
+    	ObjVarsByObjType_I entry =
+    	  m_objectVariablesByObjectType.insert(std::make_pair(objectType, std::make_pair(objectVar, ovl->getId())));
+    	m_objectVariableEntries.insert(std::make_pair(objectVar->getKey(), entry));
     }
     else if(!leaveOpen)// Close the given variable
       objectVar->close();
@@ -950,63 +1106,24 @@ unsigned long PlanDatabase::archive(eint tick){
 }
 
 void PlanDatabase::insertActiveToken(const TokenId token){
-  static const std::string sl_objectRoot("Object");
-  static const std::string sl_timelineRoot("Timeline");
-  std::string objectType = token->getObject()->baseDomain().getTypeName();
-  std::string predicate = token->getPredicateName();
-  std::string predicateSuffix = token->getUnqualifiedPredicateName();
-
   debugMsg("PlanDatabase:insertActiveToken", token->toString());
 
-  while(getSchema()->isPredicate(predicate)){
-    std::map<std::string, TokenSet>::iterator it = m_activeTokensByPredicate.find(predicate);
-    if(it == m_activeTokensByPredicate.end()){
-      static const TokenSet emptySet;
-      std::pair<std::string, TokenSet > entry(predicate, emptySet);
-      m_activeTokensByPredicate.insert(entry);
-      it = m_activeTokensByPredicate.find(predicate);
-    }
-
-    TokenSet& activeTokens = it->second;
-    activeTokens.insert(token);
-    debugMsg("PlanDatabase:insertActiveToken", token->toString() << " added for " << predicate);
-
-    // Break if we hit a built in class
-    if(objectType == sl_timelineRoot || objectType == sl_objectRoot)
-      break;
-
-    objectType = getSchema()->getParent(objectType);
-
-    std::string predStr = objectType + "." + predicateSuffix.c_str();
-    predicate = predStr;
+  const std::vector<unsigned int>& keys = token->getPredicateKeys();
+  for(std::vector<unsigned int>::const_iterator it = keys.begin(); it != keys.end(); ++it){
+    if(*it >= m_activeTokensByPredicate.size())
+      m_activeTokensByPredicate.resize(*it + 1);
+    m_activeTokensByPredicate[*it].insert(token);
   }
 }
 
   void PlanDatabase::removeActiveToken(const TokenId token){
-    static const std::string sl_objectRoot("Object");
-    static const std::string sl_timelineRoot("Timeline");
-    std::string objectType = token->getObject()->baseDomain().getTypeName();
-    std::string predicate = token->getPredicateName();
-    std::string predicateSuffix = token->getUnqualifiedPredicateName();
-
     debugMsg("PlanDatabase:removeActiveToken", token->toString());
 
-    while(getSchema()->isPredicate(predicate)){
-      std::map<std::string, TokenSet>::iterator it = m_activeTokensByPredicate.find(predicate);
-      checkError(it != m_activeTokensByPredicate.end(), token->toString() << " must be present but isn't.")
-      TokenSet& activeTokens = it->second;
-      activeTokens.erase(token);
-      debugMsg("PlanDatabase:removeActiveToken", token->toString() << " removed for " << predicate);
-
-      // Break if we hit a built in class
-      if(objectType == sl_timelineRoot || objectType == sl_objectRoot)
-	break;
-
-      objectType = getSchema()->getParent(objectType);
-
-      std::string predStr = objectType + "." + predicateSuffix.c_str();
-
-      predicate = predStr;
+    const std::vector<unsigned int>& keys = token->getPredicateKeys();
+    for(std::vector<unsigned int>::const_iterator it = keys.begin(); it != keys.end(); ++it){
+      checkError(*it < m_activeTokensByPredicate.size() && m_activeTokensByPredicate[*it].count(token) == 1,
+                 token->toString() << " must be present but isn't.");
+      m_activeTokensByPredicate[*it].erase(token);
     }
   }
 
@@ -84,6 +84,12 @@ namespace EUROPA {
      */
     const ObjectSet& getObjects() const;
 
+    /**
+     * @brief An upper bound on Object::getIndex() over all objects in the database, for sizing
+     * tables keyed by object index.
+     */
+    unsigned int getObjectIndexLimit() const;
+
     /**
      * @brief Returns the set of all tokens in the database.
      * @return All Tokens
@@ -95,6 +101,12 @@ namespace EUROPA {
      */
     const TokenSet& getActiveTokens(const std::string& predicate) const;
 
+    /**
+     * @brief Returns the set of all active tokens by predicate id.
+     * @see Schema::getPredicateId, Token::getPredicateKeys
+     */
+    const TokenSet& getActiveTokens(unsigned int predicateId) const;
+
     /**
      * @brief Register an allocated global variable.
      * @param var The variable to be registered. Must not have a parent. Furthermore, the name of the variable must be unique in this scope.
@@ -230,6 +242,19 @@ namespace EUROPA {
      */
     bool hasOrderingChoice(const TokenId token);
 
+    /**
+     * @brief Partitions objects into classes of interchangeable objects.  Two objects are interchangeable if
+     * swapping them everywhere could not change whether the database has a solution: they are of the same
+     * type, every constrained variable that belongs to no object admits either both or neither of them,
+     * their member variables take part in no constraints and have equal domains or hold interchangeable
+     * objects, and their components are pairwise interchangeable.  A search need only try the first object
+     * of each class.  The variables admitting each object are found once per propagation cycle.
+     * @param objects The objects to partition.
+     * @param classes Populated with the classes, each in the order of \a objects, and ordered by their first members.
+     */
+    void getInterchangeableObjects(const std::vector<ObjectId>& objects,
+                                   std::vector< std::vector<ObjectId> >& classes) const;
+
     /**
      * @brief Retrieves a collection of object instances of the given type. Database must be closed.
      * @param type The type of object sought.
@@ -287,6 +312,12 @@ namespace EUROPA {
      */
     void purge();
 
+    /**
+     * @brief Delete all Objects, Tokens and global variables and reopen the database, leaving the
+     * Schema untouched. Allows a database to be reused for a new problem without reloading the model.
+     */
+    void reset();
+
     /**
      * @brief Make ObjectVariable. Will populate initial values and
      * close the variable. Will also hook up the variable for synchronization
@@ -294,6 +325,10 @@ namespace EUROPA {
      * @param objectType The type of objects to pull from
      * @param objectVar The variable to be populated and possibly synchronized. Must be open.
      * @param leaveOpen If true, the object var will remain open on completion.
+     * @note Synchronized variables hold their values, so each object created while its type is open is
+     * inserted into every open variable of that type. Creating an object therefore takes time linear in
+     * the number of such variables (each insertion is logarithmic in the size of the domain), and not
+     * constant time. Close the type to stop synchronizing.
      */
     void makeObjectVariableFromType(const std::string& objectType,
 				    const ConstrainedVariableId objectVar,
@@ -400,6 +435,11 @@ namespace EUROPA {
 
     void handleObjectVariableDeletion(const ConstrainedVariableId objectVar);
 
+    /**
+     * @brief Discard root tokens and objects, cascading to their slaves and children.
+     */
+    void discardRoots();
+
     void handleObjectVariableCreation(const std::string& objectType,
 				      const ConstrainedVariableId objectVar,
 				      bool leaveOpen = false);
@@ -414,6 +454,19 @@ namespace EUROPA {
      */
     void getObjectsByPredicate(const std::string& predicate, std::list<ObjectId>& results);
 
+    /**
+     * @brief Brings m_admittingVariables up to date with the current propagation cycle.
+     */
+    void updateAdmittingVariables() const;
+
+    /**
+     * @brief True if o1 and o2 are interchangeable.
+     * @param assumed Pairs already being compared further up, which are taken to be interchangeable.
+     * @see getInterchangeableObjects
+     */
+    bool areInterchangeable(const ObjectId o1, const ObjectId o2,
+                            std::vector<std::pair<ObjectId, ObjectId> >& assumed) const;
+
     /**
      * @brief Utility to index an active token.
      */
@@ -449,13 +502,22 @@ namespace EUROPA {
     std::map<eint, std::pair<TokenId, ObjectSet> > m_tokensToOrder; /*!< All tokens to order, with the object
 								     inducing the requirement stored in the set */
 
-    std::map<std::string, TokenSet > m_activeTokensByPredicate; /*!< All active tokens sorted by predicate */
+    std::vector<TokenSet> m_activeTokensByPredicate; /*!< All active tokens by predicate id */
+    std::vector<unsigned int> m_freeObjectIndices; /*!< Indices of deleted objects, reused before growing the limit */
+    unsigned int m_objectIndexLimit;
+    mutable std::map<edouble, std::vector<eint> > m_admittingVariables; /*!< By object key, the keys of the constrained
+                                                                       variables outside any object that admit it */
+    mutable unsigned int m_admittingVariablesCycle; /*!< The propagation cycle m_admittingVariables was found in */
+    mutable bool m_admittingVariablesValid;
 
     // All this to store variables (and their listeners) for Open Object Types
     typedef std::multimap<std::string, std::pair<ConstrainedVariableId, ConstrainedVariableListenerId> > ObjVarsByObjType;
     typedef ObjVarsByObjType::iterator ObjVarsByObjType_I;
     typedef ObjVarsByObjType::const_iterator ObjVarsByObjType_CI;
     ObjVarsByObjType m_objectVariablesByObjectType;
+    std::multimap<eint, ObjVarsByObjType_I> m_objectVariableEntries; /*!< Entries of m_objectVariablesByObjectType
+                                                                     by variable key, so that deletion is not a scan */
+    void eraseObjectVariableEntry(const ObjVarsByObjType_I entry);
 private:
     PlanDatabase(const PlanDatabase&);
     PlanDatabase& operator=(const PlanDatabase&);
@@ -5,8 +5,11 @@
 #include "Object.hh"
 #include "DataTypes.hh"
 #include "CESchema.hh"
+#include "TokenLayout.hh"
 
 #include <boost/cast.hpp>
+#include <iomanip>
+#include <sstream>
 #ifdef _MANAGED
   using namespace System;
 
@@ -60,6 +63,7 @@ Schema::Schema(const std::string& name, const CESchemaId ces)
     , predicates(), primitives(), membershipRelation(), childOfRelation()
     , objectPredicates(), typesWithNoPredicates(), allObjectTypes()
     , m_predTrueCache(), m_predFalseCache(), m_hasParentCache()
+    , m_predicateIds(), m_predicateKeys(), m_tokenLayouts(), m_allTokenLayouts()
   {
       reset();
       debugMsg("Schema:constructor", "created Schema:" << name);
@@ -71,6 +75,8 @@ Schema::Schema(const std::string& name, const CESchemaId ces)
     delete static_cast<ObjectTypeMgr*>(m_objectTypeMgr);
 
     cleanup(m_methods);
+    for(std::vector<TokenLayout*>::const_iterator it = m_allTokenLayouts.begin(); it != m_allTokenLayouts.end(); ++it)
+      delete *it;
     m_id.remove();
   }
 
@@ -97,6 +103,8 @@ Schema::Schema(const std::string& name, const CESchemaId ces)
     childOfRelation.clear();
     objectPredicates.clear();
     typesWithNoPredicates.clear();
+    m_predicateKeys.clear();
+    m_tokenLayouts.clear();
 
     // Add System entities
 	addPrimitive("int");
@@ -291,6 +299,54 @@ bool Schema::hasMember(const std::string& parentType, const std::string& memberN
     return predicate.substr(0, predicate.find(getDelimiter()));
   }
 
+  unsigned int Schema::getPredicateId(const std::string& predicate) const {
+    std::map<std::string, unsigned int>::const_iterator it = m_predicateIds.find(predicate);
+    if(it != m_predicateIds.end())
+      return it->second;
+
+    check_error(isPredicate(predicate), "Predicate " + predicate + " is not defined.");
+    const unsigned int id = static_cast<unsigned int>(m_predicateIds.size());
+    m_predicateIds.insert(std::make_pair(predicate, id));
+    return id;
+  }
+
+  const std::vector<unsigned int>& Schema::getPredicateKeys(const std::string& predicate) const {
+    static const std::string sl_timelineRoot("Timeline");
+    std::map<std::string, std::vector<unsigned int> >::const_iterator it = m_predicateKeys.find(predicate);
+    if(it != m_predicateKeys.end())
+      return it->second;
+
+    std::vector<unsigned int>& keys = m_predicateKeys[predicate];
+    std::string objectType = getObjectTypeForPredicate(predicate);
+    const std::string predicateSuffix = predicate.substr(predicate.find(getDelimiter()) + 1);
+    std::string current = predicate;
+    while(isPredicate(current)){
+      keys.push_back(getPredicateId(current));
+
+      // Stop if we hit a built in class
+      if(objectType == sl_timelineRoot || objectType == rootObject())
+        break;
+
+      objectType = getParent(objectType);
+      current = objectType + getDelimiter() + predicateSuffix;
+    }
+
+    debugMsg("Schema:getPredicateKeys", "[" << m_name << "] " << predicate << " is indexed under " << keys.size() << " predicates");
+    return keys;
+  }
+
+  TokenLayout* Schema::getTokenLayout(const std::string& predicate) {
+    std::map<std::string, TokenLayout*>::const_iterator it = m_tokenLayouts.find(predicate);
+    if(it != m_tokenLayouts.end())
+      return it->second;
+
+    TokenLayout* layout = new TokenLayout(predicate, getObjectTypeForPredicate(predicate), getPredicateKeys(predicate));
+    m_allTokenLayouts.push_back(layout);
+    m_tokenLayouts.insert(std::make_pair(predicate, layout));
+    debugMsg("Schema:getTokenLayout", "[" << m_name << "] Created layout for " << predicate);
+    return layout;
+  }
+
 const std::vector<std::string>& Schema::getAllObjectTypes(const std::string& objectType) {
   std::map<std::string, std::vector<std::string> >::iterator it = allObjectTypes.find(objectType);
   if(it != allObjectTypes.end())
@@ -557,6 +613,8 @@ const std::set<std::string>& Schema::getAllObjectTypes() const {
 
     objectTypes.insert(objectType);
     membershipRelation.insert(std::pair<std::string, NameValueVector>(objectType, NameValueVector()));
+    m_predicateKeys.clear();
+    m_tokenLayouts.clear();
 
     // Add type for constrained variables to be able to hold references to objects of the new type
     if (!getCESchema()->isDataType(objectType.c_str()))
@@ -581,6 +639,8 @@ void Schema::addPredicate(const std::string& predicate) {
            "[" << m_name << "] " << "Added predicate " << predicate);
   predicates.insert(predicate);
   membershipRelation.insert(std::pair<std::string, NameValueVector>(predicate, NameValueVector()));
+  m_predicateKeys.clear();
+  m_tokenLayouts.clear();
 }
 
   /**
@@ -661,6 +721,45 @@ void Schema::write(ostream& os) const {
   }
 }
 
+std::string Schema::getModelHash() const {
+  std::ostringstream os;
+  for(std::set<std::string>::const_iterator it = objectTypes.begin(); it != objectTypes.end(); ++it){
+    std::map<std::string, std::string>::const_iterator parent = childOfRelation.find(*it);
+    os << "type " << *it << " " << (parent == childOfRelation.end() ? "" : parent->second) << "\n";
+  }
+  for(std::set<std::string>::const_iterator it = predicates.begin(); it != predicates.end(); ++it)
+    os << "predicate " << *it << "\n";
+  for(std::map<std::string, NameValueVector>::const_iterator it = membershipRelation.begin();
+      it != membershipRelation.end(); ++it){
+    os << "members " << it->first;
+    for(NameValueVector::const_iterator member = it->second.begin(); member != it->second.end(); ++member)
+      os << " " << member->first << ":" << member->second;
+    os << "\n";
+  }
+  // Symbol keys depend on the order labels were created in, so hash the names in sorted order
+  for(std::map<std::string, std::set<edouble> >::const_iterator it = enumValues.begin();
+      it != enumValues.end(); ++it){
+    std::set<std::string> values;
+    for(std::set<edouble>::const_iterator value = it->second.begin(); value != it->second.end(); ++value)
+      values.insert(LabelStr::isString(*value) ? LabelStr(*value).toString() : toString(*value));
+    os << "enum " << it->first;
+    for(std::set<std::string>::const_iterator value = values.begin(); value != values.end(); ++value)
+      os << " " << *value;
+    os << "\n";
+  }
+
+  // 64 bit FNV-1a
+  const std::string text = os.str();
+  unsigned long long hash = 0xcbf29ce484222325ULL;
+  for(std::string::const_iterator it = text.begin(); it != text.end(); ++it){
+    hash ^= static_cast<unsigned char>(*it);
+    hash *= 0x100000001b3ULL;
+  }
+  std::ostringstream result;
+  result << std::hex << std::setfill('0') << std::setw(16) << hash;
+  return result.str();
+}
+
 bool Schema::makeParentPredicateString(const std::string& predicate, std::string& predStr) const{
   check_error(std::count(predicate.begin(), predicate.end(), getDelimiter()) == 1,
               "Invalid format for predicate " + predicate);
@@ -19,6 +19,7 @@
 
 namespace EUROPA {
 class LabelStr;
+class TokenLayout;
 
   /**
    * @class Schema
@@ -242,6 +243,31 @@ class LabelStr;
      */
     const std::string getObjectTypeForPredicate(const std::string& predicate) const;
 
+    /**
+     * @brief Obtain a small integer id for a predicate, assigned on first use. Ids are dense and
+     *        never reused. Errors if !isPredicate(predicate).
+     * @param predicate The predicate to use
+     */
+    unsigned int getPredicateId(const std::string& predicate) const;
+
+    /**
+     * @brief Obtain the ids of the predicates an active token of the given predicate is indexed
+     *        under: its own, then the same predicate on each ancestor type that has it, up to a
+     *        built in class. Computed once per predicate.
+     * @param predicate The predicate to use
+     * @see PlanDatabase::getActiveTokens
+     */
+    const std::vector<unsigned int>& getPredicateKeys(const std::string& predicate) const;
+
+    /**
+     * @brief Obtain the layout shared by tokens of the given predicate, created on first use. A change
+     *        to the schema starts new layouts, but the old ones last as long as the schema, so tokens
+     *        that hold them keep the predicate keys they were indexed under.
+     * @param predicate The predicate to use
+     * @see Token::getVariable
+     */
+    TokenLayout* getTokenLayout(const std::string& predicate);
+
     /**
      * @brief Gets the index of a named member in a types member list.
      * @param type the type to search
@@ -342,6 +368,14 @@ class LabelStr;
      */
     void write (ostream& os) const;
 
+    /**
+     * @brief A fingerprint of the types, members, predicates and enumerations in the schema.
+     * Stable across processes that load the same model, so it can be used to check that saved
+     * state belongs to the loaded model.
+     * @see PlanDatabaseImage
+     */
+    std::string getModelHash() const;
+
     const CESchemaId getCESchema() const { return m_ceSchema; }
 
     // TODO: ObjectType is replacing ObjectFactory
@@ -393,6 +427,10 @@ class LabelStr;
 
     mutable std::set<std::string> m_predTrueCache, m_predFalseCache; /**< Caches from isPredicate, now useful and not static . */
     mutable std::set<std::string> m_hasParentCache; /**< Cache from hasParent, now useful and not static */
+    mutable std::map<std::string, unsigned int> m_predicateIds; /**< Ids from getPredicateId */
+    mutable std::map<std::string, std::vector<unsigned int> > m_predicateKeys; /**< Cache from getPredicateKeys */
+    std::map<std::string, TokenLayout*> m_tokenLayouts; /**< Current layouts from getTokenLayout */
+    std::vector<TokenLayout*> m_allTokenLayouts; /**< Every layout created, for deletion with the schema */
 
     Schema(const Schema&); /**< NO IMPL */
     static const std::set<std::string>& getBuiltInVariableNames();
@@ -46,6 +46,14 @@ namespace EUROPA{
      */
     virtual bool canBeConcurrent(const TokenId first, const TokenId second) = 0;
 
+    /**
+     * @brief Test if the plan can be executed whatever durations the environment chooses for contingent
+     * temporal constraints, deciding each time as execution reaches it.  Where there are contingent
+     * constraints, canPrecede also rules out orderings that would lose this property.
+     * @return true if there are no contingent constraints and the temporal constraints are consistent.
+     */
+    virtual bool isDynamicallyControllable() = 0;
+
 
     /**
      * @brief General utility for obtaining the min and max temporal distance between two timepoints.
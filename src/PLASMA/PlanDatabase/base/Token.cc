@@ -82,11 +82,10 @@ const std::string& Token::noObject(){
 	       bool closed)
       :Entity(),
        m_id(this),
-       m_name(tokenTypeName),
+       m_layout(planDatabase->getSchema()->getTokenLayout(tokenTypeName)),
+       m_name(),
        m_master(),
        m_relation("none"),
-       m_baseObjectType(),
-       m_predicateName(tokenTypeName),
        m_state(),
        m_object(),
        m_duration(),
@@ -104,8 +103,7 @@ const std::string& Token::noObject(){
           m_committed(false),
           m_deleted(false),
           m_terminated(false),
-          m_localVariables(),
-          m_unqualifiedPredicateName()
+          m_localVariables()
 {
     commonInit(tokenTypeName, rejectable, _isFact, durationBaseDomain, objectName, closed);
   }
@@ -119,11 +117,10 @@ Token::Token(const TokenId _master,
              bool closed)
     :Entity(),
      m_id(this),
-     m_name(tokenTypeName),
+     m_layout((*_master).m_planDatabase->getSchema()->getTokenLayout(tokenTypeName)),
+     m_name(),
      m_master(_master),
      m_relation(relation),
-     m_baseObjectType(),
-     m_predicateName(tokenTypeName),
      m_state(),
      m_object(),
      m_duration(),
@@ -141,8 +138,7 @@ Token::Token(const TokenId _master,
           m_committed(false),
           m_deleted(false),
           m_terminated(false),
-          m_localVariables(),
-          m_unqualifiedPredicateName()
+          m_localVariables()
 {
 
   // Master must be active to add children
@@ -214,7 +210,7 @@ Token::Token(const TokenId _master,
 
 const std::string& Token::getRelation() const {
   check_error(m_master.isNoId() || m_master.isValid());
-  return m_relation; // returns "NONE" if m_master isNoId()
+  return m_relation.toString(); // returns "NONE" if m_master isNoId()
 }
 
   /**
@@ -240,15 +236,15 @@ const TokenId Token::getSlave(unsigned int slavePosition) const{
     return -1;
   }
 
-const std::string& Token::getBaseObjectType() const {return m_baseObjectType;}
+const std::string& Token::getBaseObjectType() const {return m_layout->getBaseObjectType();}
 
-const std::string&  Token::getName() const { return m_name; }
+const std::string&  Token::getName() const { return (m_name.empty() ? getPredicateName() : m_name); }
 
 void Token::setName(const std::string& name) { m_name = name; }
 
-const std::string& Token::getPredicateName() const {return m_predicateName;}
+const std::string& Token::getPredicateName() const {return m_layout->getPredicateName();}
 
-const std::string& Token::getUnqualifiedPredicateName() const {return m_unqualifiedPredicateName;}
+const std::string& Token::getUnqualifiedPredicateName() const {return m_layout->getUnqualifiedPredicateName();}
 
   const PlanDatabaseId Token::getPlanDatabase() const {
     check_error(m_planDatabase.isValid());
@@ -275,6 +271,10 @@ const std::string& Token::getUnqualifiedPredicateName() const {return m_unqualif
 const ConstrainedVariableId Token::getVariable(const std::string& name,
                                                bool checkGlobalContext) const{
     const std::vector<ConstrainedVariableId>& vars = getVariables();
+    const unsigned int slot = m_layout->getSlot(name);
+    if(slot < vars.size() && vars[slot]->getName() == name)
+      return vars[slot];
+
     for(std::vector<ConstrainedVariableId>::const_iterator it = vars.begin();
 	it != vars.end(); ++it){
       ConstrainedVariableId var = *it;
@@ -328,6 +328,7 @@ const ConstrainedVariableId Token::getVariable(const std::string& name,
 
   void Token::close() {
     check_error(isIncomplete());
+    m_layout->addSlots(m_allVariables);
     m_state->close();
     m_planDatabase->notifyAdded(m_id);
   }
@@ -360,9 +361,9 @@ void Token::doMerge(const TokenId activeToken){
   check_error(activeToken->isActive());
   checkError(m_state->lastDomain().isMember(MERGED),
              "Not permitted to merge." << toString());
-  check_error(getPlanDatabase()->getSchema()->isA(activeToken->getPredicateName(), m_predicateName),
+  check_error(getPlanDatabase()->getSchema()->isA(activeToken->getPredicateName(), getPredicateName()),
               "Cannot merge tokens with different predicates: " +
-              m_predicateName + ", " + activeToken->getPredicateName());
+              getPredicateName() + ", " + activeToken->getPredicateName());
   checkError((isFact() && activeToken->isFact()) || true,
              "Cannot merge fact " << toString() << " onto non-fact " << 
              activeToken->toString());
@@ -486,7 +487,7 @@ void Token::doMerge(const TokenId activeToken){
     return(m_standardConstraints.find(constraint) != m_standardConstraints.end());
   }
 
-  const std::set<ConstraintId>& Token::getStandardConstraints() const
+  const ConstraintSet& Token::getStandardConstraints() const
   {
 	  return m_standardConstraints;
   }
@@ -496,7 +497,7 @@ void Token::doMerge(const TokenId activeToken){
   double Token::getViolation() const
   {
   	  double total = 0.0;
-      for (std::set<ConstraintId>::const_iterator it = m_standardConstraints.begin(); it != m_standardConstraints.end(); ++it) {
+      for (ConstraintSet::const_iterator it = m_standardConstraints.begin(); it != m_standardConstraints.end(); ++it) {
   	      ConstraintId c = *it;
   	      total += c->getViolation();
       }
@@ -508,7 +509,7 @@ void Token::doMerge(const TokenId activeToken){
   {
   	  std::ostringstream os;
 
-      for (std::set<ConstraintId>::const_iterator it = m_standardConstraints.begin(); it != m_standardConstraints.end(); ++it) {
+      for (ConstraintSet::const_iterator it = m_standardConstraints.begin(); it != m_standardConstraints.end(); ++it) {
   	      ConstraintId c = *it;
   	      if (c->getViolation() > 0.0)
   	          os << c->getViolationExpl() << std::endl;
@@ -557,11 +558,6 @@ void Token::commonInit(const std::string& predicateName,
     // The plan database must be valid
     check_error(m_planDatabase.isValid());
 
-    if(std::count(predicateName.begin(), predicateName.end(), '.') == 1)
-      m_unqualifiedPredicateName = predicateName.substr(predicateName.find('.') + 1);
-    else
-      m_unqualifiedPredicateName = predicateName;
-
     m_committed = false;
     m_deleted = false;
     m_terminated = false;
@@ -594,8 +590,8 @@ void Token::commonInit(const std::string& predicateName,
 		"Invalid predicate: " + predicateName);
 
     // Allocate an object variable with an empty domain
-    m_baseObjectType = m_planDatabase->getSchema()->getObjectTypeForPredicate(m_predicateName);
-    const DataTypeId dt = m_planDatabase->getSchema()->getCESchema()->getDataType(m_baseObjectType.c_str());
+    const std::string& baseObjectType = getBaseObjectType();
+    const DataTypeId dt = m_planDatabase->getSchema()->getCESchema()->getDataType(baseObjectType.c_str());
     m_object = (new TokenVariable<ObjectDomain>(m_id,
 						m_allVariables.size(),
 						m_planDatabase->getConstraintEngine(),
@@ -604,11 +600,11 @@ void Token::commonInit(const std::string& predicateName,
 						true,
 						"object"))->getId();
 
-    checkError(m_planDatabase->hasObjectInstances(m_baseObjectType),
-	       "Allocated a token with no object instance available of type " << m_baseObjectType);
+    checkError(m_planDatabase->hasObjectInstances(baseObjectType),
+	       "Allocated a token with no object instance available of type " << baseObjectType);
 
     // Call the plan database to fill it in, and maintain synchronization for dynamic objects
-    m_planDatabase->makeObjectVariableFromType(m_baseObjectType, m_object);
+    m_planDatabase->makeObjectVariableFromType(baseObjectType, m_object);
     // If a specific object has been specified, validate that it can be assigned
     if (objectName != noObject()) {
       ObjectId object = m_planDatabase->getObject(objectName);
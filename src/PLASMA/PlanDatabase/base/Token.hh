@@ -8,6 +8,7 @@
 #include "PlanDatabaseDefs.hh"
 #include "UnifyMemento.hh"
 #include "Schema.hh"
+#include "TokenLayout.hh"
 #include "Entity.hh"
 #include "LabelStr.hh"
 #include "Domains.hh"
@@ -59,12 +60,12 @@ namespace EUROPA {
     const TokenId getId() const;
 
     /**
-     * @brief Get the name
+     * @brief Get the name, which is the predicate name unless the token has been named.
      */
     const std::string& getName() const;
 
     /**
-     * @brief Set the name
+     * @brief Set the name.  An empty name restores the predicate name.
      */
     void setName(const std::string& name);
 
@@ -120,6 +121,17 @@ namespace EUROPA {
      */
     const std::string& getUnqualifiedPredicateName() const;
 
+    /**
+     * @brief Access the ids of the predicates the token is indexed under while active.
+     * @see Schema::getPredicateKeys, PlanDatabase::getActiveTokens
+     */
+    const std::vector<unsigned int>& getPredicateKeys() const {return m_layout->getPredicateKeys();}
+
+    /**
+     * @brief Access what the token shares with other tokens of its predicate.
+     */
+    const TokenLayout& getLayout() const {return *m_layout;}
+
     /**
      * @brief Obtain the variable used to store reachable states. The full domain is INCOMPLETE, ACTIVE, MERGED and REJECTED.
      *
@@ -162,7 +174,10 @@ namespace EUROPA {
     const std::vector<ConstrainedVariableId>& getVariables() const;
 
     /**
-     * @brief Access all variables (state, object, start, end, duration, parameters).
+     * @brief Access a variable (state, object, start, end, duration or a parameter) by name.
+     *
+     * The slot of the variable is looked up in the layout of the predicate. Variables the layout doesn't
+     * place are searched for, and then, if checkGlobalContext is true, global variables.
      */
     const ConstrainedVariableId getVariable(const std::string& name, bool checkGlobalContext=true) const;
 
@@ -194,7 +209,7 @@ namespace EUROPA {
     /**
      * @brief Internally generated constraints that are standard across Token instances of the same type.
      */
-    const std::set<ConstraintId>& getStandardConstraints() const;
+    const ConstraintSet& getStandardConstraints() const;
 
     /**
      * @brief Sum of violation value for all the constraints attached to this token
@@ -387,8 +402,8 @@ namespace EUROPA {
 		  "Cannot add parameter " + name +
 		  " after completing token construction.");
 
-      check_error(m_planDatabase->getSchema()->canContain(m_predicateName, baseDomain.getTypeName(), name),
-		  "Predicate '" + m_predicateName +
+      check_error(m_planDatabase->getSchema()->canContain(getPredicateName(), baseDomain.getTypeName(), name),
+		  "Predicate '" + getPredicateName() +
 		  "' cannot contain parameter '" + name + "'");
 
       ConstrainedVariableId id = (new TokenVariable<DomainType>(m_id,
@@ -496,11 +511,10 @@ namespace EUROPA {
     bool removeMergedToken(const TokenId token);
 
     TokenId m_id;
-    std::string m_name;
+    TokenLayout* m_layout; /*!< Shared by tokens of the predicate. Holds the predicate and object type names. */
+    std::string m_name; /*!< Empty unless the token has been named. */
     TokenId m_master;
-    std::string m_relation;
-    std::string m_baseObjectType;
-    std::string m_predicateName;
+    LabelStr m_relation;
     StateVarId m_state; /*!< state variable for token.*/
     ObjectVarId m_object; /*!< object variable for token. The set of objects it may be assigned to. */
     TempVarId m_duration; /*!< The duration of the token. [0 +inf]. */
@@ -510,8 +524,8 @@ namespace EUROPA {
     std::vector<ConstrainedVariableId> m_allVariables; /*!< The set of all variables of a token specification. Includes built in variables
 							 such as object, state, start, end, duration. Also includes all parameters (m_parameters). */
     TokenSet m_slaves;
-    std::set<ConstraintId> m_standardConstraints; /**< Indicates internally generated constraints that are standard
-                                                     across Token instances of the same type. */
+    ConstraintSet m_standardConstraints; /**< Indicates internally generated constraints that are standard
+                                            across Token instances of the same type. */
     std::vector<ConstrainedVariableId> m_pseudoVariables; /**< Indicates internally generated variables that are standard
                                                              across token instances of the same type. Pseudo variables cannot be specified
                                                              externally. */
@@ -553,7 +567,6 @@ namespace EUROPA {
     ConstrainedVariableSet m_localVariables; /*!< Variables created external to the token but related to it. They are
 					       not part of the predicate definition but may be derived from the model elsewhere
 					       such as via local rule variables.*/
-    std::string m_unqualifiedPredicateName;
   };
 
   class StateDomain : public EnumeratedDomain {
@@ -0,0 +1,40 @@
+#include "TokenLayout.hh"
+#include "ConstrainedVariable.hh"
+
+#include <algorithm>
+
+namespace EUROPA {
+
+  const unsigned int TokenLayout::NO_SLOT = static_cast<unsigned int>(-1);
+
+  namespace {
+    std::string unqualify(const std::string& predicateName) {
+      if(std::count(predicateName.begin(), predicateName.end(), '.') == 1)
+        return predicateName.substr(predicateName.find('.') + 1);
+      return predicateName;
+    }
+  }
+
+  TokenLayout::TokenLayout(const std::string& predicateName,
+                           const std::string& baseObjectType,
+                           const std::vector<unsigned int>& predicateKeys)
+    : m_predicateName(predicateName),
+      m_unqualifiedPredicateName(unqualify(predicateName)),
+      m_baseObjectType(baseObjectType),
+      m_predicateKeys(predicateKeys),
+      m_slots() {}
+
+  unsigned int TokenLayout::getSlot(const std::string& name) const {
+    SlotMap::const_iterator it = m_slots.find(name);
+    return (it == m_slots.end() ? NO_SLOT : it->second);
+  }
+
+  void TokenLayout::addSlots(const std::vector<ConstrainedVariableId>& variables) {
+    // Most tokens of a predicate have the same variables, so there is usually nothing new
+    if(m_slots.size() >= variables.size())
+      return;
+    for(unsigned int i = 0; i < variables.size(); i++)
+      m_slots.insert(std::make_pair(variables[i]->getName(), i));
+  }
+
+}
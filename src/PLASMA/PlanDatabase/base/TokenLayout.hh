@@ -0,0 +1,64 @@
+#ifndef _H_TokenLayout
+#define _H_TokenLayout
+
+#include "PlanDatabaseDefs.hh"
+
+#include <boost/unordered_map.hpp>
+#include <string>
+#include <vector>
+
+namespace EUROPA {
+
+  /**
+   * @class TokenLayout
+   * @brief Holds what all tokens of one predicate have in common: the names of the predicate and its
+   * object type, the keys it is indexed under, and the position of each variable among the token's variables.
+   *
+   * Layouts are created by the Schema on first use and shared, so a token keeps a pointer rather than copies
+   * of the names.
+   * @see Schema::getTokenLayout, Token::getVariable
+   */
+  class TokenLayout {
+  public:
+    /**
+     * @brief The slot of a name with no variable.
+     */
+    static const unsigned int NO_SLOT;
+
+    TokenLayout(const std::string& predicateName,
+                const std::string& baseObjectType,
+                const std::vector<unsigned int>& predicateKeys);
+
+    const std::string& getPredicateName() const {return m_predicateName;}
+
+    const std::string& getUnqualifiedPredicateName() const {return m_unqualifiedPredicateName;}
+
+    const std::string& getBaseObjectType() const {return m_baseObjectType;}
+
+    const std::vector<unsigned int>& getPredicateKeys() const {return m_predicateKeys;}
+
+    /**
+     * @brief The position of the named variable among the variables of a token, or NO_SLOT if it isn't known.
+     * A token may still hold its variables elsewhere, so callers should check the name of the variable found.
+     */
+    unsigned int getSlot(const std::string& name) const;
+
+    /**
+     * @brief Record the positions of the variables of a completed token.  The first token to hold a variable
+     * of a given name decides its slot.
+     */
+    void addSlots(const std::vector<ConstrainedVariableId>& variables);
+
+  private:
+    typedef boost::unordered_map<std::string, unsigned int> SlotMap;
+
+    const std::string m_predicateName;
+    const std::string m_unqualifiedPredicateName;
+    const std::string m_baseObjectType;
+    const std::vector<unsigned int> m_predicateKeys; /*!< Fixed for the life of the layout, so removal from the active token index matches insertion */
+    SlotMap m_slots; /*!< Variable positions by name */
+  };
+
+}
+
+#endif
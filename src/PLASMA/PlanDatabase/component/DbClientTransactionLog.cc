@@ -262,11 +262,15 @@ void DbClientTransactionLog::notifyConstraintDeleted(const ConstraintId constrai
   }
 
   void DbClientTransactionLog::flush(std::ostream& os){
+    write(os);
+    cleanup(m_bufferedTransactions);
+  }
+
+  void DbClientTransactionLog::write(std::ostream& os) const {
     std::list<TiXmlElement*>::const_iterator iter;
     for (iter = m_bufferedTransactions.begin() ; iter != m_bufferedTransactions.end() ; iter++) {
       os << **iter << std::endl;
     }
-    cleanup(m_bufferedTransactions);
   }
 
   std::string
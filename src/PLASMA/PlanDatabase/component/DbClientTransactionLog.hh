@@ -53,6 +53,11 @@ namespace EUROPA {
      */
     void flush(std::ostream& os);
 
+    /**
+     * @brief Write all buffered transactions to an output stream, keeping the buffer.
+     */
+    void write(std::ostream& os) const;
+
   private:
     friend class DbClientTransactionPlayer;
     const std::list<TiXmlElement*>& getBufferedTransactions() const;
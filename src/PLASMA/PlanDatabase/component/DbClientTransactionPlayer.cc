@@ -15,6 +15,7 @@
 #include "CESchema.hh"
 
 #include <algorithm>
+#include <cctype>
 #include <iostream>
 #include <sstream>
 
@@ -140,6 +141,24 @@ CESchemaId DbClientTransactionPlayer::getCESchema() const {
     }
   }
 
+  void DbClientTransactionPlayer::play(const char* transactions) {
+    check_error(transactions != NULL, "Invalid buffer for playing transactions.");
+
+    const char* start = transactions;
+    while(isspace(*start))
+      ++start;
+    if(*start == '\0')
+      return;
+
+    // Parsing the whole buffer at once avoids the character at a time extraction of the stream version
+    TiXmlDocument doc;
+    doc.Parse(start);
+    checkRuntimeError(!doc.Error(), "Failed to parse transactions: " << doc.ErrorDesc());
+
+    for(const TiXmlElement* tx = doc.FirstChildElement(); tx != NULL; tx = tx->NextSiblingElement())
+      processTransaction(*tx);
+  }
+
   void DbClientTransactionPlayer::rewind(std::istream& is, bool breakpoint) {
     check_error(is, "Invalid input stream for playing transactions.");
     std::list<TiXmlElement*> transactions;
@@ -35,6 +35,12 @@ namespace EUROPA {
      */
     void play(const DbClientTransactionLogId txLog);
 
+    /**
+     * @brief Play all transactions from a buffer, e.g. a memory mapped file.
+     * @param transactions A null terminated sequence of xml-based transactions.
+     */
+    void play(const char* transactions);
+
     /**
      * @brief Play the inverses of transactions from an input stream.
      * @param is a stream of xml-based transactions
@@ -0,0 +1,129 @@
+#include "PlanDatabaseImage.hh"
+#include "PlanDatabase.hh"
+#include "Schema.hh"
+#include "ConstraintEngine.hh"
+#include "DbClient.hh"
+#include "DbClientTransactionLog.hh"
+#include "DbClientTransactionPlayer.hh"
+#include "Debug.hh"
+#include "Error.hh"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace EUROPA {
+
+  namespace {
+
+    struct Header {
+      Header() : magic(), version(0), modelHash(), length(0) {}
+
+      std::string magic;
+      unsigned int version;
+      std::string modelHash;
+      std::string::size_type length;
+    };
+
+    bool parseHeader(const std::string& line, Header& header) {
+      std::istringstream is(line);
+      return (is >> header.magic >> header.version >> header.modelHash >> header.length) &&
+          header.magic == PlanDatabaseImage::MAGIC();
+    }
+
+    /**
+     * @brief A read only mapping of a whole file, released on destruction.
+     */
+    class MappedFile {
+    public:
+      MappedFile(const std::string& fileName) : m_data(NULL), m_size(0) {
+        int fd = open(fileName.c_str(), O_RDONLY);
+        checkRuntimeError(fd >= 0, "Failed to open " << fileName << ": " << strerror(errno));
+        struct stat status;
+        if(fstat(fd, &status) == 0 && status.st_size > 0) {
+          m_size = static_cast<size_t>(status.st_size);
+          void* data = mmap(NULL, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+          if(data != MAP_FAILED)
+            m_data = static_cast<const char*>(data);
+        }
+        close(fd);
+        checkRuntimeError(m_data != NULL, "Failed to map " << fileName << ": " << strerror(errno));
+      }
+
+      ~MappedFile() {
+        munmap(const_cast<char*>(m_data), m_size);
+      }
+
+      const char* data() const {return m_data;}
+      size_t size() const {return m_size;}
+
+    private:
+      MappedFile(const MappedFile&);
+      MappedFile& operator=(const MappedFile&);
+
+      const char* m_data;
+      size_t m_size;
+    };
+  }
+
+  const std::string& PlanDatabaseImage::MAGIC() {
+    static const std::string sl_magic("EUROPA_PDB_IMAGE");
+    return sl_magic;
+  }
+
+  void PlanDatabaseImage::write(const PlanDatabaseId db, const DbClientTransactionLogId txLog, std::ostream& os) {
+    check_error(db.isValid());
+    check_error(txLog.isValid());
+
+    std::ostringstream transactions;
+    txLog->write(transactions);
+    const std::string payload = transactions.str();
+
+    os << MAGIC() << " " << VERSION << " " << db->getSchema()->getModelHash() << " " << payload.size() << "\n";
+    os << payload << '\0';
+    os.flush();
+  }
+
+  bool PlanDatabaseImage::isCompatible(const PlanDatabaseId db, const std::string& fileName) {
+    check_error(db.isValid());
+
+    std::ifstream is(fileName.c_str());
+    std::string line;
+    Header header;
+    return std::getline(is, line) && parseHeader(line, header) && header.version == VERSION &&
+        header.modelHash == db->getSchema()->getModelHash();
+  }
+
+  bool PlanDatabaseImage::restore(const PlanDatabaseId db, const std::string& fileName) {
+    check_error(db.isValid());
+
+    MappedFile file(fileName);
+    const char* end = static_cast<const char*>(memchr(file.data(), '\n', file.size()));
+    checkRuntimeError(end != NULL, fileName << " is not a plan database image.");
+
+    Header header;
+    checkRuntimeError(parseHeader(std::string(file.data(), end), header),
+                      fileName << " is not a plan database image.");
+    checkRuntimeError(header.version == VERSION,
+                      fileName << " has image version " << header.version << ", expected " << VERSION);
+    checkRuntimeError(header.modelHash == db->getSchema()->getModelHash(),
+                      fileName << " was built against a different model.");
+
+    const char* transactions = end + 1;
+    checkRuntimeError(static_cast<size_t>(transactions - file.data()) + header.length + 1 == file.size() &&
+                      transactions[header.length] == '\0',
+                      fileName << " is truncated or corrupt.");
+
+    debugMsg("PlanDatabaseImage:restore",
+             "Restoring " << header.length << " bytes of transactions from " << fileName);
+
+    DbClientTransactionPlayer player(db->getClient());
+    player.play(transactions);
+    return db->getConstraintEngine()->propagate();
+  }
+}
@@ -0,0 +1,60 @@
+#ifndef _H_PlanDatabaseImage
+#define _H_PlanDatabaseImage
+
+#include "PlanDatabaseDefs.hh"
+#include <iostream>
+#include <string>
+
+/**
+ * @file PlanDatabaseImage
+ * @brief Saving the transactions that built a plan database, and replaying them into another.
+ */
+
+namespace EUROPA {
+
+  /**
+   * @class PlanDatabaseImage
+   * @brief A file holding the transactions that built a plan database, tagged with the model it was built against.
+   *
+   * An image is a header line followed by the transactions and a terminating null character:
+   * @verbatim
+     EUROPA_PDB_IMAGE <version> <model hash> <length>\n<transactions>\0
+     @endverbatim
+   * An image is not a snapshot of the database, and is not used in place. On restore the file is
+   * memory mapped and handed to the transaction player, which parses it into an XML document and
+   * replays every transaction through the database client, then propagates. That skips the model
+   * interpreter and a copy of the file, but a restore takes as long as playing the log, so it grows
+   * with the number of entities. The model hash guards against restoring an image into a database
+   * with a different schema.
+   * @see Schema::getModelHash, DbClientTransactionLog, DbClientTransactionPlayer
+   */
+  class PlanDatabaseImage {
+  public:
+    /**
+     * @brief Write an image of the transactions logged so far.
+     * @param db The database the transactions were logged from. Provides the model hash.
+     * @param txLog A log attached to the database's client since it was created.
+     */
+    static void write(const PlanDatabaseId db, const DbClientTransactionLogId txLog, std::ostream& os);
+
+    /**
+     * @brief Test if the file is an image built against the model loaded in db.
+     */
+    static bool isCompatible(const PlanDatabaseId db, const std::string& fileName);
+
+    /**
+     * @brief Replay an image into db and propagate. The database's client must have transaction
+     * logging enabled, as for any transaction playback.
+     * @return The result of propagation.
+     */
+    static bool restore(const PlanDatabaseId db, const std::string& fileName);
+
+    static const std::string& MAGIC();
+    static const unsigned int VERSION = 1;
+
+  private:
+    PlanDatabaseImage(); /**< NO IMPL */
+  };
+}
+
+#endif
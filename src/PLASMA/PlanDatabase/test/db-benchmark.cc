@@ -0,0 +1,172 @@
+/**
+ * Times dynamic object creation against plans with many open object variables.
+ * Every object of a type that is still open is inserted into the object variable of each
+ * token of that type, so the cost per object grows with the number of tokens. Also times
+ * creating named global tokens and looking up their variables by name, and reports how many
+ * labels that adds. Not part of the unit tests; run db-benchmark by hand to compare changes
+ * to object insertion or to the token layout.
+ */
+
+#include "PlanDatabase.hh"
+#include "Schema.hh"
+#include "Object.hh"
+#include "ObjectType.hh"
+#include "TokenType.hh"
+#include "IntervalToken.hh"
+#include "TokenVariable.hh"
+#include "CESchema.hh"
+#include "DataTypes.hh"
+#include "Domains.hh"
+#include "Constraints.hh"
+#include "Engine.hh"
+#include "ModuleConstraintEngine.hh"
+#include "ModulePlanDatabase.hh"
+#include "LabelStr.hh"
+
+#include <ctime>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <boost/cast.hpp>
+
+using namespace EUROPA;
+
+namespace {
+const std::string BENCHMARK_OBJECT_TYPE = "BenchmarkObject";
+const std::string BENCHMARK_PREDICATE = "BenchmarkObject.holds";
+const unsigned int BENCHMARK_PARAMETERS = 8;
+
+std::string parameterName(const unsigned int i) {
+  std::stringstream name;
+  name << "p" << i;
+  return name.str();
+}
+
+class BenchmarkTokenType : public TokenType {
+public:
+  BenchmarkTokenType(const ObjectTypeId ot) : TokenType(ot, BENCHMARK_PREDICATE) {
+    for(unsigned int i = 0; i < BENCHMARK_PARAMETERS; i++)
+      addArg(FloatDT::instance(), parameterName(i));
+  }
+private:
+  TokenId createInstance(const PlanDatabaseId planDb, const std::string& name, bool rejectable, bool isFact) const {
+    return (new IntervalToken(planDb, name, rejectable, isFact))->getId();
+  }
+  TokenId createInstance(const TokenId master, const std::string& name, const std::string& relation) const {
+    return (new IntervalToken(master, relation, name))->getId();
+  }
+};
+
+class BenchmarkEngine : public EngineBase {
+public:
+  BenchmarkEngine() {
+    addModule((new ModuleConstraintEngine())->getId());
+    addModule((new ModuleConstraintLibrary())->getId());
+    addModule((new ModulePlanDatabase())->getId());
+    doStart();
+
+    const SchemaId schema = boost::polymorphic_cast<Schema*>(getComponent("Schema"))->getId();
+    ObjectType* objType = new ObjectType(BENCHMARK_OBJECT_TYPE, schema->getObjectType(Schema::rootObject()));
+    objType->addTokenType((new BenchmarkTokenType(objType->getId()))->getId());
+    schema->registerObjectType(objType->getId());
+
+    // Tokens require temporal distance constraints
+    CESchema* ces = boost::polymorphic_cast<CESchema*>(getComponent("CESchema"));
+    REGISTER_SYSTEM_CONSTRAINT(ces, AddEqualConstraint, "temporalDistance", "Default");
+  }
+  virtual ~BenchmarkEngine() {doShutdown();}
+
+  const PlanDatabaseId getPlanDatabase() const {
+    return boost::polymorphic_cast<const PlanDatabase*>(getComponent("PlanDatabase"))->getId();
+  }
+};
+
+double secondsSince(const std::clock_t start) {
+  return static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+}
+
+/**
+ * Creates tokenCount tokens with open object variables, then objectCount objects of their type,
+ * then deletes the tokens. Prints the time spent creating objects and deleting tokens.
+ */
+void runObjectCreation(const unsigned int tokenCount, const unsigned int objectCount) {
+  BenchmarkEngine engine;
+  const PlanDatabaseId db = engine.getPlanDatabase();
+
+  std::vector<TokenId> tokens;
+  for(unsigned int i = 0; i < tokenCount; i++)
+    tokens.push_back((new IntervalToken(db, BENCHMARK_PREDICATE, false, false))->getId());
+
+  std::clock_t start = std::clock();
+  for(unsigned int i = 0; i < objectCount; i++) {
+    std::stringstream name;
+    name << "object" << i;
+    new Object(db, BENCHMARK_OBJECT_TYPE, name.str());
+  }
+  const double creation = secondsSince(start);
+
+  start = std::clock();
+  for(std::vector<TokenId>::const_iterator it = tokens.begin(); it != tokens.end(); ++it)
+    delete static_cast<Token*>(*it);
+  const double deletion = secondsSince(start);
+
+  std::cout << tokenCount << " " << objectCount << " " << creation << " " << deletion << std::endl;
+}
+
+/**
+ * Creates tokenCount tokens with BENCHMARK_PARAMETERS parameters each, named as the plan
+ * database names global tokens, then looks up the start and last parameter of each by name
+ * lookupRounds times. Prints the time spent on each and the number of labels added while
+ * creating the tokens.
+ */
+void runTokenCreation(const unsigned int tokenCount, const unsigned int lookupRounds) {
+  BenchmarkEngine engine;
+  const PlanDatabaseId db = engine.getPlanDatabase();
+  new Object(db, BENCHMARK_OBJECT_TYPE, "object");
+
+  const unsigned long labels = LabelStr::getSize();
+  std::clock_t start = std::clock();
+  std::vector<TokenId> tokens;
+  for(unsigned int i = 0; i < tokenCount; i++) {
+    IntervalToken* token = new IntervalToken(db, BENCHMARK_PREDICATE, false, false, IntervalIntDomain(),
+                                             IntervalIntDomain(), IntervalIntDomain(1, PLUS_INFINITY),
+                                             Token::noObject(), false);
+    for(unsigned int j = 0; j < BENCHMARK_PARAMETERS; j++)
+      token->addParameter(IntervalDomain(), parameterName(j));
+    token->close();
+    std::stringstream name;
+    name << "globalToken_" << i;
+    token->setName(name.str());
+    tokens.push_back(token->getId());
+  }
+  const double creation = secondsSince(start);
+  const unsigned long labelsAdded = LabelStr::getSize() - labels;
+
+  const std::string names[] = {"start", parameterName(BENCHMARK_PARAMETERS - 1)};
+  unsigned long found = 0;
+  start = std::clock();
+  for(unsigned int round = 0; round < lookupRounds; round++)
+    for(std::vector<TokenId>::const_iterator it = tokens.begin(); it != tokens.end(); ++it)
+      for(unsigned int i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+        found += (*it)->getVariable(names[i], false).isId();
+  const double lookup = secondsSince(start);
+
+  std::cout << tokenCount << " " << creation << " " << lookup << " " << labelsAdded << std::endl;
+  if(found != tokenCount * lookupRounds * 2)
+    std::cout << "Only " << found << " variables found" << std::endl;
+}
+}
+
+int main(int, char**) {
+  std::cout << "tokens objects create(s) delete(s)" << std::endl;
+  for(unsigned int tokenCount = 250; tokenCount <= 4000; tokenCount *= 4)
+    for(unsigned int objectCount = 250; objectCount <= 4000; objectCount *= 4)
+      runObjectCreation(tokenCount, objectCount);
+
+  std::cout << "sizeof(IntervalToken) " << sizeof(IntervalToken) << std::endl;
+  std::cout << "tokens create(s) lookup(s) labels" << std::endl;
+  for(unsigned int tokenCount = 1000; tokenCount <= 64000; tokenCount *= 4)
+    runTokenCreation(tokenCount, 10);
+  return 0;
+}
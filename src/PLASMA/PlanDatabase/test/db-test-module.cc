@@ -13,6 +13,7 @@
 #include "HasAncestorConstraint.hh"
 #include "DbClientTransactionLog.hh"
 #include "DbClientTransactionPlayer.hh"
+#include "PlanDatabaseImage.hh"
 
 #include "DbClient.hh"
 #include "ObjectType.hh"
@@ -30,6 +31,7 @@
 
 #include "unused.hh"
 
+#include <fstream>
 #include <iostream>
 #include <sstream>
 #include <iomanip>
@@ -325,6 +327,7 @@ public:
     EUROPA_runTest(testObjectPredicateRelationships);
     EUROPA_runTest(testPredicateParameterAccessors);
     EUROPA_runTest(testTokenTypeAttributes);
+    EUROPA_runTest(testPredicateKeys);
 
     return(true);
   }
@@ -589,6 +592,34 @@ private:
     return true;
   }
 
+  static bool testPredicateKeys() {
+      DEFAULT_SETUP(ce, db, true);
+    schema->addObjectType("Foo");
+    schema->addPredicate("Foo.Argle");
+    schema->addObjectType("Bar", "Foo");
+    schema->addPredicate("Bar.Argle");
+    schema->addObjectType("Baz", "Bar");
+
+    // Ids are stable and distinct
+    unsigned int fooId = schema->getPredicateId("Foo.Argle");
+    unsigned int barId = schema->getPredicateId("Bar.Argle");
+    unsigned int bazId = schema->getPredicateId("Baz.Argle");
+    CPPUNIT_ASSERT(fooId != barId && barId != bazId && fooId != bazId);
+    CPPUNIT_ASSERT(schema->getPredicateId("Bar.Argle") == barId);
+
+    // A token is indexed under its predicate and the same predicate on every ancestor that has it
+    const std::vector<unsigned int>& fooKeys = schema->getPredicateKeys("Foo.Argle");
+    CPPUNIT_ASSERT(fooKeys.size() == 1 && fooKeys[0] == fooId);
+    const std::vector<unsigned int>& bazKeys = schema->getPredicateKeys("Baz.Argle");
+    CPPUNIT_ASSERT(bazKeys.size() == 3);
+    CPPUNIT_ASSERT(bazKeys[0] == bazId && bazKeys[1] == barId && bazKeys[2] == fooId);
+
+    schema->reset();
+    DEFAULT_TEARDOWN();
+
+    return true;
+  }
+
   static bool testTokenTypeAttributes() {
       DEFAULT_SETUP(ce, db, true);
       ObjectTypeId timelineOT = schema->getObjectType("Timeline");
@@ -649,8 +680,10 @@ public:
     EUROPA_runTest(testObjectDomain);
     EUROPA_runTest(testObjectVariables);
     EUROPA_runTest(testObjectTokenRelation);
+    EUROPA_runTest(testObjectTokenRelationRestrictions);
     EUROPA_runTest(testCommonAncestorConstraint);
     EUROPA_runTest(testHasAncestorConstraint);
+    EUROPA_runTest(testAncestorIndex);
     EUROPA_runTest(testMakeObjectVariable);
     EUROPA_runTest(testInterleavedDynamicObjetAndVariableCreation);
     EUROPA_runTest(testTokenObjectVariable);
@@ -820,6 +853,59 @@ private:
     return true;
   }
 
+  /**
+   * Objects are notified only when they enter or leave the object domain of an active token.
+   */
+  static bool testObjectTokenRelationRestrictions(){
+    DEFAULT_SETUP(ce, db, false);
+    std::vector<ObjectId> objects;
+    for(unsigned int i = 0; i < 5; i++){
+      std::stringstream name;
+      name << "O" << i;
+      objects.push_back((new Object(db->getId(), LabelStr(DEFAULT_OBJECT_TYPE), name.str()))->getId());
+    }
+    db->close();
+
+    EventToken eventToken(db->getId(), LabelStr(DEFAULT_PREDICATE), false, false, IntervalIntDomain(0, 10));
+    eventToken.activate();
+    ce->propagate();
+    for(unsigned int i = 0; i < objects.size(); i++)
+      CPPUNIT_ASSERT(objects[i]->tokens().size() == 1);
+
+    // Restrict the object variable to 2 of the objects
+    std::list<ObjectId> values;
+    values.push_back(objects[1]);
+    values.push_back(objects[3]);
+    Variable<ObjectDomain> restriction(ce, ObjectDomain(GET_DEFAULT_OBJECT_TYPE(ce), values));
+    ConstraintId constraint = ce->createConstraint("eq", makeScope(eventToken.getObject(), restriction.getId()));
+    ce->propagate();
+    for(unsigned int i = 0; i < objects.size(); i++)
+      CPPUNIT_ASSERT(objects[i]->tokens().size() == (i == 1 || i == 3 ? 1u : 0u));
+
+    // Restrict further to a singleton
+    eventToken.getObject()->specify(objects[3]->getKey());
+    ce->propagate();
+    for(unsigned int i = 0; i < objects.size(); i++)
+      CPPUNIT_ASSERT(objects[i]->tokens().size() == (i == 3 ? 1u : 0u));
+    CPPUNIT_ASSERT(objects[3]->hasToken(eventToken.getId()));
+
+    // Relax back to the full domain
+    eventToken.getObject()->reset();
+    delete static_cast<Constraint*>(constraint);
+    ce->propagate();
+    for(unsigned int i = 0; i < objects.size(); i++)
+      CPPUNIT_ASSERT(objects[i]->tokens().size() == 1);
+
+    // Deactivation removes the token from all objects
+    eventToken.cancel();
+    ce->propagate();
+    for(unsigned int i = 0; i < objects.size(); i++)
+      CPPUNIT_ASSERT(objects[i]->tokens().empty());
+
+    DEFAULT_TEARDOWN();
+    return true;
+  }
+
   static bool testCommonAncestorConstraint(){
       DEFAULT_SETUP(ce, db, false);
     Object o1(db->getId(), LabelStr(DEFAULT_OBJECT_TYPE), "o1");
@@ -1002,6 +1088,108 @@ private:
     DEFAULT_TEARDOWN();
     return true;
   }
+  /**
+   * Ancestor tests over a hierarchy which is both deep and wide, checked against getAncestors, then
+   * used to filter large domains through both ancestor constraints.
+   */
+  static bool testAncestorIndex(){
+    DEFAULT_SETUP(ce, db, false);
+    static const unsigned int DEPTH = 200;
+    static const unsigned int WIDTH = 500;
+
+    // A chain, with a wide fan of leaves under every tenth link
+    std::vector<ObjectId> chain;
+    std::vector<ObjectId> leaves;
+    chain.push_back((new Object(db, LabelStr(DEFAULT_OBJECT_TYPE), "root"))->getId());
+    for(unsigned int i = 1; i < DEPTH; i++){
+      std::stringstream name;
+      name << "c" << i;
+      chain.push_back((new Object(chain.back(), LabelStr(DEFAULT_OBJECT_TYPE), name.str()))->getId());
+      if(i % 10 == 0){
+        for(unsigned int j = 0; j < WIDTH / 10; j++){
+          std::stringstream leafName;
+          leafName << "l" << j;
+          leaves.push_back((new Object(chain.back(), LabelStr(DEFAULT_OBJECT_TYPE), leafName.str()))->getId());
+        }
+      }
+    }
+    ObjectId other = (new Object(db, LabelStr(DEFAULT_OBJECT_TYPE), "other"))->getId();
+
+    for(unsigned int i = 0; i < DEPTH; i++){
+      CPPUNIT_ASSERT(chain[i]->getDepth() == i);
+      CPPUNIT_ASSERT(chain[i]->getAncestor(i) == chain[i]);
+      CPPUNIT_ASSERT(!chain[i]->hasAncestor(chain[i]));
+      CPPUNIT_ASSERT(!chain[i]->hasAncestor(other));
+      CPPUNIT_ASSERT(chain[i]->getIndex() < db->getObjectIndexLimit());
+    }
+    for(unsigned int i = 0; i < leaves.size(); i += 7){
+      std::list<ObjectId> ancestors;
+      leaves[i]->getAncestors(ancestors);
+      CPPUNIT_ASSERT(ancestors.size() == leaves[i]->getDepth());
+      CPPUNIT_ASSERT(ancestors.front() == leaves[i]->getParent());
+      for(unsigned int j = 0; j < DEPTH; j++)
+        CPPUNIT_ASSERT(leaves[i]->hasAncestor(chain[j]) ==
+                       (std::find(ancestors.begin(), ancestors.end(), chain[j]) != ancestors.end()));
+    }
+
+    ObjectDomain allLeaves(GET_DEFAULT_OBJECT_TYPE(ce));
+    for(unsigned int i = 0; i < leaves.size(); i++)
+      allLeaves.insert(leaves[i]->getKey());
+    allLeaves.close();
+
+    // Only the leaves hanging below the middle of the chain descend from it
+    {
+      Variable<ObjectDomain> first(ce, allLeaves);
+      Variable<ObjectDomain> restrictions(ce, ObjectDomain(GET_DEFAULT_OBJECT_TYPE(ce), chain[DEPTH / 2]));
+      HasAncestorConstraint constraint("hasAncestor", "Default", ce,
+                                       makeScope(first.getId(), restrictions.getId()));
+      CPPUNIT_ASSERT(ce->propagate());
+      CPPUNIT_ASSERT(first.getDerivedDomain().getSize() == (DEPTH / 2 / 10) * (WIDTH / 10));
+    }
+
+    // Restricted to the lower chain, a leaf near the top has no common ancestor with any leaf,
+    // and a leaf near the bottom has one with the leaves below the middle
+    ObjectDomain lowerChain(GET_DEFAULT_OBJECT_TYPE(ce));
+    for(unsigned int i = DEPTH / 2; i < DEPTH; i++)
+      lowerChain.insert(chain[i]->getKey());
+    lowerChain.close();
+    {
+      Variable<ObjectDomain> first(ce, ObjectDomain(GET_DEFAULT_OBJECT_TYPE(ce), leaves.front()));
+      Variable<ObjectDomain> second(ce, allLeaves);
+      Variable<ObjectDomain> restrictions(ce, lowerChain);
+      CommonAncestorConstraint constraint("commonAncestor", "Default", ce,
+                                          makeScope(first.getId(), second.getId(), restrictions.getId()));
+      CPPUNIT_ASSERT(!ce->propagate());
+    }
+    {
+      Variable<ObjectDomain> first(ce, ObjectDomain(GET_DEFAULT_OBJECT_TYPE(ce), leaves.back()));
+      Variable<ObjectDomain> second(ce, allLeaves);
+      Variable<ObjectDomain> restrictions(ce, lowerChain);
+      CommonAncestorConstraint constraint("commonAncestor", "Default", ce,
+                                          makeScope(first.getId(), second.getId(), restrictions.getId()));
+      CPPUNIT_ASSERT(ce->propagate());
+      CPPUNIT_ASSERT(second.getDerivedDomain().getSize() == (DEPTH / 2 / 10) * (WIDTH / 10));
+    }
+
+    // Reparenting a subtree updates the ancestry of everything below it
+    ObjectId subtree = (new Object(db, LabelStr(DEFAULT_OBJECT_TYPE), "subtree"))->getId();
+    ObjectId child = (new Object(subtree, LabelStr(DEFAULT_OBJECT_TYPE), "child"))->getId();
+    subtree->setParent(other);
+    CPPUNIT_ASSERT(child->getDepth() == 2);
+    CPPUNIT_ASSERT(child->hasAncestor(other));
+
+    // Indices of deleted objects are reused
+    const unsigned int limit = db->getObjectIndexLimit();
+    const unsigned int index = child->getIndex();
+    delete static_cast<Object*>(child);
+    child = (new Object(subtree, LabelStr(DEFAULT_OBJECT_TYPE), "child"))->getId();
+    CPPUNIT_ASSERT(child->getIndex() == index);
+    CPPUNIT_ASSERT(db->getObjectIndexLimit() == limit);
+
+    DEFAULT_TEARDOWN();
+    return true;
+  }
+
   /**
    * The most basic case for dynamic objects is that we can populate the variable correctly
    * and synchronize its values.
@@ -1174,6 +1362,7 @@ public:
     EUROPA_runTest(testKeepingCommittedTokensInActiveSet);
     EUROPA_runTest(testBasicTokenAllocation);
     EUROPA_runTest(testBasicTokenCreation);
+    EUROPA_runTest(testTokenLayout);
     EUROPA_runTest(testStateModel);
     EUROPA_runTest(testMasterSlaveRelationship);
     EUROPA_runTest(testTermination);
@@ -1270,6 +1459,58 @@ private:
     return true;
   }
 
+  /**
+   * Tokens of a predicate share one layout, which places their variables by name. A token whose variables
+   * are placed differently still finds them.
+   */
+  static bool testTokenLayout() {
+    DEFAULT_SETUP(ce, db, false);
+    unused(ObjectId timeline) = (new Timeline(db, LabelStr(DEFAULT_OBJECT_TYPE), "o2"))->getId();
+    db->close();
+
+    IntervalToken t0(db, LabelStr(DEFAULT_PREDICATE), true, false, IntervalIntDomain(0, 1000),
+                     IntervalIntDomain(0, 1000), IntervalIntDomain(2, 10), Token::noObject(), false);
+    t0.addParameter(IntervalDomain(-1.08, 20.18), "IntervalParam");
+    t0.close();
+    IntervalToken t1(db, LabelStr(DEFAULT_PREDICATE), true, false, IntervalIntDomain(0, 1000),
+                     IntervalIntDomain(0, 1000), IntervalIntDomain(2, 10), Token::noObject(), false);
+    t1.addParameter(IntervalDomain(-1.08, 20.18), "IntervalParam");
+    t1.close();
+
+    CPPUNIT_ASSERT(&t0.getLayout() == &t1.getLayout());
+    CPPUNIT_ASSERT(&t0.getLayout() == db->getSchema()->getTokenLayout(DEFAULT_PREDICATE));
+    CPPUNIT_ASSERT(t0.getPredicateName() == DEFAULT_PREDICATE);
+    CPPUNIT_ASSERT(t0.getBaseObjectType() == DEFAULT_OBJECT_TYPE);
+    const unsigned int slot = t0.getLayout().getSlot("IntervalParam");
+    CPPUNIT_ASSERT(slot < t0.getVariables().size());
+    CPPUNIT_ASSERT(t0.getVariables()[slot] == t0.parameters().front());
+    CPPUNIT_ASSERT(t1.getVariable("IntervalParam") == t1.parameters().front());
+    CPPUNIT_ASSERT(t1.getVariable("start") == t1.start());
+    CPPUNIT_ASSERT(t1.getVariable("NoSuchVariable", false).isNoId());
+
+    // Names are kept only by the tokens given one
+    CPPUNIT_ASSERT(t1.getName() == DEFAULT_PREDICATE);
+    const unsigned long labels = LabelStr::getSize();
+    t1.setName("testTokenLayoutName");
+    CPPUNIT_ASSERT(t1.getName() == "testTokenLayoutName");
+    CPPUNIT_ASSERT(LabelStr::getSize() == labels);
+    CPPUNIT_ASSERT(t0.getName() == DEFAULT_PREDICATE);
+
+    EventToken eventToken(db, LabelStr(DEFAULT_PREDICATE), true, false, IntervalIntDomain(0, 1000),
+                          Token::noObject(), false);
+    std::list<edouble> values;
+    values.push_back(EUROPA::LabelStr("L1"));
+    eventToken.addParameter(LabelSet(values), "LabelSetParam");
+    eventToken.addParameter(IntervalDomain(-1.08, 20.18), "IntervalParam");
+    eventToken.close();
+    CPPUNIT_ASSERT(&eventToken.getLayout() == &t0.getLayout());
+    CPPUNIT_ASSERT(eventToken.getVariable("IntervalParam") == eventToken.parameters().back());
+    CPPUNIT_ASSERT(eventToken.getVariable("LabelSetParam") == eventToken.parameters().front());
+
+    DEFAULT_TEARDOWN();
+    return true;
+  }
+
   static bool testStateModel(){
       DEFAULT_SETUP(ce, db, false);
       unused(ObjectId timeline) = (new Timeline(db, LabelStr(DEFAULT_OBJECT_TYPE), "o2"))->getId();
@@ -3872,6 +4113,8 @@ public:
     EUROPA_runTest(testBasicAllocation);
     EUROPA_runTest(testPathBasedRetrieval);
     EUROPA_runTest(testGlobalVariables);
+    EUROPA_runTest(testReset);
+    EUROPA_runTest(testImage);
     return true;
   }
 private:
@@ -4027,6 +4270,105 @@ private:
     DEFAULT_TEARDOWN();
     return true;
   }
+
+  static bool testReset(){
+    DEFAULT_SETUP(ce, db, false);
+    DbClientId client = db->getClient();
+
+    // Populate, close and solve a first problem
+    ObjectId foo1 = client->createObject(LabelStr(DEFAULT_OBJECT_TYPE).c_str(), "foo1");
+    new Object(foo1, LabelStr(DEFAULT_OBJECT_TYPE), "child");
+    client->createVariable(IntDT::NAME().c_str(), "v1");
+    db->close();
+    TokenId token = client->createToken(LabelStr(DEFAULT_PREDICATE).c_str());
+    token->activate();
+    CPPUNIT_ASSERT(client->propagate());
+    CPPUNIT_ASSERT(db->isClosed());
+
+    db->reset();
+    CPPUNIT_ASSERT(db->getState() == PlanDatabase::OPEN);
+    CPPUNIT_ASSERT(db->getObjects().empty());
+    CPPUNIT_ASSERT(db->getTokens().empty());
+    CPPUNIT_ASSERT(db->getGlobalVariables().empty());
+    CPPUNIT_ASSERT(!db->isGlobalVariable("v1"));
+    CPPUNIT_ASSERT(db->getSchema()->isObjectType(DEFAULT_OBJECT_TYPE));
+
+    // The same names can be used again for a second problem
+    ObjectId foo2 = client->createObject(LabelStr(DEFAULT_OBJECT_TYPE).c_str(), "foo1");
+    client->createVariable(IntDT::NAME().c_str(), "v1");
+    CPPUNIT_ASSERT(db->getObject("foo1") == foo2);
+    CPPUNIT_ASSERT(db->isGlobalVariable("v1"));
+    db->close();
+    token = client->createToken(LabelStr(DEFAULT_PREDICATE).c_str());
+    token->activate();
+    CPPUNIT_ASSERT(client->propagate());
+    CPPUNIT_ASSERT(token->getObject()->lastDomain().isSingleton());
+
+    DEFAULT_TEARDOWN();
+    return true;
+  }
+
+  /**
+   * Removes a file when it goes out of scope, so a failed assertion doesn't leave it behind.
+   */
+  class FileRemover {
+  public:
+    FileRemover(const std::string& fileName) : m_fileName(fileName) {}
+    ~FileRemover() {remove(m_fileName.c_str());}
+  private:
+    const std::string m_fileName;
+  };
+
+  static bool testImage(){
+    const std::string fileName("PlanDatabaseImage.img");
+    FileRemover remover(fileName);
+    std::string modelHash;
+    std::string plan;
+
+    // Build and save a state
+    {
+      PDBTestEngine testEngine;
+      PlanDatabaseId db = testEngine.getPlanDatabase();
+      DbClientId client = db->getClient();
+      client->enableTransactionLogging();
+      DbClientTransactionLog* txLog = new DbClientTransactionLog(client);
+
+      client->createObject(LabelStr(DEFAULT_OBJECT_TYPE).c_str(), "foo1");
+      db->close();
+      TokenId token = client->createToken(LabelStr(DEFAULT_PREDICATE).c_str());
+      client->activate(token);
+      client->createConstraint("eq", makeScope(token->start(), token->duration()));
+      CPPUNIT_ASSERT(client->propagate());
+
+      modelHash = db->getSchema()->getModelHash();
+      plan = PlanDatabaseWriter::toString(db, false);
+      std::ofstream os(fileName.c_str(), std::ios::binary);
+      PlanDatabaseImage::write(db, txLog->getId(), os);
+      delete txLog;
+    }
+
+    // Restore it into a database with the same model
+    {
+      PDBTestEngine testEngine;
+      PlanDatabaseId db = testEngine.getPlanDatabase();
+      db->getClient()->enableTransactionLogging();
+      CPPUNIT_ASSERT(db->getSchema()->getModelHash() == modelHash);
+      CPPUNIT_ASSERT(PlanDatabaseImage::isCompatible(db, fileName));
+
+      CPPUNIT_ASSERT(PlanDatabaseImage::restore(db, fileName));
+      CPPUNIT_ASSERT(db->isClosed());
+      CPPUNIT_ASSERT(db->getObject("foo1").isValid());
+      CPPUNIT_ASSERT(db->getTokens().size() == 1);
+      CPPUNIT_ASSERT((*db->getTokens().begin())->isActive());
+      CPPUNIT_ASSERT_MESSAGE(PlanDatabaseWriter::toString(db, false), PlanDatabaseWriter::toString(db, false) == plan);
+
+      // Any change to the model invalidates the image
+      db->getSchema()->addObjectType("ImageTestType");
+      CPPUNIT_ASSERT(db->getSchema()->getModelHash() != modelHash);
+      CPPUNIT_ASSERT(!PlanDatabaseImage::isCompatible(db, fileName));
+    }
+    return true;
+  }
 };
 
 /**
@@ -5,6 +5,7 @@
 #include "InterpreterResources.hh"
 #include "ResourceMatching.hh"
 #include "ResourceThreatDecisionPoint.hh"
+#include "ResourceBoundDecisionPoint.hh"
 #include "ProfilePropagator.hh"
 #include "FlowProfile.hh"
 #include "IncrementalFlowProfile.hh"
@@ -18,6 +19,7 @@
 #include "ResourceThreatManager.hh"
 #include "Reusable.hh"
 #include "BoostFlowProfile.hh"
+#include "ResidualFlowProfile.hh"
 #include "CESchema.hh"
 
 #include <boost/cast.hpp>
@@ -45,7 +47,8 @@ namespace EUROPA {
 void ModuleResource::initialize(EngineId engine) {
   ConstraintEngine* ce = boost::polymorphic_cast<ConstraintEngine*>(engine->getComponent("ConstraintEngine"));
   Schema* schema = boost::polymorphic_cast<Schema*>(engine->getComponent("Schema"));
-  new ProfilePropagator("Resource", ce->getId());
+  ProfilePropagator* propagator = new ProfilePropagator("Resource", ce->getId());
+  propagator->setBalancePropagation(engine->getConfig()->getProperty("Resource.balancePropagation") == "true");
 
   ObjectTypeId objectOT = schema->getObjectType(Schema::rootObject());
   ObjectType* ot;
@@ -108,6 +111,8 @@ void ModuleResource::initialize(EngineId engine) {
   REGISTER_PROFILE(pfm,TimetableProfile, TimetableProfile );
   REGISTER_PROFILE(pfm, BoostFlowProfile, FlowProfile);
   REGISTER_PROFILE(pfm, BoostFlowProfile, IncrementalFlowProfile);
+  REGISTER_PROFILE(pfm, DinicFlowProfile, DinicFlowProfile);
+  REGISTER_PROFILE(pfm, BKFlowProfile, BKFlowProfile);
   // REGISTER_PROFILE(pfm,FlowProfile, FlowProfile);
   // REGISTER_PROFILE(pfm,IncrementalFlowProfile, IncrementalFlowProfile );
   REGISTER_PROFILE(pfm,GroundedProfile, GroundedProfile );
@@ -123,6 +128,7 @@ void ModuleResource::initialize(EngineId engine) {
       boost::polymorphic_cast<SOLVERS::ComponentFactoryMgr*>(engine->getComponent("ComponentFactoryMgr"));
   REGISTER_FLAW_MANAGER(cfm,ResourceThreatManager, ResourceThreatManager);
   REGISTER_FLAW_HANDLER(cfm,ResourceThreatDecisionPoint, ResourceThreatHandler);
+  REGISTER_FLAW_HANDLER(cfm,ResourceBoundDecisionPoint, ResourceBoundHandler);
   //      REGISTER_FLAW_HANDLER(cfm,SOLVERS::ResourceThreatDecisionPoint, ResourceThreat);
 
   SOLVERS::MatchFinderMgr* mfm =
@@ -10,6 +10,17 @@ namespace EUROPA {
     class Transaction;
     typedef Id<Transaction> TransactionId;
 
+    /**
+     * @brief Orders transactions by the keys of their time and quantity variables, so that
+     * iteration over them doesn't depend on where they were allocated.
+     */
+    class TransactionKeyComparator {
+    public:
+      bool operator()(const TransactionId& t1, const TransactionId& t2) const;
+    };
+
+    typedef std::set<TransactionId, TransactionKeyComparator> TransactionSet;
+
     class Profile;
     typedef Id<Profile> ProfileId;
 
@@ -21,6 +32,7 @@ namespace EUROPA {
 
     class Instant;
     typedef Id<Instant> InstantId;
+    typedef std::set<InstantId, EntityComparator<InstantId> > InstantSet;
 
     class FVDetector;
     typedef Id<FVDetector> FVDetectorId;
@@ -40,7 +52,9 @@ namespace EUROPA {
     class ResourceTokenRelation;
     typedef Id<ResourceTokenRelation> ResourceTokenRelationId;
 
-    typedef std::map<TokenId, std::set<InstantId> > ResourceFlaws;
+    class ProfilePropagator;
+
+    typedef std::map<TokenId, InstantSet, EntityComparator<TokenId> > ResourceFlaws;
 }
 
 #endif
@@ -61,6 +61,16 @@ namespace EUROPA {
       virtual PSResourceProfile* getFDLevelProfile() = 0;
       virtual PSResourceProfile* getVDLevelProfile() = 0;
 
+      /**
+       * @brief Get bounds on how far transactions not yet in the profile could still move the level,
+       * under the same assumptions used to detect violations.
+       * @param minProduction The least total production of the transactions in the profile.
+       * @param minConsumption The least total consumption of the transactions in the profile.
+       * @return false if the detector can't bound it, in which case the level can't be reasoned about.
+       * @see Reservoir::tightenTransactions
+       */
+      virtual bool getUnplannedLevelChange(const edouble, const edouble, edouble&, edouble&) const {return false;}
+
     protected:
       friend class Profile;
 
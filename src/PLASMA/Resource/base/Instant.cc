@@ -3,6 +3,8 @@
 #include "Profile.hh"
 #include "ConstrainedVariable.hh"
 
+#include <algorithm>
+
 namespace EUROPA {
 Instant::Instant(const eint time, const ProfileId prof)
     : Entity(), m_id(this), m_time(time), m_profile(prof), m_lowerLevel(0), m_lowerLevelMax(0), m_upperLevelMin(0), m_upperLevel(0),
@@ -10,7 +12,10 @@ Instant::Instant(const eint time, const ProfileId prof)
       m_maxCumulativeProduction(0), m_maxCumulativeConsumption(0), m_minCumulativeProduction(0), m_minCumulativeConsumption(0),
       m_maxPrevProduction(0), m_maxPrevConsumption(0), m_minPrevProduction(0), m_minPrevConsumption(0),
   m_upperFlawMagnitude(0), m_lowerFlawMagnitude(0),
+  m_productionRateFlawMagnitude(0), m_consumptionRateFlawMagnitude(0),
+  m_productionSumFlawMagnitude(0), m_consumptionSumFlawMagnitude(0),
   m_violated(false), m_flawed(false), m_upperFlaw(false), m_lowerFlaw(false),
+  m_productionRateFlaw(false), m_consumptionRateFlaw(false), m_productionSumFlaw(false), m_consumptionSumFlaw(false),
   m_transactions(), m_endingTransactions(), m_startingTransactions() {}
 
     Instant::~Instant() {
@@ -19,9 +24,9 @@ Instant::Instant(const eint time, const ProfileId prof)
 
     eint Instant::getTime() const {return m_time;}
 
-    const std::set<TransactionId>& Instant::getTransactions() const {return m_transactions;}
-    const std::set<TransactionId>& Instant::getEndingTransactions() const {return m_endingTransactions;}
-    const std::set<TransactionId>& Instant::getStartingTransactions() const {return m_startingTransactions;}
+    const TransactionSet& Instant::getTransactions() const {return m_transactions;}
+    const TransactionSet& Instant::getEndingTransactions() const {return m_endingTransactions;}
+    const TransactionSet& Instant::getStartingTransactions() const {return m_startingTransactions;}
 
     void Instant::addTransaction(const TransactionId t) {
       checkError(m_transactions.find(t) == m_transactions.end(), "Instant for time " << m_time << " already has transaction " << t);
@@ -61,6 +66,19 @@ Instant::Instant(const eint time, const ProfileId prof)
       m_startingTransactions.erase(t);
     }
 
+    edouble Instant::getQuantityFlawMagnitude() const {
+      edouble retval = 0;
+      if(m_productionRateFlaw)
+        retval = std::max(retval, m_productionRateFlawMagnitude);
+      if(m_consumptionRateFlaw)
+        retval = std::max(retval, m_consumptionRateFlawMagnitude);
+      if(m_productionSumFlaw)
+        retval = std::max(retval, m_productionSumFlawMagnitude);
+      if(m_consumptionSumFlaw)
+        retval = std::max(retval, m_consumptionSumFlawMagnitude);
+      return retval;
+    }
+
     edouble Instant::getLowerLevel() {return m_lowerLevel;}
     edouble Instant::getLowerLevelMax() {return m_lowerLevelMax;}
     edouble Instant::getUpperLevelMin() {return m_upperLevelMin;}
@@ -102,7 +120,7 @@ Instant::Instant(const eint time, const ProfileId prof)
 
     bool Instant::containsStartOrEnd() {
       bool retval = false;
-      for(std::set<TransactionId>::const_iterator it = m_transactions.begin(); it != m_transactions.end(); ++it) {
+      for(TransactionSet::const_iterator it = m_transactions.begin(); it != m_transactions.end(); ++it) {
         TransactionId trans = *it;
         if(trans->time()->lastDomain().getLowerBound() == m_time || trans->time()->lastDomain().getUpperBound() == m_time) {
           retval = true;
@@ -120,7 +138,7 @@ Instant::Instant(const eint time, const ProfileId prof)
 
     std::string Instant::toString() const {
       std::stringstream sstr;
-      for(std::set<TransactionId>::const_iterator it = m_transactions.begin(); it != m_transactions.end(); ++it)
+      for(TransactionSet::const_iterator it = m_transactions.begin(); it != m_transactions.end(); ++it)
         sstr << " " << m_time << ": " << (*it) << " " << (*it)->time()->toString() << " " << (*it)->quantity()->toString() <<
           ((*it)->isConsumer() ? " (C)" : " (P)") << std::endl;
       return sstr.str();
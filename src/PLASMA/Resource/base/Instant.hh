@@ -42,25 +42,25 @@ namespace EUROPA {
        * @brief Get the complete set of transactions that overlap this Instant.
        * @return A const ref to the set of transactions.
        */
-      const std::set<TransactionId>& getTransactions() const;
+      const TransactionSet& getTransactions() const;
 
       /**
        * @brief Get the set of transactions whose latest time is equal to this instant.
        * @return A const ref to the set of transactions.
        */
-      const std::set<TransactionId>& getEndingTransactions() const;
+      const TransactionSet& getEndingTransactions() const;
 
       /**
        * @brief Get the set of transactions whose earliest time is equal to this instant.
        * @return A const ref to the set of transactions.
        */
-      const std::set<TransactionId>& getStartingTransactions() const;
+      const TransactionSet& getStartingTransactions() const;
 
       /**
        * @brief Get the set of transactions whose time overlaps this instant.
        * @return A const ref to the set of transactions.
        */
-      const std::set<TransactionId>& getOverlappingTransactions() const;
+      const TransactionSet& getOverlappingTransactions() const;
 
       /**
        * @brief Gets the lower level of the profile at this instant.  May cause profile recalculation.
@@ -180,7 +180,15 @@ namespace EUROPA {
        * @brief Set the flaw status of this instant.
        * @param flawed True if there is a flaw, false otherwise.
        */
-      void setFlawed(const bool flawed) {m_flawed = flawed;  if(!flawed) {m_upperFlaw = false; m_lowerFlaw = false; m_upperFlawMagnitude = 0; m_lowerFlawMagnitude = 0;}}
+      void setFlawed(const bool flawed) {
+        m_flawed = flawed;
+        if(!flawed) {
+          m_upperFlaw = false; m_lowerFlaw = false; m_upperFlawMagnitude = 0; m_lowerFlawMagnitude = 0;
+          m_productionRateFlaw = false; m_consumptionRateFlaw = false; m_productionSumFlaw = false; m_consumptionSumFlaw = false;
+          m_productionRateFlawMagnitude = 0; m_consumptionRateFlawMagnitude = 0;
+          m_productionSumFlawMagnitude = 0; m_consumptionSumFlawMagnitude = 0;
+        }
+      }
 
       void setUpper(const bool upperFlaw) {m_upperFlaw = upperFlaw;}
 
@@ -198,6 +206,60 @@ namespace EUROPA {
 
       edouble getLowerFlawMagnitude() const {return m_lowerFlawMagnitude;}
 
+      /**
+       * @brief Flags for production and consumption that may exceed the resource's limits, either in this
+       * instant alone (rate) or in total up to and including it (sum).  The magnitude is the amount by which
+       * the limit may be exceeded.
+       */
+      void setProductionRate(const bool flaw) {m_productionRateFlaw = flaw;}
+
+      void setConsumptionRate(const bool flaw) {m_consumptionRateFlaw = flaw;}
+
+      void setProductionSum(const bool flaw) {m_productionSumFlaw = flaw;}
+
+      void setConsumptionSum(const bool flaw) {m_consumptionSumFlaw = flaw;}
+
+      void setProductionRateMagnitude(const edouble m) {check_error(m_productionRateFlaw); m_productionRateFlawMagnitude = m;}
+
+      void setConsumptionRateMagnitude(const edouble m) {check_error(m_consumptionRateFlaw); m_consumptionRateFlawMagnitude = m;}
+
+      void setProductionSumMagnitude(const edouble m) {check_error(m_productionSumFlaw); m_productionSumFlawMagnitude = m;}
+
+      void setConsumptionSumMagnitude(const edouble m) {check_error(m_consumptionSumFlaw); m_consumptionSumFlawMagnitude = m;}
+
+      bool hasProductionRateFlaw() const {return m_productionRateFlaw;}
+
+      bool hasConsumptionRateFlaw() const {return m_consumptionRateFlaw;}
+
+      bool hasProductionSumFlaw() const {return m_productionSumFlaw;}
+
+      bool hasConsumptionSumFlaw() const {return m_consumptionSumFlaw;}
+
+      edouble getProductionRateFlawMagnitude() const {return m_productionRateFlawMagnitude;}
+
+      edouble getConsumptionRateFlawMagnitude() const {return m_consumptionRateFlawMagnitude;}
+
+      edouble getProductionSumFlawMagnitude() const {return m_productionSumFlawMagnitude;}
+
+      edouble getConsumptionSumFlawMagnitude() const {return m_consumptionSumFlawMagnitude;}
+
+      /**
+       * @brief True if either level may be outside the limits.
+       */
+      bool hasLevelFlaw() const {return m_upperFlaw || m_lowerFlaw;}
+
+      /**
+       * @brief True if production or consumption may exceed a rate or sum limit.
+       */
+      bool hasQuantityFlaw() const {
+        return m_productionRateFlaw || m_consumptionRateFlaw || m_productionSumFlaw || m_consumptionSumFlaw;
+      }
+
+      /**
+       * @brief The greatest magnitude among the production and consumption flaws, or 0 if there are none.
+       */
+      edouble getQuantityFlawMagnitude() const;
+
       /**
        * @brief Set the violation status of this instant.
        * @param violated True if there is a violation, false otherwise.
@@ -253,10 +315,13 @@ namespace EUROPA {
       edouble m_maxCumulativeProduction, m_maxCumulativeConsumption, m_minCumulativeProduction, m_minCumulativeConsumption; /**< The bounds around cumulative consumption and production */
       edouble m_maxPrevProduction, m_maxPrevConsumption, m_minPrevProduction, m_minPrevConsumption; /**< The bounds on consumption and production necessarily before this instant*/
       edouble m_upperFlawMagnitude, m_lowerFlawMagnitude; /**< The magnitude of the differences between the levels and the limits */
+      edouble m_productionRateFlawMagnitude, m_consumptionRateFlawMagnitude; /**< The amounts by which the instantaneous limits may be exceeded */
+      edouble m_productionSumFlawMagnitude, m_consumptionSumFlawMagnitude; /**< The amounts by which the cumulative limits may be exceeded */
       bool m_violated, m_flawed, m_upperFlaw, m_lowerFlaw; /**< Flaw and violation flags */
-      std::set<TransactionId> m_transactions; /**< The complete set of transactions */
-      std::set<TransactionId> m_endingTransactions; /**< The set of transactions whose upper bound is equal to the current time. */
-      std::set<TransactionId> m_startingTransactions; /**< The set of transactions whose lower bound is equal to the current time. */
+      bool m_productionRateFlaw, m_consumptionRateFlaw, m_productionSumFlaw, m_consumptionSumFlaw; /**< Production and consumption flaw flags */
+      TransactionSet m_transactions; /**< The complete set of transactions */
+      TransactionSet m_endingTransactions; /**< The set of transactions whose upper bound is equal to the current time. */
+      TransactionSet m_startingTransactions; /**< The set of transactions whose lower bound is equal to the current time. */
     };
 }
 
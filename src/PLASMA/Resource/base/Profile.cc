@@ -15,6 +15,8 @@ namespace EUROPA {
 
 Profile::Profile(const PlanDatabaseId db, const FVDetectorId flawDetector)
     : FactoryObj(),
+      m_tightenedVariables(),
+      m_tighteningUndone(),
       m_id(this)
     , m_changeCount(0)
     , m_needsRecompute(false)
@@ -156,6 +158,7 @@ void Profile::removeTransaction(const TransactionId t) {
 
   m_transactions.erase(t);
   m_transactionsByTime.erase(t->time());
+  removeTightenedVariables(t);
 
   //remove the listeners
   checkError(m_variableListeners.find(t) != m_variableListeners.end(),
@@ -464,6 +467,7 @@ void Profile::handleTemporalConstraintRemoved(const TransactionId, const unsigne
       */
 
 void Profile::handleTransactionVariableDeletion(const TransactionId t){
+  removeTightenedVariables(t);
   std::map<TransactionId, ConstrainedVariableListenerId>::iterator listIt =
       m_otherListeners.find(t);
   checkError(listIt != m_otherListeners.end(),
@@ -670,7 +674,7 @@ void Profile::addInstantsForBounds(const TransactionId t) {
       InstantId inst = (new Instant(time, m_id))->getId();
       m_instants.insert(std::pair<eint, InstantId>(time, inst));
 
-      for(std::set<TransactionId>::const_iterator it = m_transactions.begin(); it != m_transactions.end(); ++it) {
+      for(TransactionSet::const_iterator it = m_transactions.begin(); it != m_transactions.end(); ++it) {
         TransactionId trans = *it;
         check_error(trans.isValid());
         check_error(trans->time().isValid());
@@ -717,6 +721,9 @@ bool Profile::VariableListener::canIgnore(const ConstrainedVariableId variable,
       check_error(variable.isValid(), toString());
       check_error(m_profile.isValid(), toString());
       check_error(m_trans.isValid(), toString());
+      // Only note the relaxation here; the relaxation in progress may be iterating over the tracked variables
+      if(changeType == DomainListener::RELAXED || changeType == DomainListener::OPENED)
+        m_profile->markTighteningUndone(variable);
       if(m_isQuantity) {
         debugMsg("Profile:VariableListener", "Notifying profile " << m_profile << " of change to quantity variable " << variable->toString());
         m_profile->transactionQuantityChanged(m_trans, changeType);
@@ -728,6 +735,62 @@ bool Profile::VariableListener::canIgnore(const ConstrainedVariableId variable,
       return false;
     }
 
+const std::vector<ConstrainedVariableId>&
+Profile::VariableListener::getModifiedVariables(const ConstrainedVariableId) const {
+  return m_profile->m_tightenedVariables;
+}
+
+const std::vector<ConstrainedVariableId>& Profile::VariableListener::getModifiedVariables() const {
+  return m_profile->m_tightenedVariables;
+}
+
+void Profile::addTightenedVariable(const ConstrainedVariableId var) {
+  std::vector<ConstrainedVariableId>::iterator it =
+      std::find(m_tightenedVariables.begin(), m_tightenedVariables.end(), var);
+  if(it == m_tightenedVariables.end()) {
+    m_tightenedVariables.push_back(var);
+    m_tighteningUndone.push_back(false);
+  }
+  else
+    m_tighteningUndone[it - m_tightenedVariables.begin()] = false;
+}
+
+void Profile::removeTightenedVariables(const TransactionId t) {
+  unsigned int kept = 0;
+  for(unsigned int i = 0; i < m_tightenedVariables.size(); i++) {
+    if(m_tightenedVariables[i] == t->time() || m_tightenedVariables[i] == t->quantity())
+      continue;
+    m_tightenedVariables[kept] = m_tightenedVariables[i];
+    m_tighteningUndone[kept] = m_tighteningUndone[i];
+    kept++;
+  }
+  m_tightenedVariables.resize(kept);
+  m_tighteningUndone.resize(kept);
+}
+
+void Profile::markTighteningUndone(const ConstrainedVariableId var) {
+  std::vector<ConstrainedVariableId>::iterator it =
+      std::find(m_tightenedVariables.begin(), m_tightenedVariables.end(), var);
+  if(it != m_tightenedVariables.end())
+    m_tighteningUndone[it - m_tightenedVariables.begin()] = true;
+}
+
+void Profile::pruneTightenedVariables() {
+  unsigned int kept = 0;
+  for(unsigned int i = 0; i < m_tightenedVariables.size(); i++) {
+    if(m_tighteningUndone[i]) {
+      debugMsg("Profile:pruneTightenedVariables",
+               "Restriction of " << m_tightenedVariables[i]->toString() << " was undone");
+      continue;
+    }
+    m_tightenedVariables[kept] = m_tightenedVariables[i];
+    m_tighteningUndone[kept] = m_tighteningUndone[i];
+    kept++;
+  }
+  m_tightenedVariables.resize(kept);
+  m_tighteningUndone.resize(kept);
+}
+
     Profile::ConstraintAdditionListener::ConstraintAdditionListener(const ConstrainedVariableId var, TransactionId tid, ProfileId profile)
       : ConstrainedVariableListener(var), m_profile(profile), m_tid(tid) {}
 
@@ -67,7 +67,7 @@ class Profile : public FactoryObj {
   /**
    * @brief Get all the transactions in the profile.
    */
-  const std::set<TransactionId>& getAllTransactions() const {return m_transactions;}
+  const TransactionSet& getAllTransactions() const {return m_transactions;}
 
   /**
    * @brief Gets the bounds of the profile at a given point in time. Calling this method may cause recalculation.
@@ -109,6 +109,11 @@ class Profile : public FactoryObj {
       
   InstantId getInstant(const eint time) const;
 
+  /**
+   * @brief The transaction variables currently restricted by the ProfilePropagator.
+   */
+  const std::vector<ConstrainedVariableId>& getTightenedVariables() const {return m_tightenedVariables;}
+
  private:
   friend class ProfilePropagator;
   friend class ProfileIterator;
@@ -133,6 +138,14 @@ class Profile : public FactoryObj {
       return sl_const;
     }
     ProfileId getProfile() const {return m_profile;}
+
+    /**
+     * @brief Variables restricted by balance propagation depend on every transaction in the profile,
+     * so relaxing this one relaxes them all.
+     * @see ProfilePropagator::restrict
+     */
+    const std::vector<ConstrainedVariableId>& getModifiedVariables(const ConstrainedVariableId variable) const;
+    const std::vector<ConstrainedVariableId>& getModifiedVariables() const;
    private:
     bool canIgnore(const ConstrainedVariableId variable,
                    unsigned int argIndex,
@@ -181,6 +194,30 @@ class Profile : public FactoryObj {
 
   bool hasConstraint(const ConstraintId constr) const;
 
+  /**
+   * @brief Record a transaction variable restricted by the ProfilePropagator.
+   */
+  void addTightenedVariable(const ConstrainedVariableId var);
+
+  /**
+   * @brief Stop tracking the transaction's variables as restricted.
+   */
+  void removeTightenedVariables(const TransactionId t);
+
+  /**
+   * @brief Note that a relaxation undid the restriction of a tracked variable.
+   */
+  void markTighteningUndone(const ConstrainedVariableId var);
+
+  /**
+   * @brief Stop tracking variables whose restriction has been undone. Must not be called during
+   * relaxation, which iterates over m_tightenedVariables.
+   */
+  void pruneTightenedVariables();
+
+  std::vector<ConstrainedVariableId> m_tightenedVariables; /**< Variables restricted by the ProfilePropagator. */
+  std::vector<bool> m_tighteningUndone; /**< Whether each variable's restriction has been relaxed away. */
+
  protected:
   ProfileId m_id;
   unsigned int m_changeCount; /**< The number of times that the profile has changed.  Used to detect stale iterators.*/
@@ -188,7 +225,7 @@ class Profile : public FactoryObj {
   unsigned int m_constraintKeyLb; /**< The lower bound on the constraint key when searching for new constraints. */
   PlanDatabaseId m_planDatabase; /**< The plan database.  Used for creating the variable listeners. */
   FVDetectorId m_detector; /**< The flaw and violation detector. */
-  std::set<TransactionId> m_transactions; /**< The set of Transactions that impact this profile. */
+  TransactionSet m_transactions; /**< The set of Transactions that impact this profile. */
   std::multimap<TransactionId, ConstraintId> m_variableListeners; /**< The listeners on the Transactions. */
   std::map<TransactionId, ConstrainedVariableListenerId> m_otherListeners;
   std::map<ConstrainedVariableId, TransactionId> m_transactionsByTime;
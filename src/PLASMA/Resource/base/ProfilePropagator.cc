@@ -3,6 +3,7 @@
 #include "Constraint.hh"
 #include "ConstraintEngine.hh"
 #include "Debug.hh"
+#include "Resource.hh"
 #include "ResourceTokenRelation.hh"
 
 namespace EUROPA {
@@ -11,9 +12,11 @@ namespace EUROPA {
 					 const ConstraintEngineId constraintEngine)
     : DefaultPropagator(name, constraintEngine)
     , m_profiles()
+    , m_knownProfiles()
     , m_newConstraints()
     , m_updateRequired(false)
     , m_inBatchMode(false)
+    , m_balancePropagation(false)
     , m_batchListener(NULL)
     {
     }
@@ -68,7 +71,7 @@ namespace EUROPA {
 
       m_activeConstraint = 0;
 
-      for(std::set<ConstraintId>::const_iterator it = m_newConstraints.begin(); it != m_newConstraints.end(); ++it) {
+      for(ConstraintSet::const_iterator it = m_newConstraints.begin(); it != m_newConstraints.end(); ++it) {
     	  ConstraintId constraint = *it;
     	  check_error(constraint.isValid());
     	  check_error(Id<Profile::VariableListener>::convertable(constraint));
@@ -78,10 +81,11 @@ namespace EUROPA {
     	  check_error(listener != NULL);
     	  check_error(listener->getProfile().isValid());
     	  debugMsg("ProfilePropagator:execute", "Adding profile " << listener->getProfile());
-    	  m_profiles.insert(listener->getProfile());
+    	  if(m_knownProfiles.insert(listener->getProfile()).second)
+    	    m_profiles.push_back(listener->getProfile());
       }
 
-      for(std::set<ProfileId>::iterator it = m_profiles.begin(); it != m_profiles.end(); ++it) {
+      for(std::vector<ProfileId>::iterator it = m_profiles.begin(); it != m_profiles.end(); ++it) {
     	  ProfileId profile = *it;
     	  check_error(profile.isValid());
     	  if( !getConstraintEngine()->provenInconsistent()
@@ -94,6 +98,10 @@ namespace EUROPA {
                          "ProfilePropagator:execute", 
                          "Recomputing profile " << profile);
             profile->recompute();
+            profile->pruneTightenedVariables();
+            if(m_balancePropagation && !getConstraintEngine()->provenInconsistent() &&
+               profile->getResource().isId())
+              profile->getResource()->tightenTransactions(*this);
     	  }
       }
 
@@ -110,6 +118,20 @@ void ProfilePropagator::execute(const ConstraintId constraint) {
   }
 }
 
+void ProfilePropagator::restrict(const ProfileId profile, const ConstrainedVariableId var,
+                                 const edouble lb, const edouble ub) {
+  check_error(profile.isValid());
+  check_error(var.isValid());
+  Domain& dom = getCurrentDomain(var);
+  if(dom.getLowerBound() >= lb && dom.getUpperBound() <= ub)
+    return;
+
+  debugMsg("ProfilePropagator:restrict",
+           "Restricting " << var->toString() << " to [" << lb << ", " << ub << "]");
+  profile->addTightenedVariable(var);
+  dom.intersect(lb, ub);
+}
+
     bool ProfilePropagator::updateRequired() const {
       return DefaultPropagator::updateRequired() || m_updateRequired;
     }
@@ -152,8 +174,8 @@ void ProfilePropagator::enterBatchMode() {
 
   debugMsg("ProfilePropagator:BatchMode", "Entering Batch Mode");
 
-  const std::set<ConstraintId>& constraints = getConstraints();
-  std::set<ConstraintId>::const_iterator it;
+  const ConstraintSet& constraints = getConstraints();
+  ConstraintSet::const_iterator it;
   for(it=constraints.begin();it != constraints.end(); ++it) {
     if ((*it)->getName() == ResourceTokenRelation::CONSTRAINT_NAME()) {
       ResourceTokenRelation* c = id_cast<ResourceTokenRelation>(*it);
@@ -181,8 +203,8 @@ void ProfilePropagator::exitBatchMode() {
 
   enable();
 
-  const std::set<ConstraintId>& constraints = getConstraints();
-  std::set<ConstraintId>::const_iterator it;
+  const ConstraintSet& constraints = getConstraints();
+  ConstraintSet::const_iterator it;
   for(it=constraints.begin();it != constraints.end(); ++it) {
     if ((*it)->getName() == ResourceTokenRelation::CONSTRAINT_NAME()) {
       ResourceTokenRelation* c = id_cast<ResourceTokenRelation>(*it);
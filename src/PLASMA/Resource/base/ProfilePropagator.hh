@@ -22,6 +22,20 @@ private:
   virtual void exitBatchMode();
   virtual bool inBatchMode() const { return m_inBatchMode; }
 
+  /**
+   * @brief Enable resource specific tightening of transaction variables after each profile
+   * recomputation. Off by default; set from the Resource.balancePropagation property.
+   * @see Resource::tightenTransactions
+   */
+  void setBalancePropagation(const bool enabled) {m_balancePropagation = enabled;}
+  bool getBalancePropagation() const {return m_balancePropagation;}
+
+  /**
+   * @brief Restrict a transaction variable of the profile to [lb, ub]. The variable is recorded
+   * with the profile so that relaxing any of its transactions also relaxes it.
+   */
+  void restrict(const ProfileId profile, const ConstrainedVariableId var, const edouble lb, const edouble ub);
+
  protected:
   friend class Profile;
   void setUpdateRequired(const bool update) {m_updateRequired = update;}
@@ -32,10 +46,12 @@ private:
   void handleConstraintAdded(const ConstraintId constraint);
   void handleConstraintRemoved(const ConstraintId constraint);
 
-  std::set<ProfileId> m_profiles;
-  std::set<ConstraintId> m_newConstraints;
+  std::vector<ProfileId> m_profiles; /*!< In the order first seen, so that profiles are recomputed in the same order every run */
+  std::set<ProfileId> m_knownProfiles; /*!< The members of m_profiles */
+  ConstraintSet m_newConstraints;
   bool m_updateRequired;
   bool m_inBatchMode;
+  bool m_balancePropagation;
   ConstraintEngineListener* m_batchListener;
 };
 }
@@ -72,7 +72,7 @@ Resource::Resource(const ObjectId parent, const std::string& type,
       m_maxProduction(), m_maxConsumption() {}
 
 Resource::~Resource() {
-  for(std::map<TransactionId, TokenId>::const_iterator it = m_transactionsToTokens.begin();
+  for(std::map<TransactionId, TokenId, TransactionKeyComparator>::const_iterator it = m_transactionsToTokens.begin();
       it != m_transactionsToTokens.end(); ++it) {
     if ((it->first->getOwner()).isNoId() || (it->first->getOwner() == getId()))
       delete static_cast<Transaction*>(it->first);
@@ -173,7 +173,7 @@ void Resource::init(const edouble initCapacityLb, const edouble initCapacityUb,
 
   void Resource::removeFromProfile(const TokenId tok) {
     debugMsg("Resource:removeFromProfile", "Removing " << tok->toString());
-    std::map<TokenId, std::set<InstantId> >::iterator it = m_flawedTokens.find(tok);
+    ResourceFlaws::iterator it = m_flawedTokens.find(tok);
     if(it != m_flawedTokens.end()) {
       m_flawedTokens.erase(it);
       notifyOrderingNoLongerRequired(tok);
@@ -199,7 +199,7 @@ void Resource::init(const edouble initCapacityLb, const edouble initCapacityUb,
       return;
     }
 
-    std::multimap<TokenId, TokenId> pairs;
+    std::multimap<TokenId, TokenId, EntityComparator<TokenId> > pairs;
     std::map<eint, InstantId>::iterator first = m_flawedInstants.lower_bound(token->start()->lastDomain().getLowerBound());
     if(first == m_flawedInstants.end()) {
       debugMsg("Resource:getOrderingChoices", "No ordering choices:  no flawed instants after token start: " << token->start()->lastDomain().getLowerBound());
@@ -221,8 +221,8 @@ void Resource::init(const edouble initCapacityLb, const edouble initCapacityUb,
     for(; first != last && count < limit; ++first) {
       debugMsg("Resource:getOrderingChoices", "Generating orderings for time " << first->second->getTime());
 
-      const std::set<TransactionId>& transactions = first->second->getTransactions();
-      for(std::set<TransactionId>::const_iterator it = transactions.begin(); it != transactions.end() && count < limit; ++it) {
+      const TransactionSet& transactions = first->second->getTransactions();
+      for(TransactionSet::const_iterator it = transactions.begin(); it != transactions.end() && count < limit; ++it) {
         TransactionId predecessor = *it;
         check_error(predecessor.isValid());
         check_error(m_transactionsToTokens.find(predecessor) != m_transactionsToTokens.end());
@@ -232,7 +232,7 @@ void Resource::init(const edouble initCapacityLb, const edouble initCapacityUb,
         TokenId predecessorToken = m_transactionsToTokens.find(predecessor)->second;
         check_error(predecessorToken.isValid());
 
-        for(std::set<TransactionId>::const_iterator subIt = transactions.begin(); subIt != transactions.end() && count < limit; ++subIt) {
+        for(TransactionSet::const_iterator subIt = transactions.begin(); subIt != transactions.end() && count < limit; ++subIt) {
           if(subIt == it)
             continue;
 
@@ -256,7 +256,7 @@ void Resource::init(const edouble initCapacityLb, const edouble initCapacityUb,
                    "Considering order <" << predecessorToken->getPredicateName() << "(" << predecessorToken->getKey() << "), " <<
                    successorToken->getPredicateName() << "(" << successorToken->getKey() << ")>");
 
-          std::multimap<TokenId, TokenId>::iterator checkFirst = pairs.lower_bound(predecessorToken);
+          std::multimap<TokenId, TokenId, EntityComparator<TokenId> >::iterator checkFirst = pairs.lower_bound(predecessorToken);
           //if we have an entry for the predecessor
           if(checkFirst != pairs.end() && checkFirst->first == predecessorToken) {
             bool foundPair = false;
@@ -284,7 +284,7 @@ void Resource::init(const edouble initCapacityLb, const edouble initCapacityUb,
         }
       }
     }
-    for(std::multimap<TokenId, TokenId>::iterator it = pairs.begin(); it != pairs.end(); ++it)
+    for(std::multimap<TokenId, TokenId, EntityComparator<TokenId> >::iterator it = pairs.begin(); it != pairs.end(); ++it)
       results.push_back(*it);
     debugMsg("Resource:getOrderingChoices", "Ultimately found " << results.size() << " orderings.");
   }
@@ -300,7 +300,7 @@ void Resource::init(const edouble initCapacityLb, const edouble initCapacityUb,
 
   TokenId Resource::getTokenForTransaction(TransactionId t)
   {
-    std::map<TransactionId, TokenId>::iterator transIt = m_transactionsToTokens.find(t);
+    std::map<TransactionId, TokenId, TransactionKeyComparator>::iterator transIt = m_transactionsToTokens.find(t);
     check_error(transIt != m_transactionsToTokens.end());
     TokenId tok = transIt->second;
     check_error(tok.isValid());
@@ -312,8 +312,8 @@ void Resource::init(const edouble initCapacityLb, const edouble initCapacityUb,
   {
     ResourceTokenRelationId retval = ResourceTokenRelationId::noId();
 
-    const std::set<ConstraintId>& constraints = tok->getStandardConstraints();
-    std::set<ConstraintId>::const_iterator constIt = constraints.begin();
+    const ConstraintSet& constraints = tok->getStandardConstraints();
+    ConstraintSet::const_iterator constIt = constraints.begin();
     for(;constIt != constraints.end();++constIt) {
       ConstraintId c = *constIt;
       if (c->getName() == ResourceTokenRelation::CONSTRAINT_NAME())
@@ -368,14 +368,14 @@ void Resource::resetViolations(InstantId ) {
     check_error(inst->isViolated());
     check_error(!inst->getTransactions().empty());
 
-    const std::set<TransactionId>& txns = inst->getTransactions();
+    const TransactionSet& txns = inst->getTransactions();
     TransactionId txn = *(txns.begin());
     ConstraintEngineId ce = txn->quantity()->getConstraintEngine();
 
     debugMsg("Resource:notifyViolated", "Received notification of violation at time " << inst->getTime());
 
     if (ce->getAllowViolations()) { // TODO: move this test to the constraint?
-      std::set<TransactionId>::const_iterator it = txns.begin();
+      TransactionSet::const_iterator it = txns.begin();
       for(;it != txns.end(); ++it) {
         txn = *it;
         TokenId tok = getTokenForTransaction(txn);
@@ -399,8 +399,8 @@ void Resource::resetViolations(InstantId ) {
   void Resource::notifyNoLongerViolated(const InstantId inst)
   {
     // remove all constraints associated with the instant from violated list
-    const std::set<TransactionId>& txns = inst->getTransactions();
-    std::set<TransactionId>::const_iterator it = txns.begin();
+    const TransactionSet& txns = inst->getTransactions();
+    TransactionSet::const_iterator it = txns.begin();
     for(;it != txns.end(); ++it) {
       TransactionId txn = *it;
       TokenId tok = getTokenForTransaction(txn);
@@ -428,7 +428,7 @@ void Resource::resetViolations(InstantId ) {
         it != transactions.end(); ++it) {
       TransactionId trans = *it;
       check_error(trans.isValid());
-      std::map<TransactionId, TokenId>::iterator transIt = m_transactionsToTokens.find(trans);
+      std::map<TransactionId, TokenId, TransactionKeyComparator>::iterator transIt = m_transactionsToTokens.find(trans);
       check_error(transIt != m_transactionsToTokens.end());
       TokenId tok = transIt->second;
 
@@ -446,7 +446,7 @@ void Resource::resetViolations(InstantId ) {
         debugMsg("Resource:notifyFlawed", 
                  toString() << " Token " << tok->getPredicateName() << "(" << tok->getKey() << ") is flawed at instant " << inst->getTime() <<
                  ".  Notifying that an ordering is required.");
-        m_flawedTokens.insert(std::pair<TokenId, std::set<InstantId> >(tok, std::set<InstantId>()));
+        m_flawedTokens.insert(std::make_pair(tok, InstantSet()));
         flawIt = m_flawedTokens.find(tok);
         flawIt->second.insert(inst);
         notifyOrderingRequired(tok);
@@ -478,7 +478,7 @@ void Resource::resetViolations(InstantId ) {
     debugMsg("Resource:notifyNoLongerFlawed", toString() << " Removing instant " << inst->getTime() << " from the set of flawed instants.");
     m_flawedInstants.erase(inst->getTime());
 
-    std::set<TokenId> flawlessTokens;
+    TokenSet flawlessTokens;
 
     for(ResourceFlaws::iterator tokIt = m_flawedTokens.begin(); tokIt != m_flawedTokens.end(); ++tokIt) {
       TokenId tok = tokIt->first;
@@ -492,7 +492,7 @@ void Resource::resetViolations(InstantId ) {
                    "(" << tok->getKey() << ")");
       if(size > tokIt->second.size() && !tokIt->second.empty()) {
         std::stringstream str;
-        for(std::set<InstantId>::const_iterator it = tokIt->second.begin(); it != tokIt->second.end(); ++it)
+        for(InstantSet::const_iterator it = tokIt->second.begin(); it != tokIt->second.end(); ++it)
           str << (*it)->getTime() << " ";
         debugMsg("Resource:notifyNoLongerFlawed", toString() << " Remaining flaws for token " << tok->getPredicateName() <<
                  "(" << tok->getKey() << "): " << str.str());
@@ -501,7 +501,7 @@ void Resource::resetViolations(InstantId ) {
         flawlessTokens.insert(tokIt->first);
     }
 
-    for(std::set<TokenId>::const_iterator it = flawlessTokens.begin(); it != flawlessTokens.end(); ++it) {
+    for(TokenSet::const_iterator it = flawlessTokens.begin(); it != flawlessTokens.end(); ++it) {
       TokenId tok = *it;
       check_error(tok.isValid());
       debugMsg("Resource:notifyNoLongerFlawed", toString() << " Notifying that the token " << tok->getPredicateName() << "(" <<
@@ -558,17 +558,17 @@ void Resource::getOrderingChoices(const InstantId inst,
     return;
   }
 
-  const std::set<TransactionId>& transactions = inst->getTransactions();
+  const TransactionSet& transactions = inst->getTransactions();
   unsigned int count = 0;
   TemporalAdvisorId temporalAdvisor = getPlanDatabase()->getTemporalAdvisor();
   std::set<std::pair<TransactionId, TransactionId> > uniquePairs;
 
-  for(std::set<TransactionId>::const_iterator preIt = transactions.begin(); preIt != transactions.end() && count < limit; ++preIt) {
+  for(TransactionSet::const_iterator preIt = transactions.begin(); preIt != transactions.end() && count < limit; ++preIt) {
     TransactionId predecessor = *preIt;
     check_error(predecessor.isValid());
-    //for(std::set<TransactionId>::const_iterator sucIt = transactions.begin(); sucIt != transactions.end() && count < limit; ++sucIt) {
+    //for(TransactionSet::const_iterator sucIt = transactions.begin(); sucIt != transactions.end() && count < limit; ++sucIt) {
     std::vector<ConstrainedVariableId> sucTimevars;
-    for(std::map<TransactionId, TokenId>::const_iterator sucIt = m_transactionsToTokens.begin(); sucIt != m_transactionsToTokens.end() && count < limit; ++sucIt) {
+    for(std::map<TransactionId, TokenId, TransactionKeyComparator>::const_iterator sucIt = m_transactionsToTokens.begin(); sucIt != m_transactionsToTokens.end() && count < limit; ++sucIt) {
       TransactionId successor = sucIt->first;
       check_error(successor.isValid());
       sucTimevars.push_back(TimeVarId(successor->time()));
@@ -579,7 +579,7 @@ void Resource::getOrderingChoices(const InstantId inst,
                                               sucTimevars, presucLbs, presucUbs);
     unsigned int i = 0;
 
-    for(std::map<TransactionId, TokenId>::const_iterator sucIt = m_transactionsToTokens.begin(); sucIt != m_transactionsToTokens.end() && count < limit; ++sucIt) {
+    for(std::map<TransactionId, TokenId, TransactionKeyComparator>::const_iterator sucIt = m_transactionsToTokens.begin(); sucIt != m_transactionsToTokens.end() && count < limit; ++sucIt) {
       TransactionId successor = sucIt->first;
       check_error(successor.isValid());
 
@@ -186,6 +186,14 @@ namespace EUROPA {
 
       virtual PSList<PSEntityKey> getOrderingChoices(TimePoint t);
 
+      /**
+       * @brief Tighten the time and quantity variables of transactions in the profile beyond what
+       * the profile's levels imply.  Called by the propagator after the profile is recomputed, when
+       * enabled.  The default does nothing.
+       * @see ProfilePropagator::setBalancePropagation
+       */
+      virtual void tightenTransactions(ProfilePropagator&) {}
+
     protected:
       friend class FVDetector;
       /**
@@ -251,8 +259,8 @@ namespace EUROPA {
       ExplicitProfileId m_capacityProfile; /**< The capacity profile for this resource. */
       ExplicitProfileId m_limitProfile; /**< The limit profile for this resource. */
       ProfileId m_profile; /**< The usage profile for this resource. */
-      std::map<TransactionId, TokenId> m_transactionsToTokens;
-      std::map<TokenId, std::set<InstantId> > m_flawedTokens;
+      std::map<TransactionId, TokenId, TransactionKeyComparator> m_transactionsToTokens;
+      ResourceFlaws m_flawedTokens;
       std::map<eint, InstantId> m_flawedInstants;
       edouble m_maxInstProduction, m_maxInstConsumption; /**< The maximum production and consumption allowed at an instant */
       edouble m_maxProduction, m_maxConsumption; /**< The maximum production and consumption allowed over the lifetime of the resource */
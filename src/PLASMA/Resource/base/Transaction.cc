@@ -16,11 +16,24 @@ Transaction::Transaction(ConstrainedVariableId _time, ConstrainedVariableId _qua
     , m_time(_time)
     , m_quantity(_quantity)
     , m_isConsumer(_isConsumer)
-    , m_owner(owner) {
+    , m_owner(owner)
+    , m_timeKey(_time->getKey())
+    , m_quantityKey(_quantity->getKey()) {
   checkRuntimeError(_quantity->lastDomain().getLowerBound() >= 0.0,
                     "All transactions require positive quantity variables.");
 }
 
+bool TransactionKeyComparator::operator()(const TransactionId& t1, const TransactionId& t2) const {
+  checkError(t1.isValid(), t1);
+  checkError(t2.isValid(), t2);
+  if(t1->m_timeKey != t2->m_timeKey)
+    return t1->m_timeKey < t2->m_timeKey;
+  if(t1->m_quantityKey != t2->m_quantityKey)
+    return t1->m_quantityKey < t2->m_quantityKey;
+  // Only transactions sharing both their variables get here
+  return t1 < t2;
+}
+
       Transaction::~Transaction()
       {
           m_id.remove();
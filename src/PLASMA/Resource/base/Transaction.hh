@@ -57,6 +57,10 @@ namespace EUROPA {
       ConstrainedVariableId m_time, m_quantity; /**< The variables for the time and amount of the transaction */
       bool m_isConsumer; /**< The flag indicating whether this transaction consumes or produces some amount of resource */
       EntityId m_owner;
+
+    private:
+      friend class TransactionKeyComparator;
+      eint m_timeKey, m_quantityKey; /**< Kept for ordering, since the variables may go before the transaction does */
     };
 }
 #endif
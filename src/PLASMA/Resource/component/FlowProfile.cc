@@ -94,7 +94,7 @@ bool FlowProfile::getEarliestLowerLevelInstant(const TransactionId t, InstantId&
             m_instants.lower_bound(t->time()->lastDomain().getLowerBound());
         start != end; ++start) {
       InstantId inst = start->second;
-      for(std::set<TransactionId>::const_iterator it = 
+      for(TransactionSet::const_iterator it = 
               inst->getTransactions().begin();
           it != inst->getTransactions().end(); ++it) {
         if((*it)->isConsumer()) {
@@ -130,7 +130,7 @@ bool FlowProfile::getEarliestUpperLevelInstant(const TransactionId t, InstantId&
             m_instants.lower_bound(t->time()->lastDomain().getLowerBound());
         start != end; ++start) {
       InstantId inst = start->second;
-      for(std::set<TransactionId>::const_iterator it = 
+      for(TransactionSet::const_iterator it = 
               inst->getTransactions().begin();
           it != inst->getTransactions().end(); ++it) {
         if(!(*it)->isConsumer()) {
@@ -161,7 +161,7 @@ void FlowProfile::initRecompute(InstantId inst) {
   m_lowerClosedLevel = getInitCapacityLb();
   m_upperClosedLevel = getInitCapacityUb();
   
-  for(std::set<TransactionId>::const_iterator it = m_transactions.begin(); 
+  for(TransactionSet::const_iterator it = m_transactions.begin(); 
       it != m_transactions.end(); ++it) {
     if((*it)->time()->lastDomain().getUpperBound() < inst->getTime()) {
       m_upperClosedLevel = m_upperClosedLevel + 
@@ -211,10 +211,10 @@ void FlowProfile::recomputeLevels(InstantId prev, InstantId inst) {
            << m_lowerClosedLevel << ","
            << m_upperClosedLevel << "]");
 
-  const std::set<TransactionId>& transactions = inst->getTransactions();
+  const TransactionSet& transactions = inst->getTransactions();
 
-  std::set<TransactionId>::const_iterator iter = transactions.begin();
-  std::set<TransactionId>::const_iterator end = transactions.end();
+  TransactionSet::const_iterator iter = transactions.begin();
+  TransactionSet::const_iterator end = transactions.end();
 
   for( ; iter != end; ++iter )
   {
@@ -259,7 +259,7 @@ void FlowProfile::recomputeLevels(InstantId prev, InstantId inst) {
       // {
         enableTransaction( transaction1, inst );
 
-        std::set<TransactionId>::const_iterator secondIter = transactions.begin();
+        TransactionSet::const_iterator secondIter = transactions.begin();
 
         for( ; secondIter != end; ++secondIter )
         {
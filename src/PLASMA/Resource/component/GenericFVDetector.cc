@@ -47,49 +47,39 @@ GenericFVDetector::GenericFVDetector(const ResourceId res)
     	}
     	return getResourceLevelViolation(inst);
     }
-    /* Reporting these flaws is new, and is not fully supported.  To get full functionality, we need:
-     *
-     * 1) To implement the ?? methods as is done for ??={Lower,Upper}and used in the handleResourceLevelFlaws subclass methods.
-     *    The variables set in that case are used by the threat manager so that one can decide to prefer one type of flaw
-     *    over another, or to order flaws by magnitude.
-     *
-     * 2) To handle these flaws differently.  A flaw could be resolved by either bounding consumption/production variables OR
-     *    by adding an action (I think) and current flaw handling will simply try rescheduling things, which could easily not
-     *    help.  We probably need a specialized DecisionPoint.
-     *
-     * Alternatives to full functionality:
-     * a) Ignore these flaws (currently we cannot filter flaws based on type, but we may in the future)
-     * b) Be conservative and report flaws as violations.
-     *
+    /* Production and consumption that may exceed the instantaneous or cumulative limits are flagged on the
+     * instant along with the amount of the excess, so that the threat manager can filter and order them
+     * like level flaws.  They are best resolved by bounding the quantities of the contributing transactions
+     * (see ResourceBoundDecisionPoint) since reordering cannot reduce a sum.
      */
     void GenericFVDetector::handleResourceFlaws(const InstantId inst)
     {
     	if (inst->getMaxCumulativeConsumption() > m_maxCumulativeConsumption)
     	{
     		inst->setFlawed(true);
-//       		inst->set??(true);
-//       		inst->set??Magnitude(std::abs(m_maxCumulativeConsumption - inst->getMaxCumulativeConsumption()));
+    		inst->setConsumptionSum(true);
+    		inst->setConsumptionSumMagnitude(inst->getMaxCumulativeConsumption() - m_maxCumulativeConsumption);
        		debugMsg("GenericFVDetector:detect", "Cumulative consumption flaw.");
     	}
     	if (inst->getMaxCumulativeProduction() > m_maxCumulativeProduction)
     	{
     		inst->setFlawed(true);
-//       		inst->set??(true);
-//       		inst->set??Magnitude(std::abs(m_maxCumulativeProduction - inst->getMaxCumulativeProduction()));
+    		inst->setProductionSum(true);
+    		inst->setProductionSumMagnitude(inst->getMaxCumulativeProduction() - m_maxCumulativeProduction);
        		debugMsg("GenericFVDetector:detect", "Cumulative production flaw.");
     	}
     	if (inst->getMaxInstantConsumption() > m_maxInstConsumption)
     	{
     		inst->setFlawed(true);
-//       		inst->set??(true);
-//       		inst->set??Magnitude(std::abs(m_maxInstConsumption - inst->getMaxInstantConsumption()));
+    		inst->setConsumptionRate(true);
+    		inst->setConsumptionRateMagnitude(inst->getMaxInstantConsumption() - m_maxInstConsumption);
        		debugMsg("GenericFVDetector:detect", "Instantaneous consumption flaw.");
     	}
     	if (inst->getMaxInstantProduction() > m_maxInstProduction)
     	{
     		inst->setFlawed(true);
-//       		inst->set??(true);
-//       		inst->set??Magnitude(std::abs(m_maxInstProduction - inst->getMaxInstantProduction()));
+    		inst->setProductionRate(true);
+    		inst->setProductionRateMagnitude(inst->getMaxInstantProduction() - m_maxInstProduction);
        		debugMsg("GenericFVDetector:detect", "Instantaneous production flaw.");
     	}
     	handleResourceLevelFlaws(inst);
@@ -154,6 +144,14 @@ GenericFVDetector::GenericFVDetector(const ResourceId res)
     	return new GenericFVProfile(this,m_res->getProfile(),false);
     }
 
+    // The default level bounds assume a closed world
+    bool GenericFVDetector::getUnplannedLevelChange(const edouble, const edouble, edouble& lb, edouble& ub) const
+    {
+    	lb = 0;
+    	ub = 0;
+    	return true;
+    }
+
     Resource::ProblemType GenericFVDetector::getResourceLevelViolation(const InstantId inst) const
     {
     	edouble limitLb, limitUb;
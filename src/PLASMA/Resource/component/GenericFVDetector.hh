@@ -39,6 +39,8 @@ namespace EUROPA {
 
       virtual PSResourceProfile* getFDLevelProfile();
       virtual PSResourceProfile* getVDLevelProfile();
+      virtual bool getUnplannedLevelChange(const edouble minProduction, const edouble minConsumption,
+                                           edouble& lb, edouble& ub) const;
 
     protected:
       edouble m_maxInstConsumption, m_maxInstProduction;
@@ -67,16 +67,16 @@ namespace EUROPA
 
       initializeGraphs<FlowProfileGraphImpl>();
 
-      std::set<TransactionId> enabledLower;
-      std::set<TransactionId> enabledUpper;
+      TransactionSet enabledLower;
+      TransactionSet enabledUpper;
 
       // we got to put all the transactions which are pending at this instant but are not yet contributing
       // to the levels back into the maximum flow!
-      const std::set<TransactionId>& transactions = inst->getTransactions();
+      const TransactionSet& transactions = inst->getTransactions();
 
       {
-        std::set<TransactionId>::const_iterator iter = transactions.begin();
-        std::set<TransactionId>::const_iterator end = transactions.end();
+        TransactionSet::const_iterator iter = transactions.begin();
+        TransactionSet::const_iterator end = transactions.end();
 
         for( ; iter != end; ++iter )
           {
@@ -113,14 +113,14 @@ namespace EUROPA
       }
 
       {
-        std::set<TransactionId>::const_iterator iter = enabledLower.begin();
-        std::set<TransactionId>::const_iterator end = enabledLower.end();
+        TransactionSet::const_iterator iter = enabledLower.begin();
+        TransactionSet::const_iterator end = enabledLower.end();
 
         for( ; iter != end; ++iter )
           {
             const TransactionId transaction1 = (*iter);
 
-            std::set<TransactionId>::const_iterator iter2 = iter;
+            TransactionSet::const_iterator iter2 = iter;
 
             for( ; iter2 != end; ++iter2 )
               {
@@ -155,14 +155,14 @@ namespace EUROPA
       }
 
       {
-        std::set<TransactionId>::const_iterator iter = enabledUpper.begin();
-        std::set<TransactionId>::const_iterator end = enabledUpper.end();
+        TransactionSet::const_iterator iter = enabledUpper.begin();
+        TransactionSet::const_iterator end = enabledUpper.end();
 
         for( ; iter != end; ++iter )
           {
             const TransactionId transaction1 = (*iter);
 
-            std::set<TransactionId>::const_iterator iter2 = iter;
+            TransactionSet::const_iterator iter2 = iter;
 
             for( ; iter2 != end; ++iter2 )
               {
@@ -217,10 +217,10 @@ bool IncrementalFlowProfile::enableOrderings( const InstantId inst  ) {
 
   bool returnValue = false;
 
-  const std::set<TransactionId>& startingTransactions = inst->getStartingTransactions();
+  const TransactionSet& startingTransactions = inst->getStartingTransactions();
 
-  std::set<TransactionId>::const_iterator ite = startingTransactions.begin();
-  std::set<TransactionId>::const_iterator end = startingTransactions.end();
+  TransactionSet::const_iterator ite = startingTransactions.begin();
+  TransactionSet::const_iterator end = startingTransactions.end();
 
   for( ; ite != end; ++ite )
   {
@@ -232,10 +232,10 @@ bool IncrementalFlowProfile::enableOrderings( const InstantId inst  ) {
 
       returnValue = true;
 
-      const std::set<TransactionId>& transactions = inst->getTransactions();
+      const TransactionSet& transactions = inst->getTransactions();
 
-      std::set<TransactionId>::const_iterator iter = transactions.begin();
-      std::set<TransactionId>::const_iterator iterEnd = transactions.end();
+      TransactionSet::const_iterator iter = transactions.begin();
+      TransactionSet::const_iterator iterEnd = transactions.end();
 
       for( ; iter != iterEnd; ++iter )
       {
@@ -378,13 +378,13 @@ void IncrementalFlowProfile::recomputeLevels( InstantId inst, edouble lowerLevel
     }
   }
 
-  const std::set<TransactionId>& endingTransactions = inst->getEndingTransactions();
+  const TransactionSet& endingTransactions = inst->getEndingTransactions();
 
   bool contraction = false;
 
   {
-    std::set<TransactionId>::const_iterator ite = endingTransactions.begin();
-    std::set<TransactionId>::const_iterator end = endingTransactions.end();
+    TransactionSet::const_iterator ite = endingTransactions.begin();
+    TransactionSet::const_iterator end = endingTransactions.end();
 
     for( ; ite != end; ++ite )
     {
@@ -1,5 +1,6 @@
 #include "OpenWorldFVDetector.hh"
 
+#include <algorithm>
 #include <cmath>
 #include "Profile.hh"
 
@@ -28,6 +29,15 @@ Resource::ProblemType OpenWorldFVDetector::getResourceLevelViolation(const Insta
 	return retval;
 }
 
+// As in getVDLevelBounds, anything not yet committed may still be produced or consumed
+bool OpenWorldFVDetector::getUnplannedLevelChange(const edouble minProduction, const edouble minConsumption,
+                                                  edouble& lb, edouble& ub) const
+{
+	lb = -std::max(edouble(0), m_maxCumulativeConsumption - minConsumption);
+	ub = std::max(edouble(0), m_maxCumulativeProduction - minProduction);
+	return true;
+}
+
 void OpenWorldFVDetector::getFDLevelBounds(const InstantId inst, edouble& lb, edouble& ub) const
 {
 	const std::pair<edouble,edouble>& capacityBounds = m_res->getCapacityProfile()->getValue(inst->getTime());
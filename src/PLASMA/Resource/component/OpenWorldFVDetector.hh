@@ -7,6 +7,8 @@ namespace EUROPA {
 	class OpenWorldFVDetector : public GenericFVDetector {
 	public:
 		OpenWorldFVDetector(const ResourceId res);
+		virtual bool getUnplannedLevelChange(const edouble minProduction, const edouble minConsumption,
+		                                     edouble& lb, edouble& ub) const;
 	protected:
 		virtual Resource::ProblemType getResourceLevelViolation(const InstantId inst) const;
 		virtual void getFDLevelBounds(const InstantId inst, edouble& lb, edouble& ub) const; // Level Bounds for FlawDetection
@@ -5,10 +5,15 @@
 #include "Transaction.hh"
 #include "ConstraintEngine.hh"
 #include "Domains.hh"
+#include "FVDetector.hh"
 #include "PlanDatabase.hh"
+#include "ProfilePropagator.hh"
+#include "TemporalAdvisor.hh"
 #include "Token.hh"
 #include "TokenVariable.hh"
 
+#include <algorithm>
+
 namespace EUROPA {
 Reservoir::Reservoir(const PlanDatabaseId planDatabase, const std::string& type,
                      const std::string& name, const std::string& detectorName,
@@ -76,6 +81,118 @@ Reservoir::Reservoir(const ObjectId parent, const std::string& type,
     Resource::removeFromProfile(tok);
   }
 
+  namespace {
+    /**
+     * @brief Find the earliest time by which transactions, sorted by earliest time, can supply amount.
+     * @return PLUS_INFINITY if they can't.
+     */
+    edouble earliestSupply(std::vector<std::pair<edouble, edouble> >& supply, const edouble amount) {
+      std::sort(supply.begin(), supply.end());
+      edouble sum = 0;
+      for(std::vector<std::pair<edouble, edouble> >::const_iterator it = supply.begin(); it != supply.end(); ++it) {
+        sum += it->second;
+        if(sum >= amount)
+          return it->first;
+      }
+      return PLUS_INFINITY;
+    }
+  }
+
+  void Reservoir::tightenTransactions(ProfilePropagator& propagator) {
+    ConstraintEngineId ce = getPlanDatabase()->getConstraintEngine();
+    if(ce->getAllowViolations() || m_capacityProfile->getValues().size() != 1 ||
+       m_limitProfile->getValues().size() != 1)
+      return;
+
+    const TransactionSet& transactions = m_profile->getAllTransactions();
+    if(transactions.empty())
+      return;
+
+    edouble minProduction = 0, minConsumption = 0;
+    std::vector<TransactionId> all(transactions.begin(), transactions.end());
+    std::vector<ConstrainedVariableId> times;
+    for(std::vector<TransactionId>::const_iterator it = all.begin(); it != all.end(); ++it) {
+      times.push_back((*it)->time());
+      ((*it)->isConsumer() ? minConsumption : minProduction) += (*it)->quantity()->lastDomain().getLowerBound();
+    }
+
+    edouble slackLb, slackUb;
+    if(!m_detector->getUnplannedLevelChange(minProduction, minConsumption, slackLb, slackUb))
+      return;
+
+    const std::pair<edouble, edouble>& capacity = m_capacityProfile->getValues().begin()->second;
+    const edouble lowerLimit = m_limitProfile->getValues().begin()->second.first;
+    const edouble upperLimit = m_limitProfile->getValues().begin()->second.second;
+    TemporalAdvisorId temporalAdvisor = getPlanDatabase()->getTemporalAdvisor();
+
+    for(std::vector<TransactionId>::const_iterator it = all.begin(); it != all.end(); ++it) {
+      TransactionId x = *it;
+      std::vector<eint> lbs, ubs;
+      temporalAdvisor->getTemporalDistanceSigns(x->time(), times, lbs, ubs);
+
+      // Bounds on the level at x's time, excluding x itself
+      edouble necessaryMax = capacity.second + slackUb, necessaryMin = capacity.first + slackLb;
+      edouble possibleProduction = 0, possibleConsumption = 0;
+      std::vector<std::pair<edouble, edouble> > producers, consumers;
+      for(unsigned int i = 0; i < all.size(); i++) {
+        TransactionId y = all[i];
+        if(y == x || lbs[i] > 0)
+          continue;
+        const Domain& quantity = y->quantity()->lastDomain();
+        if(ubs[i] <= 0) {
+          necessaryMax += (y->isConsumer() ? -quantity.getLowerBound() : quantity.getUpperBound());
+          necessaryMin += (y->isConsumer() ? -quantity.getUpperBound() : quantity.getLowerBound());
+        }
+        else if(y->isConsumer()) {
+          possibleConsumption += quantity.getUpperBound();
+          consumers.push_back(std::make_pair(y->time()->lastDomain().getLowerBound(), quantity.getUpperBound()));
+        }
+        else {
+          possibleProduction += quantity.getUpperBound();
+          producers.push_back(std::make_pair(y->time()->lastDomain().getLowerBound(), quantity.getUpperBound()));
+        }
+      }
+
+      const edouble maxBefore = necessaryMax + possibleProduction;
+      const edouble minBefore = necessaryMin - possibleConsumption;
+      const edouble qlb = x->quantity()->lastDomain().getLowerBound();
+      edouble quantityLb = MINUS_INFINITY, quantityUb = PLUS_INFINITY, timeLb = MINUS_INFINITY;
+      if(x->isConsumer()) {
+        if(lowerLimit != MINUS_INFINITY) {
+          quantityUb = maxBefore - lowerLimit;
+          const edouble deficit = lowerLimit - (necessaryMax - qlb);
+          if(deficit > 0)
+            timeLb = earliestSupply(producers, deficit);
+        }
+        if(upperLimit != PLUS_INFINITY)
+          quantityLb = minBefore - upperLimit;
+      }
+      else {
+        if(upperLimit != PLUS_INFINITY) {
+          quantityUb = upperLimit - minBefore;
+          const edouble excess = (necessaryMin + qlb) - upperLimit;
+          if(excess > 0)
+            timeLb = earliestSupply(consumers, excess);
+        }
+        if(lowerLimit != MINUS_INFINITY)
+          quantityLb = lowerLimit - maxBefore;
+      }
+
+      debugMsg("Reservoir:tightenTransactions",
+               "For " << x->toString() << " level before is in [" << minBefore << ", " << maxBefore <<
+               "], bounding quantity to [" << quantityLb << ", " << quantityUb << "] and time above " << timeLb);
+
+      propagator.restrict(m_profile, x->quantity(), quantityLb, quantityUb);
+      if(ce->provenInconsistent())
+        return;
+      // If not enough can be supplied at any time, the quantity bound has already emptied
+      if(timeLb != PLUS_INFINITY)
+        propagator.restrict(m_profile, x->time(), timeLb, PLUS_INFINITY);
+      if(ce->provenInconsistent())
+        return;
+    }
+  }
+
   void Reservoir::getOrderingChoices(const TokenId token,
                                      std::vector<std::pair<TokenId, TokenId> >& results,
                                      unsigned long limit) {
@@ -55,6 +55,15 @@ class Reservoir : public Resource {
 
 //       void getTokensToOrder(std::vector<TokenId>& results);
 
+      /**
+       * @brief Bound each transaction by the producers and consumers that must, or may, precede it.
+       * A consumer can take no more than the most the level can be before it, less the lower limit,
+       * and can't happen before enough production is possible to keep the level above the lower limit.
+       * Producers are bounded symmetrically against the upper limit.  Only applies with constant
+       * capacity and limits.
+       */
+      void tightenTransactions(ProfilePropagator& propagator);
+
 
     private:
       //void notifyViolated(const InstantId inst);
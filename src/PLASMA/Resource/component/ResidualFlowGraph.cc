@@ -0,0 +1,247 @@
+#include "ResidualFlowGraph.hh"
+#include "Debug.hh"
+#include "Error.hh"
+
+#include <algorithm>
+#include <limits>
+
+namespace EUROPA {
+
+namespace {
+const int NO_EDGE = -1;
+const int TERMINAL = -2; /**< The parent edge of the source and sink in the search trees. */
+
+const char FREE = 0;
+const char SOURCE_TREE = 1;
+const char SINK_TREE = 2;
+}
+
+ResidualFlowGraph::ResidualFlowGraph()
+    : m_firstEdge(), m_nextEdge(), m_target(), m_residual(), m_level(), m_currentEdge(),
+      m_queue(), m_tree(), m_parentEdge(), m_active(), m_activeQueue(), m_orphans() {}
+
+void ResidualFlowGraph::clear() {
+  m_firstEdge.clear();
+  m_nextEdge.clear();
+  m_target.clear();
+  m_residual.clear();
+}
+
+int ResidualFlowGraph::addNode() {
+  m_firstEdge.push_back(NO_EDGE);
+  return getNodeCount() - 1;
+}
+
+int ResidualFlowGraph::addEdge(const int from, const int to, const double capacity,
+                               const double reverseCapacity) {
+  checkError(from >= 0 && from < getNodeCount(), "No node " << from);
+  checkError(to >= 0 && to < getNodeCount(), "No node " << to);
+  const int edge = getEdgeCount();
+
+  m_target.push_back(to);
+  m_residual.push_back(capacity);
+  m_nextEdge.push_back(m_firstEdge[from]);
+  m_firstEdge[from] = edge;
+
+  m_target.push_back(from);
+  m_residual.push_back(reverseCapacity);
+  m_nextEdge.push_back(m_firstEdge[to]);
+  m_firstEdge[to] = edge + 1;
+  return edge;
+}
+
+double ResidualFlowGraph::maxFlow(const int source, const int sink, const Algorithm algorithm) {
+  checkError(source != sink, "The source and sink must differ.");
+  double flow = (algorithm == DINIC ? dinic(source, sink) : boykovKolmogorov(source, sink));
+  debugMsg("ResidualFlowGraph:maxFlow",
+           (algorithm == DINIC ? "Dinic" : "Boykov-Kolmogorov") << " pushed " << flow <<
+           " through " << getNodeCount() << " nodes and " << getEdgeCount() << " edges");
+  return flow;
+}
+
+double ResidualFlowGraph::dinic(const int source, const int sink) {
+  double flow = 0;
+  while(dinicLevels(source, sink)) {
+    m_currentEdge = m_firstEdge;
+    for(double pushed = dinicAugment(source, sink, std::numeric_limits<double>::max());
+        pushed > 0; pushed = dinicAugment(source, sink, std::numeric_limits<double>::max()))
+      flow += pushed;
+  }
+  return flow;
+}
+
+// Breadth first distances from the source over edges with residual capacity
+bool ResidualFlowGraph::dinicLevels(const int source, const int sink) {
+  m_level.assign(m_firstEdge.size(), -1);
+  m_queue.clear();
+  m_level[source] = 0;
+  m_queue.push_back(source);
+  for(std::vector<int>::size_type i = 0; i < m_queue.size(); ++i) {
+    const int node = m_queue[i];
+    for(int edge = m_firstEdge[node]; edge != NO_EDGE; edge = m_nextEdge[edge]) {
+      const int target = m_target[edge];
+      if(m_residual[edge] > 0 && m_level[target] < 0) {
+        m_level[target] = m_level[node] + 1;
+        m_queue.push_back(target);
+      }
+    }
+  }
+  return m_level[sink] >= 0;
+}
+
+// Push flow along one shortest path, resuming each node's scan where the last one stopped
+double ResidualFlowGraph::dinicAugment(const int node, const int sink, const double limit) {
+  if(node == sink)
+    return limit;
+  for(int& edge = m_currentEdge[node]; edge != NO_EDGE; edge = m_nextEdge[edge]) {
+    const int target = m_target[edge];
+    if(m_residual[edge] > 0 && m_level[target] == m_level[node] + 1) {
+      const double pushed = dinicAugment(target, sink, std::min(limit, m_residual[edge]));
+      if(pushed > 0) {
+        m_residual[edge] -= pushed;
+        m_residual[edge ^ 1] += pushed;
+        return pushed;
+      }
+    }
+  }
+  return 0;
+}
+
+/**
+ * Grows a search tree from each of the source and sink.  When they touch, flow is pushed along
+ * the path through both and the nodes cut off by saturated edges are re-attached or freed,
+ * rather than searching again from scratch.  In each tree, a node's parent edge is the one that
+ * carries flow from the source side to the sink side.
+ */
+double ResidualFlowGraph::boykovKolmogorov(const int source, const int sink) {
+  m_tree.assign(m_firstEdge.size(), FREE);
+  m_parentEdge.assign(m_firstEdge.size(), NO_EDGE);
+  m_active.assign(m_firstEdge.size(), 0);
+  m_activeQueue.clear();
+  m_orphans.clear();
+
+  m_tree[source] = SOURCE_TREE;
+  m_tree[sink] = SINK_TREE;
+  m_parentEdge[source] = TERMINAL;
+  m_parentEdge[sink] = TERMINAL;
+  bkActivate(source);
+  bkActivate(sink);
+
+  double flow = 0;
+  while(!m_activeQueue.empty()) {
+    const int node = m_activeQueue.front();
+    int path = NO_EDGE;
+    if(m_tree[node] != FREE) {
+      for(int edge = m_firstEdge[node]; edge != NO_EDGE && path == NO_EDGE; edge = m_nextEdge[edge]) {
+        const int other = m_target[edge];
+        const int forward = (m_tree[node] == SOURCE_TREE ? edge : edge ^ 1);
+        if(m_residual[forward] <= 0)
+          continue;
+        if(m_tree[other] == FREE) {
+          m_tree[other] = m_tree[node];
+          m_parentEdge[other] = forward;
+          bkActivate(other);
+        }
+        else if(m_tree[other] != m_tree[node])
+          path = forward;
+      }
+    }
+
+    if(path == NO_EDGE) {
+      m_active[node] = 0;
+      m_activeQueue.pop_front();
+      continue;
+    }
+
+    flow += bkAugment(path);
+    while(!m_orphans.empty()) {
+      const int orphan = m_orphans.back();
+      m_orphans.pop_back();
+      bkAdopt(orphan);
+    }
+  }
+  return flow;
+}
+
+double ResidualFlowGraph::bkAugment(const int path) {
+  double bottleneck = m_residual[path];
+  for(int node = getSource(path); m_parentEdge[node] != TERMINAL; node = getSource(m_parentEdge[node]))
+    bottleneck = std::min(bottleneck, m_residual[m_parentEdge[node]]);
+  for(int node = getTarget(path); m_parentEdge[node] != TERMINAL; node = getTarget(m_parentEdge[node]))
+    bottleneck = std::min(bottleneck, m_residual[m_parentEdge[node]]);
+
+  m_residual[path] -= bottleneck;
+  m_residual[path ^ 1] += bottleneck;
+
+  for(int node = getSource(path); m_parentEdge[node] != TERMINAL;) {
+    const int edge = m_parentEdge[node];
+    const int parent = getSource(edge);
+    m_residual[edge] -= bottleneck;
+    m_residual[edge ^ 1] += bottleneck;
+    if(m_residual[edge] <= 0) {
+      m_parentEdge[node] = NO_EDGE;
+      m_orphans.push_back(node);
+    }
+    node = parent;
+  }
+  for(int node = getTarget(path); m_parentEdge[node] != TERMINAL;) {
+    const int edge = m_parentEdge[node];
+    const int parent = getTarget(edge);
+    m_residual[edge] -= bottleneck;
+    m_residual[edge ^ 1] += bottleneck;
+    if(m_residual[edge] <= 0) {
+      m_parentEdge[node] = NO_EDGE;
+      m_orphans.push_back(node);
+    }
+    node = parent;
+  }
+  return bottleneck;
+}
+
+// Test if a node is still connected to the root of its tree
+bool ResidualFlowGraph::bkHasOrigin(int node) const {
+  while(m_parentEdge[node] != TERMINAL) {
+    const int edge = m_parentEdge[node];
+    if(edge == NO_EDGE)
+      return false;
+    node = (m_tree[node] == SOURCE_TREE ? getSource(edge) : getTarget(edge));
+  }
+  return true;
+}
+
+void ResidualFlowGraph::bkAdopt(const int orphan) {
+  const char tree = m_tree[orphan];
+  for(int edge = m_firstEdge[orphan]; edge != NO_EDGE; edge = m_nextEdge[edge]) {
+    const int other = m_target[edge];
+    const int forward = (tree == SOURCE_TREE ? edge ^ 1 : edge);
+    if(m_tree[other] == tree && m_residual[forward] > 0 && bkHasOrigin(other)) {
+      m_parentEdge[orphan] = forward;
+      return;
+    }
+  }
+
+  // No way back to the root, so free the orphan and orphan its children in turn
+  for(int edge = m_firstEdge[orphan]; edge != NO_EDGE; edge = m_nextEdge[edge]) {
+    const int other = m_target[edge];
+    if(m_tree[other] != tree)
+      continue;
+    const int forward = (tree == SOURCE_TREE ? edge ^ 1 : edge);
+    if(m_residual[forward] > 0)
+      bkActivate(other);
+    const int parentEdge = m_parentEdge[other];
+    if(parentEdge >= 0 && (tree == SOURCE_TREE ? getSource(parentEdge) : getTarget(parentEdge)) == orphan) {
+      m_parentEdge[other] = NO_EDGE;
+      m_orphans.push_back(other);
+    }
+  }
+  m_tree[orphan] = FREE;
+}
+
+void ResidualFlowGraph::bkActivate(const int node) {
+  if(!m_active[node]) {
+    m_active[node] = 1;
+    m_activeQueue.push_back(node);
+  }
+}
+
+}
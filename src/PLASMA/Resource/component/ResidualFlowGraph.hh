@@ -0,0 +1,89 @@
+#ifndef _H_ResidualFlowGraph
+#define _H_ResidualFlowGraph
+
+/**
+ * @file ResidualFlowGraph.hh
+ * @brief A residual network held in contiguous arrays, with Dinic and Boykov-Kolmogorov maximum flow.
+ * @ingroup Resource
+ */
+
+#include <deque>
+#include <vector>
+
+namespace EUROPA {
+
+/**
+ * @brief A directed network for maximum flow problems.  Nodes are indices from 0, edges are
+ * stored in pairs so that the reverse of edge e is e^1, and each node's out edges are chained
+ * through the edge arrays.  Capacities are residual: running a maximum flow algorithm consumes
+ * them, and getResidual reports what is left.
+ */
+class ResidualFlowGraph {
+ public:
+  enum Algorithm {
+    DINIC,
+    BOYKOV_KOLMOGOROV
+  };
+
+  ResidualFlowGraph();
+
+  /**
+   * @brief Remove all nodes and edges.  Storage is kept for reuse.
+   */
+  void clear();
+
+  /**
+   * @brief Add a node, returning its index.
+   */
+  int addNode();
+
+  /**
+   * @brief Add an edge from \a from to \a to and its reverse, returning the index of the forward edge.
+   */
+  int addEdge(const int from, const int to, const double capacity, const double reverseCapacity);
+
+  int getNodeCount() const {return static_cast<int>(m_firstEdge.size());}
+  int getEdgeCount() const {return static_cast<int>(m_target.size());}
+
+  int getFirstEdge(const int node) const {return m_firstEdge[node];}
+  int getNextEdge(const int edge) const {return m_nextEdge[edge];}
+  int getSource(const int edge) const {return m_target[edge ^ 1];}
+  int getTarget(const int edge) const {return m_target[edge];}
+  double getResidual(const int edge) const {return m_residual[edge];}
+
+  /**
+   * @brief Push the maximum flow from \a source to \a sink through the residual network.
+   * @return The amount of flow pushed.
+   */
+  double maxFlow(const int source, const int sink, const Algorithm algorithm);
+
+ private:
+  double dinic(const int source, const int sink);
+  bool dinicLevels(const int source, const int sink);
+  double dinicAugment(const int node, const int sink, const double limit);
+
+  double boykovKolmogorov(const int source, const int sink);
+  double bkAugment(const int edge);
+  bool bkHasOrigin(int node) const;
+  void bkAdopt(const int orphan);
+  void bkActivate(const int node);
+
+  std::vector<int> m_firstEdge; /**< Per node, the first out edge, or -1. */
+  std::vector<int> m_nextEdge; /**< Per edge, the next out edge of its source, or -1. */
+  std::vector<int> m_target; /**< Per edge, the node it enters. */
+  std::vector<double> m_residual; /**< Per edge, the remaining capacity. */
+
+  // Working storage for the algorithms, indexed by node
+  std::vector<int> m_level;
+  std::vector<int> m_currentEdge;
+  std::vector<int> m_queue;
+  std::vector<char> m_tree;
+  std::vector<int> m_parentEdge;
+  std::vector<char> m_active;
+  std::deque<int> m_activeQueue;
+  std::vector<int> m_orphans;
+};
+
+}
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef _H_ResidualFlowProfile
+#define _H_ResidualFlowProfile
+#include "FlowProfile.hh"
+#include "ResidualFlowProfileGraph.hh"
+namespace EUROPA {
+
+/**
+ * @brief A FlowProfile using Dinic's maximum flow algorithm.
+ */
+class DinicFlowProfile : public FlowProfile {
+ public:
+  DinicFlowProfile(const PlanDatabaseId db, const FVDetectorId flawDetector)
+      : FlowProfile(db, flawDetector) {
+    initializeGraphs<EUROPA::DinicFlowProfileGraph>();
+  }
+};
+
+/**
+ * @brief A FlowProfile using the Boykov-Kolmogorov maximum flow algorithm, without depending on boost's.
+ */
+class BKFlowProfile : public FlowProfile {
+ public:
+  BKFlowProfile(const PlanDatabaseId db, const FVDetectorId flawDetector)
+      : FlowProfile(db, flawDetector) {
+    initializeGraphs<EUROPA::BKFlowProfileGraph>();
+  }
+};
+}
+
+#endif
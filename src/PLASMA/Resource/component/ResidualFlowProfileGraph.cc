@@ -0,0 +1,159 @@
+#include "ResidualFlowProfileGraph.hh"
+#include "Debug.hh"
+#include "ConstrainedVariable.hh"
+#include "Domain.hh"
+#include "Transaction.hh"
+
+#include <algorithm>
+
+namespace EUROPA {
+
+ResidualFlowProfileGraph::ResidualFlowProfileGraph(const TransactionId source,
+                                                   const TransactionId sink,
+                                                   bool lowerLevel,
+                                                   const ResidualFlowGraph::Algorithm algorithm)
+    : FlowProfileGraph(source, sink, lowerLevel), m_graph(), m_algorithm(algorithm),
+      m_transactionToNode(), m_nodeToTransaction(), m_connected(), m_activeTransactions(),
+      m_active(), m_source(-1), m_sink(-1) {
+  m_source = addNode(source);
+  m_sink = addNode(sink);
+}
+
+int ResidualFlowProfileGraph::addNode(const TransactionId t) {
+  std::map<TransactionId, int>::const_iterator found = m_transactionToNode.find(t);
+  if(found != m_transactionToNode.end())
+    return found->second;
+  int retval = m_graph.addNode();
+  m_transactionToNode.insert(std::make_pair(t, retval));
+  m_nodeToTransaction.push_back(t);
+  return retval;
+}
+
+int ResidualFlowProfileGraph::getNode(const TransactionId t) const {
+  std::map<TransactionId, int>::const_iterator it = m_transactionToNode.find(t);
+  checkError(it != m_transactionToNode.end(), "Failed to find a node for " << t);
+  return it->second;
+}
+
+// As with the boost graph, the first edge added between two nodes wins
+void ResidualFlowProfileGraph::addEdge(const TransactionId t1, const TransactionId t2,
+                                       const edouble capacity, const edouble reverseCapacity) {
+  debugMsg("ResidualFlowProfileGraph:addEdge",
+           (isLowerLevel() ? "<lower>" : "<upper>") << t1 << " -> " << t2 << " [" <<
+           capacity << ", " << reverseCapacity << "]");
+  int n1 = getNode(t1);
+  int n2 = getNode(t2);
+  if(!m_connected.insert(std::make_pair(n1, n2)).second)
+    return;
+  m_connected.insert(std::make_pair(n2, n1));
+  m_graph.addEdge(n1, n2, cast_basis(capacity), cast_basis(reverseCapacity));
+}
+
+void ResidualFlowProfileGraph::enableAt(const TransactionId t1, const TransactionId t2) {
+  if(m_transactionToNode.find(t1) == m_transactionToNode.end() ||
+     m_transactionToNode.find(t2) == m_transactionToNode.end())
+    return;
+  m_recalculate = true;
+  addEdge(t1, t2, PLUS_INFINITY, PLUS_INFINITY);
+}
+
+void ResidualFlowProfileGraph::enableAtOrBefore(const TransactionId t1, const TransactionId t2) {
+  if(m_transactionToNode.find(t1) == m_transactionToNode.end() ||
+     m_transactionToNode.find(t2) == m_transactionToNode.end())
+    return;
+  m_recalculate = true;
+  addEdge(t1, t2, 0, PLUS_INFINITY);
+}
+
+void ResidualFlowProfileGraph::disable(const TransactionId transaction) {
+  if(m_active.erase(transaction) == 0)
+    return;
+  m_activeTransactions.erase(std::find(m_activeTransactions.begin(), m_activeTransactions.end(),
+                                       transaction));
+}
+
+void ResidualFlowProfileGraph::addTransactionToGraph(const TransactionId t) {
+  const TransactionId sourceTransaction = m_nodeToTransaction[m_source];
+  const TransactionId sinkTransaction = m_nodeToTransaction[m_sink];
+  if(t == sourceTransaction || t == sinkTransaction)
+    return;
+
+  addNode(t);
+  if(isLowerLevel() == t->isConsumer())
+    addEdge(sourceTransaction, t, t->quantity()->lastDomain().getUpperBound(), 0.0);
+  else
+    addEdge(t, sinkTransaction, t->quantity()->lastDomain().getLowerBound(), 0.0);
+}
+
+void ResidualFlowProfileGraph::enableTransaction(const TransactionId t, const InstantId,
+                                                 TransactionId2InstantId) {
+  if(m_active.insert(t).second)
+    m_activeTransactions.push_back(t);
+  m_recalculate = true;
+}
+
+edouble ResidualFlowProfileGraph::getResidualFromSource(const TransactionIdTransactionIdPair2Order& at,
+                                                        const TransactionIdTransactionIdPair2Order& other) {
+  reset();
+  for(std::vector<TransactionId>::const_iterator it = m_activeTransactions.begin();
+      it != m_activeTransactions.end(); ++it)
+    addTransactionToGraph(*it);
+  for(TransactionIdTransactionIdPair2Order::const_iterator it = at.begin(); it != at.end(); ++it)
+    enableAt(it->first.first, it->first.second);
+  for(TransactionIdTransactionIdPair2Order::const_iterator it = other.begin(); it != other.end(); ++it) {
+    switch(it->second) {
+      case AFTER_OR_AT:
+        enableAtOrBefore(it->first.second, it->first.first);
+        break;
+      case BEFORE_OR_AT:
+        enableAtOrBefore(it->first.first, it->first.second);
+        break;
+      case STRICTLY_AT:
+        enableAt(it->first.first, it->first.second);
+        break;
+      case NOT_ORDERED:
+      case UNKNOWN:
+        break;
+    }
+  }
+  return getResidualFromSource();
+}
+
+edouble ResidualFlowProfileGraph::getResidualFromSource() {
+  edouble residual = 0.0;
+  if(m_graph.getNodeCount() <= 2) {
+    m_recalculate = false;
+    return residual;
+  }
+  if(m_recalculate) {
+    m_graph.maxFlow(m_source, m_sink, m_algorithm);
+    m_recalculate = false;
+  }
+  for(int edge = m_graph.getFirstEdge(m_source); edge != -1; edge = m_graph.getNextEdge(edge))
+    residual += m_graph.getResidual(edge);
+
+  debugMsg("ResidualFlowProfileGraph:getResidualFromSource",
+           (isLowerLevel() ? "<lower>" : "<upper>") << "Residual " << residual);
+  return residual;
+}
+
+void ResidualFlowProfileGraph::removeTransaction(const TransactionId id) {
+  debugMsg("ResidualFlowProfileGraph:removeTransaction",
+           (isLowerLevel() ? "<lower>" : "<upper>") << "Removing " << id);
+  disable(id);
+  m_recalculate = true;
+}
+
+void ResidualFlowProfileGraph::reset() {
+  const TransactionId source = m_nodeToTransaction[m_source];
+  const TransactionId sink = m_nodeToTransaction[m_sink];
+  m_graph.clear();
+  m_transactionToNode.clear();
+  m_nodeToTransaction.clear();
+  m_connected.clear();
+  m_source = addNode(source);
+  m_sink = addNode(sink);
+  m_recalculate = true;
+}
+
+}
@@ -0,0 +1,90 @@
+#ifndef _H_ResidualFlowProfileGraph
+#define _H_ResidualFlowProfileGraph
+
+#include "FlowProfileGraph.hh"
+#include "ResidualFlowGraph.hh"
+#include "Types.hh"
+
+#include <map>
+#include <set>
+#include <vector>
+
+namespace EUROPA {
+
+/**
+ * @brief A FlowProfileGraph over a ResidualFlowGraph, with no dependencies beyond the standard
+ * library.  Like BoostFlowProfileGraph, the network is rebuilt from the enabled transactions and
+ * their orderings each time the residual is requested.
+ */
+class ResidualFlowProfileGraph : public FlowProfileGraph {
+ public:
+  ResidualFlowProfileGraph(const TransactionId source, const TransactionId sink, bool lowerLevel,
+                           const ResidualFlowGraph::Algorithm algorithm);
+  ~ResidualFlowProfileGraph() {}
+  /**
+   * @brief Creates bi-directional edge between \a t1 and \a t2 with infinite capacity
+   * as a result of a concurrent constraint between the two transactions
+   */
+  void enableAt(const TransactionId t1, const TransactionId t2);
+  /**
+   * @brief Creates directed edge between \a t1 and \a t2 with infinite capacity
+   * as a result of a before or at constraint between the two transactions (reverse
+   * capacity set to zero)
+   */
+  void enableAtOrBefore(const TransactionId t1, const TransactionId t2);
+  /**
+   * @brief Marks \a transaction to be added to the network when it is next built.
+   * @see FlowProfileGraph::enableTransaction
+   */
+  void enableTransaction(const TransactionId transaction, const InstantId inst,
+                         TransactionId2InstantId contributions);
+  bool isEnabled(const TransactionId) const {return true;}
+  void disable(const TransactionId transaction);
+  void pushFlow(const TransactionId) {}
+  /**
+   * @brief Returns the cummulative residual capacity originating from the source, computing the
+   * maximum flow first if the network changed.
+   */
+  edouble getResidualFromSource();
+  /**
+   * @brief Rebuilds the network from the enabled transactions and the given orderings, then
+   * returns the residual from the source.
+   */
+  edouble getResidualFromSource(const TransactionIdTransactionIdPair2Order& at,
+                                const TransactionIdTransactionIdPair2Order& other);
+  edouble disableReachableResidualGraph(TransactionId2InstantId, const InstantId) {return 0.0;}
+  void removeTransaction(const TransactionId id);
+  void reset();
+  void restoreFlow() {}
+
+ private:
+  int addNode(const TransactionId t);
+  int getNode(const TransactionId t) const;
+  void addEdge(const TransactionId t1, const TransactionId t2, const edouble capacity,
+               const edouble reverseCapacity);
+  void addTransactionToGraph(const TransactionId t);
+
+  ResidualFlowGraph m_graph;
+  const ResidualFlowGraph::Algorithm m_algorithm;
+  std::map<TransactionId, int> m_transactionToNode;
+  std::vector<TransactionId> m_nodeToTransaction;
+  std::set<std::pair<int, int> > m_connected; /**< Node pairs joined by an edge in either direction. */
+  std::vector<TransactionId> m_activeTransactions;
+  TransactionSet m_active;
+  int m_source, m_sink;
+};
+
+class DinicFlowProfileGraph : public ResidualFlowProfileGraph {
+ public:
+  DinicFlowProfileGraph(const TransactionId source, const TransactionId sink, bool lowerLevel)
+      : ResidualFlowProfileGraph(source, sink, lowerLevel, ResidualFlowGraph::DINIC) {}
+};
+
+class BKFlowProfileGraph : public ResidualFlowProfileGraph {
+ public:
+  BKFlowProfileGraph(const TransactionId source, const TransactionId sink, bool lowerLevel)
+      : ResidualFlowProfileGraph(source, sink, lowerLevel, ResidualFlowGraph::BOYKOV_KOLMOGOROV) {}
+};
+
+}
+#endif
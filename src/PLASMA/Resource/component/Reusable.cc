@@ -258,11 +258,11 @@ edouble getUb(ConstrainedVariableId v) {
 }
 }
 
-  std::set<UsesId> CBReusable::getConstraintsForInstant(const InstantId instant)
+  UsesSet CBReusable::getConstraintsForInstant(const InstantId instant)
   {
-    std::set<UsesId> retval;
+    UsesSet retval;
 
-    std::map<UsesId, std::pair<TransactionId, TransactionId> >::const_iterator it = m_constraintsToTransactions.begin();
+    std::map<UsesId, std::pair<TransactionId, TransactionId>, EntityComparator<UsesId> >::const_iterator it = m_constraintsToTransactions.begin();
 
     for (;it != m_constraintsToTransactions.end(); ++it) {
       UsesId c = it->first;
@@ -287,8 +287,8 @@ edouble getUb(ConstrainedVariableId v) {
     TransactionId txn = *(inst->getTransactions().begin());
     ConstraintEngineId ce = txn->quantity()->getConstraintEngine(); // TODO: keep track of constraint engine more cleanly?
     if (ce->getAllowViolations()) { // TODO: move this test to the constraint?
-      std::set<UsesId> constraints = getConstraintsForInstant(inst);
-      std::set<UsesId>::const_iterator it = constraints.begin();
+      UsesSet constraints = getConstraintsForInstant(inst);
+      UsesSet::const_iterator it = constraints.begin();
       for(;it != constraints.end(); ++it) {
         UsesId c = *it;
         c->notifyViolated(problem,inst);
@@ -303,8 +303,8 @@ edouble getUb(ConstrainedVariableId v) {
   {
     debugMsg("CBReusable:violations", "Received notification of violation removed at time " << inst->getTime());
 
-    std::set<UsesId> constraints = getConstraintsForInstant(inst);
-    std::set<UsesId>::const_iterator it = constraints.begin();
+    UsesSet constraints = getConstraintsForInstant(inst);
+    UsesSet::const_iterator it = constraints.begin();
     for(;it != constraints.end(); ++it) {
       UsesId c = *it;
       c->notifyNoLongerViolated(inst);
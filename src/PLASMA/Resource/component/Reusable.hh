@@ -45,6 +45,7 @@ namespace EUROPA {
 
     typedef Id<CBReusable> CBReusableId;
     typedef Id<Uses> UsesId;
+    typedef std::set<UsesId, EntityComparator<UsesId> > UsesSet;
 
     class CBReusable : public Resource {
     public:
@@ -65,7 +66,7 @@ namespace EUROPA {
     protected:
       void addToProfile(const ConstraintId c);
       void removeFromProfile(const ConstraintId c);
-      std::set<UsesId> getConstraintsForInstant(const InstantId instant);
+      UsesSet getConstraintsForInstant(const InstantId instant);
 
       void addToProfile(TransactionId t);
       void removeFromProfile(TransactionId t);
@@ -76,7 +77,7 @@ namespace EUROPA {
       void createTransactions(const TokenId) {}
       void removeTransactions(const TokenId) {}
 
-      std::map<UsesId, std::pair<TransactionId, TransactionId> > m_constraintsToTransactions;
+      std::map<UsesId, std::pair<TransactionId, TransactionId>, EntityComparator<UsesId> > m_constraintsToTransactions;
 
       friend class Uses;
     };
@@ -0,0 +1,192 @@
+#include "ResourceBoundDecisionPoint.hh"
+#include "Instant.hh"
+#include "Transaction.hh"
+#include "Profile.hh"
+#include "Resource.hh"
+#include "Constraint.hh"
+#include "ConstrainedVariable.hh"
+#include "DbClient.hh"
+#include "Domains.hh"
+#include "tinyxml.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace EUROPA {
+  using namespace SOLVERS;
+
+namespace {
+/**
+ * Orders choices by the greatest reduction in quantity, breaking ties by the key of the quantity variable.
+ */
+class ReductionOrder {
+ public:
+  bool operator()(const std::pair<TransactionId, edouble>& a, const std::pair<TransactionId, edouble>& b) const {
+    edouble reductionA = a.first->quantity()->lastDomain().getUpperBound() - a.second;
+    edouble reductionB = b.first->quantity()->lastDomain().getUpperBound() - b.second;
+    if(reductionA != reductionB)
+      return reductionA > reductionB;
+    return a.first->quantity()->getKey() < b.first->quantity()->getKey();
+  }
+};
+}
+
+    bool ResourceBoundDecisionPoint::customStaticMatch(const EntityId entity) {
+      return InstantId::convertable(entity) && InstantId(entity)->hasQuantityFlaw();
+    }
+
+    //resolve the largest excess first, since bounding for it may resolve the others
+    Resource::ProblemType ResourceBoundDecisionPoint::selectProblem(const InstantId inst) {
+      Resource::ProblemType retval = Resource::NoProblem;
+      edouble magnitude = MINUS_INFINITY;
+      if(inst->hasProductionRateFlaw() && inst->getProductionRateFlawMagnitude() > magnitude) {
+        retval = Resource::ProductionRateExceeded;
+        magnitude = inst->getProductionRateFlawMagnitude();
+      }
+      if(inst->hasConsumptionRateFlaw() && inst->getConsumptionRateFlawMagnitude() > magnitude) {
+        retval = Resource::ConsumptionRateExceeded;
+        magnitude = inst->getConsumptionRateFlawMagnitude();
+      }
+      if(inst->hasProductionSumFlaw() && inst->getProductionSumFlawMagnitude() > magnitude) {
+        retval = Resource::ProductionSumExceeded;
+        magnitude = inst->getProductionSumFlawMagnitude();
+      }
+      if(inst->hasConsumptionSumFlaw() && inst->getConsumptionSumFlawMagnitude() > magnitude) {
+        retval = Resource::ConsumptionSumExceeded;
+        magnitude = inst->getConsumptionSumFlawMagnitude();
+      }
+      return retval;
+    }
+
+ResourceBoundDecisionPoint::ResourceBoundDecisionPoint(const DbClientId client,
+                                                       const InstantId flawedInstant,
+                                                       const TiXmlElement& configData,
+                                                       const std::string& explanation)
+    : ResourceThreatDecisionPoint(client, flawedInstant, configData, explanation),
+      m_problem(selectProblem(flawedInstant)), m_magnitude(0),
+      m_bounds(), m_boundIndex(0), m_bound(), m_boundConstr() {
+  checkError(m_problem != Resource::NoProblem,
+             "No production or consumption flaw at " << m_instTime << " on " << m_resName);
+  switch(m_problem) {
+    case Resource::ProductionRateExceeded:
+      m_magnitude = flawedInstant->getProductionRateFlawMagnitude();
+      break;
+    case Resource::ConsumptionRateExceeded:
+      m_magnitude = flawedInstant->getConsumptionRateFlawMagnitude();
+      break;
+    case Resource::ProductionSumExceeded:
+      m_magnitude = flawedInstant->getProductionSumFlawMagnitude();
+      break;
+    default:
+      m_magnitude = flawedInstant->getConsumptionSumFlawMagnitude();
+      break;
+  }
+}
+
+    ResourceBoundDecisionPoint::~ResourceBoundDecisionPoint() {}
+
+    /**
+     * The contributors to a rate flaw are the transactions that may occur at the instant; the contributors
+     * to a sum flaw are those that may occur at or before it.  A contributor with an unbounded quantity is
+     * capped at the limit itself.  The ordering choices are collected afterwards, since that clears the
+     * flawed instant.
+     */
+    void ResourceBoundDecisionPoint::handleInitialize() {
+      check_error(m_flawedInstant.isValid());
+      ResourceId res = m_flawedInstant->getProfile()->getResource();
+      const bool consumption = (m_problem == Resource::ConsumptionRateExceeded ||
+                                m_problem == Resource::ConsumptionSumExceeded);
+      const bool cumulative = (m_problem == Resource::ProductionSumExceeded ||
+                               m_problem == Resource::ConsumptionSumExceeded);
+      edouble limit;
+      if(cumulative)
+        limit = (consumption ? res->getMaxConsumption() : res->getMaxProduction());
+      else
+        limit = (consumption ? res->getMaxInstConsumption() : res->getMaxInstProduction());
+
+      const TransactionSet& candidates =
+          (cumulative ? m_flawedInstant->getProfile()->getAllTransactions() : m_flawedInstant->getTransactions());
+      for(TransactionSet::const_iterator it = candidates.begin(); it != candidates.end(); ++it) {
+        TransactionId trans = *it;
+        if(trans->isConsumer() != consumption ||
+           trans->time()->lastDomain().getLowerBound() > m_instTime)
+          continue;
+        edouble lb, ub;
+        trans->quantity()->lastDomain().getBounds(lb, ub);
+        edouble bound = (ub == PLUS_INFINITY ? limit : ub - m_magnitude);
+        bound = std::max(lb, bound);
+        if(bound < ub)
+          m_bounds.push_back(std::make_pair(trans, bound));
+      }
+      std::sort(m_bounds.begin(), m_bounds.end(), ReductionOrder());
+      debugMsg("ResourceBoundDecisionPoint:handleInitialize",
+               "Found " << m_bounds.size() << " bound choices for " << Resource::getProblemString(m_problem) <<
+               " of " << m_magnitude << " at " << m_instTime << " on " << m_resName);
+      ResourceThreatDecisionPoint::handleInitialize();
+    }
+
+    bool ResourceBoundDecisionPoint::hasNext() const {
+      return bounding() || ResourceThreatDecisionPoint::hasNext();
+    }
+
+    bool ResourceBoundDecisionPoint::canUndo() const {
+      return DecisionPoint::canUndo() && (m_boundConstr.isValid() || m_constr.isValid());
+    }
+
+    void ResourceBoundDecisionPoint::handleExecute() {
+      if(!bounding()) {
+        ResourceThreatDecisionPoint::handleExecute();
+        return;
+      }
+      check_error(m_boundConstr.isNoId());
+      const std::pair<TransactionId, edouble>& choice = m_bounds[m_boundIndex];
+      debugMsg("SolverDecisionPoint:handleExecute", "For " << m_instTime << " on " << m_resName << ", bounding " <<
+               toString(choice) << " because of " << getExplanation() << ".");
+      std::stringstream name;
+      name << "bound" << getKey();
+      m_bound = m_client->createVariable("float", IntervalDomain(choice.second), name.str(), true);
+      m_boundConstr = m_client->createConstraint("leq", makeScope(choice.first->quantity(), m_bound));
+    }
+
+    void ResourceBoundDecisionPoint::handleUndo() {
+      if(m_boundConstr.isNoId()) {
+        ResourceThreatDecisionPoint::handleUndo();
+        return;
+      }
+      debugMsg("SolverDecisionPoint:handleUndo", "Retracting bound decision on " << m_instTime << " on " <<
+               m_resName);
+      m_client->deleteConstraint(m_boundConstr);
+      m_client->deleteVariable(m_bound);
+      m_boundConstr = ConstraintId::noId();
+      m_bound = ConstrainedVariableId::noId();
+      m_boundIndex++;
+    }
+
+    std::string ResourceBoundDecisionPoint::toShortString() const {
+      if(!bounding() && m_index < m_choiceCount)
+        return ResourceThreatDecisionPoint::toShortString();
+      std::stringstream os;
+      os << "BND(" << m_instTime << ") on " << m_resName;
+      if(bounding())
+        os << ": " << toString(m_bounds[m_boundIndex]);
+      return os.str();
+    }
+
+    std::string ResourceBoundDecisionPoint::toString() const {
+      std::stringstream os;
+      os << "DP: " << Resource::getProblemString(m_problem) << " of " << m_magnitude << " at " << m_instTime <<
+          " on " << m_resName << std::endl;
+      for(unsigned long i = 0; i < m_bounds.size(); ++i) {
+        os << (i == m_boundIndex ? "  *" : "   ") << toString(m_bounds[i]) << std::endl;
+      }
+      os << ResourceThreatDecisionPoint::toString();
+      return os.str();
+    }
+
+    std::string ResourceBoundDecisionPoint::toString(const std::pair<TransactionId, edouble>& choice) const {
+      std::stringstream os;
+      os << "quantity " << choice.first->quantity()->getKey() << " " <<
+          choice.first->quantity()->lastDomain().toString() << " <= " << choice.second;
+      return os.str();
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef _H_ResourceBoundDecisionPoint
+#define _H_ResourceBoundDecisionPoint
+
+#include "ResourceThreatDecisionPoint.hh"
+#include "ResourceDefs.hh"
+#include "Resource.hh"
+#include "ConstraintEngineDefs.hh"
+
+#include <vector>
+
+namespace EUROPA {
+
+    /**
+     * @brief Resolves an instant whose production or consumption may exceed an instantaneous or cumulative
+     * limit by bounding the quantity of one contributing transaction, rather than by ordering transactions.
+     * Each choice caps one transaction's quantity so that, on its own, it removes as much of the excess
+     * as it can.  Choices are tried in descending order of the reduction they allow.  Once they are
+     * exhausted, or if no quantity can be reduced, the ordering choices of ResourceThreatDecisionPoint
+     * are tried, configured by the same attributes.
+     */
+    class ResourceBoundDecisionPoint : public ResourceThreatDecisionPoint {
+    public:
+      ResourceBoundDecisionPoint(const DbClientId client, const InstantId inst, const TiXmlElement& configData, const std::string& explanation = "unknown");
+      virtual ~ResourceBoundDecisionPoint();
+      virtual std::string toString() const;
+      virtual std::string toShortString() const;
+      /**
+       * @brief The transactions to bound, each with the upper bound to impose on its quantity.
+       * These are tried before the ordering choices.
+       */
+      const std::vector<std::pair<TransactionId, edouble> >& getBoundChoices() {return m_bounds;}
+      /**
+       * @brief The kind of flaw being resolved: one of the rate or sum problems.
+       */
+      Resource::ProblemType getProblem() const {return m_problem;}
+      virtual void handleInitialize();
+      virtual bool hasNext() const;
+      virtual bool canUndo() const;
+      virtual void handleExecute();
+      virtual void handleUndo();
+
+      /**
+       * @brief Matches only instants with a production or consumption flaw.
+       */
+      static bool customStaticMatch(const EntityId entity);
+      /**
+       * @brief Weighted above ResourceThreatDecisionPoint, so that this is preferred when both are configured.
+       * Search stays complete since the ordering choices remain available after the bounds.
+       */
+      static unsigned int customStaticFilterCount() {return 1;}
+
+    private:
+      static Resource::ProblemType selectProblem(const InstantId inst);
+      std::string toString(const std::pair<TransactionId, edouble>& choice) const;
+      bool bounding() const {return m_boundIndex < m_bounds.size();}
+
+      Resource::ProblemType m_problem;
+      edouble m_magnitude;
+      std::vector<std::pair<TransactionId, edouble> > m_bounds;
+      unsigned long m_boundIndex;
+      ConstrainedVariableId m_bound;
+      ConstraintId m_boundConstr;
+    };
+
+}
+
+#endif
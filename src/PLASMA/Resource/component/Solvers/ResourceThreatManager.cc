@@ -14,7 +14,9 @@ namespace EUROPA {
   using namespace SOLVERS;
     /**
        config attributes are "first", "second", "third".  options are
-       greatest/least, earliest/latest, upper/lower
+       greatest/least, earliest/latest, upper/lower/quantity
+       magnitude="all" makes most/least without a direction count quantity flaw magnitudes along with
+       level flaw magnitudes; the default, "level", counts level flaws only
      */
 
 //     class TimeComparator {
@@ -74,13 +76,27 @@ class ThreatIterator : public FlawIterator {
       enum FlawDirection {
         ABSOLUTE = 0,
         UPPER,
-        LOWER
+        LOWER,
+        QUANTITY
       };
 
       virtual ~InstantComparator() {}
       virtual bool operator()(const InstantId a, const InstantId b) const = 0;
       virtual std::string toString() const = 0;
       virtual InstantComparator* copy() const = 0;
+
+      static std::string directionName(const FlawDirection dir) {
+        switch(dir) {
+          case UPPER:
+            return "Upper";
+          case LOWER:
+            return "Lower";
+          case QUANTITY:
+            return "Quantity";
+          default:
+            return "Absolute";
+        }
+      }
     };
 
     DecisionOrder::~DecisionOrder() {
@@ -146,7 +162,8 @@ DecisionOrder::DecisionOrder(const DecisionOrder& other) : m_cmps() {
 
     class MostInstantComparator : public InstantComparator {
     public:
-      MostInstantComparator(const FlawDirection& dir = ABSOLUTE) : InstantComparator(), m_dir(dir) {}
+      MostInstantComparator(const FlawDirection& dir = ABSOLUTE, const bool withQuantity = false)
+        : InstantComparator(), m_dir(dir), m_withQuantity(withQuantity) {}
       bool operator()(const InstantId a, const InstantId b) const {
         if(m_dir == UPPER) {
           if(a->hasUpperLevelFlaw()) {
@@ -169,14 +186,28 @@ DecisionOrder::DecisionOrder(const DecisionOrder& other) : m_cmps() {
           else
             return false;
         }
+        else if(m_dir == QUANTITY) {
+          if(a->hasQuantityFlaw()) {
+            if(b->hasQuantityFlaw())
+              return a->getQuantityFlawMagnitude() > b->getQuantityFlawMagnitude();
+            else
+              return true;
+          }
+          else
+            return false;
+        }
         else {
           edouble flawA = 0, flawB = 0;
+          if(m_withQuantity) {
+            flawA = a->getQuantityFlawMagnitude();
+            flawB = b->getQuantityFlawMagnitude();
+          }
           if(a->hasUpperLevelFlaw())
-            flawA = a->getUpperFlawMagnitude();
+            flawA = std::max(flawA, a->getUpperFlawMagnitude());
           if(a->hasLowerLevelFlaw())
             flawA = std::max(flawA, a->getLowerFlawMagnitude());
           if(b->hasUpperLevelFlaw())
-            flawB = b->getUpperFlawMagnitude();
+            flawB = std::max(flawB, b->getUpperFlawMagnitude());
           if(b->hasLowerLevelFlaw())
             flawB = std::max(flawB, b->getLowerFlawMagnitude());
           return flawA > flawB;
@@ -184,15 +215,17 @@ DecisionOrder::DecisionOrder(const DecisionOrder& other) : m_cmps() {
         check_error(ALWAYS_FAIL);
         return false;
       }
-      std::string toString() const {return std::string("mostFlawed") + (m_dir == ABSOLUTE ? "Absolute" : (m_dir == UPPER ? "Upper" : "Lower"));}
-      InstantComparator* copy() const {return new MostInstantComparator(m_dir);}
+      std::string toString() const {return std::string("mostFlawed") + directionName(m_dir);}
+      InstantComparator* copy() const {return new MostInstantComparator(m_dir, m_withQuantity);}
     private:
       FlawDirection m_dir;
+      bool m_withQuantity; /**< Whether an absolute comparison counts quantity flaws as well as level flaws. */
     };
 
     class LeastInstantComparator : public InstantComparator {
     public:
-      LeastInstantComparator(const FlawDirection& dir = ABSOLUTE) : InstantComparator(), m_dir(dir) {}
+      LeastInstantComparator(const FlawDirection& dir = ABSOLUTE, const bool withQuantity = false)
+        : InstantComparator(), m_dir(dir), m_withQuantity(withQuantity) {}
       bool operator()(const InstantId a, const InstantId b) const {
         if(m_dir == UPPER) {
           if(a->hasUpperLevelFlaw()) {
@@ -215,14 +248,28 @@ DecisionOrder::DecisionOrder(const DecisionOrder& other) : m_cmps() {
           else
             return false;
         }
+        else if(m_dir == QUANTITY) {
+          if(a->hasQuantityFlaw()) {
+            if(b->hasQuantityFlaw())
+              return a->getQuantityFlawMagnitude() < b->getQuantityFlawMagnitude();
+            else
+              return true;
+          }
+          else
+            return false;
+        }
         else {
           edouble flawA = PLUS_INFINITY, flawB = PLUS_INFINITY;
+          if(m_withQuantity && a->hasQuantityFlaw())
+            flawA = a->getQuantityFlawMagnitude();
+          if(m_withQuantity && b->hasQuantityFlaw())
+            flawB = b->getQuantityFlawMagnitude();
           if(a->hasUpperLevelFlaw())
-            flawA = a->getUpperFlawMagnitude();
+            flawA = std::min(flawA, a->getUpperFlawMagnitude());
           if(a->hasLowerLevelFlaw())
             flawA = std::min(flawA, a->getLowerFlawMagnitude());
           if(b->hasUpperLevelFlaw())
-            flawB = b->getUpperFlawMagnitude();
+            flawB = std::min(flawB, b->getUpperFlawMagnitude());
           if(b->hasLowerLevelFlaw())
             flawB = std::min(flawB, b->getLowerFlawMagnitude());
           return flawA < flawB;
@@ -230,10 +277,11 @@ DecisionOrder::DecisionOrder(const DecisionOrder& other) : m_cmps() {
         check_error(ALWAYS_FAIL);
         return false;
       }
-      std::string toString() const {return std::string("leastFlawed") + (m_dir == ABSOLUTE ? "Absolute" : (m_dir == UPPER ? "Upper" : "Lower"));}
-      InstantComparator* copy() const {return new LeastInstantComparator(m_dir);}
+      std::string toString() const {return std::string("leastFlawed") + directionName(m_dir);}
+      InstantComparator* copy() const {return new LeastInstantComparator(m_dir, m_withQuantity);}
     private:
       FlawDirection m_dir;
+      bool m_withQuantity; /**< Whether an absolute comparison counts quantity flaws as well as level flaws. */
     };
 
     class UpperInstantComparator : public InstantComparator {
@@ -254,9 +302,28 @@ DecisionOrder::DecisionOrder(const DecisionOrder& other) : m_cmps() {
       InstantComparator* copy() const {return new LowerInstantComparator();}
     };
 
+    class QuantityInstantComparator : public InstantComparator {
+    public:
+      bool operator()(const InstantId a, const InstantId b) const {
+        return a->hasQuantityFlaw() && !b->hasQuantityFlaw();
+      }
+      std::string toString() const {return "quantityFlaw";}
+      InstantComparator* copy() const {return new QuantityInstantComparator();}
+    };
+
     //at some point, this should take data about ordering choices by earliest/latest, most/least flawed, and most/least transactions
 ResourceThreatManager::ResourceThreatManager(const TiXmlElement& configData) 
-    : FlawManager(configData), m_preferUpper(false), m_preferLower(false), m_order() {
+    : FlawManager(configData), m_preferUpper(false), m_preferLower(false), m_flaws(), m_order() {
+  //restrict the kinds of flaw handled, so that level and quantity flaws can have separate managers
+  m_flaws = (configData.Attribute("flaws") == NULL ? "all" : configData.Attribute("flaws"));
+  checkError(m_flaws == "all" || m_flaws == "level" || m_flaws == "quantity",
+             "Unknown flaws attribute '" << m_flaws << "'");
+
+  //"most" and "least" without a direction compare level flaws only, unless asked to count quantity flaws too
+  std::string magnitude = (configData.Attribute("magnitude") == NULL ? "level" : configData.Attribute("magnitude"));
+  checkError(magnitude == "level" || magnitude == "all", "Unknown magnitude attribute '" << magnitude << "'");
+  const bool withQuantity = (magnitude == "all");
+
   std::string order = (configData.Attribute("order") == NULL ? 
                        "lower,most,earliest" : configData.Attribute("order"));
       std::string::size_type curPos = 0;
@@ -279,11 +346,15 @@ ResourceThreatManager::ResourceThreatManager(const TiXmlElement& configData)
           dir = InstantComparator::UPPER;
           m_preferUpper = true;
         }
+        else if(orderStr == "quantity") {
+          m_order.addOrder(new QuantityInstantComparator());
+          dir = InstantComparator::QUANTITY;
+        }
         else if(orderStr == "most") {
-          m_order.addOrder(new MostInstantComparator(dir));
+          m_order.addOrder(new MostInstantComparator(dir, withQuantity));
         }
         else if(orderStr == "least") {
-          m_order.addOrder(new LeastInstantComparator(dir));
+          m_order.addOrder(new LeastInstantComparator(dir, withQuantity));
         }
         else {
           checkError(ALWAYS_FAIL, "Unknown decision order '" << orderStr << "'");
@@ -300,9 +371,16 @@ ResourceThreatManager::ResourceThreatManager(const TiXmlElement& configData)
       return !InstantId::convertable(entity);
     }
 
-    //there may be no dynamic information here
+    //the kinds of flaw on an instant change as it is recomputed
     bool ResourceThreatManager::dynamicMatch(const EntityId entity) {
-      return staticMatch(entity);
+      if(staticMatch(entity))
+        return true;
+      InstantId inst(entity);
+      if(m_flaws == "level")
+        return !inst->hasLevelFlaw();
+      if(m_flaws == "quantity")
+        return !inst->hasQuantityFlaw();
+      return false;
     }
 
     void ResourceThreatManager::handleInitialize() {
@@ -40,6 +40,7 @@ namespace EUROPA {
     protected:
     private:
       bool m_preferUpper, m_preferLower;
+      std::string m_flaws; /**< "all", "level", or "quantity": the kinds of flaw this manager handles. */
       DecisionOrder m_order;
     };
 }
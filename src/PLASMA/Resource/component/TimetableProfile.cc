@@ -48,9 +48,9 @@ void TimetableProfile::recomputeLevels( InstantId, InstantId inst) {
   edouble maxCumulativeProduction(m_maxPrevProduction), minCumulativeProduction(m_minPrevProduction);
   edouble maxCumulativeConsumption(m_maxPrevConsumption), minCumulativeConsumption(m_minPrevConsumption);
 
-  const std::set<TransactionId>& transactions(inst->getTransactions());
+  const TransactionSet& transactions(inst->getTransactions());
   debugMsg("TimetableProfile:recomputeLevels", "Transactions at " << inst->getTime() << ":");
-  for(std::set<TransactionId>::const_iterator it = transactions.begin(); it != transactions.end(); ++it) {
+  for(TransactionSet::const_iterator it = transactions.begin(); it != transactions.end(); ++it) {
     TransactionId trans = *it;
     edouble lb, ub;
     trans->quantity()->lastDomain().getBounds(lb, ub);
@@ -104,7 +104,7 @@ void TimetableProfile::recomputeLevels( InstantId, InstantId inst) {
                m_minPrevConsumption, m_maxPrevConsumption, m_minPrevProduction, m_maxPrevProduction);
 
   //update the values for production and consumption that must have happened by the next transaction
-  for(std::set<TransactionId>::const_iterator it = inst->getEndingTransactions().begin(); it != inst->getEndingTransactions().end(); ++it) {
+  for(TransactionSet::const_iterator it = inst->getEndingTransactions().begin(); it != inst->getEndingTransactions().end(); ++it) {
     TransactionId trans = *it;
     check_error(trans.isValid());
     edouble lb, ub;
@@ -0,0 +1,142 @@
+#ifndef H_RANDOM_FLOW_SCENARIO
+#define H_RANDOM_FLOW_SCENARIO
+
+#include "ResourceDefs.hh"
+#include "FVDetector.hh"
+#include "Profile.hh"
+#include "Transaction.hh"
+#include "ConstraintEngine.hh"
+#include "Constraints.hh"
+#include "Variable.hh"
+#include "Domains.hh"
+#include "PlanDatabase.hh"
+#include "Utils.hh"
+
+#include <vector>
+#include <boost/cstdint.hpp>
+
+namespace EUROPA {
+
+class DummyDetector : public FVDetector {
+public:
+  DummyDetector(const ResourceId res) : FVDetector(res) {};
+  bool detect(const InstantId ) {return false;}
+  void initialize(const InstantId ) {}
+  void initialize() {}
+
+  virtual PSResourceProfile* getFDLevelProfile() { return NULL; }
+  virtual PSResourceProfile* getVDLevelProfile() { return NULL; }
+};
+
+/**
+ * @brief A randomly generated set of transactions and orderings between them, rebuilt in a fresh
+ * database for each profile type so that the envelopes different max flow backends compute can be compared.
+ */
+class RandomFlowScenario {
+public:
+  typedef std::vector<std::pair<eint, std::pair<edouble, edouble> > > Envelope;
+
+  RandomFlowScenario(unsigned int seed, unsigned int transactionCount, unsigned int orderingCount)
+      : m_transactions(), m_orderings(), m_state(seed) {
+    const unsigned int horizon = 10 * transactionCount;
+    for(unsigned int i = 0; i < transactionCount; ++i) {
+      TransactionSpec spec;
+      spec.earliest = static_cast<int>(next() % horizon);
+      spec.latest = spec.earliest + static_cast<int>(next() % (horizon / 2 + 1));
+      spec.minQuantity = next() % 5;
+      spec.maxQuantity = spec.minQuantity + next() % 5;
+      spec.consumer = (next() % 2 == 0);
+      m_transactions.push_back(spec);
+    }
+    for(unsigned int i = 0; i < orderingCount && transactionCount > 1; ++i) {
+      OrderingSpec spec;
+      spec.first = next() % transactionCount;
+      spec.second = next() % transactionCount;
+      spec.concurrent = (next() % 8 == 0);
+      if(spec.first != spec.second)
+        m_orderings.push_back(spec);
+    }
+  }
+
+  /**
+   * @brief Compute the envelope with a Profile of the given type, in an empty, closed database.
+   * @return false if the orderings are temporally inconsistent, in which case there is no envelope.
+   */
+  template<typename ProfileType>
+  bool computeEnvelope(ConstraintEngine& ce, PlanDatabase& db, Envelope& envelope) const {
+    DummyDetector detector(ResourceId::noId());
+    ProfileType profile(db.getId(), detector.getId());
+
+    std::vector<ConstrainedVariableId> variables;
+    std::vector<TransactionId> transactions;
+    std::vector<ConstraintId> constraints;
+    for(std::vector<TransactionSpec>::const_iterator it = m_transactions.begin(); it != m_transactions.end(); ++it) {
+      ConstrainedVariableId time =
+          (new Variable<IntervalIntDomain>(ce.getId(), IntervalIntDomain(it->earliest, it->latest), false, true, "t"))->getId();
+      ConstrainedVariableId quantity =
+          (new Variable<IntervalDomain>(ce.getId(), IntervalDomain(it->minQuantity, it->maxQuantity), false, true, "q"))->getId();
+      variables.push_back(time);
+      variables.push_back(quantity);
+      transactions.push_back((new Transaction(time, quantity, it->consumer, EntityId::noId()))->getId());
+    }
+    for(std::vector<OrderingSpec>::const_iterator it = m_orderings.begin(); it != m_orderings.end(); ++it) {
+      std::vector<ConstrainedVariableId> scope =
+          makeScope(transactions[it->first]->time(), transactions[it->second]->time());
+      if(it->concurrent)
+        constraints.push_back((new EqualConstraint("concurrent", "Temporal", ce.getId(), scope))->getId());
+      else
+        constraints.push_back((new LessThanEqualConstraint("precedes", "Temporal", ce.getId(), scope))->getId());
+    }
+
+    bool consistent = ce.propagate();
+    if(consistent) {
+      for(std::vector<TransactionId>::const_iterator it = transactions.begin(); it != transactions.end(); ++it)
+        profile.addTransaction(*it);
+      profile.recompute();
+
+      envelope.clear();
+      for(ProfileIterator ite(profile.getId()); !ite.done(); ite.next())
+        envelope.push_back(std::make_pair(ite.getTime(), std::make_pair(ite.getLowerBound(), ite.getUpperBound())));
+
+      for(std::vector<TransactionId>::const_iterator it = transactions.begin(); it != transactions.end(); ++it)
+        profile.removeTransaction(*it);
+    }
+
+    for(std::vector<ConstraintId>::const_iterator it = constraints.begin(); it != constraints.end(); ++it)
+      delete static_cast<Constraint*>(*it);
+    for(std::vector<TransactionId>::const_iterator it = transactions.begin(); it != transactions.end(); ++it)
+      delete static_cast<Transaction*>(*it);
+    for(std::vector<ConstrainedVariableId>::const_iterator it = variables.begin(); it != variables.end(); ++it)
+      delete static_cast<ConstrainedVariable*>(*it);
+    return consistent;
+  }
+
+private:
+  struct TransactionSpec {
+    int earliest, latest;
+    double minQuantity, maxQuantity;
+    bool consumer;
+  };
+
+  struct OrderingSpec {
+    unsigned int first, second;
+    bool concurrent;
+  };
+
+  /**
+   * @brief The next number from a linear congruential generator seeded by the constructor. The scenario keeps
+   * its own, so the same seed gives the same scenario everywhere, and random() is left alone.
+   */
+  unsigned int next() {
+    m_state = 1664525u * m_state + 1013904223u;
+    return m_state >> 8; // The low bits of the state have short periods
+  }
+
+  std::vector<TransactionSpec> m_transactions;
+  std::vector<OrderingSpec> m_orderings;
+  boost::uint32_t m_state;
+};
+
+}
+
+#endif /* H_RANDOM_FLOW_SCENARIO */
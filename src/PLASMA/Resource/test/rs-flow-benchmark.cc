@@ -0,0 +1,75 @@
+/**
+ * Times envelope computation with each max flow backend on random transaction sets of increasing size.
+ * Not part of the unit tests; run rs-flow-benchmark by hand to compare the backends.
+ */
+
+#include "RandomFlowScenario.hh"
+#include "BoostFlowProfile.hh"
+#include "ResidualFlowProfile.hh"
+#include "Schema.hh"
+#include "Engine.hh"
+#include "ModuleConstraintEngine.hh"
+#include "ModulePlanDatabase.hh"
+#include "ModuleTemporalNetwork.hh"
+#include "ModuleRulesEngine.hh"
+#include "ModuleSolvers.hh"
+#include "ModuleResource.hh"
+#include "ModuleNddl.hh"
+
+#include <ctime>
+#include <iostream>
+#include <boost/cast.hpp>
+
+using namespace EUROPA;
+
+namespace {
+class BenchmarkEngine : public EngineBase {
+public:
+  BenchmarkEngine() {
+    addModule((new ModuleConstraintEngine())->getId());
+    addModule((new ModuleConstraintLibrary())->getId());
+    addModule((new ModulePlanDatabase())->getId());
+    addModule((new ModuleRulesEngine())->getId());
+    addModule((new ModuleTemporalNetwork())->getId());
+    addModule((new ModuleSolvers())->getId());
+    addModule((new ModuleResource())->getId());
+    addModule((new ModuleNddl())->getId());
+    doStart();
+    boost::polymorphic_cast<Schema*>(getComponent("Schema"))->addObjectType("Resource");
+  }
+  virtual ~BenchmarkEngine() {doShutdown();}
+};
+
+/**
+ * Computes the envelope in a fresh engine.
+ * @return The time taken, in seconds.
+ */
+template<typename ProfileType>
+double timeEnvelope(const RandomFlowScenario& scenario, RandomFlowScenario::Envelope& envelope) {
+  BenchmarkEngine engine;
+  ConstraintEngine& ce = *boost::polymorphic_cast<ConstraintEngine*>(engine.getComponent("ConstraintEngine"));
+  PlanDatabase& db = *boost::polymorphic_cast<PlanDatabase*>(engine.getComponent("PlanDatabase"));
+  db.close();
+
+  std::clock_t start = std::clock();
+  scenario.computeEnvelope<ProfileType>(ce, db, envelope);
+  return static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+}
+}
+
+int main(int, char**) {
+  std::cout << "transactions orderings boost(s) dinic(s) bk(s)" << std::endl;
+  for(unsigned int size = 25; size <= 400; size *= 2) {
+    RandomFlowScenario scenario(size, size, size * 2);
+    RandomFlowScenario::Envelope boost, dinic, bk;
+    const double boostTime = timeEnvelope<BoostFlowProfile>(scenario, boost);
+    const double dinicTime = timeEnvelope<DinicFlowProfile>(scenario, dinic);
+    const double bkTime = timeEnvelope<BKFlowProfile>(scenario, bk);
+    if(dinic != boost || bk != boost) {
+      std::cerr << "Backends disagree on the envelope for " << size << " transactions" << std::endl;
+      return 1;
+    }
+    std::cout << size << " " << size * 2 << " " << boostTime << " " << dinicTime << " " << bkTime << std::endl;
+  }
+  return 0;
+}
@@ -12,6 +12,8 @@
 #include "ClosedWorldFVDetector.hh"
 #include "BoostFlowProfile.hh"
 #include "BoostFlowProfileGraph.hh"
+#include "ResidualFlowProfile.hh"
+#include "RandomFlowScenario.hh"
 
 #include "Debug.hh"
 #include "Engine.hh"
@@ -33,6 +35,7 @@
 #include <iostream>
 #include <string>
 #include <list>
+#include <vector>
 #include <boost/cast.hpp>
 
 using namespace EUROPA;
@@ -76,17 +79,6 @@ private:
   }
 };
 
-class DummyDetector : public FVDetector {
-public:
-  DummyDetector(const ResourceId res) : FVDetector(res) {};
-  bool detect(const InstantId ) {return false;}
-  void initialize(const InstantId ) {}
-  void initialize() {}
-
-  virtual PSResourceProfile* getFDLevelProfile() { return NULL; }
-  virtual PSResourceProfile* getVDLevelProfile() { return NULL; }
-};
-
 // class BoostFlowProfile : public FlowProfile {
 //  public:
 //   BoostFlowProfile(const PlanDatabaseId db, const FVDetectorId flawDetector)
@@ -147,6 +139,84 @@ public:
 
   }
 
+  static bool dinicFlowProfileTest() {
+    debugMsg("ResourceTest"," DinicFlowProfile ");
+
+    testAddAndRemove<DinicFlowProfile>();
+    testScenario0<DinicFlowProfile>();
+    testScenario1<DinicFlowProfile>();
+    testScenario2<DinicFlowProfile>();
+    testScenario3<DinicFlowProfile>();
+    testScenario4<DinicFlowProfile>();
+    testScenario5<DinicFlowProfile>();
+    testScenario6<DinicFlowProfile>();
+    testScenario7<DinicFlowProfile>();
+    testScenario8<DinicFlowProfile>();
+    testScenario9<DinicFlowProfile>();
+    testScenario10<DinicFlowProfile>();
+    testScenario11<DinicFlowProfile>();
+    testScenario12<DinicFlowProfile>();
+    testScenario13<DinicFlowProfile>();
+    testScenario14<DinicFlowProfile>();
+    testPaulBug<DinicFlowProfile>();
+    return true;
+  }
+
+  static bool bkFlowProfileTest() {
+    debugMsg("ResourceTest"," BKFlowProfile ");
+
+    testAddAndRemove<BKFlowProfile>();
+    testScenario0<BKFlowProfile>();
+    testScenario1<BKFlowProfile>();
+    testScenario2<BKFlowProfile>();
+    testScenario3<BKFlowProfile>();
+    testScenario4<BKFlowProfile>();
+    testScenario5<BKFlowProfile>();
+    testScenario6<BKFlowProfile>();
+    testScenario7<BKFlowProfile>();
+    testScenario8<BKFlowProfile>();
+    testScenario9<BKFlowProfile>();
+    testScenario10<BKFlowProfile>();
+    testScenario11<BKFlowProfile>();
+    testScenario12<BKFlowProfile>();
+    testScenario13<BKFlowProfile>();
+    testScenario14<BKFlowProfile>();
+    testPaulBug<BKFlowProfile>();
+    return true;
+  }
+
+  template<typename ProfileType>
+  static bool computeEnvelope(const RandomFlowScenario& scenario, RandomFlowScenario::Envelope& envelope) {
+    RESOURCE_DEFAULT_SETUP(ce, db, true);
+    return scenario.computeEnvelope<ProfileType>(ce, db, envelope);
+  }
+
+  /**
+   * Every backend must compute the same envelope for the same transactions.
+   */
+  static bool differentialFlowProfileTest() {
+    debugMsg("ResourceTest"," Differential ");
+
+    unsigned int compared = 0;
+    for(unsigned int seed = 1; seed <= 60; ++seed) {
+      RandomFlowScenario scenario(seed, 2 + seed % 19, seed % 23);
+      RandomFlowScenario::Envelope pushRelabel, boost, dinic, bk;
+      bool consistent = computeEnvelope<EUROPA::FlowProfile>(scenario, pushRelabel);
+      CPPUNIT_ASSERT(computeEnvelope<BoostFlowProfile>(scenario, boost) == consistent);
+      CPPUNIT_ASSERT(computeEnvelope<DinicFlowProfile>(scenario, dinic) == consistent);
+      CPPUNIT_ASSERT(computeEnvelope<BKFlowProfile>(scenario, bk) == consistent);
+      if(!consistent)
+        continue;
+      debugMsg("ResourceTest:differential", "Comparing " << pushRelabel.size() << " instants for seed " << seed);
+      CPPUNIT_ASSERT(boost == pushRelabel);
+      CPPUNIT_ASSERT(dinic == pushRelabel);
+      CPPUNIT_ASSERT(bk == pushRelabel);
+      ++compared;
+    }
+    CPPUNIT_ASSERT(compared > 0);
+    return true;
+  }
+
   static bool incrementalFlowProfileTest() {
      debugMsg("ResourceTest"," IncrementalFlowProfile ");
 
@@ -173,7 +243,10 @@ public:
   static bool test(){
     return 
         // flowProfileTest() && 
-        boostFlowProfileTest() //&& 
+        boostFlowProfileTest() &&
+        dinicFlowProfileTest() &&
+        bkFlowProfileTest() &&
+        differentialFlowProfileTest() //&&
         //incrementalFlowProfileTest()
         ;
   }
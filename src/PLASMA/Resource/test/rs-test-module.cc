@@ -26,6 +26,7 @@
 #include "Debug.hh"
 
 #include "ThreatDecisionPoint.hh"
+#include "Solver.hh"
 #include "Context.hh"
 #include "Profile.hh"
 #include "FlowProfile.hh"
@@ -35,6 +36,7 @@
 #include "ClosedWorldFVDetector.hh"
 #include "DurativeTokens.hh"
 #include "ResourceThreatDecisionPoint.hh"
+#include "ResourceBoundDecisionPoint.hh"
 #include "ResourceThreatManager.hh"
 #include "ProfilePropagator.hh"
 #include "ResourceMatching.hh"
@@ -1107,14 +1109,14 @@ private:
     InstantId inst = profile.getInstant(0);
     CPPUNIT_ASSERT(inst.isValid());
     CPPUNIT_ASSERT(inst->getTime() == 0);
-    for(std::set<TransactionId>::const_iterator it = inst->getTransactions().begin();
+    for(TransactionSet::const_iterator it = inst->getTransactions().begin();
 	it != inst->getTransactions().end(); ++it) {
       CPPUNIT_ASSERT((*it).isValid());
       CPPUNIT_ASSERT((*it) == trans1->getId());
     }
 
     //for time 5
-    std::set<TransactionId> trans;
+    TransactionSet trans;
     trans.insert(trans1->getId());
     trans.insert(trans3->getId());
     trans.insert(trans4->getId());
@@ -1122,7 +1124,7 @@ private:
     inst = profile.getInstant(5);
     CPPUNIT_ASSERT(inst.isValid());
     CPPUNIT_ASSERT(inst->getTime() == 5);
-    for(std::set<TransactionId>::const_iterator it = inst->getTransactions().begin();
+    for(TransactionSet::const_iterator it = inst->getTransactions().begin();
 	it != inst->getTransactions().end(); ++it) {
       CPPUNIT_ASSERT((*it).isValid());
       CPPUNIT_ASSERT(trans.find(*it) != trans.end());
@@ -1139,7 +1141,7 @@ private:
     inst = profile.getInstant(10);
     CPPUNIT_ASSERT(inst.isValid());
     CPPUNIT_ASSERT(inst->getTime() == 10);
-    for(std::set<TransactionId>::const_iterator it = inst->getTransactions().begin();
+    for(TransactionSet::const_iterator it = inst->getTransactions().begin();
 	it != inst->getTransactions().end(); ++it) {
       CPPUNIT_ASSERT((*it).isValid());
       CPPUNIT_ASSERT(trans.find(*it) != trans.end());
@@ -1155,7 +1157,7 @@ private:
     inst = profile.getInstant(15);
     CPPUNIT_ASSERT(inst.isValid());
     CPPUNIT_ASSERT(inst->getTime() == 15);
-    for(std::set<TransactionId>::const_iterator it = inst->getTransactions().begin();
+    for(TransactionSet::const_iterator it = inst->getTransactions().begin();
 	it != inst->getTransactions().end(); ++it) {
       CPPUNIT_ASSERT((*it).isValid());
       CPPUNIT_ASSERT(trans.find(*it) != trans.end());
@@ -1178,6 +1180,8 @@ public:
     EUROPA_runTest(testReusable);
     EUROPA_runTest(testReservoirRemove);
     EUROPA_runTest(testDanglingTransaction);
+    EUROPA_runTest(testReservoirBalance);
+    EUROPA_runTest(testReservoirBalanceSteps);
     return true;
   }
 private:
@@ -1318,6 +1322,109 @@ private:
     return true;
   }
 
+  /**
+   * A consumer of 5 that must precede a producer of 5 on a reservoir starting at 3 can never
+   * be satisfied, but no instant's level bounds show it.
+   */
+  static bool propagateConsumerBeforeProducer(bool balance) {
+    RESOURCE_DEFAULT_SETUP(ce, db, false);
+    id_cast<ProfilePropagator>(ce.getPropagatorByName("Resource"))->setBalancePropagation(balance);
+    Reservoir res1(db.getId(), "Reservoir", "Battery1",
+                   "ClosedWorldFVDetector", "TimetableProfile",
+                   3, 3, 0, 1000);
+    ConsumerToken c1(db.getId(), "Reservoir.consume", IntervalIntDomain(0, 100), IntervalDomain(5));
+    ProducerToken p1(db.getId(), "Reservoir.produce", IntervalIntDomain(0, 100), IntervalDomain(5));
+    ConstrainedVariableId d1 =
+        db.getClient()->createVariable("int", IntervalIntDomain(1, PLUS_INFINITY), "d1");
+    db.getClient()->createConstraint("temporalDistance", makeScope(c1.getTime(), d1, p1.getTime()));
+    return ce.propagate();
+  }
+
+  static bool testReservoirBalance() {
+    CPPUNIT_ASSERT(propagateConsumerBeforeProducer(false));
+    CPPUNIT_ASSERT(!propagateConsumerBeforeProducer(true));
+
+    RESOURCE_DEFAULT_SETUP(ce, db, false);
+    ProfilePropagator* propagator = id_cast<ProfilePropagator>(ce.getPropagatorByName("Resource"));
+    CPPUNIT_ASSERT(!propagator->getBalancePropagation());
+    propagator->setBalancePropagation(true);
+
+    Reservoir res1(db.getId(), "Reservoir", "Battery1",
+                   "ClosedWorldFVDetector", "TimetableProfile",
+                   0, 0, 0, 10);
+    ProducerToken p1(db.getId(), "Reservoir.produce", IntervalIntDomain(20, 100), IntervalDomain(0, 10));
+    ConsumerToken c1(db.getId(), "Reservoir.consume", IntervalIntDomain(0, 100), IntervalDomain(5, 15));
+    CPPUNIT_ASSERT(ce.propagate());
+
+    // Only p1 can supply c1, so c1 can't happen before p1 can or take more than p1 can make
+    CPPUNIT_ASSERT(c1.getTime()->lastDomain().getLowerBound() == 20);
+    CPPUNIT_ASSERT(c1.getQuantity()->lastDomain().getUpperBound() == 10);
+    CPPUNIT_ASSERT(c1.getQuantity()->lastDomain().getLowerBound() == 5);
+    CPPUNIT_ASSERT(p1.getTime()->lastDomain().getLowerBound() == 20);
+
+    p1.getTime()->specify(50);
+    CPPUNIT_ASSERT(ce.propagate());
+    CPPUNIT_ASSERT(c1.getTime()->lastDomain().getLowerBound() == 50);
+
+    // Relaxing p1 relaxes what was inferred from it
+    p1.getTime()->reset();
+    CPPUNIT_ASSERT(ce.propagate());
+    CPPUNIT_ASSERT(c1.getTime()->lastDomain().getLowerBound() == 20);
+
+    // Variables whose restriction has been undone are no longer tracked
+    CPPUNIT_ASSERT(!res1.getProfile()->getTightenedVariables().empty());
+    propagator->setBalancePropagation(false);
+    p1.getTime()->specify(50);
+    CPPUNIT_ASSERT(ce.propagate());
+    p1.getTime()->reset();
+    CPPUNIT_ASSERT(ce.propagate());
+    CPPUNIT_ASSERT(c1.getTime()->lastDomain().getLowerBound() == 0);
+    CPPUNIT_ASSERT(res1.getProfile()->getTightenedVariables().empty());
+
+    RESOURCE_DEFAULT_TEARDOWN();
+    return true;
+  }
+
+  /**
+   * A consumer of 5 on an empty reservoir can't happen before the producer that covers it, which is no
+   * earlier than 20.  Without balance propagation, a solver assigning times tries each earlier time first.
+   */
+  static unsigned int solveConsumerAfterProducer(bool balance) {
+    RESOURCE_DEFAULT_SETUP(ce, db, false);
+    id_cast<ProfilePropagator>(ce.getPropagatorByName("Resource"))->setBalancePropagation(balance);
+    Reservoir res1(db.getId(), "Reservoir", "Battery1",
+                   "ClosedWorldFVDetector", "TimetableProfile",
+                   0, 0, 0, 10);
+    db.close();
+    ProducerToken p1(db.getId(), "Reservoir.produce", IntervalIntDomain(20, 30), IntervalDomain(10));
+    ConsumerToken c1(db.getId(), "Reservoir.consume", IntervalIntDomain(0, 30), IntervalDomain(5));
+    CPPUNIT_ASSERT(ce.propagate());
+
+    std::string config =
+        "<Solver name=\"BalanceTestSolver\"><UnboundVariableManager defaultPriority=\"0\">"
+        "<FlawHandler component=\"StandardVariableHandler\"/></UnboundVariableManager></Solver>";
+    TiXmlElement* configXml = initXml(config);
+    unsigned int steps = 0;
+    {
+      SOLVERS::Solver solver(db.getId(), *configXml);
+      CPPUNIT_ASSERT(solver.solve(100, 100));
+      CPPUNIT_ASSERT(c1.getTime()->lastDomain().getSingletonValue() >= 20);
+      steps = solver.getStepCount();
+    }
+    delete configXml;
+    RESOURCE_DEFAULT_TEARDOWN();
+    return steps;
+  }
+
+  static bool testReservoirBalanceSteps() {
+    const unsigned int withoutBalance = solveConsumerAfterProducer(false);
+    const unsigned int withBalance = solveConsumerAfterProducer(true);
+    debugMsg("ResourceTest:testReservoirBalanceSteps",
+             "Solved in " << withBalance << " steps with balance propagation and " << withoutBalance << " without");
+    CPPUNIT_ASSERT(withBalance < withoutBalance);
+    return true;
+  }
+
   static bool testReservoirRemove() {
     RESOURCE_DEFAULT_SETUP(ce, db, false);
     //setup two reservoirs
@@ -1362,11 +1469,11 @@ private:
     //should create two transactions and four instants
     ProfileIterator it(res.getProfile());
     CPPUNIT_ASSERT(!it.done());
-    std::set<TransactionId> trans;
+    TransactionSet trans;
     int instCount = 0;
     while(!it.done()) {
       InstantId inst = it.getInstant();
-      for(std::set<TransactionId>::const_iterator transIt = inst->getTransactions().begin(); transIt != inst->getTransactions().end(); ++transIt)
+      for(TransactionSet::const_iterator transIt = inst->getTransactions().begin(); transIt != inst->getTransactions().end(); ++transIt)
 	trans.insert(*transIt);
       instCount++;
       it.next();
@@ -1486,6 +1593,9 @@ class ResourceSolverTest {
     EUROPA_runTest(testResourceThreatDecisionPoint);
     EUROPA_runTest(testResourceThreatManager);
     EUROPA_runTest(testResourceThreatManagerNoMoreFlaws);
+    EUROPA_runTest(testRateLimitBoundDecisionPoint);
+    EUROPA_runTest(testSumLimitBoundDecisionPoint);
+    EUROPA_runTest(testFixedQuantityBoundDecisionPoint);
     return true;
   }
  private:
@@ -1963,6 +2073,189 @@ class ResourceSolverTest {
     delete earliestXml;
     return true;
   }
+
+  /**
+   * Two consumers of up to 8 at the same time may exceed a rate limit of 10 by 6.  Bounding either one
+   * to 2 resolves the flaw.
+   */
+  static bool testRateLimitBoundDecisionPoint() {
+    RESOURCE_DEFAULT_SETUP(ceObj, dbObj, false);
+
+    PlanDatabaseId db = dbObj.getId();
+    ConstraintEngineId ce = ceObj.getId();
+    DbClientId client = db->getClient();
+
+    Reservoir res(db, "Reservoir", "rateLimited", "ClosedWorldFVDetector", "TimetableProfile",
+                  100, 100, 0, 1000, PLUS_INFINITY, 10, PLUS_INFINITY, PLUS_INFINITY);
+    ConsumerToken c1(db, "Reservoir.consume", IntervalIntDomain(10), IntervalDomain(0, 8));
+    ConsumerToken c2(db, "Reservoir.consume", IntervalIntDomain(10), IntervalDomain(0, 8));
+    CPPUNIT_ASSERT(ce->propagate());
+
+    std::vector<InstantId> flawedInstants;
+    res.getFlawedInstants(flawedInstants);
+    CPPUNIT_ASSERT(flawedInstants.size() == 1);
+    InstantId inst = flawedInstants[0];
+    CPPUNIT_ASSERT(inst->hasConsumptionRateFlaw());
+    CPPUNIT_ASSERT(inst->getConsumptionRateFlawMagnitude() == 6);
+    CPPUNIT_ASSERT(inst->getQuantityFlawMagnitude() == 6);
+    CPPUNIT_ASSERT(!inst->hasConsumptionSumFlaw());
+    CPPUNIT_ASSERT(!inst->hasProductionRateFlaw());
+    CPPUNIT_ASSERT(!inst->hasLevelFlaw());
+    CPPUNIT_ASSERT(ResourceBoundDecisionPoint::customStaticMatch(inst));
+
+    TiXmlElement dummy("");
+    ResourceBoundDecisionPoint dp(client, inst, dummy);
+    dp.initialize();
+    CPPUNIT_ASSERT(dp.getProblem() == Resource::ConsumptionRateExceeded);
+    CPPUNIT_ASSERT(dp.getBoundChoices().size() == 2);
+    CPPUNIT_ASSERT(dp.getBoundChoices()[0].second == 2);
+    CPPUNIT_ASSERT(dp.getBoundChoices()[1].second == 2);
+
+    ConstrainedVariableId bounded = dp.getBoundChoices()[0].first->quantity();
+    dp.execute();
+    CPPUNIT_ASSERT(ce->propagate());
+    CPPUNIT_ASSERT(bounded->lastDomain().getUpperBound() == 2);
+    flawedInstants.clear();
+    res.getFlawedInstants(flawedInstants);
+    CPPUNIT_ASSERT(flawedInstants.empty());
+
+    dp.undo();
+    CPPUNIT_ASSERT(ce->propagate());
+    CPPUNIT_ASSERT(bounded->lastDomain().getUpperBound() == 8);
+    res.getFlawedInstants(flawedInstants);
+    CPPUNIT_ASSERT(flawedInstants.size() == 1);
+    CPPUNIT_ASSERT(dp.hasNext());
+
+    RESOURCE_DEFAULT_TEARDOWN();
+    return true;
+  }
+
+  /**
+   * Consumers of up to 8, 15 and 4 may consume 27 by time 20 against a total limit of 20.  Only the
+   * first two can absorb all of the excess, so they come first.
+   */
+  static bool testSumLimitBoundDecisionPoint() {
+    RESOURCE_DEFAULT_SETUP(ceObj, dbObj, false);
+
+    PlanDatabaseId db = dbObj.getId();
+    ConstraintEngineId ce = ceObj.getId();
+    DbClientId client = db->getClient();
+
+    Reservoir res(db, "Reservoir", "sumLimited", "ClosedWorldFVDetector", "TimetableProfile",
+                  100, 100, 0, 1000, PLUS_INFINITY, PLUS_INFINITY, PLUS_INFINITY, 20);
+    ConsumerToken c1(db, "Reservoir.consume", IntervalIntDomain(10), IntervalDomain(0, 8));
+    ConsumerToken c2(db, "Reservoir.consume", IntervalIntDomain(20), IntervalDomain(5, 15));
+    ConsumerToken c3(db, "Reservoir.consume", IntervalIntDomain(15, 30), IntervalDomain(0, 4));
+    CPPUNIT_ASSERT(ce->propagate());
+
+    std::vector<InstantId> flawedInstants;
+    res.getFlawedInstants(flawedInstants);
+    CPPUNIT_ASSERT(flawedInstants.size() == 2);
+    InstantId inst = flawedInstants[0];
+    CPPUNIT_ASSERT(inst->getTime() == 20);
+    CPPUNIT_ASSERT(inst->hasConsumptionSumFlaw());
+    CPPUNIT_ASSERT(inst->getConsumptionSumFlawMagnitude() == 7);
+    CPPUNIT_ASSERT(!inst->hasConsumptionRateFlaw());
+    CPPUNIT_ASSERT(!inst->hasLevelFlaw());
+
+    // Managers can be restricted to one kind of flaw
+    SOLVERS::Context ctx("foo");
+    std::string level = "<ResourceThreatManager flaws=\"level\"><FlawHandler component=\"ResourceThreatHandler\"/></ResourceThreatManager>";
+    TiXmlElement* levelXml = initXml(level);
+    ResourceThreatManager levelManager(*levelXml);
+    levelManager.initialize(*levelXml, db, ctx.getId(), SOLVERS::FlawManagerId::noId());
+    CPPUNIT_ASSERT(levelManager.noMoreFlaws());
+
+    std::string quantity = "<ResourceThreatManager flaws=\"quantity\" order=\"quantity,most,earliest\"><FlawHandler component=\"ResourceBoundHandler\"/></ResourceThreatManager>";
+    TiXmlElement* quantityXml = initXml(quantity);
+    ResourceThreatManager quantityManager(*quantityXml);
+    quantityManager.initialize(*quantityXml, db, ctx.getId(), SOLVERS::FlawManagerId::noId());
+    CPPUNIT_ASSERT(!quantityManager.noMoreFlaws());
+    std::string explanation;
+    CPPUNIT_ASSERT(quantityManager.betterThan(flawedInstants[0], flawedInstants[1], explanation));
+    CPPUNIT_ASSERT(explanation == "earliest");
+
+    TiXmlElement dummy("");
+    ResourceBoundDecisionPoint dp(client, inst, dummy);
+    dp.initialize();
+    CPPUNIT_ASSERT(dp.getProblem() == Resource::ConsumptionSumExceeded);
+    CPPUNIT_ASSERT(dp.getBoundChoices().size() == 3);
+    CPPUNIT_ASSERT(dp.getBoundChoices()[2].first->quantity() == c3.getQuantity());
+    CPPUNIT_ASSERT(dp.getBoundChoices()[2].second == 0);
+
+    dp.execute();
+    CPPUNIT_ASSERT(ce->propagate());
+    flawedInstants.clear();
+    res.getFlawedInstants(flawedInstants);
+    CPPUNIT_ASSERT(flawedInstants.empty());
+    CPPUNIT_ASSERT(quantityManager.noMoreFlaws());
+
+    dp.undo();
+    CPPUNIT_ASSERT(ce->propagate());
+    CPPUNIT_ASSERT(!quantityManager.noMoreFlaws());
+
+    delete quantityXml;
+    delete levelXml;
+    RESOURCE_DEFAULT_TEARDOWN();
+    return true;
+  }
+
+  /**
+   * Two uses of 8 against an instantaneous limit of 10 may start together at 10.  Their quantities are
+   * fixed, so nothing can be bounded and only ordering the end of the first before the start of the
+   * second separates them.
+   */
+  static bool testFixedQuantityBoundDecisionPoint() {
+    RESOURCE_DEFAULT_SETUP(ceObj, dbObj, false);
+
+    PlanDatabaseId db = dbObj.getId();
+    ConstraintEngineId ce = ceObj.getId();
+    DbClientId client = db->getClient();
+
+    Reusable res(db, "Reusable", "rateLimited", "ClosedWorldFVDetector", "TimetableProfile", 20, 20, 0, 10);
+    ReusableToken tok1(db, "Reusable.uses", IntervalIntDomain(0, 10), IntervalIntDomain(10, 20),
+                       IntervalIntDomain(10), IntervalDomain(8), "rateLimited");
+    ReusableToken tok2(db, "Reusable.uses", IntervalIntDomain(10), IntervalIntDomain(20),
+                       IntervalIntDomain(10), IntervalDomain(8), "rateLimited");
+    CPPUNIT_ASSERT(ce->propagate());
+
+    std::vector<InstantId> flawedInstants;
+    res.getFlawedInstants(flawedInstants);
+    CPPUNIT_ASSERT(!flawedInstants.empty());
+    InstantId inst = flawedInstants[0];
+    CPPUNIT_ASSERT(inst->getTime() == 10);
+    CPPUNIT_ASSERT(inst->hasConsumptionRateFlaw());
+    CPPUNIT_ASSERT(ResourceBoundDecisionPoint::customStaticMatch(inst));
+
+    TiXmlElement dummy("");
+    ResourceBoundDecisionPoint dp(client, inst, dummy);
+    dp.initialize();
+    CPPUNIT_ASSERT(dp.getBoundChoices().empty());
+    CPPUNIT_ASSERT(!dp.getChoices().empty());
+    CPPUNIT_ASSERT(dp.hasNext());
+
+    bool resolved = false;
+    while(!resolved && dp.hasNext()) {
+      dp.execute();
+      if(ce->propagate()) {
+        flawedInstants.clear();
+        res.getFlawedInstants(flawedInstants);
+        resolved = flawedInstants.empty();
+      }
+      if(!resolved)
+        dp.undo();
+    }
+    CPPUNIT_ASSERT(resolved);
+    CPPUNIT_ASSERT(tok1.start()->lastDomain().isSingleton() && tok1.start()->lastDomain().getSingletonValue() == 0);
+
+    dp.undo();
+    CPPUNIT_ASSERT(ce->propagate());
+    res.getFlawedInstants(flawedInstants);
+    CPPUNIT_ASSERT(!flawedInstants.empty());
+
+    RESOURCE_DEFAULT_TEARDOWN();
+    return true;
+  }
 };
 
 void ResourceModuleTests::cppSetup(void)
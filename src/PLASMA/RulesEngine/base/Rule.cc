@@ -87,4 +87,9 @@ void RuleSchema::purgeAll() {
 
         return os.str();
     }
+
+    bool Rule::describe(RuleBody&) const
+    {
+        return false;
+    }
 }
@@ -12,6 +12,7 @@
 
 #include "RulesEngineDefs.hh"
 #include "Engine.hh"
+#include <string>
 #include <vector>
 #include <map>
 
@@ -52,6 +53,45 @@ namespace EUROPA {
     std::multimap<std::string, RuleId> m_rulesByName;
   };
 
+  /**
+   * @class RuleBody
+   * @brief The slaves and constraints a rule makes every time it fires, given as data. Tokens are named as the
+   * rule names them: "this" is the token the rule fires on, and each slave has the name it is declared with.
+   */
+  class RuleBody {
+  public:
+    struct Slave {
+      std::string name; /*!< Empty if the rule doesn't name it */
+      std::string predicate;
+      std::string relation; /*!< Of the slave to the token the rule fires on */
+    };
+
+    /**
+     * @brief A constraint argument. Either a variable, named by a path such as "duration", "rest.start" or the
+     * name of a global, or a constant if the path is empty.
+     */
+    struct Argument {
+      Argument(const std::string& _path) : path(_path), type(), lb(0), ub(0) {}
+      Argument(const DataTypeId _type, const edouble _lb, const edouble _ub) : path(), type(_type), lb(_lb), ub(_ub) {}
+
+      std::string path;
+      DataTypeId type;
+      edouble lb;
+      edouble ub;
+    };
+
+    struct ConstraintSpec {
+      std::string name;
+      std::vector<Argument> args;
+    };
+
+    RuleBody() : slaves(), constraints(), unchecked() {}
+
+    std::vector<Slave> slaves;
+    std::vector<ConstraintSpec> constraints;
+    std::vector<std::string> unchecked; /*!< Parts of the body that could not be given as data, such as guarded ones */
+  };
+
   /**
    * @class Rule
    * @brief Defines an abstract base class that is implemented by a provider of rules.
@@ -81,6 +121,12 @@ namespace EUROPA {
 
       virtual std::string toString() const;
 
+      /**
+       * @brief Describe what every instance of this rule makes, without making anything.
+       * @return false if the rule can't describe its body, which is the default.
+       */
+      virtual bool describe(RuleBody& body) const;
+
     protected:
       /**
        * @brief Constructor.
@@ -165,6 +165,18 @@ namespace EUROPA{
 
     const std::vector<ConstrainedVariableId> &getGuards(void) const { return m_guards;}
 
+    /**
+     * @brief The domain of an explicit guard on the first guard variable, or 0 if the guards are implied.
+     */
+    const Domain* getGuardDomain() const {return m_guardDomain;}
+
+    /**
+     * @brief False if the explicit guard is a negative test.
+     */
+    bool isPositive() const {return m_isPositive;}
+
+    const ConstraintId getGuardListener() const {return m_guardListener;}
+
     const std::vector<ConstrainedVariableId> &getVariables(void) const { return m_variables;}
 
     /**
@@ -12,14 +12,14 @@ RuleVariableListener::RuleVariableListener(const std::string& name,
                                            const ConstraintEngineId constraintEngine,
                                            const std::vector<ConstrainedVariableId>& scope)
     : Constraint(name, propagatorName, constraintEngine, scope), m_ruleInstance(), 
-      m_sourceConstraint() {}
+      m_sourceConstraint(), m_guardTests(), m_dependencies() {}
 
 
 RuleVariableListener::RuleVariableListener(const ConstraintEngineId constraintEngine,
                                            const RuleInstanceId ruleInstance,
                                            const std::vector<ConstrainedVariableId>& scope)
     : Constraint(CONSTRAINT_NAME(), PROPAGATOR_NAME(), constraintEngine, scope),
-      m_ruleInstance(ruleInstance), m_sourceConstraint() {
+      m_ruleInstance(ruleInstance), m_sourceConstraint(), m_guardTests(), m_dependencies() {
   check_error(! m_ruleInstance->isExecuted(),
               "A Rule Instance should never be already executed when we construct the constraint!");
 
@@ -42,11 +42,12 @@ RuleVariableListener::RuleVariableListener(const ConstraintEngineId constraintEn
   /**
    * @brief Handle all behaviour immediately on set or reset operations
    * so that rule execution is not subject to the vagaries of propagtion timing
-   * @return true
+   * @return true if the event cannot change the outcome of the guard test
+   * @see canTrigger
    */
 bool RuleVariableListener::canIgnore(const ConstrainedVariableId,
-                                     unsigned int,
-                                     const DomainListener::ChangeType&){
+                                     unsigned int argIndex,
+                                     const DomainListener::ChangeType& changeType){
   checkError(getRuleInstance().isValid(), getKey() << " has lost its rule instance:" << getRuleInstance());
 
   if(getRuleInstance().isNoId())
@@ -56,7 +57,64 @@ bool RuleVariableListener::canIgnore(const ConstrainedVariableId,
            "Checking canIgnore for guard listener for rule " << getRuleInstance()->getRule()->getName() <<
            " from source " << (m_sourceConstraint.isId() ? m_sourceConstraint->getName() : "NULL"));
 
-  return false;
+  return !canTrigger(argIndex, changeType);
+}
+
+bool RuleVariableListener::canTrigger(unsigned int argIndex,
+                                      const DomainListener::ChangeType& changeType){
+  checkError(argIndex < getScope().size(), argIndex << " is out of range for " << toString());
+
+  if(getRuleInstance().isNoId())
+    return false;
+
+  if(m_guardTests.empty())
+    compileGuard();
+
+  if((m_dependencies[argIndex] & (1u << changeType)) == 0)
+    return false;
+
+  if(!DomainListener::isRestriction(changeType))
+    return true;
+
+  // A restriction can empty a satisfied guard, but never falsify it
+  if(getRuleInstance()->isExecuted())
+    return false;
+
+  const ConstrainedVariableId var = getScope()[argIndex];
+  switch(m_guardTests[argIndex]){
+  case SPECIFIED:
+    return var->baseDomain().isSingleton();
+  case MEMBER:
+    return var->lastDomain().isSingleton();
+  default:
+    return true;
+  }
+}
+
+void RuleVariableListener::compileGuard(){
+  const RuleInstanceId ruleInstance = getRuleInstance();
+  checkError(ruleInstance.isValid(), "Can't compile the guard of " << toString() << " without a rule instance.");
+
+  // Events that can change whether a variable is specified, or its base domain is a singleton, or
+  // that undo earlier restrictions
+  const unsigned int common = (1u << DomainListener::SET_TO_SINGLETON) | (1u << DomainListener::RESET) |
+      (1u << DomainListener::RELAXED) | (1u << DomainListener::CLOSED) | (1u << DomainListener::OPENED);
+  unsigned int restrictions = 0;
+  for(int i = 0; DomainListener::isRestriction(static_cast<DomainListener::ChangeType>(i)); i++)
+    restrictions |= (1u << i);
+
+  const unsigned int scopeSize = getScope().size();
+  m_guardTests.assign(scopeSize, SPECIFIED);
+  m_dependencies.assign(scopeSize, common | (1u << DomainListener::BOUNDS_RESTRICTED));
+
+  if(ruleInstance->getGuardDomain() != 0){
+    m_guardTests[0] = (ruleInstance->isPositive() ? MEMBER : NOT_MEMBER);
+    m_dependencies[0] = common | restrictions;
+  }
+
+  debugMsg("RuleVariableListener:compileGuard",
+           "Compiled guard for rule " << ruleInstance->getRule()->getName() << " with " << scopeSize <<
+           " variables " << (ruleInstance->getGuardDomain() != 0 ? "and an explicit guard" : "and implied guards"));
 }
 
   const RuleInstanceId RuleVariableListener::getRuleInstance() {
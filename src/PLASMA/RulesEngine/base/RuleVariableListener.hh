@@ -32,6 +32,20 @@ namespace EUROPA
 
     const RuleInstanceId getRuleInstance();
 
+    /**
+     * @brief Test if an event on a guard variable could change the outcome of RuleInstance::test.
+     *
+     * The guard is compiled, on first use, into a mask per scope position of the change types
+     * the position depends on. Restrictions never make a satisfied guard false, so once the rule
+     * has fired only relaxations, resets and specifications are of interest. Before it fires, a
+     * restriction matters to an implied guard only if it leaves a singleton base domain, and to a
+     * positive explicit guard only if it leaves a singleton derived domain.
+     * @param argIndex The scope position of the variable that changed.
+     * @param changeType The event.
+     * @return false if the event can be ignored.
+     */
+    bool canTrigger(unsigned int argIndex, const DomainListener::ChangeType& changeType);
+
     /**
      * @brief Standard constraint name
      */
@@ -81,8 +95,24 @@ namespace EUROPA
 
     void handleExecute();
 
+    /**
+     * @brief The test applied to a guard variable, by scope position.
+     */
+    enum GuardTest {
+      SPECIFIED, /*!< Implied guard: specified or a singleton base domain. */
+      MEMBER, /*!< Explicit guard: a singleton derived domain within the guard domain. */
+      NOT_MEMBER /*!< Negative explicit guard: derived domain disjoint from the guard domain. */
+    };
+
+    /**
+     * @brief Compile the guard tests and dependency masks from the rule instance.
+     */
+    void compileGuard();
+
     RuleInstanceId m_ruleInstance;
     ConstraintId m_sourceConstraint;
+    std::vector<GuardTest> m_guardTests;
+    std::vector<unsigned int> m_dependencies; /*!< Bit per DomainListener::ChangeType, by scope position */
   };
 }
 #endif
@@ -14,6 +14,7 @@
 #include "Domains.hh"
 #include "Propagators.hh"
 #include "ProxyVariableRelation.hh"
+#include "RuleVariableListener.hh"
 #include "Constraint.hh"
 #include "CESchema.hh"
 #include "TestUtils.hh"
@@ -315,6 +316,7 @@ public:
     EUROPA_runTest(testPurge);
     EUROPA_runTest(testGNATS_3157);
     EUROPA_runTest(testProxyVariableRelation);
+    EUROPA_runTest(testGuardDependencies);
     return true;
   }
 private:
@@ -691,6 +693,91 @@ private:
 
     return true;
   }
+
+  static RuleVariableListener* getGuardListener(const RuleInstanceId ruleInstance, bool explicitGuard){
+    if(ruleInstance->getGuardListener().isId() && (ruleInstance->getGuardDomain() != 0) == explicitGuard)
+      return id_cast<RuleVariableListener>(ruleInstance->getGuardListener());
+    for(std::vector<RuleInstanceId>::const_iterator it = ruleInstance->getChildRules().begin();
+        it != ruleInstance->getChildRules().end(); ++it){
+      RuleVariableListener* listener = getGuardListener(*it, explicitGuard);
+      if(listener != NULL)
+        return listener;
+    }
+    return NULL;
+  }
+
+  static RuleVariableListener* getGuardListener(const RulesEngineId re, const TokenId token, bool explicitGuard){
+    std::set<RuleInstanceId> ruleInstances;
+    re->getRuleInstances(token, ruleInstances);
+    for(std::set<RuleInstanceId>::const_iterator it = ruleInstances.begin(); it != ruleInstances.end(); ++it){
+      RuleVariableListener* listener = getGuardListener(*it, explicitGuard);
+      if(listener != NULL)
+        return listener;
+    }
+    return NULL;
+  }
+
+  static bool testGuardDependencies(){
+    RE_DEFAULT_SETUP(ce, db, false);
+    Object o1(db, "AllObjects", "o1");
+    Object o2(db, "AllObjects", "o2");
+    db->close();
+
+    re->getRuleSchema()->registerRule((new NestedGuards_0())->getId());
+
+    IntervalToken t0(db,
+		     "AllObjects.Predicate",
+		     true,
+		     false,
+		     IntervalIntDomain(0, 10),
+		     IntervalIntDomain(0, 20),
+		     IntervalIntDomain(1, 1000));
+    t0.activate();
+    ce->propagate();
+
+    // The root is guarded by the object variable being specified. Only specification matters.
+    RuleVariableListener* root = getGuardListener(re, t0.getId(), false);
+    CPPUNIT_ASSERT(root != NULL);
+    CPPUNIT_ASSERT(!root->canTrigger(0, DomainListener::VALUE_REMOVED));
+    CPPUNIT_ASSERT(!root->canTrigger(0, DomainListener::RESTRICT_TO_SINGLETON));
+    CPPUNIT_ASSERT(!root->canTrigger(0, DomainListener::BOUNDS_RESTRICTED));
+    CPPUNIT_ASSERT(root->canTrigger(0, DomainListener::SET_TO_SINGLETON));
+    CPPUNIT_ASSERT(root->canTrigger(0, DomainListener::RESET));
+    CPPUNIT_ASSERT(root->canTrigger(0, DomainListener::RELAXED));
+
+    t0.getObject()->specify(o1.getKey());
+    ce->propagate();
+    CPPUNIT_ASSERT(t0.slaves().size() == 1);
+
+    // The child is guarded by start == [8 12]. Bounds changes matter only once start is a singleton.
+    RuleVariableListener* child = getGuardListener(re, t0.getId(), true);
+    CPPUNIT_ASSERT(child != NULL);
+    CPPUNIT_ASSERT(!t0.start()->lastDomain().isSingleton());
+    CPPUNIT_ASSERT(!child->canTrigger(0, DomainListener::LOWER_BOUND_INCREASED));
+    CPPUNIT_ASSERT(child->canTrigger(0, DomainListener::SET_TO_SINGLETON));
+
+    // Restricting start to a singleton by propagation alone must fire the child
+    ConstrainedVariableId cVar = db->getClient()->createVariable("int", IntervalIntDomain(10, 10), "cVar");
+    ConstraintId decision = db->getClient()->createConstraint("eq", makeScope(cVar, t0.start()));
+    ce->propagate();
+    CPPUNIT_ASSERT(t0.slaves().size() == 2);
+
+    // Once fired, further restrictions can't falsify the guard
+    CPPUNIT_ASSERT(!child->canTrigger(0, DomainListener::RESTRICT_TO_SINGLETON));
+    CPPUNIT_ASSERT(!root->canTrigger(0, DomainListener::BOUNDS_RESTRICTED));
+    CPPUNIT_ASSERT(child->canTrigger(0, DomainListener::RELAXED));
+
+    // Relaxing the restriction undoes the child
+    db->getClient()->deleteConstraint(decision);
+    ce->propagate();
+    CPPUNIT_ASSERT(t0.slaves().size() == 1);
+
+    t0.cancel();
+    ce->propagate();
+    CPPUNIT_ASSERT(t0.slaves().empty());
+    RE_DEFAULT_TEARDOWN();
+    return true;
+  }
 };
 
 /*void RulesEngineModuleTests::runTests(std::string path)
@@ -3,6 +3,7 @@
 
 #include "Engine.hh"
 #include "PSList.hh"
+#include "PSEntity.hh"
 #include <string>
 
 namespace EUROPA 
@@ -17,6 +18,28 @@ namespace EUROPA
       virtual PSSolver* createSolver(const std::string& configurationFile) = 0;            	
   };
   
+/**
+ * @brief An open decision: the flawed entity, the kind of flaw (the name of the flaw manager
+ * reporting it), the flaw handler that would resolve it and its priority.
+ */
+class PSOpenDecision {
+ public:
+  PSOpenDecision(PSEntityKey entityKey, const std::string& flawType, int handlerId, double priority)
+      : m_entityKey(entityKey), m_flawType(flawType), m_handlerId(handlerId), m_priority(priority) {}
+
+  PSEntityKey getEntityKey() const {return m_entityKey;}
+  const std::string& getFlawType() const {return m_flawType;}
+  /** @brief Identifies the flaw handler among those of the same flaw type. */
+  int getHandlerId() const {return m_handlerId;}
+  double getPriority() const {return m_priority;}
+
+ private:
+  PSEntityKey m_entityKey;
+  std::string m_flawType;
+  int m_handlerId;
+  double m_priority;
+};
+
 class PSSolver {
  public:
   virtual ~PSSolver() {}
@@ -38,6 +61,11 @@ class PSSolver {
   virtual bool hasFlaws() = 0;	
 
   virtual PSList<std::string> getFlaws() = 0;	
+  /**
+   * @brief The open decisions, best first, without rendering the flaws as getFlaws() does.
+   * @param k If positive, only the k best are returned.
+   */
+  virtual PSList<PSOpenDecision> getOpenDecisions(int k = 0) = 0;
   virtual std::string getLastExecutedDecision() = 0;	
 
   // TODO: should horizon start and end be part of configuration?
@@ -38,6 +38,8 @@ namespace EUROPA {
     class Context;
     typedef Id<Context> ContextId;
 
+    class FlawStatistics;
+
     typedef std::vector<DecisionPointId> DecisionStack;
 
     typedef double Priority; /*!< Used to reference to the priority used in calculating heuristics. */
@@ -34,7 +34,9 @@ void Component::setName(const std::string& name){
 
 ComponentId ComponentFactoryMgr::createComponentInstance(const TiXmlElement& configData) {
   std::string name = extractData(configData, "component");
-  return FactoryMgr::createInstance(name,ComponentArgs(configData));
+  ComponentId component = FactoryMgr::createInstance(name,ComponentArgs(configData));
+  component->setName(name);
+  return component;
 }
 
 }
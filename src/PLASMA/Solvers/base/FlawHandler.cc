@@ -27,7 +27,8 @@ FlawHandler::FlawHandler(const TiXmlElement& configData):
     m_guards(readGuards(configData, false)),
     m_masterGuards(readGuards(configData, true)),
     m_db(),
-    m_maxChoices(0){
+    m_maxChoices(0),
+    m_componentName(){
 
       // Establish the priority
       const char* priorityStr = m_configData->Attribute("priority");
@@ -40,6 +41,10 @@ FlawHandler::FlawHandler(const TiXmlElement& configData):
       const char* maxChoicesStr =  m_configData->Attribute("maxChoices");
       m_maxChoices = static_cast<unsigned int>(atof(maxChoicesStr));
 
+      const char* component = m_configData->Attribute("component");
+      if(component != NULL)
+        m_componentName = component;
+
       // The base uses a number that exceeds the max absolute value priority allowed.
       // It also multiplies by a minimum of 1 to ensure that 0 guards are handled as low weights.
       // Note also that we make it 2 so that defaul t compatibility heuristics 
@@ -53,6 +53,11 @@ namespace EUROPA {
      */
     unsigned int getMaxChoices() const;
 
+    /**
+     * @brief The component name this handler is configured with.
+     */
+    const std::string& getComponentName() const {return m_componentName;}
+
     /**
      * @brief Tests for a match between this factory and the entity
      */
@@ -208,6 +213,7 @@ namespace EUROPA {
     PlanDatabaseId m_db;
       
     unsigned int m_maxChoices; /*!< Allows a cut operator on choices. xml attribute is 'maxChoices' */
+    std::string m_componentName; /*!< The xml attribute 'component' */
   }; 
 
     /**
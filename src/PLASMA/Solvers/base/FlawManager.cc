@@ -5,6 +5,7 @@
 #include "FlawHandler.hh"
 #include "Token.hh"
 #include "Debug.hh"
+#include "FlawStatistics.hh"
 
 /**
  * @file FlawManager.cc
@@ -37,6 +38,7 @@ FlawManager::FlawManager(const TiXmlElement& configData)
     , m_activeFlawHandlersByKey()
     , m_timestamp(0)
     , m_context()
+    , m_statistics(NULL)
 {
 }
 
@@ -347,7 +349,7 @@ FlawManager::FlawManager(const TiXmlElement& configData)
           if(bestP == getBestCasePriority())
             break;
         }
-        else if((std::abs(priorityDiff) < EPSILON && betterThan(candidate, flawToResolve, explanation))){
+        else if((std::abs(priorityDiff) < EPSILON && breakTie(candidate, flawToResolve, explanation))){
           debugMsg("FlawManager:next",
                    "Updating because candidate is judged better than old candidate.");
           flawToResolve = candidate;
@@ -518,6 +520,8 @@ FlawManager::FlawManager(const TiXmlElement& configData)
       checkError(flawHandler.isValid(), "On " << sl_counter << ": No flawHandler for " << entity->toString());
       DecisionPointId dp =  flawHandler->create(m_db->getClient(), entity, explanation);
       dp->setCutoff(flawHandler->getMaxChoices());
+      dp->setComponentName(flawHandler->getComponentName());
+      dp->setStatistics(m_statistics);
       return dp;
     }
 
@@ -645,6 +649,23 @@ FlawManager::FlawManager(const TiXmlElement& configData)
       }
     }
 
+    /**
+     * Learned hints only break ties, so that configured priorities, dead-ends and zero commitment decisions keep
+     * their meaning.
+     */
+    bool FlawManager::breakTie(const EntityId a, const EntityId b, std::string& explanation){
+      if(m_statistics != NULL && a.isId() && b.isId()) {
+        int hint = m_statistics->compare(a, b);
+        if(hint != 0) {
+          debugMsg("FlawManager:breakTie", "Statistics prefer " << (hint < 0 ? a : b)->getKey());
+          if(hint < 0)
+            explanation = "statistics";
+          return hint < 0;
+        }
+      }
+      return betterThan(a, b, explanation);
+    }
+
     std::string FlawManager::toString(const EntityId entity) const {
       return entity->toString();
     }
@@ -159,6 +159,7 @@ namespace EUROPA {
       virtual bool noMoreFlaws() = 0;
 
     protected:
+      friend class Solver; /*!< Allocates decisions on given flaws when replaying a search */
 
       FlawManager(const TiXmlElement& configData);
 
@@ -174,9 +175,22 @@ namespace EUROPA {
 
       virtual bool betterThan(const EntityId a, const EntityId b, std::string& explanation);
 
+      /**
+       * @brief Use learned statistics to decide between flaws of equal priority before betterThan, and to
+       * order the choices on the decisions allocated.
+       * @param statistics The statistics, or NULL for none.
+       */
+      void setStatistics(const FlawStatistics* statistics) {m_statistics = statistics;}
+
       PlanDatabaseId m_db;
 
     private:
+      /**
+       * @brief Decide between two flaws of equal priority, by learned statistics if there are any that tell
+       * them apart, otherwise by betterThan.
+       */
+      bool breakTie(const EntityId a, const EntityId b, std::string& explanation);
+
       bool staticallyExcluded(const EntityId entity) const;
       bool isValid() const;
 
@@ -190,6 +204,7 @@ namespace EUROPA {
       std::map<eint, FlawHandlerEntry> m_activeFlawHandlersByKey; /*!< Applicable Flaw Handlers for each entity */
       unsigned int m_timestamp; /*!< Used for testing for stale iterators */
       ContextId m_context;
+      const FlawStatistics* m_statistics; /*!< Learned hints, if any */
       //static const Priority BEST_CASE_PRIORITY = 0;
     };
 
@@ -0,0 +1,291 @@
+#include "FlawStatistics.hh"
+#include "Debug.hh"
+#include "ConstraintEngine.hh"
+#include "PlanDatabase.hh"
+#include "Schema.hh"
+#include "Token.hh"
+#include "Object.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace EUROPA {
+namespace SOLVERS {
+
+namespace {
+const char STATISTICS_HEADER[] = "EUROPA-FLAW-STATISTICS 1";
+const char MODEL_PREFIX[] = "model ";
+
+void add(FlawStatistics::Record& to, const FlawStatistics::Record& from) {
+  to.executions += from.executions;
+  to.failures += from.failures;
+  to.backtracks += from.backtracks;
+  to.propagationCost += from.propagationCost;
+}
+
+// A record is written as its counts, then the label and the choice kind, separated by tabs
+bool parseRecord(const std::string& line, std::pair<std::string, std::string>& key,
+                 FlawStatistics::Record& record) {
+  std::string::size_type labelStart = line.find('\t');
+  std::string::size_type kindStart = (labelStart == std::string::npos ? labelStart : line.find('\t', labelStart + 1));
+  if(kindStart == std::string::npos)
+    return false;
+  std::istringstream counts(line.substr(0, labelStart));
+  if(!(counts >> record.executions >> record.failures >> record.backtracks >> record.propagationCost))
+    return false;
+  key.first = line.substr(labelStart + 1, kindStart - labelStart - 1);
+  key.second = line.substr(kindStart + 1);
+  return true;
+}
+
+// Less than 0 if a retracts more decisions per execution, or as many at a lower propagation cost
+int compareRecords(const FlawStatistics::Record& a, const FlawStatistics::Record& b) {
+  double rateA = FlawStatistics::getRetractionRate(a);
+  double rateB = FlawStatistics::getRetractionRate(b);
+  if(rateA != rateB)
+    return (rateA > rateB ? -1 : 1);
+  double costA = FlawStatistics::getPropagationCost(a);
+  double costB = FlawStatistics::getPropagationCost(b);
+  if(costA != costB)
+    return (costA < costB ? -1 : 1);
+  return 0;
+}
+
+class ChoiceOrder {
+ public:
+  ChoiceOrder(const FlawStatistics& statistics, const std::string& label)
+      : m_statistics(statistics), m_label(label) {}
+  bool operator()(const LabelStr& a, const LabelStr& b) const {
+    // Choices that retract fewer decisions go first, so the order of the retraction rates is reversed
+    FlawStatistics::Record recordA = m_statistics.getRecord(m_label, a.toString());
+    FlawStatistics::Record recordB = m_statistics.getRecord(m_label, b.toString());
+    double rateA = FlawStatistics::getRetractionRate(recordA);
+    double rateB = FlawStatistics::getRetractionRate(recordB);
+    if(rateA != rateB)
+      return rateA < rateB;
+    return FlawStatistics::getPropagationCost(recordA) < FlawStatistics::getPropagationCost(recordB);
+  }
+ private:
+  const FlawStatistics& m_statistics;
+  const std::string m_label;
+};
+}
+
+FlawStatistics::FlawStatistics(const PlanDatabaseId db)
+    : SearchListener(), m_modelHash(computeModelHash(db->getSchema())), m_records(), m_otherModels(), m_labels(),
+      m_ceListener(db->getConstraintEngine()), m_recovering(false), m_failedDecision(0), m_failedKey() {}
+
+FlawStatistics::~FlawStatistics() {}
+
+void FlawStatistics::notifyCreated(DecisionPointId dp) {
+  m_labels[dp->getKey()] = getLabel(Entity::getEntity(dp->getFlawedEntityKey()));
+  m_ceListener.m_executions = 0;
+}
+
+void FlawStatistics::notifyDeleted(DecisionPointId dp) {
+  m_labels.erase(dp->getKey());
+}
+
+void FlawStatistics::notifyUndone(DecisionPointId dp) {
+  if(m_recovering && dp->getKey() != m_failedDecision)
+    m_records[m_failedKey].backtracks++;
+}
+
+void FlawStatistics::notifyStepSucceeded(DecisionPointId dp) {record(dp, false);}
+
+void FlawStatistics::notifyStepFailed(DecisionPointId dp) {record(dp, true);}
+
+void FlawStatistics::notifyRetractSucceeded(DecisionPointId) {
+  m_recovering = false;
+  m_ceListener.m_executions = 0;
+}
+
+void FlawStatistics::record(const DecisionPointId dp, const bool failed) {
+  std::map<eint, std::string>::const_iterator it = m_labels.find(dp->getKey());
+  checkError(it != m_labels.end(), "No flaw recorded for " << dp->toString());
+  Key key(it->second, dp->getChoiceKind());
+  Record& record = m_records[key];
+  record.executions++;
+  record.propagationCost += m_ceListener.m_executions;
+  m_ceListener.m_executions = 0;
+  m_recovering = failed;
+  if(failed) {
+    record.failures++;
+    m_failedDecision = dp->getKey();
+    m_failedKey = key;
+  }
+  debugMsg("FlawStatistics:record", (failed ? "Failed " : "Executed ") << key.second << " on " << key.first);
+}
+
+FlawStatistics::Record FlawStatistics::getRecord(const std::string& label) const {
+  Record retval = {0, 0, 0, 0};
+  for(std::map<Key, Record>::const_iterator it = m_records.lower_bound(Key(label, std::string()));
+      it != m_records.end() && it->first.first == label; ++it)
+    add(retval, it->second);
+  return retval;
+}
+
+FlawStatistics::Record FlawStatistics::getRecord(const std::string& label, const std::string& choiceKind) const {
+  std::map<Key, Record>::const_iterator it = m_records.find(Key(label, choiceKind));
+  if(it != m_records.end())
+    return it->second;
+  Record retval = {0, 0, 0, 0};
+  return retval;
+}
+
+double FlawStatistics::getFailureRate(const Record& record) {
+  return (record.executions == 0 ? 0.0 : static_cast<double>(record.failures) / record.executions);
+}
+
+double FlawStatistics::getRetractionRate(const Record& record) {
+  return (record.executions == 0 ? 0.0 :
+          static_cast<double>(record.failures + record.backtracks) / record.executions);
+}
+
+double FlawStatistics::getPropagationCost(const Record& record) {
+  return (record.executions == 0 ? 0.0 : static_cast<double>(record.propagationCost) / record.executions);
+}
+
+std::string FlawStatistics::getLabel(const EntityId flaw) {
+  checkError(flaw.isValid(), "Invalid flaw " << flaw);
+  if(TokenId::convertable(flaw)) {
+    TokenId token(flaw);
+    return (token->isInactive() ? "inactive " : "active ") + token->getPredicateName();
+  }
+  if(ConstrainedVariableId::convertable(flaw)) {
+    ConstrainedVariableId var(flaw);
+    EntityId parent = var->parent();
+    if(parent.isId() && TokenId::convertable(parent))
+      return "variable " + TokenId(parent)->getPredicateName() + "." + var->getName();
+    if(parent.isId() && ObjectId::convertable(parent))
+      return "variable " + ObjectId(parent)->getType() + "." + var->getName();
+    return "variable " + var->getName();
+  }
+  return flaw->entityType().toString();
+}
+
+int FlawStatistics::compare(const EntityId a, const EntityId b) const {
+  return compareRecords(getRecord(getLabel(a)), getRecord(getLabel(b)));
+}
+
+void FlawStatistics::orderChoices(const EntityId flaw, std::vector<LabelStr>& choiceKinds) const {
+  std::stable_sort(choiceKinds.begin(), choiceKinds.end(), ChoiceOrder(*this, getLabel(flaw)));
+}
+
+void FlawStatistics::write(std::ostream& os) const {
+  os << STATISTICS_HEADER << std::endl;
+  os << MODEL_PREFIX << m_modelHash << std::endl;
+  for(std::map<Key, Record>::const_iterator it = m_records.begin(); it != m_records.end(); ++it)
+    os << it->second.executions << " " << it->second.failures << " " << it->second.backtracks << " " <<
+        it->second.propagationCost << "\t" << it->first.first << "\t" << it->first.second << std::endl;
+
+  for(std::map<std::string, std::vector<std::string> >::const_iterator it = m_otherModels.begin();
+      it != m_otherModels.end(); ++it) {
+    os << MODEL_PREFIX << it->first << std::endl;
+    for(std::vector<std::string>::const_iterator lineIt = it->second.begin(); lineIt != it->second.end(); ++lineIt)
+      os << *lineIt << std::endl;
+  }
+}
+
+bool FlawStatistics::read(std::istream& is) {
+  std::string line;
+  if(!std::getline(is, line) || line != STATISTICS_HEADER) {
+    debugMsg("FlawStatistics:read", "Not a statistics file");
+    return false;
+  }
+
+  std::map<Key, Record> records;
+  std::map<std::string, std::vector<std::string> > otherModels;
+  std::vector<std::string>* otherLines = NULL;
+  bool inModel = false;
+  while(std::getline(is, line)) {
+    if(line.compare(0, sizeof(MODEL_PREFIX) - 1, MODEL_PREFIX) == 0) {
+      std::string hash = line.substr(sizeof(MODEL_PREFIX) - 1);
+      inModel = (hash == m_modelHash);
+      otherLines = (inModel ? NULL : &otherModels[hash]);
+      continue;
+    }
+
+    Key key;
+    Record record;
+    if((!inModel && otherLines == NULL) || !parseRecord(line, key, record)) {
+      debugMsg("FlawStatistics:read", "Bad line: " << line);
+      return false;
+    }
+    if(inModel)
+      add(records[key], record);
+    else
+      otherLines->push_back(line);
+  }
+
+  for(std::map<Key, Record>::const_iterator it = records.begin(); it != records.end(); ++it)
+    add(m_records[it->first], it->second);
+  for(std::map<std::string, std::vector<std::string> >::const_iterator it = otherModels.begin();
+      it != otherModels.end(); ++it) {
+    std::vector<std::string>& lines = m_otherModels[it->first];
+    lines.insert(lines.end(), it->second.begin(), it->second.end());
+  }
+  debugMsg("FlawStatistics:read", "Read " << records.size() << " records for model " << m_modelHash);
+  return true;
+}
+
+bool FlawStatistics::load(const std::string& fileName) {
+  std::ifstream in(fileName.c_str());
+  if(!in.is_open()) {
+    debugMsg("FlawStatistics:load", "No statistics in " << fileName);
+    return true;
+  }
+  return read(in);
+}
+
+bool FlawStatistics::save(const std::string& fileName) const {
+  // Written aside and renamed, so a run that stops while writing leaves the old file whole
+  const std::string tempName = fileName + ".tmp";
+  {
+    std::ofstream out(tempName.c_str());
+    if(!out.is_open())
+      return false;
+    write(out);
+    out.close();
+    if(!out) {
+      std::remove(tempName.c_str());
+      return false;
+    }
+  }
+  if(std::rename(tempName.c_str(), fileName.c_str()) != 0) {
+    std::remove(tempName.c_str());
+    return false;
+  }
+  return true;
+}
+
+std::string FlawStatistics::computeModelHash(const SchemaId schema) {
+  std::stringstream text;
+  const std::set<std::string>& objectTypes = schema->getAllObjectTypes();
+  std::set<std::string> types(objectTypes.begin(), objectTypes.end());
+  schema->getPredicates(types);
+  for(std::set<std::string>::const_iterator it = types.begin(); it != types.end(); ++it) {
+    text << *it << "(";
+    const Schema::NameValueVector& members = schema->getMembers(*it);
+    for(Schema::NameValueVector::const_iterator memberIt = members.begin(); memberIt != members.end(); ++memberIt)
+      text << memberIt->first << " " << memberIt->second << ";";
+    text << ")";
+  }
+
+  // 64 bit FNV-1a
+  const std::string data = text.str();
+  unsigned long long hash = 14695981039346656037ULL;
+  for(std::string::const_iterator it = data.begin(); it != data.end(); ++it) {
+    hash ^= static_cast<unsigned char>(*it);
+    hash *= 1099511628211ULL;
+  }
+  std::stringstream os;
+  os << std::hex << std::setw(16) << std::setfill('0') << hash;
+  return os.str();
+}
+
+}
+}
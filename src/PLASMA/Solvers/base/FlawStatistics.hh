@@ -0,0 +1,164 @@
+#ifndef H_FlawStatistics
+#define H_FlawStatistics
+
+/**
+ * @file FlawStatistics.hh
+ * @brief Defines statistics on how flaws were resolved, kept from one run to the next as heuristic hints.
+ * @ingroup Solvers
+ */
+
+#include "SearchListener.hh"
+#include "ConstraintEngineListener.hh"
+#include "LabelStr.hh"
+
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace EUROPA {
+namespace SOLVERS {
+
+/**
+ * @brief Records, for each kind of flaw and each kind of choice made on it, how often the choice was made,
+ * how often propagation failed after it, how many decisions had to be retracted to recover from those
+ * failures, and how many constraint executions propagation took.
+ *
+ * Flaws are told apart by a label that does not depend on the instance: the predicate of a token, or the
+ * predicate or object type and name of a variable.  Choices are told apart by DecisionPoint::getChoiceKind.
+ *
+ * The statistics can be saved to a file and loaded again by a later run.  A file holds a section for each
+ * model, keyed by a hash of its schema, so that one file can serve several models.
+ *
+ * Loaded statistics are used as hints by FlawManager and by decision points when they are configured on a
+ * Solver.  Hints only decide between flaws of equal priority, preferring the flaw whose choices have cost
+ * the most retracted decisions, and order the kinds of choice on a decision, trying those that have cost
+ * the fewest first.  Ties go to the cheaper propagation.  No flaw or choice is ever left out, so search
+ * remains complete.
+ * @see Solver
+ */
+class FlawStatistics : public SearchListener {
+ public:
+  struct Record {
+    unsigned long executions; /*!< Choices executed */
+    unsigned long failures; /*!< Choices after which propagation failed */
+    unsigned long backtracks; /*!< Other decisions retracted to recover from those failures */
+    unsigned long propagationCost; /*!< Constraint executions propagating the choices */
+  };
+
+  /**
+   * @param db The database searched.  The hash of its schema keys the statistics saved.
+   */
+  FlawStatistics(const PlanDatabaseId db);
+
+  ~FlawStatistics();
+
+  void notifyCreated(DecisionPointId dp);
+  void notifyDeleted(DecisionPointId dp);
+  void notifyUndone(DecisionPointId dp);
+  void notifyStepSucceeded(DecisionPointId dp);
+  void notifyStepFailed(DecisionPointId dp);
+  void notifyRetractSucceeded(DecisionPointId dp);
+
+  const std::string& getModelHash() const {return m_modelHash;}
+
+  /**
+   * @brief The statistics of all choices on flaws with the given label.
+   */
+  Record getRecord(const std::string& label) const;
+
+  /**
+   * @brief The statistics of one kind of choice on flaws with the given label.
+   */
+  Record getRecord(const std::string& label, const std::string& choiceKind) const;
+
+  /**
+   * @brief The fraction of executions that failed.  0 if there are none.
+   */
+  static double getFailureRate(const Record& record);
+
+  /**
+   * @brief The decisions retracted per execution, counting each failed choice and each other decision
+   * retracted to recover from it.  0 if there are no executions.
+   */
+  static double getRetractionRate(const Record& record);
+
+  /**
+   * @brief The constraint executions per choice executed.  0 if there are no executions.
+   */
+  static double getPropagationCost(const Record& record);
+
+  /**
+   * @brief The label under which the statistics of a flaw are kept.
+   */
+  static std::string getLabel(const EntityId flaw);
+
+  /**
+   * @brief Compare two flaws of equal priority, by retraction rate and then by propagation cost.
+   * @return Less than 0 if a should be decided first, greater than 0 if b should, and 0 if there is no hint.
+   */
+  int compare(const EntityId a, const EntityId b) const;
+
+  /**
+   * @brief Stably order the kinds of choice on a flaw so that those with the lowest retraction rate, and
+   * then the lowest propagation cost, come first.
+   */
+  void orderChoices(const EntityId flaw, std::vector<LabelStr>& choiceKinds) const;
+
+  /**
+   * @brief Write the statistics for this model, along with those read for other models.
+   */
+  void write(std::ostream& os) const;
+
+  /**
+   * @brief Add the statistics written by write() for this model to those recorded.
+   * @return false if the stream is not in the expected format, in which case nothing is added.
+   */
+  bool read(std::istream& is);
+
+  /**
+   * @brief Read the statistics in a file, if there is one.
+   * @return false if the file exists but couldn't be read.
+   */
+  bool load(const std::string& fileName);
+
+  /**
+   * @brief Write the statistics to a temporary file and rename it over the file named.
+   * @return false if the file couldn't be written, in which case the file named is unchanged.
+   */
+  bool save(const std::string& fileName) const;
+
+  /**
+   * @brief A hash of the object types and predicates in a schema, with their members.
+   */
+  static std::string computeModelHash(const SchemaId schema);
+
+ private:
+  typedef std::pair<std::string, std::string> Key; /*!< Label and choice kind */
+
+  /**
+   * @brief Counts the constraint executions propagating each choice.
+   */
+  class CeListener : public ConstraintEngineListener {
+   public:
+    CeListener(const ConstraintEngineId ce) : ConstraintEngineListener(ce), m_executions(0) {}
+    void notifyExecuted(const ConstraintId) {m_executions++;}
+    unsigned long m_executions;
+  };
+
+  void record(const DecisionPointId dp, const bool failed);
+
+  std::string m_modelHash;
+  std::map<Key, Record> m_records;
+  std::map<std::string, std::vector<std::string> > m_otherModels; /*!< Lines read for other models, by hash */
+  std::map<eint, std::string> m_labels; /*!< Labels of the flaws of open decisions, by decision key */
+  CeListener m_ceListener;
+  bool m_recovering; /*!< True from a failed step until search resumes */
+  eint m_failedDecision; /*!< Key of the decision that failed */
+  Key m_failedKey; /*!< Where the decisions retracted to recover are counted */
+};
+
+}
+}
+
+#endif
@@ -24,7 +24,7 @@ MatchingRule::MatchingRule(const TiXmlElement& configData)
       m_masterObjectType(WILD_CARD()), m_masterPredicate(WILD_CARD()), 
       m_masterRelation(WILD_CARD()),
       m_tokenName(WILD_CARD()),
-      m_staticFilterCount(0), m_lastCycle(0), m_hitCount(0),
+      m_staticFilterCount(0), m_lastCycle(0), m_hitCount(0), m_index(0),
       m_matchingEngine() {
   
   std::string expr;
@@ -93,6 +93,7 @@ MatchingRule::MatchingRule(const TiXmlElement& configData)
 
     void MatchingRule::initialize(const MatchingEngineId matchingEngine){
       m_matchingEngine = matchingEngine;
+      m_index = static_cast<unsigned int>(m_matchingEngine->getRules().size());
       m_matchingEngine->registerRule(getId());
     }
 
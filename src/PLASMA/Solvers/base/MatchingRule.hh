@@ -68,6 +68,11 @@ class MatchingRule: public Component {
 
   const std::string& tokenNameFilter() const;
 
+  /**
+   * @brief The order in which this rule was registered with its matching engine.
+   */
+  unsigned int getIndex() const {return m_index;}
+
   ContextId getContext() const {return m_context;}
   virtual void setContext(ContextId ctx) {check_error(ctx != ContextId::noId()); m_context = ctx;}
  protected:
@@ -88,6 +93,7 @@ class MatchingRule: public Component {
   unsigned int m_staticFilterCount; /*!< Count of the number of static filters on this rule */
   unsigned int m_lastCycle; /*!< The last MatchingEngine cycle */
   unsigned int m_hitCount; /*!< Count of hits in the current matching cycle */
+  unsigned int m_index; /*!< Position in the registration order of the matching engine */
   MatchingEngineId m_matchingEngine;
 };
   }
@@ -96,6 +96,18 @@ namespace EUROPA {
        * @brief Notify of a failed search (the search took more steps than was allowed).
        */
       virtual void notifyTimedOut() {};
+
+      /**
+       * @brief Notify that optimization found a plan better than any found before it.
+       * @param value The objective value of the new plan.
+       * @see Solver::optimize
+       */
+      virtual void notifyIncumbent(edouble) {};
+
+      /**
+       * @brief Notify that optimization proved the last incumbent optimal.
+       */
+      virtual void notifyOptimal() {};
     protected:
     private:
       SearchListenerId m_id;
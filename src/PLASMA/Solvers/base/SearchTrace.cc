@@ -0,0 +1,209 @@
+#include "SearchTrace.hh"
+#include "Debug.hh"
+
+#include <algorithm>
+#include <istream>
+#include <ostream>
+#include <sstream>
+
+namespace EUROPA {
+namespace SOLVERS {
+
+namespace {
+const char TRACE_MAGIC[] = "EUROPA-TRACE";
+const unsigned int TRACE_VERSION = 2;
+
+// Integers are written little-endian with a fixed width, so traces can be read on any platform
+void writeInt(std::ostream& os, unsigned long long value, unsigned int bytes) {
+  for(unsigned int i = 0; i < bytes; i++)
+    os.put(static_cast<char>((value >> (8 * i)) & 0xff));
+}
+
+bool readInt(std::istream& is, unsigned long long& value, unsigned int bytes) {
+  value = 0;
+  for(unsigned int i = 0; i < bytes; i++) {
+    char c;
+    if(!is.get(c))
+      return false;
+    value |= static_cast<unsigned long long>(static_cast<unsigned char>(c)) << (8 * i);
+  }
+  return true;
+}
+
+/**
+ * Reads length bytes as they arrive, so a corrupt length costs no more memory than the bytes actually there.
+ */
+bool readBytes(std::istream& is, unsigned long long length, std::string& result) {
+  result.clear();
+  char buffer[4096];
+  while(length > 0) {
+    const std::streamsize chunk = static_cast<std::streamsize>(std::min<unsigned long long>(length, sizeof(buffer)));
+    if(!is.read(buffer, chunk))
+      return false;
+    result.append(buffer, static_cast<std::string::size_type>(chunk));
+    length -= static_cast<unsigned long long>(chunk);
+  }
+  return true;
+}
+
+const char* eventName(const SearchTrace::EventType type) {
+  static const char* names[] = {"EXECUTED", "FAILED", "UNDONE", "COMPLETED", "EXHAUSTED", "TIMED_OUT"};
+  return names[type];
+}
+}
+
+SearchTrace::SearchTrace(const eint baseKey)
+    : SearchListener(), m_baseKey(baseKey), m_entries(), m_decisionTypes(1), m_decisionTypeIndex() {
+  m_decisionTypeIndex.insert(std::make_pair(std::string(), 0));
+}
+
+void SearchTrace::notifyStepSucceeded(DecisionPointId dp) {record(EXECUTED, dp);}
+
+void SearchTrace::notifyStepFailed(DecisionPointId dp) {record(FAILED, dp);}
+
+void SearchTrace::notifyUndone(DecisionPointId dp) {record(UNDONE, dp);}
+
+void SearchTrace::notifyCompleted() {record(COMPLETED, DecisionPointId::noId());}
+
+void SearchTrace::notifyExhausted() {record(EXHAUSTED, DecisionPointId::noId());}
+
+void SearchTrace::notifyTimedOut() {record(TIMED_OUT, DecisionPointId::noId());}
+
+void SearchTrace::record(const EventType type, const DecisionPointId dp) {
+  Entry entry = {type, 0, 0, 0};
+  if(dp.isId()) {
+    entry.decisionType = getDecisionTypeIndex(getDecisionType(dp));
+    entry.flawKey = static_cast<int64_t>(cast_llong(dp->getFlawedEntityKey() - m_baseKey));
+    // Events on a decision follow the execution of the choice concerned
+    entry.choice = dp->getExecutionCount() - 1;
+  }
+  m_entries.push_back(entry);
+  debugMsg("SearchTrace:record", toString(entry));
+}
+
+unsigned int SearchTrace::getDecisionTypeIndex(const std::string& name) {
+  std::map<std::string, unsigned int>::const_iterator it = m_decisionTypeIndex.find(name);
+  if(it != m_decisionTypeIndex.end())
+    return it->second;
+  unsigned int retval = m_decisionTypes.size();
+  m_decisionTypes.push_back(name);
+  m_decisionTypeIndex.insert(std::make_pair(name, retval));
+  return retval;
+}
+
+const std::string& SearchTrace::getDecisionType(const Entry& entry) const {
+  checkError(entry.decisionType < m_decisionTypes.size(), "No decision type " << entry.decisionType);
+  return m_decisionTypes[entry.decisionType];
+}
+
+std::string SearchTrace::getDecisionType(const DecisionPointId dp) {
+  return dp->getComponentName();
+}
+
+std::string SearchTrace::toString(const Entry& entry) const {
+  std::stringstream os;
+  os << eventName(entry.type);
+  if(!getDecisionType(entry).empty())
+    os << " " << getDecisionType(entry) << " on " << entry.flawKey << " choice " << entry.choice;
+  return os.str();
+}
+
+void SearchTrace::getPath(SearchTrace& path) const {
+  path.m_baseKey = m_baseKey;
+  path.m_decisionTypes = m_decisionTypes;
+  path.m_decisionTypeIndex = m_decisionTypeIndex;
+  path.m_entries.clear();
+  for(std::vector<Entry>::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it) {
+    // Every choice executed is retracted before the decision takes another or is discarded
+    if(isStep(*it))
+      path.m_entries.push_back(*it);
+    else if(it->type == UNDONE) {
+      checkError(!path.m_entries.empty(), "Retraction without a step at " << toString(*it));
+      path.m_entries.pop_back();
+    }
+  }
+  if(!m_entries.empty() && !isStep(m_entries.back()) && m_entries.back().type != UNDONE)
+    path.m_entries.push_back(m_entries.back());
+}
+
+void SearchTrace::write(std::ostream& os) const {
+  os.write(TRACE_MAGIC, sizeof(TRACE_MAGIC));
+  writeInt(os, TRACE_VERSION, 4);
+  writeInt(os, m_decisionTypes.size(), 4);
+  for(std::vector<std::string>::const_iterator it = m_decisionTypes.begin(); it != m_decisionTypes.end(); ++it) {
+    writeInt(os, it->size(), 4);
+    os.write(it->data(), it->size());
+  }
+  writeInt(os, m_entries.size(), 8);
+  for(std::vector<Entry>::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it) {
+    writeInt(os, it->type, 1);
+    writeInt(os, it->decisionType, 2);
+    writeInt(os, static_cast<unsigned long long>(it->flawKey), 8);
+    writeInt(os, it->choice, 4);
+  }
+}
+
+bool SearchTrace::read(std::istream& is) {
+  m_entries.clear();
+  m_decisionTypes.assign(1, std::string());
+  m_decisionTypeIndex.clear();
+  m_decisionTypeIndex.insert(std::make_pair(std::string(), 0));
+
+  char magic[sizeof(TRACE_MAGIC)];
+  unsigned long long value;
+  if(!is.read(magic, sizeof(magic)) || std::string(magic, sizeof(magic)) != std::string(TRACE_MAGIC, sizeof(magic)) ||
+     !readInt(is, value, 4) || value != TRACE_VERSION || !readInt(is, value, 4) || value == 0) {
+    debugMsg("SearchTrace:read", "Not a trace");
+    return false;
+  }
+
+  std::vector<std::string> decisionTypes;
+  for(unsigned long long count = value; count > 0; count--) {
+    if(!readInt(is, value, 4)) {
+      debugMsg("SearchTrace:read", "Truncated decision types");
+      return false;
+    }
+    std::string name;
+    if(!readBytes(is, value, name)) {
+      debugMsg("SearchTrace:read", "Truncated decision type of " << value << " bytes");
+      return false;
+    }
+    decisionTypes.push_back(name);
+  }
+  if(!decisionTypes[0].empty())
+    return false;
+
+  std::vector<Entry> entries;
+  if(!readInt(is, value, 8))
+    return false;
+  for(unsigned long long count = value; count > 0; count--) {
+    unsigned long long type, decisionType, flawKey, choice;
+    if(!readInt(is, type, 1) || !readInt(is, decisionType, 2) || !readInt(is, flawKey, 8) || !readInt(is, choice, 4) ||
+       type > TIMED_OUT || decisionType >= decisionTypes.size()) {
+      debugMsg("SearchTrace:read", "Bad entry " << entries.size());
+      return false;
+    }
+    Entry entry = {static_cast<EventType>(type), static_cast<unsigned int>(decisionType),
+                   static_cast<int64_t>(flawKey), static_cast<unsigned int>(choice)};
+    entries.push_back(entry);
+  }
+
+  for(unsigned int i = 1; i < decisionTypes.size(); i++)
+    getDecisionTypeIndex(decisionTypes[i]);
+  m_entries.swap(entries);
+  return true;
+}
+
+bool SearchTrace::findDivergence(const SearchTrace& a, const SearchTrace& b, unsigned long& index) {
+  for(index = 0; index < a.m_entries.size() && index < b.m_entries.size(); index++) {
+    const Entry& x = a.m_entries[index];
+    const Entry& y = b.m_entries[index];
+    if(x.type != y.type || x.flawKey != y.flawKey || x.choice != y.choice ||
+       a.getDecisionType(x) != b.getDecisionType(y))
+      return true;
+  }
+  return a.m_entries.size() != b.m_entries.size();
+}
+
+}
+}
@@ -0,0 +1,120 @@
+#ifndef H_SearchTrace
+#define H_SearchTrace
+
+/**
+ * @file SearchTrace.hh
+ * @brief Defines a compact record of the decisions made in a search, for replay and comparison.
+ * @ingroup Solvers
+ */
+
+#include "SearchListener.hh"
+
+#include <iosfwd>
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace EUROPA {
+namespace SOLVERS {
+
+/**
+ * @brief Records each choice the Solver executes, whether propagation succeeded after it, each retraction, and
+ * how the search ended.
+ *
+ * A trace is a few bytes per step, so it can be kept for long searches where debug output can't.  It can be
+ * written to and read from a binary stream, compared with another trace to find where two searches part, and
+ * followed by a Solver to repeat a search.
+ * Flaws are identified by entity key relative to a base key.  Keys are allocated in sequence, so a base of 0
+ * identifies the same flaws in another process that loads the same model in the same way.
+ * @see Solver::replay
+ */
+class SearchTrace : public SearchListener {
+ public:
+  enum EventType {
+    EXECUTED = 0, /*!< A choice was executed and propagation succeeded */
+    FAILED, /*!< A choice was executed and propagation failed */
+    UNDONE, /*!< A choice was retracted */
+    COMPLETED, /*!< No flaws were left */
+    EXHAUSTED, /*!< No choices were left */
+    TIMED_OUT /*!< The step or depth limit was reached */
+  };
+
+  struct Entry {
+    EventType type;
+    unsigned int decisionType; /*!< Index of the decision point type, for events on a decision */
+    int64_t flawKey; /*!< Key of the flawed entity, less the base key */
+    unsigned int choice; /*!< The number of choices executed before this one on the same decision */
+  };
+
+  /**
+   * @param baseKey Subtracted from the key of each flaw recorded.
+   */
+  SearchTrace(const eint baseKey = 0);
+
+  void notifyStepSucceeded(DecisionPointId dp);
+  void notifyStepFailed(DecisionPointId dp);
+  void notifyUndone(DecisionPointId dp);
+  void notifyCompleted();
+  void notifyExhausted();
+  void notifyTimedOut();
+
+  const std::vector<Entry>& getEntries() const {return m_entries;}
+
+  /**
+   * @brief The name of the type of decision point in an entry.
+   */
+  const std::string& getDecisionType(const Entry& entry) const;
+
+  /**
+   * @brief The name by which the type of a decision point is recorded: the component name its flaw handler
+   * is configured with, which is the same on every platform.
+   */
+  static std::string getDecisionType(const DecisionPointId dp);
+
+  /**
+   * @brief True if the entry is for the execution of a choice.
+   */
+  static bool isStep(const Entry& entry) {return entry.type == EXECUTED || entry.type == FAILED;}
+
+  std::string toString(const Entry& entry) const;
+
+  /**
+   * @brief Replace a trace with the steps of this one that were never retracted, followed by how the search
+   * ended.  Followed by a Solver, it leads straight to where this search ended.
+   */
+  void getPath(SearchTrace& path) const;
+
+  /**
+   * @brief Write the trace in binary form.
+   */
+  void write(std::ostream& os) const;
+
+  /**
+   * @brief Replace the trace with one written by write().
+   * @return false, leaving the trace empty, if the stream doesn't hold a complete trace.
+   */
+  bool read(std::istream& is);
+
+  /**
+   * @brief Find the first entry at which two traces differ.
+   * @param index Set to the index of the first differing entry, or to the length of the shorter trace if one
+   * is the start of the other.
+   * @return false if the traces are the same.
+   */
+  static bool findDivergence(const SearchTrace& a, const SearchTrace& b, unsigned long& index);
+
+ private:
+  void record(const EventType type, const DecisionPointId dp);
+  unsigned int getDecisionTypeIndex(const std::string& name);
+
+  eint m_baseKey;
+  std::vector<Entry> m_entries;
+  std::vector<std::string> m_decisionTypes; /*!< Names of the decision point types, by index */
+  std::map<std::string, unsigned int> m_decisionTypeIndex;
+};
+
+}
+}
+
+#endif
@@ -10,8 +10,12 @@
 #include "PlanDatabaseWriter.hh"
 #include "FlawHandler.hh"
 #include "Context.hh"
+#include "FlawStatistics.hh"
+#include "Domains.hh"
 #include "tinyxml.h"
+#include <algorithm>
 #include <bitset>
+#include <list>
 
 /**
  * @file Solver.cc
@@ -67,6 +71,11 @@ Solver::Solver(const PlanDatabaseId db, const TiXmlElement& configData)
   m_decisionStack(),
   m_lastExecutedDecision(),
   m_listeners(),
+  m_objectiveName(), m_objective(), m_maximize(false), m_objectiveBound(), m_objectiveConstraint(),
+  m_hasIncumbent(false), m_incumbent(0), m_incumbentCount(0), m_optimal(false),
+  m_incumbentDecisions(), m_backtrackFloor(0),
+  m_replaySteps(), m_replayDecisionTypes(), m_replayBaseKey(0), m_replayPosition(0), m_replayDiverged(false),
+  m_statistics(NULL), m_statisticsFile(),
   m_ceListener(db->getConstraintEngine(), *this),
       m_dbListener(db, *this) {
   checkError(strcmp(configData.Value(), "Solver") == 0,
@@ -75,6 +84,13 @@ Solver::Solver(const PlanDatabaseId db, const TiXmlElement& configData)
   // Extract the name of the Solver
   m_name = extractData(configData, "name");
 
+  // The objective is looked up when optimizing, since it may not have been created yet
+  const char* objective = configData.Attribute("objective");
+  if(objective != NULL)
+    m_objectiveName = objective;
+  const char* maximize = configData.Attribute("maximize");
+  m_maximize = (maximize != NULL && strcmp(maximize, "true") == 0);
+
   m_context = ((new Context(m_name + "Context"))->getId());
   // Initialize the common filter
   m_masterFlawFilter.initialize(configData, m_db, m_context);
@@ -101,10 +117,33 @@ Solver::Solver(const PlanDatabaseId db, const TiXmlElement& configData)
       m_flawManagers.push_back(flawManager);
     }
   }
+
+  // Statistics from earlier runs are loaded now, so the first decisions can use them
+  const char* statistics = configData.Attribute("statistics");
+  if(statistics != NULL) {
+    m_statisticsFile = statistics;
+    m_statistics = new FlawStatistics(m_db);
+    // A file that can't be read is overwritten when the solver is deleted, so search starts cold
+    condWarning(m_statistics->load(m_statisticsFile),
+                "Can't read flaw statistics from " + m_statisticsFile + ", starting without them");
+    addListener(m_statistics->getId());
+
+    const char* useStatistics = configData.Attribute("useStatistics");
+    if(useStatistics == NULL || strcmp(useStatistics, "false") != 0) {
+      for(FlawManagers::const_iterator it = m_flawManagers.begin(); it != m_flawManagers.end(); ++it)
+        (*it)->setStatistics(m_statistics);
+    }
+  }
 }
 
 Solver::~Solver(){
   cleanupDecisions();
+  if(m_statistics != NULL) {
+    removeListener(m_statistics->getId());
+    condWarning(m_statistics->save(m_statisticsFile),
+                "Can't save flaw statistics to " + m_statisticsFile);
+    delete m_statistics;
+  }
   EUROPA::cleanup(m_flawManagers);
   delete static_cast<Context*>(m_context);
   m_id.remove();
@@ -129,6 +168,7 @@ Solver::~Solver(){
       m_depthFloor = getDepth();
       m_maxSteps = maxSteps;
       m_maxDepth = maxDepth;
+      m_backtrackFloor = 0;
 
       // Reset the flaw found flag for a new evaluation
       m_noFlawsFound = false;
@@ -136,7 +176,7 @@ Solver::~Solver(){
 
       while(!m_timedOut && !m_exhausted && !m_noFlawsFound) step();
 
-      checkError(!m_exhausted || m_decisionStack.empty(),
+      checkError(!m_exhausted || getDepth() == m_backtrackFloor,
                  "If we have exhausted all our options to recover, then we must have no further decision available." <<
                  " Stack size is " << m_decisionStack.size());
 
@@ -145,6 +185,328 @@ Solver::~Solver(){
       return m_noFlawsFound;
     }
 
+    void Solver::setObjective(const ConstrainedVariableId objective, bool maximize) {
+      checkError(objective.isValid(), "Invalid objective for " << m_name);
+      checkError(m_objectiveConstraint.isNoId(), "Cannot change the objective while optimizing.");
+      m_objective = objective;
+      m_maximize = maximize;
+    }
+
+    bool Solver::optimize(unsigned int maxSteps, unsigned int maxDepth){
+      if(m_objective.isNoId()) {
+        checkError(!m_objectiveName.empty(), "No objective has been given to " << m_name);
+        m_objective = m_db->getGlobalVariable(m_objectiveName);
+      }
+      checkError(m_objective->baseDomain().isNumeric(), "Can't optimize " << m_objective->toString());
+
+      m_stepCountFloor = getStepCount();
+      m_depthFloor = getDepth();
+      m_maxSteps = maxSteps;
+      m_maxDepth = maxDepth;
+      m_noFlawsFound = false;
+      m_timedOut = false;
+      // An earlier search may have run out of choices.  Nothing is left on the stack then, so search starts over.
+      m_exhausted = false;
+      m_backtrackFloor = getDepth();
+      m_hasIncumbent = false;
+      m_incumbentCount = 0;
+      m_incumbentDecisions.clear();
+      m_optimal = false;
+
+      ConstraintEngineId ce = m_db->getConstraintEngine();
+      bool autoPropagation = ce->getAutoPropagation();
+      ce->setAutoPropagation(false);
+
+      postObjectiveBound("lt", IntervalDomain());
+      while(!m_timedOut && !m_exhausted) {
+        step();
+        if(!m_noFlawsFound)
+          continue;
+
+        recordIncumbent();
+        m_noFlawsFound = false;
+        if(m_maximize)
+          m_objectiveBound->restrictBaseDomain(IntervalDomain(m_incumbent, PLUS_INFINITY));
+        else
+          m_objectiveBound->restrictBaseDomain(IntervalDomain(MINUS_INFINITY, m_incumbent));
+        m_exhausted = backtrackFromIncumbent();
+      }
+      removeObjectiveBound();
+      m_optimal = m_hasIncumbent && m_exhausted;
+
+      debugMsg("Solver:optimize",
+               (m_hasIncumbent ? "Best value " + toString(m_incumbent) : "No plan") << " after " <<
+               m_stepCount << " steps and " << m_incumbentCount << " plans" << (m_optimal ? ", proved optimal" : ""));
+
+      if(m_hasIncumbent) {
+        if(m_optimal)
+          publish(notifyOptimal);
+
+        // Take the decisions of the incumbent again.  Any search this still needs counts against the limits.
+        unsigned int stepCount = m_stepCount;
+        bool timedOut = m_timedOut;
+        reset(getDepth() - m_backtrackFloor);
+        m_stepCount = stepCount;
+        if(m_maximize)
+          postObjectiveBound("leq", IntervalDomain(m_incumbent, PLUS_INFINITY));
+        else
+          postObjectiveBound("leq", IntervalDomain(MINUS_INFINITY, m_incumbent));
+        restoreIncumbent();
+        while(!m_timedOut && !m_exhausted && !m_noFlawsFound) step();
+        m_timedOut = m_timedOut || timedOut;
+        if(m_noFlawsFound && getObjectiveValue() != m_incumbent)
+          recordIncumbent();
+        removeObjectiveBound();
+        m_db->getClient()->propagate();
+      }
+
+      ce->setAutoPropagation(autoPropagation);
+      return m_hasIncumbent && m_noFlawsFound;
+    }
+
+    edouble Solver::getIncumbentValue() const {
+      checkError(m_hasIncumbent, m_name << " has no incumbent.");
+      return m_incumbent;
+    }
+
+    edouble Solver::getObjectiveValue() const {
+      const Domain& dom = m_objective->lastDomain();
+      edouble retval = (m_maximize ? dom.getUpperBound() : dom.getLowerBound());
+      checkError(retval != PLUS_INFINITY && retval != MINUS_INFINITY, "Unbounded objective " << m_objective->toString());
+      return retval;
+    }
+
+    void Solver::recordIncumbent() {
+      m_incumbent = getObjectiveValue();
+      m_hasIncumbent = true;
+      m_incumbentCount++;
+      debugMsg("Solver:optimize", "Incumbent " << m_incumbentCount << " has value " << m_incumbent <<
+               " at step " << getStepCount());
+      m_incumbentDecisions.clear();
+      for(unsigned long i = m_backtrackFloor; i < m_decisionStack.size(); i++)
+        m_incumbentDecisions.push_back(getIncumbentDecision(m_decisionStack[i]));
+      publish(notifyIncumbent, m_incumbent);
+    }
+
+    Solver::IncumbentDecision Solver::getIncumbentDecision(const DecisionPointId decision) const {
+      IncumbentDecision retval;
+      retval.key = decision->getFlawedEntityKey();
+      retval.onToken = false;
+      retval.onVariable = false;
+      retval.variableIndex = 0;
+      retval.specified = false;
+      retval.value = 0;
+      retval.choice = decision->getExecutionCount() - 1;
+
+      EntityId flaw = Entity::getEntity(retval.key);
+      TokenId token;
+      if(ConstrainedVariableId::convertable(flaw)) {
+        ConstrainedVariableId var = flaw;
+        // Variables are specified from choices that a random ordering may not offer in the same order again
+        if(var->isSpecified()) {
+          retval.specified = true;
+          retval.value = var->getSpecifiedValue();
+        }
+        if(var->parent().isId() && TokenId::convertable(var->parent())) {
+          token = var->parent();
+          retval.onVariable = true;
+          retval.variableIndex = var->getIndex();
+        }
+      }
+      else if(TokenId::convertable(flaw))
+        token = flaw;
+
+      if(token.isId()) {
+        std::list<unsigned int> path;
+        while(token->master().isId()) {
+          path.push_front(static_cast<unsigned int>(token->master()->getSlavePosition(token)));
+          token = token->master();
+        }
+        retval.key = token->getKey();
+        retval.path.assign(path.begin(), path.end());
+        retval.onToken = true;
+      }
+      return retval;
+    }
+
+    EntityId Solver::getIncumbentFlaw(const IncumbentDecision& decision) const {
+      EntityId entity = Entity::getEntity(decision.key);
+      if(entity.isNoId() || !decision.onToken)
+        return entity;
+
+      TokenId token = entity;
+      for(std::vector<unsigned int>::const_iterator it = decision.path.begin();
+          it != decision.path.end() && token.isId(); ++it)
+        token = token->getSlave(*it);
+
+      if(token.isNoId() || !decision.onVariable)
+        return token;
+      if(decision.variableIndex >= token->getVariables().size())
+        return EntityId::noId();
+      return token->getVariables()[decision.variableIndex];
+    }
+
+    void Solver::restoreIncumbent() {
+      m_baseConflictLevel = m_db->getConstraintEngine()->getViolation();
+      m_db->getClient()->propagate();
+      for(unsigned long i = 0; i < m_incumbentDecisions.size() && conflictLevelOk(); i++) {
+        const IncumbentDecision& recorded = m_incumbentDecisions[i];
+        EntityId flaw = getIncumbentFlaw(recorded);
+        DecisionPointId decision =
+            (flaw.isId() ? allocateDecisionPoint(flaw->getKey(), "incumbent") : DecisionPointId::noId());
+        if(decision.isNoId()) {
+          debugMsg("Solver:optimize", "Incumbent decision " << i << " has no open flaw");
+          return;
+        }
+
+        decision->initialize();
+        while(decision->hasNext()) {
+          decision->execute();
+          bool chosen = (decision->getExecutionCount() - 1 == recorded.choice);
+          if(recorded.specified) {
+            ConstrainedVariableId var = flaw;
+            chosen = var->isSpecified() && var->getSpecifiedValue() == recorded.value;
+          }
+          if(chosen)
+            break;
+          decision->undo();
+        }
+
+        if(decision->isExecuted() && m_db->getClient()->propagate() && conflictLevelOk()) {
+          m_decisionStack.push_back(decision);
+          continue;
+        }
+
+        debugMsg("Solver:optimize", "Incumbent decision " << i << " no longer applies: " << decision->toString());
+        if(decision->isExecuted())
+          decision->undo();
+        decision->discard();
+        m_db->getClient()->propagate();
+        return;
+      }
+    }
+
+    void Solver::postObjectiveBound(const std::string& relation, const Domain& bound) {
+      check_error(m_objectiveConstraint.isNoId());
+      DbClientId client = m_db->getClient();
+      m_objectiveBound = client->createVariable("float", bound, m_name + "ObjectiveBound", true);
+      if(m_maximize)
+        m_objectiveConstraint = client->createConstraint(relation, makeScope(m_objectiveBound, m_objective));
+      else
+        m_objectiveConstraint = client->createConstraint(relation, makeScope(m_objective, m_objectiveBound));
+    }
+
+    void Solver::removeObjectiveBound() {
+      check_error(m_objectiveConstraint.isValid());
+      DbClientId client = m_db->getClient();
+      client->deleteConstraint(m_objectiveConstraint);
+      client->deleteVariable(m_objectiveBound);
+      m_objectiveConstraint = ConstraintId::noId();
+      m_objectiveBound = ConstrainedVariableId::noId();
+    }
+
+    /**
+     * @brief Unlike a failed step, the bound may rule out not just the last decision but an earlier one, so
+     * each decision we backtrack to is only resumed if the bound is consistent with the decisions below it.
+     */
+    bool Solver::backtrackFromIncumbent() {
+      while(!backtrack()) {
+        m_db->getClient()->propagate();
+        if(conflictLevelOk())
+          return false;
+
+        debugMsg("Solver:backtrack", "Bound on the objective rules out " << m_activeDecision->toString());
+        publish(notifyRetractNotDone,m_activeDecision);
+        publish(notifyDeleted,m_activeDecision);
+        m_activeDecision->discard();
+        m_activeDecision = DecisionPointId::noId();
+      }
+      checkError(getDepth() == m_backtrackFloor, "Must be exhausted if we failed to backtrack out.");
+      return true;
+    }
+
+    void Solver::replay(const SearchTrace& trace, const eint baseKey) {
+      m_replaySteps.clear();
+      m_replayDecisionTypes.clear();
+      for(std::vector<SearchTrace::Entry>::const_iterator it = trace.getEntries().begin();
+          it != trace.getEntries().end(); ++it) {
+        if(SearchTrace::isStep(*it)) {
+          m_replaySteps.push_back(*it);
+          m_replayDecisionTypes.push_back(trace.getDecisionType(*it));
+        }
+      }
+      m_replayBaseKey = baseKey;
+      m_replayPosition = 0;
+      m_replayDiverged = false;
+    }
+
+    DecisionPointId Solver::getReplayDecision() {
+      const eint key = getReplayKey();
+      DecisionPointId retval = allocateDecisionPoint(key, "replay");
+      if(retval.isNoId())
+        diverge("no open flaw with key " + toString(key));
+      return retval;
+    }
+
+    DecisionPointId Solver::allocateDecisionPoint(const eint key, const std::string& explanation) {
+      for(FlawManagers::const_iterator it = m_flawManagers.begin(); it != m_flawManagers.end(); ++it){
+        FlawManagerId fm = *it;
+        EntityId flaw;
+        IteratorId flaws = fm->createIterator();
+        while(!flaws->done() && flaw.isNoId()) {
+          EntityId candidate = flaws->next();
+          if(candidate.isId() && candidate->getKey() == key)
+            flaw = candidate;
+        }
+        delete static_cast<Iterator*>(flaws);
+
+        if(flaw.isId())
+          return fm->allocateDecisionPoint(flaw, explanation);
+      }
+      return DecisionPointId::noId();
+    }
+
+    void Solver::checkReplay(bool consistent) {
+      const SearchTrace::Entry& expected = m_replaySteps[m_replayPosition];
+      const eint key = getReplayKey();
+      if(m_activeDecision->getFlawedEntityKey() != key)
+        diverge("decided key " + toString(m_activeDecision->getFlawedEntityKey()) + " not " + toString(key));
+      else if(SearchTrace::getDecisionType(m_activeDecision) != m_replayDecisionTypes[m_replayPosition])
+        diverge("decided with " + SearchTrace::getDecisionType(m_activeDecision) + " not " +
+                m_replayDecisionTypes[m_replayPosition]);
+      else if(m_activeDecision->getExecutionCount() - 1 != expected.choice)
+        diverge("executed choice " + toString(m_activeDecision->getExecutionCount() - 1) + " not " +
+                toString(expected.choice));
+      else if(consistent != (expected.type == SearchTrace::EXECUTED))
+        diverge(consistent ? "propagation succeeded" : "propagation failed");
+      else
+        m_replayPosition++;
+    }
+
+    eint Solver::getReplayKey() const {
+      // Keys are stored in the trace at a fixed width, which an eint holds for any key in use
+      return m_replayBaseKey + static_cast<long>(m_replaySteps[m_replayPosition].flawKey);
+    }
+
+    /**
+     * @brief Choices executed and retracted in the trace may be left out of it, so choices before the recorded one
+     * are passed over rather than searched again.
+     */
+    void Solver::skipToReplayChoice() {
+      const unsigned int choice = m_replaySteps[m_replayPosition].choice;
+      if(m_activeDecision->getFlawedEntityKey() != getReplayKey())
+        return;
+      while(m_activeDecision->getExecutionCount() < choice && m_activeDecision->hasNext()) {
+        m_activeDecision->execute();
+        m_activeDecision->undo();
+      }
+    }
+
+    void Solver::diverge(const std::string& reason) {
+      debugMsg("Solver:replay", "Diverged from the trace at step " << m_replayPosition << ": " << reason);
+      m_replayDiverged = true;
+    }
+
     const SolverId Solver::getId() const{ return m_id;}
 
 const std::string& Solver::getName() const { return m_name;}
@@ -208,8 +570,13 @@ const std::string& Solver::getName() const { return m_name;}
       checkError(!m_exhausted, "Cannot allocate a search node when retracting.");
       checkError(m_activeDecision.isNoId(), "There can be no active decision.");
 
+      // When following a trace, the trace decides
+      if(isReplaying())
+        m_activeDecision = getReplayDecision();
+
       // First try for a zero commitment decision
-      m_activeDecision = getZeroCommitmentDecision();
+      if(m_activeDecision.isNoId())
+        m_activeDecision = getZeroCommitmentDecision();
 
       // If we don't get a hit up front, search for best alternative
       if(m_activeDecision.isNoId()){
@@ -260,7 +627,7 @@ const std::string& Solver::getName() const { return m_name;}
     }
 
     bool Solver::isExhausted() const {
-      checkError(!m_exhausted || m_decisionStack.empty(),
+      checkError(!m_exhausted || getDepth() <= m_backtrackFloor,
                  "Cannot be left in an exhausted state if there are still decisions to evaluate.");
       return m_exhausted;
     }
@@ -338,13 +705,20 @@ const std::string& Solver::getName() const { return m_name;}
 
       condDebugMsg(m_stepCount % 50 == 0, "Solver:heartbeat", std::endl << printOpenDecisions());
 
+      if(isReplaying())
+        skipToReplayChoice();
+
       if(!m_activeDecision->cut() && m_activeDecision->hasNext()){
         m_lastExecutedDecision = m_activeDecision->toString();
         m_activeDecision->execute();
         m_db->getClient()->propagate();
         m_stepCount++;
 
-        if(conflictLevelOk()){
+        bool consistent = conflictLevelOk();
+        if(isReplaying())
+          checkReplay(consistent);
+
+        if(consistent){
           m_decisionStack.push_back(m_activeDecision);
           publish(notifyStepSucceeded,m_activeDecision);
           m_activeDecision = DecisionPointId::noId();
@@ -366,7 +740,7 @@ const std::string& Solver::getName() const { return m_name;}
 
       // If still left in a backtrack state, the deicion stack must be exhausted
       if(m_exhausted) {
-        checkError(m_decisionStack.empty(), "Must be exhausted if we failed to backtrack out.");
+        checkError(getDepth() == m_backtrackFloor, "Must be exhausted if we failed to backtrack out.");
         debugMsg("Solver:step", "Solver exhausted at step " << getStepCount());
         publish(notifyExhausted);
       }
@@ -381,9 +755,9 @@ const std::string& Solver::getName() const { return m_name;}
 
       bool backtracking = true;
 
-      while(backtracking && (m_activeDecision.isId() || !m_decisionStack.empty())){
+      while(backtracking && (m_activeDecision.isId() || getDepth() > m_backtrackFloor)){
         // If we have no active decision, source it from the decision stack
-        if(m_activeDecision.isNoId() && !m_decisionStack.empty()){
+        if(m_activeDecision.isNoId() && getDepth() > m_backtrackFloor){
           m_activeDecision = m_decisionStack.back();
           m_decisionStack.pop_back();
           debugMsg("Solver:backtrack", "Retrieving closed decision. Depth is:" << m_decisionStack.size());
@@ -462,6 +836,7 @@ const std::string& Solver::getName() const { return m_name;}
         depth--;
       }
 
+      m_backtrackFloor = std::min(m_backtrackFloor, getDepth());
       m_stepCount = 0;
       m_noFlawsFound = false;
       m_exhausted = false;
@@ -501,6 +876,7 @@ const std::string& Solver::getName() const { return m_name;}
       m_stepCount = 0;
       m_stepCountFloor = 0;
       m_depthFloor = 0;
+      m_backtrackFloor = 0;
       m_noFlawsFound = false;
       m_exhausted = false;
       m_timedOut = false;
@@ -707,6 +1083,45 @@ void Solver::notifyChanged(const ConstrainedVariableId variable,
       return priorityQueue;
     }
 
+    void Solver::getOpenDecisions(std::vector<OpenDecision>& decisions, unsigned int k) const
+    {
+      checkError(m_db->getConstraintEngine()->constraintConsistent(),
+                 "Can only call this if variable changes have been propagated first.");
+
+      // Ordered as in the rendered form, with ties broken by flaw manager. With k > 0 only the
+      // best k are held, so the cost is bounded by the number of flaws times log(k).
+      std::multimap<Priority, OpenDecision> best;
+      unsigned int multiplier = 1;
+      for(FlawManagers::const_iterator it = m_flawManagers.begin();
+          it != m_flawManagers.end(); ++it){
+        FlawManagerId fm = *it;
+        IteratorId flawIterator = fm->createIterator();
+        double adjustment = cast_double(EPSILON) * multiplier++;
+        while(!flawIterator->done()){
+          EntityId flaw = flawIterator->next();
+          FlawHandlerId flawHandler = fm->getFlawHandler(flaw);
+          checkError(flawHandler.isValid(), "No flawHandler for " << flaw->toString());
+          const Priority priority = flawHandler->getPriority(flaw);
+
+          if(k > 0 && best.size() == k){
+            std::multimap<Priority, OpenDecision>::iterator worst = best.end();
+            --worst;
+            if(!(priority + adjustment < worst->first))
+              continue;
+            best.erase(worst);
+          }
+          best.insert(std::make_pair(priority + adjustment, OpenDecision(flaw, fm, flawHandler, priority)));
+        }
+
+        delete static_cast<Iterator*>(flawIterator);
+      }
+
+      decisions.clear();
+      decisions.reserve(best.size());
+      for(std::multimap<Priority, OpenDecision>::const_iterator it = best.begin(); it != best.end(); ++it)
+        decisions.push_back(it->second);
+    }
+
     /**
      * @brief Will print the open decisions in priority order
      */
@@ -12,6 +12,7 @@
 #include "SolverDefs.hh"
 #include "FlawManager.hh"
 #include "SearchListener.hh"
+#include "SearchTrace.hh"
 #include "EntityIterator.hh"
 #include "ConstraintEngineListener.hh"
 #include "PlanDatabaseListener.hh"
@@ -19,6 +20,28 @@
 namespace EUROPA {
 namespace SOLVERS {
 
+/**
+ * @brief An open decision as indexed by a flaw manager. Building one does not render the flaw.
+ * @see Solver::getOpenDecisions
+ */
+class OpenDecision {
+ public:
+  OpenDecision(const EntityId flaw, const FlawManagerId flawManager,
+               const FlawHandlerId flawHandler, const Priority priority)
+      : m_flaw(flaw), m_flawManager(flawManager), m_flawHandler(flawHandler), m_priority(priority) {}
+
+  const EntityId getFlaw() const {return m_flaw;}
+  const FlawManagerId getFlawManager() const {return m_flawManager;}
+  const FlawHandlerId getFlawHandler() const {return m_flawHandler;}
+  Priority getPriority() const {return m_priority;}
+
+ private:
+  EntityId m_flaw;
+  FlawManagerId m_flawManager;
+  FlawHandlerId m_flawHandler;
+  Priority m_priority;
+};
+
 /**
  * @brief Defines the main solver interface for identification and resolution of flaws on a plan database.
  *
@@ -32,6 +55,13 @@ class Solver {
 
   /**
    * @brief Constructor
+   *
+   * If the configuration has a 'statistics' attribute, statistics on the flaws resolved are loaded from the file
+   * it names, added to as the Solver searches, and saved back to it when the Solver is deleted.  The statistics
+   * are used as hints for ordering flaws and choices unless 'useStatistics' is "false".  Hints change the order
+   * of search, so a trace replayed with them may diverge.  A file that can't be read is warned about and
+   * replaced by the statistics of this run.
+   * @see FlawStatistics
    */
   Solver(const PlanDatabaseId db, const TiXmlElement& configData);
 
@@ -56,6 +86,89 @@ class Solver {
   bool solve(unsigned int maxSteps = std::numeric_limits<unsigned int>::max(),
              unsigned int maxDepth = std::numeric_limits<unsigned int>::max());
 #endif // _MSC_VER
+  /**
+   * @brief Searches for the best plan under the objective by branch and bound.
+   *
+   * Each time a plan is found it becomes the incumbent, the objective is bounded to be strictly better
+   * than it, and search resumes by backtracking from that plan.  Search ends when no better plan can be
+   * found, proving the incumbent optimal, or when the limits are reached.  Decisions made before optimizing
+   * are kept.  The decisions of each incumbent are recorded, and those of the last one are followed again
+   * afterwards without search so that it is left in the database.  Should they no longer apply, search
+   * resumes under a bound of the incumbent within what is left of the step limit.
+   * @param maxSteps The maximum number of steps permitted for the whole search.
+   * @param maxDepth The maximum growth in stack size permitted.
+   * @return true if a plan was found and is left in the database, otherwise false.
+   * @see setObjective, isOptimal, getIncumbentValue
+   */
+#ifdef _MSC_VER
+  bool optimize(unsigned int maxSteps = UINT_MAX,
+                unsigned int maxDepth = UINT_MAX);
+#else
+  bool optimize(unsigned int maxSteps = std::numeric_limits<unsigned int>::max(),
+                unsigned int maxDepth = std::numeric_limits<unsigned int>::max());
+#endif // _MSC_VER
+
+  /**
+   * @brief Set the variable to optimize, overriding the 'objective' attribute of the configuration.
+   *
+   * An expression over token variables can be optimized by constraining a global variable to it in the model.
+   * Since plans are flexible, the value of a plan is taken to be the best bound of the objective in it.
+   * @param objective The variable to optimize.
+   * @param maximize True to maximize the objective, otherwise it is minimized.
+   */
+  void setObjective(const ConstrainedVariableId objective, bool maximize = false);
+
+  /**
+   * @brief True if the last call to optimize found a plan.
+   */
+  bool hasIncumbent() const {return m_hasIncumbent;}
+
+  /**
+   * @brief The objective value of the best plan found by the last call to optimize.
+   */
+  edouble getIncumbentValue() const;
+
+  /**
+   * @brief The number of successively better plans found by the last call to optimize.
+   */
+  unsigned int getIncumbentCount() const {return m_incumbentCount;}
+
+  /**
+   * @brief True if the last call to optimize proved that no plan is better than the incumbent.
+   */
+  bool isOptimal() const {return m_optimal;}
+
+  /**
+   * @brief Follow a recorded search.  Each new decision is taken on the flaw that was decided next in the trace,
+   * rather than the one preferred by the flaw managers, and its choices are passed over up to the one recorded.
+   * Each choice executed and its propagation result are checked against the trace.  At the end of the trace, or
+   * at the first difference, normal search resumes.
+   * @param trace The search to follow.  Record it by adding a SearchTrace as a listener.
+   * @param baseKey Added to the keys in the trace to give the keys of flaws in this search.
+   * @see hasDiverged, getReplayPosition
+   */
+  void replay(const SearchTrace& trace, const eint baseKey = 0);
+
+  /**
+   * @brief True while following a trace.
+   */
+  bool isReplaying() const {return !m_replayDiverged && m_replayPosition < m_replaySteps.size();}
+
+  /**
+   * @brief True if the search departed from the trace being followed.
+   */
+  bool hasDiverged() const {return m_replayDiverged;}
+
+  /**
+   * @brief The number of steps of the trace being followed that have been repeated.
+   */
+  unsigned long getReplayPosition() const {return m_replayPosition;}
+
+  /**
+   * @brief The statistics kept on the flaws resolved, or NULL if none are configured.
+   */
+  const FlawStatistics* getStatistics() const {return m_statistics;}
+
   /**
    * @brief Invocation for a single step of flaw resolution.
    *
@@ -176,6 +289,14 @@ class Solver {
 
   std::multimap<Priority, std::string> getOpenDecisions() const;
 
+  /**
+   * @brief Retrieve open decisions best first, in the same order as the rendered form but
+   * without rendering any flaw.
+   * @param decisions Output, cleared first.
+   * @param k If non-zero, only the k best decisions are retrieved.
+   */
+  void getOpenDecisions(std::vector<OpenDecision>& decisions, unsigned int k = 0) const;
+
   std::string printOpenDecisions() const;
 
   /**
@@ -209,6 +330,31 @@ class Solver {
    */
   DecisionPointId getZeroCommitmentDecision();
 
+  /**
+   * @brief Allocates a decision on the flaw decided next in the trace being followed.
+   * @return DecisionPointId::noId() if that flaw is not open, in which case the search has diverged.
+   */
+  DecisionPointId getReplayDecision();
+
+  /**
+   * @brief Compares the step just taken with the next step of the trace being followed.
+   * @param consistent True if propagation succeeded after the step.
+   */
+  void checkReplay(bool consistent);
+
+  /**
+   * @brief The key of the flaw decided at the next step of the trace being followed.
+   */
+  eint getReplayKey() const;
+
+  /**
+   * @brief Executes and retracts the choices of the active decision that come before the one taken at the next
+   * step of the trace being followed, so that the recorded choice is executed next.
+   */
+  void skipToReplayChoice();
+
+  void diverge(const std::string& reason);
+
   void doStep();
   bool conflictLevelOk();
   double m_baseConflictLevel;  // Keeps track of initial conflict level before a solver step is taken
@@ -223,6 +369,59 @@ class Solver {
    */
   void cleanupDecisions();
 
+  /**
+   * @brief The value of the current plan: the lower bound of the objective when minimizing, otherwise its upper bound.
+   */
+  edouble getObjectiveValue() const;
+
+  /**
+   * @brief Where a decision of the incumbent was taken, and what it chose.  Tokens are located by their path
+   * from a root token, and variables by their index in their token, since both are created again with new
+   * keys when the decisions are followed again.
+   */
+  struct IncumbentDecision {
+    eint key; /*!< The key of the flawed entity, or of the root token it is located from */
+    std::vector<unsigned int> path; /*!< The slave positions from the root token to the flawed token */
+    bool onToken; /*!< True if the flaw is located from a root token */
+    bool onVariable; /*!< True if the flaw is a variable of the located token */
+    unsigned long variableIndex; /*!< The index of the flawed variable in its token */
+    bool specified; /*!< True if the decision specified the flawed variable */
+    edouble value; /*!< The value specified */
+    unsigned int choice; /*!< The index of the choice executed */
+  };
+
+  void recordIncumbent();
+
+  IncumbentDecision getIncumbentDecision(const DecisionPointId decision) const;
+
+  EntityId getIncumbentFlaw(const IncumbentDecision& decision) const;
+
+  /**
+   * @brief Take the recorded decisions of the incumbent again, for as long as they apply and are consistent.
+   */
+  void restoreIncumbent();
+
+  /**
+   * @brief Allocates a decision on the open flaw with the given key.
+   * @return DecisionPointId::noId() if no flaw manager has that flaw open.
+   */
+  DecisionPointId allocateDecisionPoint(const eint key, const std::string& explanation);
+
+  /**
+   * @brief Constrain the objective to be no worse than a new variable with the given domain.
+   * @param relation "lt" for a strict bound, "leq" otherwise.
+   */
+  void postObjectiveBound(const std::string& relation, const Domain& bound);
+
+  void removeObjectiveBound();
+
+  /**
+   * @brief Backtrack from a plan that the tightened bound has ruled out, discarding decisions until the
+   * bound is consistent with those that remain.
+   * @return true if search is exhausted.
+   */
+  bool backtrackFromIncumbent();
+
   void notifyAdded(const TokenId token);
 
   void notifyRemoved(const TokenId token);
@@ -272,6 +471,24 @@ class Solver {
   DecisionStack m_decisionStack; /*!< Stack of decisions made */
   std::string m_lastExecutedDecision; /*!< Kept for debugging and UI purposes */
   std::list<SearchListenerId> m_listeners; /*!< The set of listeners for the search */
+  std::string m_objectiveName; /*!< The name of the global variable to optimize, if configured */
+  ConstrainedVariableId m_objective; /*!< The variable to optimize */
+  bool m_maximize; /*!< True if the objective is maximized rather than minimized */
+  ConstrainedVariableId m_objectiveBound; /*!< The bound on the objective posted while optimizing */
+  ConstraintId m_objectiveConstraint; /*!< Relates the objective to its bound */
+  bool m_hasIncumbent; /*!< True when optimize has found a plan */
+  edouble m_incumbent; /*!< The objective value of the best plan found */
+  unsigned int m_incumbentCount; /*!< The number of improving plans found */
+  bool m_optimal; /*!< True when the incumbent is proved optimal */
+  std::vector<IncumbentDecision> m_incumbentDecisions; /*!< The decisions of the incumbent above the backtrack floor */
+  unsigned long m_backtrackFloor; /*!< Decisions below this depth are not revisited.  Set while optimizing. */
+  std::vector<SearchTrace::Entry> m_replaySteps; /*!< The steps of the trace being followed */
+  std::vector<std::string> m_replayDecisionTypes; /*!< The decision point type of each step being followed */
+  eint m_replayBaseKey; /*!< Added to the keys in the trace being followed */
+  unsigned long m_replayPosition; /*!< The index of the next step to follow */
+  bool m_replayDiverged; /*!< True once the search departs from the trace */
+  FlawStatistics* m_statistics; /*!< Learned flaw statistics, if configured */
+  std::string m_statisticsFile; /*!< Where the statistics are loaded from and saved to */
 
   class FlawIterator : public Iterator {
    public:
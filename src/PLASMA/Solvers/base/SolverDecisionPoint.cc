@@ -10,7 +10,7 @@ DecisionPoint::DecisionPoint(const DbClientId client, eint entityKey,
                              const std::string& explanation) 
       : Entity(), m_client(client),  m_entityKey(entityKey), m_id(this), 
 	m_explanation(explanation), m_isExecuted(false), m_initialized(false),
-        m_context(), m_maxChoices(0), m_counter(0) {}
+        m_context(), m_maxChoices(0), m_counter(0), m_statistics(NULL), m_componentName() {}
 
     DecisionPoint::~DecisionPoint() {m_id.remove();}
 
@@ -67,7 +67,33 @@ namespace EUROPA {
 
       void setCutoff(unsigned int maxChoices) {m_maxChoices = maxChoices;}
 
+      /**
+       * @brief The component name of the flaw handler that allocated this decision, or empty if there was none.
+       */
+      const std::string& getComponentName() const {return m_componentName;}
+
+      void setComponentName(const std::string& name) {m_componentName = name;}
+
+      /**
+       * @brief The number of times a choice has been executed.
+       */
+      unsigned int getExecutionCount() const {return m_counter;}
+
       const eint getFlawedEntityKey() {return m_entityKey;}
+
+      /**
+       * @brief The kind of the choice last executed, under which FlawStatistics records it. Empty unless
+       * a subclass tells its choices apart.
+       */
+      virtual std::string getChoiceKind() const {return "";}
+
+      /**
+       * @brief Statistics a subclass may use to order its choices, or NULL.
+       * @see FlawStatistics::orderChoices
+       */
+      const FlawStatistics* getStatistics() const {return m_statistics;}
+
+      void setStatistics(const FlawStatistics* statistics) {m_statistics = statistics;}
       //    protected:
       DecisionPoint(const DbClientId client, eint entityKey, const std::string& explanation);
 
@@ -149,6 +175,8 @@ namespace EUROPA {
       ContextId m_context;
       unsigned int m_maxChoices; /*!< Set to bound number of choices */
       unsigned int m_counter; /*!< Increment on execution */
+      const FlawStatistics* m_statistics; /*!< Hints for ordering choices, if any */
+      std::string m_componentName; /*!< The component name of the allocating flaw handler */
     };
   }
 }
@@ -51,11 +51,11 @@ namespace EUROPA {
         return false;
       ConstrainedVariableId var = entity;
       debugMsg("GuardFilter:test", "Testing " << entity->toLongString() << " for guard-ness.");
-      std::set<ConstraintId> constraints;
+      ConstraintSet constraints;
       var->constraints(constraints);
       debugMsg("GuardFilter:test",
                "Testing for " << RuleVariableListener::CONSTRAINT_NAME() << " constraints.");
-      for(std::set<ConstraintId>::iterator it = constraints.begin(); it != constraints.end(); ++it) {
+      for(ConstraintSet::iterator it = constraints.begin(); it != constraints.end(); ++it) {
         ConstraintId constr = *it;
         debugMsg("GuardFilter:test", "Variable has a " << constr->getName() << " constraint.");
         //indicate a match if this variable is a guard (will be filtered out)
@@ -3,6 +3,7 @@
 #include "Token.hh"
 #include "TokenVariable.hh"
 #include "ConstrainedVariable.hh"
+#include "FlawStatistics.hh"
 
 // TODO: move this to the appropriate place
 #ifdef _MSC_VER
@@ -96,6 +97,10 @@ void OpenConditionDecisionPoint::handleInitialize(){
              m_flawedToken->getKey() << " because it isn't in the state domain.");
   }
 
+  // Learned statistics may put the states that have failed least often first
+  if(getStatistics() != NULL)
+    getStatistics()->orderChoices(m_flawedToken, m_choices);
+
   m_choiceCount = m_choices.size();
 }
 
@@ -138,6 +143,10 @@ void OpenConditionDecisionPoint::handleUndo() {
     m_choiceIndex++;
 }
 
+std::string OpenConditionDecisionPoint::getChoiceKind() const {
+  return (m_choiceIndex < m_choices.size() ? m_choices[m_choiceIndex].toString() : std::string());
+}
+
 bool OpenConditionDecisionPoint::hasNext() const {
   return m_choiceIndex < m_choiceCount;
 }
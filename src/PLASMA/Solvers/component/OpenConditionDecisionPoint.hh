@@ -53,6 +53,11 @@ namespace EUROPA {
       virtual std::string toString() const;
       virtual std::string toShortString() const;
 
+      /**
+       * @brief The state assigned by the current choice.
+       */
+      virtual std::string getChoiceKind() const;
+
       /**
        * @brief Accessor to flawed token
        */
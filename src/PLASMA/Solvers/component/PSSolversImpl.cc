@@ -118,6 +118,20 @@ bool PSSolverImpl::solve(int maxSteps, int maxDepth) {
     return retval;
   }
 
+  PSList<PSOpenDecision> PSSolverImpl::getOpenDecisions(int k) {
+    PSList<PSOpenDecision> retval;
+
+    std::vector<SOLVERS::OpenDecision> decisions;
+    m_solver->getOpenDecisions(decisions, k > 0 ? static_cast<unsigned int>(k) : 0);
+    for(std::vector<SOLVERS::OpenDecision>::const_iterator it = decisions.begin(); it != decisions.end(); ++it)
+      retval.push_back(PSOpenDecision(it->getFlaw()->getEntityKey(),
+                                      it->getFlawManager()->getName(),
+                                      static_cast<int>(it->getFlawHandler()->getIndex()),
+                                      it->getPriority()));
+
+    return retval;
+  }
+
   std::string PSSolverImpl::getLastExecutedDecision() {
     return m_solver->getLastExecutedDecision();
   }
@@ -43,6 +43,7 @@ class PSSolverImpl : public PSSolver {
 
   virtual bool hasFlaws();
   virtual PSList<std::string> getFlaws();
+  virtual PSList<PSOpenDecision> getOpenDecisions(int k = 0);
   virtual std::string getLastExecutedDecision();
 
   virtual const std::string& getConfigFilename();
@@ -5,6 +5,10 @@
 #include "DbClient.hh"
 #include "Debug.hh"
 #include "PlanDatabase.hh"
+#include "FlawStatistics.hh"
+#include "tinyxml.h"
+
+#include <set>
 
 /**
  * @author Conor McGann
@@ -20,11 +24,12 @@ namespace EUROPA {
 
   ThreatDecisionPoint::ThreatDecisionPoint(const DbClientId client,
                                            const TokenId tokenToOrder,
-                                           const TiXmlElement&,
+                                           const TiXmlElement& configData,
                                            const std::string& explanation)
       : DecisionPoint(client, tokenToOrder->getKey(), explanation),
-        m_tokenToOrder(tokenToOrder), m_choices(), m_choiceCount(0), m_index(0) {
-      // Here is where we would look for custom processing for configuration of the decision point
+        m_tokenToOrder(tokenToOrder), m_choices(), m_choiceCount(0), m_index(0), m_breakSymmetry(false) {
+      const char* breakSymmetry = configData.Attribute("breakSymmetry");
+      m_breakSymmetry = (breakSymmetry != NULL && strcmp(breakSymmetry, "true") == 0);
     }
 
     void ThreatDecisionPoint::handleExecute(){
@@ -82,9 +87,74 @@ namespace EUROPA {
       m_tokenToOrder->getPlanDatabase()->getOrderingChoices(m_tokenToOrder, m_choices);
       ObjectComparator cmp;
       std::sort<std::vector<std::pair<ObjectId, std::pair<TokenId, TokenId> > >::iterator, ObjectComparator&>(m_choices.begin(), m_choices.end(), cmp);
+      if(m_breakSymmetry)
+        breakObjectSymmetry();
+      if(getStatistics() != NULL)
+        orderChoicesByKind();
       m_choiceCount = m_choices.size();
     }
 
+    void ThreatDecisionPoint::breakObjectSymmetry() {
+      std::vector<ObjectId> objects;
+      for(std::vector<std::pair<ObjectId, std::pair<TokenId, TokenId> > >::const_iterator it = m_choices.begin();
+          it != m_choices.end(); ++it) {
+        if(objects.empty() || objects.back() != it->first)
+          objects.push_back(it->first);
+      }
+      if(objects.size() < 2)
+        return;
+
+      std::vector< std::vector<ObjectId> > classes;
+      m_tokenToOrder->getPlanDatabase()->getInterchangeableObjects(objects, classes);
+      if(classes.size() == objects.size())
+        return;
+
+      std::set<ObjectId> firsts;
+      for(std::vector< std::vector<ObjectId> >::const_iterator it = classes.begin(); it != classes.end(); ++it)
+        firsts.insert(it->front());
+
+      std::vector<std::pair<ObjectId, std::pair<TokenId, TokenId> > > choices;
+      for(std::vector<std::pair<ObjectId, std::pair<TokenId, TokenId> > >::const_iterator it = m_choices.begin();
+          it != m_choices.end(); ++it) {
+        if(firsts.find(it->first) != firsts.end())
+          choices.push_back(*it);
+      }
+      debugMsg("ThreatDecisionPoint:breakObjectSymmetry",
+               "Reduced " << m_choices.size() << " choices to " << choices.size() <<
+               " for " << m_tokenToOrder->toString());
+      m_choices.swap(choices);
+    }
+
+    void ThreatDecisionPoint::orderChoicesByKind() {
+      std::vector<LabelStr> kinds;
+      kinds.push_back(LabelStr("before"));
+      kinds.push_back(LabelStr("after"));
+      kinds.push_back(LabelStr("alone"));
+      getStatistics()->orderChoices(m_tokenToOrder, kinds);
+
+      std::vector<std::pair<ObjectId, std::pair<TokenId, TokenId> > > choices;
+      choices.reserve(m_choices.size());
+      for(std::vector<LabelStr>::const_iterator kindIt = kinds.begin(); kindIt != kinds.end(); ++kindIt) {
+        for(unsigned long i = 0; i < m_choices.size(); i++) {
+          if(getChoiceKind(i) == kindIt->toString())
+            choices.push_back(m_choices[i]);
+        }
+      }
+      checkError(choices.size() == m_choices.size(), "Lost ordering choices for " << m_tokenToOrder->toString());
+      m_choices.swap(choices);
+    }
+
+    std::string ThreatDecisionPoint::getChoiceKind() const {
+      return (m_index < m_choices.size() ? getChoiceKind(m_index) : std::string());
+    }
+
+    std::string ThreatDecisionPoint::getChoiceKind(unsigned long index) const {
+      const std::pair<TokenId, TokenId>& tokens = m_choices[index].second;
+      if(tokens.first == m_tokenToOrder)
+        return (tokens.second == m_tokenToOrder ? "alone" : "before");
+      return "after";
+    }
+
     std::string ThreatDecisionPoint::toShortString() const {
       std::stringstream os;
       
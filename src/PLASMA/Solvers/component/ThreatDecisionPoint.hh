@@ -14,7 +14,14 @@ namespace SOLVERS {
 
 /**
  * @brief Defines a class for formulation, execution and retraction of token ordering
- * decisions as a means to resolve object flaws.
+ * decisions as a means to resolve object flaws.  If configured with breakSymmetry="true", only
+ * orderings on the first object of each class of interchangeable objects are tried.
+ *
+ * The kind of a choice is "before" if it puts the token before another, "after" if it puts it after another,
+ * and "alone" if it puts the token on an object with no other tokens.  Learned statistics may reorder the
+ * choices by kind.
+ * @see PlanDatabase::getInterchangeableObjects
+ * @see FlawStatistics
  */
 class ThreatDecisionPoint: public DecisionPoint {
  public:
@@ -30,15 +37,32 @@ class ThreatDecisionPoint: public DecisionPoint {
 
   const TokenId getToken() const {return m_tokenToOrder;}
 
+  /**
+   * @brief The ordering choices, as (object, (predecessor, successor)).  Populated by initialize().
+   */
+  const std::vector< std::pair<ObjectId, std::pair<TokenId, TokenId> > >& getChoices() const {return m_choices;}
+
   virtual std::string toString() const;
   virtual std::string toShortString() const;
 
+  virtual std::string getChoiceKind() const;
+
  protected:
   virtual void handleInitialize();
 
   void extractParts(unsigned long index, ObjectId& object, TokenId& predecessor,
                     TokenId& successor) const;
 
+  /**
+   * @brief Drops the choices on objects that are interchangeable with an earlier object.
+   */
+  void breakObjectSymmetry();
+
+  /**
+   * @brief Stably moves the choices of the kinds the statistics prefer to the front.
+   */
+  void orderChoicesByKind();
+
   /** Main Interface for the solver **/
   bool hasNext() const;
 
@@ -46,12 +70,15 @@ class ThreatDecisionPoint: public DecisionPoint {
   std::vector< std::pair<ObjectId, std::pair<TokenId, TokenId> > > m_choices; /*!< Choices across all objects */
   unsigned long m_choiceCount; /*!< Stored choice count - size of m_orderingChoices */
   unsigned long m_index; /*!< Current choice position in m_orderingChoices */
+  bool m_breakSymmetry; /*!< True if choices on interchangeable objects are to be dropped */
 
  private:
   virtual void handleExecute();
   virtual void handleUndo();
 
   /** HELPER METHODS **/
+  std::string getChoiceKind(unsigned long index) const;
+
   std::string toString(unsigned long index,
                        const std::pair<ObjectId, std::pair<TokenId, TokenId> >& choice) const;
 };
@@ -4,8 +4,11 @@
 #include "Domain.hh"
 #include "Debug.hh"
 #include "ValueSource.hh"
+#include "Object.hh"
+#include "PlanDatabase.hh"
 #include "tinyxml.h"
 #include <ctime>
+#include <set>
 
 /**
  * @brief Provides implementation for base class and common subclasses for handling variable flaws.
@@ -32,6 +35,41 @@ namespace EUROPA {
 
       checkError(strcmp(configData.Value(), "FlawHandler") == 0,
 		 "Configuration error. Expected element <FlawHandler> but found " << configData.Value());
+
+      const char* breakSymmetry = configData.Attribute("breakSymmetry");
+      if(breakSymmetry != NULL && strcmp(breakSymmetry, "true") == 0)
+        breakObjectSymmetry();
+    }
+
+    void UnboundVariableDecisionPoint::breakObjectSymmetry() {
+      const ObjectDomain* dom = dynamic_cast<const ObjectDomain*>(&(m_flawedVariable->lastDomain()));
+      if(dom == NULL)
+        return;
+
+      std::list<ObjectId> values = dom->makeObjectList();
+      if(values.size() < 2)
+        return;
+      std::vector<ObjectId> objects(values.begin(), values.end());
+      std::vector< std::vector<ObjectId> > classes;
+      objects.front()->getPlanDatabase()->getInterchangeableObjects(objects, classes);
+      if(classes.size() == objects.size())
+        return;
+
+      std::set<edouble> firsts;
+      for(std::vector< std::vector<ObjectId> >::const_iterator it = classes.begin(); it != classes.end(); ++it)
+        firsts.insert(it->front()->getKey());
+
+      OrderedValueSource* choices = new OrderedValueSource(m_flawedVariable->lastDomain());
+      for(Domain::size_type i = 0; i < m_choices->getCount(); i++) {
+        edouble value = m_choices->getValue(i);
+        if(firsts.find(value) != firsts.end())
+          choices->addValue(value);
+      }
+      debugMsg("UnboundVariableDecisionPoint:breakObjectSymmetry",
+               "Reduced " << m_choices->getCount() << " choices to " << choices->getCount() <<
+               " for " << m_flawedVariable->toString());
+      delete m_choices;
+      m_choices = choices;
     }
 
     UnboundVariableDecisionPoint::~UnboundVariableDecisionPoint(){
@@ -19,6 +19,10 @@ namespace SOLVERS {
      * This class adds the particulars of variable binding and unbinding, but
      * leaves all details of how choices are stored and how they are iterated through to
      * derived classes, thus allowing for specialized storage and selection.
+     *
+     * If configured with breakSymmetry="true", a variable over objects is only assigned the first
+     * object of each class of interchangeable objects.
+     * @see PlanDatabase::getInterchangeableObjects
      */
 class UnboundVariableDecisionPoint: public DecisionPoint {
  public:
@@ -68,6 +72,11 @@ class UnboundVariableDecisionPoint: public DecisionPoint {
 
   virtual bool canUndo() const;
 
+  /**
+   * @brief Drops the choices of objects that are interchangeable with an earlier choice.
+   */
+  void breakObjectSymmetry();
+
   /**
    * @brief Retrieves the next choice to be executed. Implementation will depend
    * on the representation of choices in the derived class.
@@ -1,6 +1,7 @@
 #include "solvers-test-module.hh"
 //#include "Nddl.hh"
 #include "Solver.hh"
+#include "FlawStatistics.hh"
 #include "ComponentFactory.hh"
 #include "Constraint.hh"
 #include "ConstraintType.hh"
@@ -37,7 +38,10 @@
 #include "ModuleSolvers.hh"
 #include "ModuleNddl.hh"
 
+#include <cstdio>
+#include <cstring>
 #include <fstream>
+#include <sstream>
 
 #include <boost/scoped_ptr.hpp>
 #include <boost/algorithm/string/predicate.hpp>
@@ -585,6 +589,7 @@ public:
     EUROPA_runTest(testValueEnum);
     EUROPA_runTest(testHSTSOpenConditionDecisionPoint);
     EUROPA_runTest(testHSTSThreatDecisionPoint);
+    EUROPA_runTest(testThreatSymmetryBreaking);
     return true;
   }
 
@@ -1594,6 +1599,74 @@ private:
     delete farHeurXml;
     return true;
   }
+
+  static std::set<ObjectId> orderingObjects(const SOLVERS::ThreatDecisionPoint& dp) {
+    std::set<ObjectId> objects;
+    for(unsigned long i = 0; i < dp.getChoices().size(); i++)
+      objects.insert(dp.getChoices()[i].first);
+    return objects;
+  }
+
+  static bool testThreatSymmetryBreaking() {
+    TestEngine testEngine;
+    CPPUNIT_ASSERT(testEngine.playTransactions((getTestLoadLibraryPath() + "/SymmetricTracks.nddl").c_str()));
+    PlanDatabaseId db = testEngine.getPlanDatabase();
+    DbClientId client = db->getClient();
+    TokenId next = client->getGlobalToken("next");
+    CPPUNIT_ASSERT(next.isValid());
+    ObjectId t2 = db->getObject("t2");
+    ObjectId t3 = db->getObject("t3");
+    ObjectId t4 = db->getObject("t4");
+
+    std::string plainHeur("<FlawHandler component=\"StandardThreatHandler\"/>");
+    TiXmlElement* plainHeurXml = initXml(plainHeur);
+    SOLVERS::ThreatDecisionPoint plain(client, next, *plainHeurXml);
+    plain.initialize();
+    std::set<ObjectId> plainObjects = orderingObjects(plain);
+    CPPUNIT_ASSERT(plainObjects.size() == 4);
+
+    // t2 and t3 differ only in their unused buses.  t4's bus is busy, so it stays.
+    std::string breakingHeur("<FlawHandler component=\"StandardThreatHandler\" breakSymmetry=\"true\"/>");
+    TiXmlElement* breakingHeurXml = initXml(breakingHeur);
+    SOLVERS::ThreatDecisionPoint breaking(client, next, *breakingHeurXml);
+    breaking.initialize();
+    std::set<ObjectId> breakingObjects = orderingObjects(breaking);
+    CPPUNIT_ASSERT(breakingObjects.size() == 3);
+    CPPUNIT_ASSERT(breakingObjects.find(t2) != breakingObjects.end());
+    CPPUNIT_ASSERT(breakingObjects.find(t3) == breakingObjects.end());
+    CPPUNIT_ASSERT(breakingObjects.find(t4) != breakingObjects.end());
+    CPPUNIT_ASSERT(breaking.getChoices().size() + 1 == plain.getChoices().size());
+
+    // Once t2 holds the job it is no longer interchangeable with t3
+    breaking.execute();
+    CPPUNIT_ASSERT(client->propagate());
+    std::vector<ObjectId> objects;
+    objects.push_back(t2);
+    objects.push_back(t3);
+    std::vector< std::vector<ObjectId> > classes;
+    db->getInterchangeableObjects(objects, classes);
+    CPPUNIT_ASSERT(classes.size() == (breaking.getChoices().front().first == t2 ? 2 : 1));
+    breaking.undo();
+
+    delete plainHeurXml;
+    delete breakingHeurXml;
+    return true;
+  }
+};
+
+/**
+ * Records the plans reported while optimizing.
+ */
+class IncumbentListener : public SearchListener {
+ public:
+  IncumbentListener() : SearchListener(), m_values(), m_optimalCount(0) {}
+  void notifyIncumbent(edouble value) {m_values.push_back(value);}
+  void notifyOptimal() {m_optimalCount++;}
+  const std::vector<edouble>& getValues() const {return m_values;}
+  unsigned int getOptimalCount() const {return m_optimalCount;}
+ private:
+  std::vector<edouble> m_values;
+  unsigned int m_optimalCount;
 };
 
 class SolverTests {
@@ -1602,18 +1675,24 @@ public:
     EUROPA_runTest(testMinValuesSimpleCSP);
     EUROPA_runTest(testSuccessfulSearch);
     EUROPA_runTest(testExhaustiveSearch);
+    EUROPA_runTest(testSymmetryBreaking);
     EUROPA_runTest(testSimpleActivation);
     EUROPA_runTest(testSimpleRejection);
     EUROPA_runTest(testMultipleSearch);
     EUROPA_runTest(testOversearch);
     EUROPA_runTest(testBacktrackFirstDecisionPoint);
     EUROPA_runTest(testMultipleSolutionsSearch);
+    EUROPA_runTest(testBranchAndBound);
+    EUROPA_runTest(testSearchTrace);
+    EUROPA_runTest(testFlawStatistics);
+    EUROPA_runTest(testAllocationIndependence);
     EUROPA_runTest(testGNATS_3196);
     EUROPA_runTest(testContext);
     EUROPA_runTest(testDeletedFlaw);
     EUROPA_runTest(testDeleteAfterCommit);
     EUROPA_runTest(testSingleonGuardLoop);
     EUROPA_runTest(testNoMoreFlawsAfterAddition);
+    EUROPA_runTest(testOpenDecisions);
     return true;
   }
 
@@ -1637,6 +1716,56 @@ private:
   }
 
 
+  static bool testOpenDecisions() {
+    TestEngine testEngine;
+    TiXmlElement* root = initXml( (getTestLoadLibraryPath() + "/SolverTests.xml").c_str(), "SimpleCSPSolver");
+    TiXmlElement* child = root->FirstChildElement();
+
+    CPPUNIT_ASSERT(testEngine.playTransactions( (getTestLoadLibraryPath() + "/StaticCSP.nddl").c_str()));
+    Solver solver(testEngine.getPlanDatabase(), *child);
+
+    // Same decisions in the same order as the rendered form
+    std::multimap<Priority, std::string> rendered = solver.getOpenDecisions();
+    std::vector<OpenDecision> decisions;
+    solver.getOpenDecisions(decisions);
+    CPPUNIT_ASSERT(decisions.size() == 5);
+    CPPUNIT_ASSERT(decisions.size() == rendered.size());
+    std::multimap<Priority, std::string>::const_iterator it = rendered.begin();
+    for(unsigned int i = 0; i < decisions.size(); ++i, ++it) {
+      const OpenDecision& decision = decisions[i];
+      CPPUNIT_ASSERT(decision.getFlawManager()->getName() == "UnboundVariableManager");
+      CPPUNIT_ASSERT(decision.getFlawManager()->toString(decision.getFlaw()) == it->second);
+      CPPUNIT_ASSERT(decision.getPriority() == decision.getFlawManager()->getPriority(decision.getFlaw()));
+    }
+
+    // v0 is resolved by the first flaw handler, v2 by the catch-all third one
+    ConstrainedVariableId v0 = testEngine.getPlanDatabase()->getGlobalVariable("v0");
+    ConstrainedVariableId v2 = testEngine.getPlanDatabase()->getGlobalVariable("v2");
+    for(unsigned int i = 0; i < decisions.size(); ++i) {
+      if(decisions[i].getFlaw() == v0)
+        CPPUNIT_ASSERT(decisions[i].getFlawHandler()->getIndex() == 0);
+      if(decisions[i].getFlaw() == v2)
+        CPPUNIT_ASSERT(decisions[i].getFlawHandler()->getIndex() == 2);
+    }
+
+    // Top-k is a prefix of the full order
+    std::vector<OpenDecision> best;
+    solver.getOpenDecisions(best, 2);
+    CPPUNIT_ASSERT(best.size() == 2);
+    for(unsigned int i = 0; i < best.size(); ++i)
+      CPPUNIT_ASSERT(best[i].getFlaw() == decisions[i].getFlaw());
+
+    solver.getOpenDecisions(best, 100);
+    CPPUNIT_ASSERT(best.size() == decisions.size());
+
+    // Nothing is open once solved
+    CPPUNIT_ASSERT(solver.solve());
+    solver.getOpenDecisions(best);
+    CPPUNIT_ASSERT(best.empty());
+
+    return true;
+  }
+
   /**
    * @brief Tests for an infinite loop when binding a singleton guard.
    */
@@ -1737,6 +1866,28 @@ private:
     return true;
   }
 
+  static unsigned long countExhaustiveSteps(const std::string& solverName) {
+    TestEngine testEngine;
+    TiXmlElement* root = initXml((getTestLoadLibraryPath() + "/SolverTests.xml").c_str(), solverName.c_str());
+    TiXmlElement* child = root->FirstChildElement();
+    CPPUNIT_ASSERT(testEngine.playTransactions((getTestLoadLibraryPath() + "/SymmetricObjects.nddl").c_str()));
+    Solver solver(testEngine.getPlanDatabase(), *child);
+    CPPUNIT_ASSERT(!solver.solve());
+    return solver.getStepCount();
+  }
+
+  static bool testSymmetryBreaking() {
+    // Each of 3 variables ranges over 5 rovers, r1 to r4 being interchangeable until one is used
+    unsigned long plainSteps = countExhaustiveSteps("SimpleCSPSolver");
+    CPPUNIT_ASSERT_MESSAGE(toString(plainSteps), plainSteps == 5 + 5*5 + 5*5*5);
+
+    // v0 may be r1 or r5.  Each then leaves 3 or 2 choices for v1, and each of those 2 to 4 for v2
+    unsigned long symmetricSteps = countExhaustiveSteps("SymmetryBreakingCSPSolver");
+    debugMsg("SolverTests:testSymmetryBreaking", "Step count " << plainSteps << " reduced to " << symmetricSteps);
+    CPPUNIT_ASSERT_MESSAGE(toString(symmetricSteps), symmetricSteps == 2 + (3 + 2) + (3 + 4 + 3) + (3 + 2));
+    return true;
+  }
+
   static bool testSimpleActivation() {
     TestEngine testEngine;
     TiXmlElement* root = initXml((getTestLoadLibraryPath() + "/SolverTests.xml").c_str(), "SimpleActivationSolver");
@@ -1878,6 +2029,392 @@ private:
     return true;
   }
 
+  static bool testBranchAndBound() {
+    TestEngine testEngine;
+    TiXmlElement* root = initXml((getTestLoadLibraryPath() + "/SolverTests.xml").c_str(), "SchedulingSolver");
+    TiXmlElement* child = root->FirstChildElement();
+    CPPUNIT_ASSERT(testEngine.playTransactions((getTestLoadLibraryPath() + "/Scheduling.nddl").c_str()));
+    PlanDatabaseId db = testEngine.getPlanDatabase();
+    ConstrainedVariableId makespan = db->getGlobalVariable("makespan");
+
+    // The configured objective.  Each plan found must improve on the last, ending with the optimum in the database
+    {
+      IncumbentListener listener;
+      Solver solver(db, *child);
+      solver.addListener(listener.getId());
+      CPPUNIT_ASSERT(solver.optimize());
+      CPPUNIT_ASSERT(solver.isOptimal());
+      CPPUNIT_ASSERT_MESSAGE(toString(solver.getIncumbentValue()), solver.getIncumbentValue() == 7);
+      CPPUNIT_ASSERT(solver.noMoreFlaws());
+      CPPUNIT_ASSERT_MESSAGE(makespan->toString(), makespan->lastDomain().getLowerBound() == 7);
+
+      const std::vector<edouble>& values = listener.getValues();
+      CPPUNIT_ASSERT(values.size() == solver.getIncumbentCount());
+      for(unsigned int i = 1; i < values.size(); i++)
+        CPPUNIT_ASSERT(values[i] < values[i-1]);
+      CPPUNIT_ASSERT(values.back() == 7);
+      CPPUNIT_ASSERT(listener.getOptimalCount() == 1);
+      solver.removeListener(listener.getId());
+      solver.reset();
+    }
+
+    // The slack before a deadline of 12, maximized
+    {
+      Solver solver(db, *child);
+      solver.setObjective(db->getGlobalVariable("slack"), true);
+      CPPUNIT_ASSERT(solver.optimize());
+      CPPUNIT_ASSERT(solver.isOptimal());
+      CPPUNIT_ASSERT_MESSAGE(toString(solver.getIncumbentValue()), solver.getIncumbentValue() == 5);
+      solver.reset();
+    }
+
+    // With only the budget for a first plan, the best plan found is taken again without further steps
+    {
+      Solver solver(db, *child);
+      CPPUNIT_ASSERT(solver.solve());
+      unsigned int steps = solver.getStepCount();
+      solver.reset();
+      CPPUNIT_ASSERT(solver.optimize(steps + 1));
+      CPPUNIT_ASSERT_MESSAGE(toString(solver.getStepCount()), solver.getStepCount() <= steps + 1);
+      CPPUNIT_ASSERT(solver.noMoreFlaws());
+      CPPUNIT_ASSERT_MESSAGE(makespan->toString(),
+                             makespan->lastDomain().getLowerBound() == solver.getIncumbentValue());
+      solver.reset();
+    }
+
+    // Decisions made before optimizing are kept
+    {
+      Solver solver(db, *child);
+      solver.step();
+      CPPUNIT_ASSERT(solver.getDepth() == 1);
+      eint key = solver.getDecisionStack().front()->getKey();
+      CPPUNIT_ASSERT(solver.optimize());
+      CPPUNIT_ASSERT(solver.getDecisionStack().front()->getKey() == key);
+      CPPUNIT_ASSERT(solver.noMoreFlaws());
+      solver.reset();
+    }
+
+    // Running out of choices in an earlier search doesn't stop the next one
+    {
+      Solver solver(db, *child);
+      CPPUNIT_ASSERT(solver.solve());
+      for(unsigned int i = 0; i < 1000 && !solver.isExhausted(); i++) {
+        solver.backjump(1);
+        solver.solve();
+      }
+      CPPUNIT_ASSERT(solver.isExhausted());
+      CPPUNIT_ASSERT(solver.optimize());
+      CPPUNIT_ASSERT(solver.isOptimal());
+      CPPUNIT_ASSERT_MESSAGE(toString(solver.getIncumbentValue()), solver.getIncumbentValue() == 7);
+      solver.reset();
+    }
+
+    // Ordering three jobs takes more than one step, so there can be no plan within the budget
+    {
+      Solver solver(db, *child);
+      CPPUNIT_ASSERT(!solver.optimize(1));
+      CPPUNIT_ASSERT(solver.isTimedOut());
+      CPPUNIT_ASSERT(!solver.hasIncumbent() && !solver.isOptimal());
+      solver.reset();
+    }
+
+    return true;
+  }
+
+  static unsigned long countSteps(const SearchTrace& trace) {
+    unsigned long retval = 0;
+    for(std::vector<SearchTrace::Entry>::const_iterator it = trace.getEntries().begin();
+        it != trace.getEntries().end(); ++it)
+      if(SearchTrace::isStep(*it))
+        retval++;
+    return retval;
+  }
+
+  /**
+   * A problem played into a fresh engine, with the configuration of a solver read from SolverTests.xml.  The
+   * configuration is deleted along with it.
+   */
+  class SolverProblem {
+  public:
+    SolverProblem(const std::string& solverName, const std::string& problem)
+        : m_root(initXml((getTestLoadLibraryPath() + "/SolverTests.xml").c_str(), solverName.c_str())),
+          m_document(m_root->GetDocument()), m_engine() {
+      CPPUNIT_ASSERT_MESSAGE(problem, m_engine.playTransactions((getTestLoadLibraryPath() + "/" + problem).c_str()));
+    }
+    const PlanDatabaseId getPlanDatabase() {return m_engine.getPlanDatabase();}
+    TiXmlElement& getConfig() {return *m_root->FirstChildElement();}
+    eint getKey(const std::string& variable) {return getPlanDatabase()->getGlobalVariable(variable)->getKey();}
+  private:
+    TiXmlElement* m_root;
+    scoped_ptr<TiXmlDocument> m_document;
+    TestEngine m_engine;
+  };
+
+  class FileRemover {
+  public:
+    FileRemover(const std::string& fileName) : m_fileName(fileName) {}
+    ~FileRemover() {remove(m_fileName.c_str());}
+  private:
+    const std::string m_fileName;
+  };
+
+  /**
+   * Records an exhaustive search, writes the trace out and reads it back, then follows it in a fresh database.
+   * Keys are taken relative to the first variable, since other tests have allocated keys before these.
+   */
+  static bool testSearchTrace() {
+    std::stringstream written;
+    unsigned int stepCount = 0;
+    {
+      SolverProblem problem("SimpleCSPSolver", "ExhaustiveSearch.nddl");
+      SearchTrace trace(problem.getKey("v0"));
+      Solver solver(problem.getPlanDatabase(), problem.getConfig());
+      solver.addListener(trace.getId());
+      CPPUNIT_ASSERT(!solver.solve());
+      stepCount = solver.getStepCount();
+      CPPUNIT_ASSERT(countSteps(trace) == stepCount);
+      CPPUNIT_ASSERT(trace.getEntries().back().type == SearchTrace::EXHAUSTED);
+      solver.removeListener(trace.getId());
+      trace.write(written);
+    }
+    SearchTrace recorded;
+    CPPUNIT_ASSERT(recorded.read(written));
+    CPPUNIT_ASSERT(countSteps(recorded) == stepCount);
+
+    // A decision type longer than the file is malformed, not a reason to allocate its length
+    {
+      std::string bytes = written.str();
+      bytes.replace(strlen("EUROPA-TRACE") + 1 + 8, 4, 4, '\xff');
+      std::istringstream corrupt(bytes);
+      SearchTrace trace;
+      CPPUNIT_ASSERT(!trace.read(corrupt));
+    }
+
+    // Following the trace takes the same path
+    {
+      SolverProblem problem("SimpleCSPSolver", "ExhaustiveSearch.nddl");
+      eint baseKey = problem.getKey("v0");
+      SearchTrace trace(baseKey);
+      Solver solver(problem.getPlanDatabase(), problem.getConfig());
+      solver.addListener(trace.getId());
+      solver.replay(recorded, baseKey);
+      CPPUNIT_ASSERT(!solver.solve());
+      CPPUNIT_ASSERT(!solver.hasDiverged());
+      CPPUNIT_ASSERT(solver.getReplayPosition() == stepCount);
+      unsigned long index;
+      CPPUNIT_ASSERT(!SearchTrace::findDivergence(recorded, trace, index));
+      solver.removeListener(trace.getId());
+    }
+
+    // A search cut short differs where it timed out, and one that can't find the recorded flaws searches as usual
+    {
+      SolverProblem problem("SimpleCSPSolver", "ExhaustiveSearch.nddl");
+      eint baseKey = problem.getKey("v0");
+      SearchTrace trace(baseKey);
+      Solver solver(problem.getPlanDatabase(), problem.getConfig());
+      solver.addListener(trace.getId());
+      CPPUNIT_ASSERT(!solver.solve(5));
+      unsigned long index;
+      CPPUNIT_ASSERT(SearchTrace::findDivergence(recorded, trace, index));
+      CPPUNIT_ASSERT(trace.getEntries()[index].type == SearchTrace::TIMED_OUT);
+      solver.removeListener(trace.getId());
+      solver.reset();
+
+      solver.replay(recorded, baseKey + 100000);
+      CPPUNIT_ASSERT(!solver.solve());
+      CPPUNIT_ASSERT(solver.hasDiverged() && solver.getReplayPosition() == 0);
+      CPPUNIT_ASSERT(solver.getStepCount() == stepCount);
+    }
+
+    // Decisions are recorded by the component name of their flaw handler, and the path to a plan found after
+    // backtracking leads straight to it
+    SearchTrace path;
+    {
+      SolverProblem problem("SimpleCSPSolver", "SuccessfulSearch.nddl");
+      SearchTrace trace(problem.getKey("v0"));
+      Solver solver(problem.getPlanDatabase(), problem.getConfig());
+      solver.addListener(trace.getId());
+      CPPUNIT_ASSERT(solver.solve());
+      CPPUNIT_ASSERT(trace.getDecisionType(trace.getEntries().front()) == "Min");
+      trace.getPath(path);
+      CPPUNIT_ASSERT(countSteps(path) == 3 && countSteps(trace) > 3);
+      CPPUNIT_ASSERT(path.getEntries().back().type == SearchTrace::COMPLETED);
+      solver.removeListener(trace.getId());
+    }
+    {
+      SolverProblem problem("SimpleCSPSolver", "SuccessfulSearch.nddl");
+      eint baseKey = problem.getKey("v0");
+      Solver solver(problem.getPlanDatabase(), problem.getConfig());
+      solver.replay(path, baseKey);
+      CPPUNIT_ASSERT(solver.solve());
+      CPPUNIT_ASSERT(!solver.hasDiverged() && solver.getReplayPosition() == 3);
+      CPPUNIT_ASSERT(solver.getStepCount() == 3);
+    }
+    return true;
+  }
+
+  /**
+   * Runs an exhaustive search twice, the second time with the statistics saved by the first.  The hints change
+   * which flaw is decided first but not the size of the search, and statistics saved for other models are kept.
+   * A file that can't be read is replaced.
+   */
+  static bool testFlawStatistics() {
+    const std::string fileName("FlawStatistics.txt");
+    FileRemover remover(fileName);
+    {
+      std::ofstream out(fileName.c_str());
+      out << "EUROPA-FLAW-STATISTICS 1" << std::endl << "model other" << std::endl << "1 1 0 0\tvariable x\t" << std::endl;
+    }
+
+    unsigned int stepCount = 0;
+    std::string mostRetracted;
+    {
+      SolverProblem problem("SimpleCSPSolver", "ExhaustiveSearch.nddl");
+      problem.getConfig().SetAttribute("statistics", fileName.c_str());
+      Solver solver(problem.getPlanDatabase(), problem.getConfig());
+      CPPUNIT_ASSERT(solver.getStatistics() != NULL);
+      CPPUNIT_ASSERT(!solver.solve());
+      stepCount = solver.getStepCount();
+
+      // Every step is recorded.  Propagation fails only when the last variable is bound, and recovering from
+      // that retracts the others
+      unsigned long executions = 0, failures = 0, backtracks = 0, propagationCost = 0;
+      double worstRate = 0;
+      const char* names[] = {"v0", "v1", "v2"};
+      for(int i = 0; i < 3; i++) {
+        std::string label = FlawStatistics::getLabel(problem.getPlanDatabase()->getGlobalVariable(names[i]));
+        FlawStatistics::Record record = solver.getStatistics()->getRecord(label);
+        executions += record.executions;
+        failures += record.failures;
+        backtracks += record.backtracks;
+        propagationCost += record.propagationCost;
+        if(FlawStatistics::getRetractionRate(record) > worstRate) {
+          worstRate = FlawStatistics::getRetractionRate(record);
+          mostRetracted = names[i];
+        }
+      }
+      CPPUNIT_ASSERT(executions == stepCount);
+      CPPUNIT_ASSERT(failures > 0 && backtracks > 0 && propagationCost > 0);
+      CPPUNIT_ASSERT(!mostRetracted.empty());
+      FlawStatistics::Record record = solver.getStatistics()->getRecord(
+          FlawStatistics::getLabel(problem.getPlanDatabase()->getGlobalVariable(mostRetracted)));
+      CPPUNIT_ASSERT(FlawStatistics::getRetractionRate(record) > FlawStatistics::getFailureRate(record));
+    }
+
+    {
+      SolverProblem problem("SimpleCSPSolver", "ExhaustiveSearch.nddl");
+      problem.getConfig().SetAttribute("statistics", fileName.c_str());
+      Solver solver(problem.getPlanDatabase(), problem.getConfig());
+      ConstrainedVariableId first = problem.getPlanDatabase()->getGlobalVariable(mostRetracted);
+      CPPUNIT_ASSERT(solver.getStatistics()->getRecord(FlawStatistics::getLabel(first)).failures > 0);
+
+      // The variable that cost the most retractions is decided first, and the search is as long as before
+      CPPUNIT_ASSERT(!solver.solve(1));
+      CPPUNIT_ASSERT(first->lastDomain().isSingleton());
+      CPPUNIT_ASSERT(!solver.solve());
+      CPPUNIT_ASSERT(solver.isExhausted());
+      CPPUNIT_ASSERT(solver.getStepCount() == stepCount);
+    }
+
+    {
+      std::ifstream in(fileName.c_str());
+      std::stringstream saved;
+      saved << in.rdbuf();
+      CPPUNIT_ASSERT(saved.str().find("model other\n1 1 0 0\tvariable x\t\n") != std::string::npos);
+    }
+
+    // A malformed file starts the search cold, and is replaced by the statistics of that search
+    {
+      std::ofstream out(fileName.c_str());
+      out << "EUROPA-FLAW-STATISTICS 1" << std::endl << "not a record" << std::endl;
+    }
+    {
+      SolverProblem problem("SimpleCSPSolver", "ExhaustiveSearch.nddl");
+      problem.getConfig().SetAttribute("statistics", fileName.c_str());
+      Solver solver(problem.getPlanDatabase(), problem.getConfig());
+      ConstrainedVariableId v0 = problem.getPlanDatabase()->getGlobalVariable("v0");
+      CPPUNIT_ASSERT(solver.getStatistics()->getRecord(FlawStatistics::getLabel(v0)).executions == 0);
+      CPPUNIT_ASSERT(!solver.solve());
+    }
+    {
+      SolverProblem problem("SimpleCSPSolver", "ExhaustiveSearch.nddl");
+      FlawStatistics statistics(problem.getPlanDatabase());
+      CPPUNIT_ASSERT(statistics.load(fileName));
+      ConstrainedVariableId v0 = problem.getPlanDatabase()->getGlobalVariable("v0");
+      CPPUNIT_ASSERT(statistics.getRecord(FlawStatistics::getLabel(v0)).executions > 0);
+    }
+    return true;
+  }
+
+  /**
+   * Solves a problem, recording the search relative to the key of the named global variable.  If perturb is
+   * set, blocks of varied size are allocated and every other one freed first, so that the entities of the
+   * problem land at different addresses, in a different relative order, than they otherwise would.
+   */
+  static unsigned int traceSearch(const std::string& solverName, const std::string& problem,
+                                  const std::string& baseVariable, const bool perturb, SearchTrace& trace) {
+    std::vector<char*> blocks;
+    if(perturb) {
+      unsigned int size = 7;
+      for(unsigned int i = 0; i < 2000; i++) {
+        size = (size * 37 + 11) % 509;
+        blocks.push_back(new char[size + 1]);
+      }
+      for(unsigned int i = 0; i < blocks.size(); i += 2) {
+        delete[] blocks[i];
+        blocks[i] = NULL;
+      }
+    }
+
+    unsigned int stepCount = 0;
+    {
+      SolverProblem solverProblem(solverName, problem);
+      SearchTrace recording(solverProblem.getKey(baseVariable));
+      Solver solver(solverProblem.getPlanDatabase(), solverProblem.getConfig());
+      solver.addListener(recording.getId());
+      solver.solve();
+      stepCount = solver.getStepCount();
+      solver.removeListener(recording.getId());
+      std::stringstream written;
+      recording.write(written);
+      CPPUNIT_ASSERT(trace.read(written));
+    }
+
+    for(std::vector<char*>::const_iterator it = blocks.begin(); it != blocks.end(); ++it)
+      delete[] *it;
+    return stepCount;
+  }
+
+  /**
+   * Solves the same problems with and without perturbing the heap first.  Containers ordered by key rather
+   * than by address make the same decisions in the same order either way.  The dispatching problem orders
+   * tokens across several objects, and has to retract most of its choices before it finds a plan.
+   */
+  static bool testAllocationIndependence() {
+    struct {const char* solver; const char* problem; const char* baseVariable; bool retracts;} problems[] =
+        {{"SimpleCSPSolver", "ExhaustiveSearch.nddl", "v0", true},
+         {"SchedulingSolver", "Scheduling.nddl", "makespan", false},
+         {"SchedulingSolver", "Dispatching.nddl", "makespan", true}};
+    for(unsigned int i = 0; i < sizeof(problems) / sizeof(problems[0]); i++) {
+      SearchTrace plain, perturbed;
+      unsigned int plainSteps = traceSearch(problems[i].solver, problems[i].problem, problems[i].baseVariable,
+                                            false, plain);
+      unsigned int perturbedSteps = traceSearch(problems[i].solver, problems[i].problem, problems[i].baseVariable,
+                                                true, perturbed);
+      CPPUNIT_ASSERT_MESSAGE(problems[i].problem, plainSteps > 0);
+      CPPUNIT_ASSERT_MESSAGE(toString(plainSteps) + " " + toString(perturbedSteps), plainSteps == perturbedSteps);
+      unsigned long index;
+      CPPUNIT_ASSERT_MESSAGE(problems[i].problem, !SearchTrace::findDivergence(plain, perturbed, index));
+
+      bool retracted = false;
+      for(std::vector<SearchTrace::Entry>::const_iterator it = plain.getEntries().begin();
+          it != plain.getEntries().end(); ++it)
+        retracted = retracted || it->type == SearchTrace::UNDONE;
+      CPPUNIT_ASSERT_MESSAGE(problems[i].problem, retracted == problems[i].retracts);
+    }
+    return true;
+  }
+
   static bool testGNATS_3196(){
     TestEngine testEngine;
     TiXmlElement* root = initXml( (getTestLoadLibraryPath() + "/SolverTests.xml").c_str(), "GNATS_3196");
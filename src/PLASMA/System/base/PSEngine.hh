@@ -11,10 +11,10 @@
 
 #ifdef _MSC_VER
 	#if defined USE_EUROPA_DLL
-		#if defined DLL_EXPORT
-			#define EUROPA_WINDOWS_DLL __declspec(dllexport)
-		#else
-			#define EUROPA_WINDOWS_DLL __declspec(dllimport)
+		#if defined DLL_EXPORT
+			#define EUROPA_WINDOWS_DLL __declspec(dllexport)
+		#else
+			#define EUROPA_WINDOWS_DLL __declspec(dllimport)
 		#endif
 	#else
 		#define EUROPA_WINDOWS_DLL
@@ -57,6 +57,12 @@ namespace EUROPA {
       virtual PSList<std::string> getViolationExpl() const = 0;
       virtual PSList<PSConstraint*> getAllViolations() const = 0;
 
+      /**
+       * @brief Find a minimal set of constraints and specified values that can't hold together.
+       * @see PSConstraintEngine::explainInconsistency
+       */
+      virtual bool explainInconsistency(PSList<PSConstraint*>& constraints, PSList<PSVariable*>& facts) = 0;
+
       // Plan Database methods
     virtual PSList<PSObject*> getObjects() = 0;
       virtual PSList<PSObject*> getObjectsByType(const std::string& objectType) = 0;
@@ -75,6 +81,26 @@ namespace EUROPA {
 
       virtual std::string planDatabaseToString() = 0;
 
+      /**
+       * @brief Delete all objects, tokens and global variables, keeping the loaded model.
+       */
+      virtual void resetPlanDatabase() = 0;
+
+      /**
+       * @brief Write the plan database as a grounded plan, for later validation.
+       * Every token and global variable must be a singleton.
+       * @see PlanValidator
+       */
+      virtual std::string groundedPlanToString() = 0;
+
+      /**
+       * @brief Check a grounded plan against the loaded model, without loading it into the plan database.
+       * @param unchecked Set to a description of each check that could not be made, such as constraints over objects.
+       * @return A description of each violation found; empty if the plan is valid.
+       * @see PlanValidator
+       */
+      virtual PSList<std::string> validatePlan(const std::string& plan, bool isFile, PSList<std::string>& unchecked) = 0;
+
       virtual PSSchema* getPSSchema() = 0;
 
       // Solver methods
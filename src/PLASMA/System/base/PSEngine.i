@@ -173,6 +173,7 @@ namespace EUROPA {
   class PSConstraint;
   class PSObject;
   class PSSolver;
+  class PSOpenDecision;
   class PSToken;
   class PSVariable;
   class PSVarValue;
@@ -237,6 +238,13 @@ namespace EUROPA {
     int get(int idx);
   };
   
+  %rename(PSOpenDecisionList) PSList<EUROPA::PSOpenDecision>;
+  class PSList<EUROPA::PSOpenDecision> {
+  public:
+    int size() const;
+    PSOpenDecision get(int idx);
+  };
+
   %rename(PSValueList) PSList<EUROPA::PSVarValue>;
   class PSList<EUROPA::PSVarValue> {
   public:
@@ -298,6 +306,9 @@ namespace EUROPA {
     void addPlanDatabaseListener(PSPlanDatabaseListener& listener);
     void addConstraintEngineListener(PSConstraintEngineListener& listener);
     std::string planDatabaseToString();
+    void resetPlanDatabase();
+    std::string groundedPlanToString();
+    PSList<std::string> validatePlan(const std::string& plan, bool isFile, PSList<std::string>& unchecked);
 
     PSSchema* getPSSchema();
 
@@ -318,6 +329,7 @@ namespace EUROPA {
     double getViolation() const;
     PSList<std::string> getViolationExpl() const;
 	PSList<PSConstraint*> getAllViolations() const;
+    bool explainInconsistency(PSList<PSConstraint*>& constraints, PSList<PSVariable*>& facts);
 
     PSSolver* createSolver(const std::string& configurationFile);
   };
@@ -399,6 +411,15 @@ namespace EUROPA {
     PSObject();
   };
 
+  class PSOpenDecision
+  {
+  public:
+    PSEntityKey getEntityKey() const;
+    const std::string& getFlawType() const;
+    int getHandlerId() const;
+    double getPriority() const;
+  };
+
   class PSSolver
   {
   public:
@@ -420,6 +441,7 @@ namespace EUROPA {
 
     int getOpenDecisionCnt();
     PSList<std::string> getFlaws();
+    PSList<PSOpenDecision> getOpenDecisions(int k = 0);
     std::string getLastExecutedDecision();
 
     const std::string& getConfigFilename();
@@ -14,6 +14,11 @@
 #include "Constraint.hh"
 #include "PlanDatabase.hh"
 #include "PSSolversImpl.hh"
+#include "PlanValidator.hh"
+#include "RulesEngine.hh"
+
+#include <fstream>
+#include <sstream>
 
 namespace EUROPA {
 
@@ -110,6 +115,45 @@ PSEngineImpl::PSEngineImpl() : m_started(false) {}
     return getPlanDatabase()->toString();
   }
 
+  void PSEngineImpl::resetPlanDatabase()
+  {
+    check_runtime_error(isStarted(),"PSEngine has not been started");
+    getPlanDatabase()->reset();
+  }
+
+  std::string PSEngineImpl::groundedPlanToString()
+  {
+    check_runtime_error(isStarted(),"PSEngine has not been started");
+    std::ostringstream os;
+    PlanValidator::write(getPlanDatabase(), os);
+    return os.str();
+  }
+
+  PSList<std::string> PSEngineImpl::validatePlan(const std::string& plan, bool isFile,
+                                                 PSList<std::string>& unchecked)
+  {
+    check_runtime_error(isStarted(),"PSEngine has not been started");
+    std::string text = plan;
+    if(isFile) {
+      std::ifstream is(plan.c_str());
+      check_runtime_error(is.good(), "Failed to open " + plan);
+      std::ostringstream contents;
+      contents << is.rdbuf();
+      text = contents.str();
+    }
+
+    PlanValidator validator(getPlanDatabase(), getRulesEngine()->getRuleSchema());
+    const std::vector<std::string> violations = validator.validate(text.c_str());
+    PSList<std::string> retval;
+    for(std::vector<std::string>::const_iterator it = violations.begin(); it != violations.end(); ++it)
+      retval.push_back(*it);
+    unchecked.clear();
+    for(std::vector<std::string>::const_iterator it = validator.getUnchecked().begin();
+        it != validator.getUnchecked().end(); ++it)
+      unchecked.push_back(*it);
+    return retval;
+  }
+
   PSSchema* PSEngineImpl::getPSSchema()
   {
 	  return getPlanDatabase()->getSchema();
@@ -187,6 +231,11 @@ PSEngineImpl::PSEngineImpl() : m_started(false) {}
 	  return getConstraintEnginePtr()->getAllViolations();
   }
 
+  bool PSEngineImpl::explainInconsistency(PSList<PSConstraint*>& constraints, PSList<PSVariable*>& facts)
+  {
+    return getConstraintEngine()->explainInconsistency(constraints, facts);
+  }
+
   // Solver methods
   PSSolver* PSEngineImpl::createSolver(const std::string& configurationFile)
   {
@@ -38,6 +38,7 @@ namespace EUROPA {
     virtual double getViolation() const;
     virtual PSList<std::string> getViolationExpl() const;
     virtual PSList<PSConstraint*> getAllViolations() const;
+    virtual bool explainInconsistency(PSList<PSConstraint*>& constraints, PSList<PSVariable*>& facts);
 
     // Plan Database methods
     virtual PSList<PSObject*> getObjects();
@@ -56,6 +57,9 @@ namespace EUROPA {
     virtual PSPlanDatabaseClient* getPlanDatabaseClient();
 
     virtual std::string planDatabaseToString();
+    virtual void resetPlanDatabase();
+    virtual std::string groundedPlanToString();
+    virtual PSList<std::string> validatePlan(const std::string& plan, bool isFile, PSList<std::string>& unchecked);
     virtual PSSchema* getPSSchema();
 
 
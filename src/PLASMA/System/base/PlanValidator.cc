@@ -0,0 +1,833 @@
+#include "PlanValidator.hh"
+#include "PlanDatabase.hh"
+#include "Schema.hh"
+#include "Object.hh"
+#include "Token.hh"
+#include "TokenType.hh"
+#include "TokenVariable.hh"
+#include "ConstraintEngine.hh"
+#include "Constraint.hh"
+#include "ConstraintType.hh"
+#include "Propagators.hh"
+#include "CESchema.hh"
+#include "DataType.hh"
+#include "Domains.hh"
+#include "Rule.hh"
+#include "Debug.hh"
+#include "Error.hh"
+#include "tinyxml.h"
+
+#ifndef NO_RESOURCES
+#include "Resource.hh"
+#include "Profile.hh"
+#include "Transaction.hh"
+#endif
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <limits>
+#include <set>
+#include <sstream>
+
+namespace EUROPA {
+
+  namespace {
+
+    const char* attribute(const TiXmlElement& element, const char* name) {
+      const char* value = element.Attribute(name);
+      return (value == NULL ? "" : value);
+    }
+
+    /**
+     * Numbers are written in full, since the default precision can round the infinities beyond range.
+     */
+    std::string numberAsString(const edouble value) {
+      if(value >= PLUS_INFINITY)
+        return "inf";
+      if(value <= MINUS_INFINITY)
+        return "-inf";
+      std::ostringstream os;
+      os << std::setprecision(std::numeric_limits<double>::digits10 + 2) << cast_double(value);
+      return os.str();
+    }
+
+    bool stringAsNumber(const char* str, edouble& value) {
+      if(str == NULL)
+        return false;
+      if(strcmp(str, "inf") == 0 || strcmp(str, "+inf") == 0) {
+        value = PLUS_INFINITY;
+        return true;
+      }
+      if(strcmp(str, "-inf") == 0) {
+        value = MINUS_INFINITY;
+        return true;
+      }
+      char* end = NULL;
+      const double result = strtod(str, &end);
+      if(end == str || *end != '\0' || result >= cast_double(PLUS_INFINITY) ||
+         result <= cast_double(MINUS_INFINITY))
+        return false;
+      value = result;
+      return true;
+    }
+
+    std::string keyAsString(const eint key) {
+      std::ostringstream os;
+      os << key;
+      return os.str();
+    }
+
+    bool isEarlierKey(const std::string& key, const std::string& other) {
+      return key.size() < other.size() || (key.size() == other.size() && key < other);
+    }
+
+    std::string valueAsString(const ConstrainedVariableId var, const edouble value) {
+      const DataTypeId dt = var->getDataType();
+      if(dt->isEntity())
+        return Entity::getTypedEntity<Object>(value)->getName();
+      if(dt->isNumeric() && !dt->isBool())
+        return numberAsString(value);
+      return dt->toString(value);
+    }
+
+    /**
+     * @brief Set the type and value of var on element. A numeric variable that is not a singleton is
+     * written as bounds, and any other as just its type, which leaves constraints on it unchecked.
+     */
+    void setValue(TiXmlElement& element, const ConstrainedVariableId var) {
+      const Domain& domain = var->lastDomain();
+      element.SetAttribute("type", var->getDataType()->getName().c_str());
+      if(domain.isSingleton())
+        element.SetAttribute("value", valueAsString(var, domain.getSingletonValue()).c_str());
+      else if(domain.isNumeric() && !domain.isEmpty()) {
+        element.SetAttribute("lb", numberAsString(domain.getLowerBound()).c_str());
+        element.SetAttribute("ub", numberAsString(domain.getUpperBound()).c_str());
+      }
+    }
+
+    void setGroundedValue(TiXmlElement& element, const ConstrainedVariableId var) {
+      checkRuntimeError(var->lastDomain().isSingleton(),
+                        "Grounded plans need singleton variables, but " << var->toString() << " is not.");
+      setValue(element, var);
+    }
+
+    bool isWritten(const TokenId token) {
+      return token->isActive() || token->isMerged();
+    }
+
+    /**
+     * @brief Set element to refer to var, as a token or global variable if it is one.
+     * @return false if var belongs to a token that is not in the plan.
+     */
+    bool setArgument(TiXmlElement& element, const ConstrainedVariableId var, const ConstrainedVariableSet& globals) {
+      Token* token = (var->parent().isId() ? dynamic_cast<Token*>(static_cast<Entity*>(var->parent())) : NULL);
+      if(token != NULL) {
+        if(!isWritten(token->getId()))
+          return false;
+        element.SetAttribute("token", keyAsString(token->getKey()).c_str());
+        element.SetAttribute("var", var->getName().c_str());
+      }
+      else if(globals.find(var) != globals.end())
+        element.SetAttribute("global", var->getName().c_str());
+      else
+        setValue(element, var);
+      return true;
+    }
+
+#ifndef NO_RESOURCES
+    void addProfile(TiXmlElement& resource, const char* name, const ExplicitProfileId profile) {
+      const std::map<eint, std::pair<edouble, edouble> >& values = profile->getValues();
+      for(std::map<eint, std::pair<edouble, edouble> >::const_iterator it = values.begin(); it != values.end(); ++it) {
+        TiXmlElement* element = new TiXmlElement(name);
+        element->SetAttribute("time", numberAsString(it->first).c_str());
+        element->SetAttribute("lb", numberAsString(it->second.first).c_str());
+        element->SetAttribute("ub", numberAsString(it->second.second).c_str());
+        resource.LinkEndChild(element);
+      }
+    }
+
+    TiXmlElement* resourceAsXml(const Resource& resource) {
+      TiXmlElement* element = new TiXmlElement("resource");
+      element->SetAttribute("name", resource.getName().c_str());
+      element->SetAttribute("maxInstConsumption", numberAsString(resource.getMaxInstConsumption()).c_str());
+      element->SetAttribute("maxInstProduction", numberAsString(resource.getMaxInstProduction()).c_str());
+      element->SetAttribute("maxConsumption", numberAsString(resource.getMaxConsumption()).c_str());
+      element->SetAttribute("maxProduction", numberAsString(resource.getMaxProduction()).c_str());
+      addProfile(*element, "capacity", resource.getCapacityProfile());
+      addProfile(*element, "limit", resource.getLimitProfile());
+
+      const TransactionSet& transactions = resource.getProfile()->getAllTransactions();
+      for(TransactionSet::const_iterator it = transactions.begin(); it != transactions.end(); ++it) {
+        const TransactionId transaction = *it;
+        checkRuntimeError(transaction->time()->lastDomain().isSingleton() &&
+                          transaction->quantity()->lastDomain().isSingleton(),
+                          "Grounded plans need singleton transactions, but " << transaction->toString() <<
+                          " on " << resource.getName() << " is not.");
+        TiXmlElement* child = new TiXmlElement("transaction");
+        child->SetAttribute("time", numberAsString(transaction->time()->lastDomain().getSingletonValue()).c_str());
+        child->SetAttribute("quantity",
+                            numberAsString(transaction->quantity()->lastDomain().getSingletonValue()).c_str());
+        child->SetAttribute("consumer", transaction->isConsumer() ? "true" : "false");
+        element->LinkEndChild(child);
+      }
+      return element;
+    }
+#endif
+
+    /**
+     * @brief The value of a profile of time, lb and ub entries at a time, or the default before the first entry.
+     */
+    std::pair<edouble, edouble> valueAt(const std::map<edouble, std::pair<edouble, edouble> >& profile,
+                                        const edouble time, const std::pair<edouble, edouble>& value) {
+      std::map<edouble, std::pair<edouble, edouble> >::const_iterator it = profile.upper_bound(time);
+      if(it == profile.begin())
+        return value;
+      --it;
+      return it->second;
+    }
+  }
+
+  PlanValidator::PlanValidator(const PlanDatabaseId db, const RuleSchemaId rules)
+    : m_db(db), m_rules(rules), m_ce((new ConstraintEngine(db->getConstraintEngine()->getCESchema()))->getId()),
+      m_objects(), m_globals(), m_tokens(), m_variables(), m_hasRules(), m_bodies(), m_undescribed(), m_checked(),
+      m_violations(), m_unchecked() {
+    check_error(m_db.isValid());
+    check_error(m_rules.isValid());
+    m_ce->setAutoPropagation(false);
+  }
+
+  PlanValidator::~PlanValidator() {
+    check_error(m_variables.empty(), "Variables made during validation should have been deleted.");
+    delete static_cast<ConstraintEngine*>(m_ce);
+  }
+
+  void PlanValidator::write(const PlanDatabaseId db, std::ostream& os) {
+    check_error(db.isValid());
+
+    TiXmlElement plan("plan");
+    plan.SetAttribute("model", db->getSchema()->getModelHash().c_str());
+
+    const ObjectSet& objects = db->getObjects();
+    for(ObjectSet::const_iterator it = objects.begin(); it != objects.end(); ++it) {
+      const ObjectId object = *it;
+      TiXmlElement* element = new TiXmlElement("object");
+      element->SetAttribute("name", object->getName().c_str());
+      element->SetAttribute("type", object->getType().c_str());
+      plan.LinkEndChild(element);
+#ifndef NO_RESOURCES
+      const Resource* resource = dynamic_cast<const Resource*>(static_cast<Object*>(object));
+      if(resource != NULL)
+        plan.LinkEndChild(resourceAsXml(*resource));
+#endif
+    }
+
+    const ConstrainedVariableSet& globals = db->getGlobalVariables();
+    for(ConstrainedVariableSet::const_iterator it = globals.begin(); it != globals.end(); ++it) {
+      TiXmlElement* element = new TiXmlElement("global");
+      element->SetAttribute("name", (*it)->getName().c_str());
+      setGroundedValue(*element, *it);
+      plan.LinkEndChild(element);
+    }
+
+    const TokenSet& tokens = db->getTokens();
+    for(TokenSet::const_iterator it = tokens.begin(); it != tokens.end(); ++it) {
+      const TokenId token = *it;
+      if(!isWritten(token))
+        continue;
+      TiXmlElement* element = new TiXmlElement("token");
+      element->SetAttribute("key", keyAsString(token->getKey()).c_str());
+      element->SetAttribute("predicate", token->getPredicateName().c_str());
+      if(token->master().isId()) {
+        element->SetAttribute("master", keyAsString(token->master()->getKey()).c_str());
+        element->SetAttribute("relation", token->getRelation().c_str());
+      }
+      if(token->isMerged())
+        element->SetAttribute("merged", keyAsString(token->getActiveToken()->getKey()).c_str());
+
+      // Merging moves the constraints on a token to the active one, so a merged token takes the values it leaves open
+      // from the active token
+      const std::vector<ConstrainedVariableId>& variables = token->getVariables();
+      const std::vector<ConstrainedVariableId>& values =
+          (token->isMerged() ? token->getActiveToken() : token)->getVariables();
+      for(unsigned int i = 0; i < variables.size(); i++) {
+        TiXmlElement* child = new TiXmlElement("var");
+        child->SetAttribute("name", variables[i]->getName().c_str());
+        setGroundedValue(*child, (variables[i]->lastDomain().isSingleton() ? variables[i] : values[i]));
+        element->LinkEndChild(child);
+        if(variables[i] == token->getObject())
+          element->SetAttribute("object", attribute(*child, "value"));
+      }
+      plan.LinkEndChild(element);
+    }
+
+    const CESchemaId ces = db->getConstraintEngine()->getCESchema();
+    const ConstraintSet& constraints = db->getConstraintEngine()->getConstraints();
+    for(ConstraintSet::const_iterator it = constraints.begin(); it != constraints.end(); ++it) {
+      const ConstraintId constraint = *it;
+      // Constraints that can't be made by name belong to the engine's own machinery, such as rule guards
+      if(!constraint->isActive() || !ces->isConstraintType(constraint->getName()))
+        continue;
+      TiXmlElement element("constraint");
+      element.SetAttribute("name", constraint->getName().c_str());
+      const std::vector<ConstrainedVariableId>& scope = constraint->getScope();
+      bool written = true;
+      for(std::vector<ConstrainedVariableId>::const_iterator var = scope.begin(); written && var != scope.end(); ++var) {
+        TiXmlElement* arg = new TiXmlElement("arg");
+        element.LinkEndChild(arg);
+        written = setArgument(*arg, *var, globals);
+      }
+      if(written)
+        plan.InsertEndChild(element);
+    }
+
+    os << plan << std::endl;
+  }
+
+  std::vector<std::string> PlanValidator::validate(const char* plan) {
+    check_error(plan != NULL, "Invalid buffer for validating a plan.");
+
+    m_objects.clear();
+    m_globals.clear();
+    m_tokens.clear();
+    m_checked.clear();
+    m_violations.clear();
+    m_unchecked.clear();
+
+    TiXmlDocument doc;
+    doc.Parse(plan);
+    checkRuntimeError(!doc.Error(), "Failed to parse plan: " << doc.ErrorDesc());
+    const TiXmlElement* root = doc.RootElement();
+    checkRuntimeError(root != NULL && strcmp(root->Value(), "plan") == 0, "Expected a grounded plan.");
+
+    // Index everything first, since slaves and constraints may refer to tokens later in the plan
+    for(const TiXmlElement* child = root->FirstChildElement(); child != NULL; child = child->NextSiblingElement()) {
+      if(strcmp(child->Value(), "object") == 0)
+        checkObject(*child);
+      else if(strcmp(child->Value(), "global") == 0)
+        m_globals[attribute(*child, "name")] = child;
+      else if(strcmp(child->Value(), "token") == 0) {
+        const std::string key = attribute(*child, "key");
+        if(m_tokens.find(key) != m_tokens.end()) {
+          report("Token " + key + " is in the plan more than once");
+          continue;
+        }
+        TokenRecord& token = m_tokens[key];
+        token.element = child;
+        for(const TiXmlElement* var = child->FirstChildElement("var"); var != NULL; var = var->NextSiblingElement("var"))
+          token.vars[attribute(*var, "name")] = var;
+      }
+    }
+
+    for(std::map<std::string, TokenRecord>::iterator it = m_tokens.begin(); it != m_tokens.end(); ++it)
+      checkToken(it->first, it->second);
+
+    for(const TiXmlElement* child = root->FirstChildElement("constraint"); child != NULL;
+        child = child->NextSiblingElement("constraint"))
+      checkConstraint(*child);
+
+    checkRules();
+    checkTimelines();
+
+    for(const TiXmlElement* child = root->FirstChildElement("resource"); child != NULL;
+        child = child->NextSiblingElement("resource"))
+      checkResource(*child);
+
+    for(std::map<std::string, ConstrainedVariableId>::const_iterator it = m_variables.begin(); it != m_variables.end(); ++it)
+      delete static_cast<ConstrainedVariable*>(it->second);
+    m_variables.clear();
+
+    debugMsg("PlanValidator:validate",
+             m_tokens.size() << " tokens checked, with " << m_violations.size() << " violations and " <<
+             m_unchecked.size() << " checks not made");
+    return m_violations;
+  }
+
+  void PlanValidator::checkObject(const TiXmlElement& object) {
+    const std::string name = attribute(object, "name");
+    const std::string type = attribute(object, "type");
+    if(!m_db->getSchema()->isObjectType(type))
+      report("Object " + name + " has type " + type + ", which is not in the model");
+    m_objects[name] = type;
+  }
+
+  void PlanValidator::checkToken(const std::string& key, TokenRecord& token) {
+    const SchemaId schema = m_db->getSchema();
+    const std::string predicate = attribute(*token.element, "predicate");
+    const std::string prefix = "Token " + key + " (" + predicate + ")";
+    if(!schema->isPredicate(predicate)) {
+      report(prefix + " has a predicate that is not in the model");
+      return;
+    }
+
+    const std::string objectName = attribute(*token.element, "object");
+    std::map<std::string, std::string>::const_iterator object = m_objects.find(objectName);
+    if(object == m_objects.end())
+      report(prefix + " is on " + objectName + ", which is not in the plan");
+    else if(schema->isObjectType(object->second) &&
+            !schema->isA(object->second, schema->getObjectTypeForPredicate(predicate)))
+      report(prefix + " can't be on " + objectName + ", which is a " + object->second);
+
+    // The schema's built in variables leave out the time of event tokens
+    for(std::map<std::string, const TiXmlElement*>::const_iterator it = token.vars.begin(); it != token.vars.end(); ++it)
+      if(it->first != "time" && !schema->hasMember(predicate, it->first))
+        report(prefix + " has a variable " + it->first + " that the model does not define");
+
+    std::map<std::string, const TiXmlElement*>::const_iterator start = token.vars.find("start");
+    std::map<std::string, const TiXmlElement*>::const_iterator end = token.vars.find("end");
+    // Event tokens have a time instead
+    if(start == token.vars.end() && end == token.vars.end())
+      start = end = token.vars.find("time");
+    if(start == token.vars.end() || !stringAsNumber(start->second->Attribute("value"), token.start))
+      report(prefix + " has no grounded start");
+    if(end == token.vars.end() || !stringAsNumber(end->second->Attribute("value"), token.end))
+      report(prefix + " has no grounded end");
+
+    const char* master = token.element->Attribute("master");
+    if(master != NULL) {
+      std::map<std::string, TokenRecord>::const_iterator it = m_tokens.find(master);
+      if(it == m_tokens.end())
+        report(prefix + " is a slave of " + master + ", which is not in the plan");
+      else if(it->second.element->Attribute("merged") != NULL)
+        report(prefix + " is a slave of " + master + ", which is merged rather than active");
+      else {
+        const std::string masterPredicate = attribute(*it->second.element, "predicate");
+        if(schema->isPredicate(masterPredicate) && !hasRules(masterPredicate))
+          report(prefix + " is a slave of " + master + ", but the model has no rules for " + masterPredicate);
+      }
+    }
+
+    const char* merged = token.element->Attribute("merged");
+    if(merged != NULL) {
+      std::map<std::string, TokenRecord>::const_iterator it = m_tokens.find(merged);
+      if(it == m_tokens.end())
+        report(prefix + " is merged into " + merged + ", which is not in the plan");
+      else if(it->second.element->Attribute("merged") != NULL)
+        report(prefix + " is merged into " + merged + ", which is not active");
+      else if(predicate != attribute(*it->second.element, "predicate"))
+        report(prefix + " is merged into " + merged + ", which has a different predicate");
+    }
+  }
+
+  void PlanValidator::checkConstraint(const TiXmlElement& constraint) {
+    const std::string name = attribute(constraint, "name");
+
+    std::ostringstream description;
+    description << name << "(";
+    for(const TiXmlElement* arg = constraint.FirstChildElement("arg"); arg != NULL; arg = arg->NextSiblingElement("arg")) {
+      if(arg != constraint.FirstChildElement("arg"))
+        description << ", ";
+      if(arg->Attribute("token") != NULL)
+        description << attribute(*arg, "token") << "." << attribute(*arg, "var");
+      else if(arg->Attribute("global") != NULL)
+        description << attribute(*arg, "global");
+      else if(arg->Attribute("value") != NULL)
+        description << attribute(*arg, "value");
+      else
+        description << "[" << attribute(*arg, "lb") << ", " << attribute(*arg, "ub") << "]";
+    }
+    description << ")";
+
+    // Rules may make a constraint the plan also lists
+    if(!m_checked.insert(description.str()).second)
+      return;
+    if(!m_ce->getCESchema()->isConstraintType(name)) {
+      report("Constraint " + description.str() + " is not in the model");
+      return;
+    }
+
+    std::vector<ConstrainedVariableId> scope;
+    std::vector<ConstrainedVariableId> scratch;
+    std::string problem;
+    bool evaluable = true;
+    for(const TiXmlElement* arg = constraint.FirstChildElement("arg"); problem.empty() && arg != NULL;
+        arg = arg->NextSiblingElement("arg")) {
+      bool isScratch = false;
+      const ConstrainedVariableId var = getVariable(*arg, problem, isScratch);
+      if(var.isNoId()) {
+        evaluable = false;
+        continue;
+      }
+      scope.push_back(var);
+      if(isScratch)
+        scratch.push_back(var);
+    }
+
+    if(!problem.empty())
+      report("Constraint " + description.str() + " can't be checked: " + problem);
+    else if(!evaluable)
+      m_unchecked.push_back("Constraint " + description.str() +
+                            " can't be evaluated over objects or variables that are not grounded");
+    else {
+      try {
+        // Every constraint is evaluated by its own execute(), which a default propagator does as well as the one
+        // it is registered with
+        const std::string& propagator = m_ce->getCESchema()->getConstraintType(name)->getPropagatorName();
+        if(m_ce->getPropagatorByName(propagator).isNoId())
+          new DefaultPropagator(propagator, m_ce);
+        const ConstraintId instance = m_ce->createConstraint(name, scope);
+        const bool satisfied = m_ce->propagate();
+        delete static_cast<Constraint*>(instance);
+        debugMsg("PlanValidator:checkConstraint", description.str() << (satisfied ? " holds" : " is violated"));
+        if(!satisfied)
+          report("Constraint " + description.str() + " is violated");
+      }
+      catch(Error& e) {
+        report("Constraint " + description.str() + " can't be checked: " + e.getMsg());
+      }
+    }
+
+    for(std::vector<ConstrainedVariableId>::const_iterator it = scratch.begin(); it != scratch.end(); ++it)
+      delete static_cast<ConstrainedVariable*>(*it);
+  }
+
+  void PlanValidator::checkRules() {
+    std::map<std::string, std::vector<std::string> > slaves; // By master key
+    for(std::map<std::string, TokenRecord>::const_iterator it = m_tokens.begin(); it != m_tokens.end(); ++it) {
+      const char* master = it->second.element->Attribute("master");
+      if(master != NULL)
+        slaves[master].push_back(it->first);
+    }
+    for(std::map<std::string, std::vector<std::string> >::iterator it = slaves.begin(); it != slaves.end(); ++it)
+      std::sort(it->second.begin(), it->second.end(), isEarlierKey);
+
+    const SchemaId schema = m_db->getSchema();
+    std::set<std::string> listed; // Predicates whose unchecked rule parts are listed
+    for(std::map<std::string, TokenRecord>::const_iterator it = m_tokens.begin(); it != m_tokens.end(); ++it) {
+      // Rules only fire for active tokens
+      const std::string predicate = attribute(*it->second.element, "predicate");
+      if(it->second.element->Attribute("merged") != NULL || !schema->isPredicate(predicate) || !hasRules(predicate))
+        continue;
+      const std::vector<RuleBody>* bodies = getBodies(predicate);
+      if(listed.insert(predicate).second) {
+        if(bodies == NULL)
+          m_unchecked.push_back("The rules of " + predicate + " can't be checked, since one can't describe its body");
+        else
+          for(std::vector<RuleBody>::const_iterator body = bodies->begin(); body != bodies->end(); ++body)
+            for(std::vector<std::string>::const_iterator part = body->unchecked.begin(); part != body->unchecked.end(); ++part)
+              m_unchecked.push_back("In a rule of " + predicate + ": " + *part);
+      }
+      if(bodies != NULL)
+        checkExpansion(it->first, predicate, *bodies, slaves[it->first]);
+    }
+  }
+
+  void PlanValidator::checkExpansion(const std::string& key, const std::string& predicate,
+                                     const std::vector<RuleBody>& bodies, const std::vector<std::string>& slaves) {
+    typedef std::pair<std::string, std::string> Subgoal; // (predicate, relation)
+    std::map<Subgoal, std::deque<std::string> > unmatched; // Keys of the slaves not yet matched to a rule's
+    for(std::vector<std::string>::const_iterator it = slaves.begin(); it != slaves.end(); ++it) {
+      const TiXmlElement& slave = *m_tokens.find(*it)->second.element;
+      unmatched[Subgoal(attribute(slave, "predicate"), attribute(slave, "relation"))].push_back(*it);
+    }
+
+    std::map<Subgoal, std::pair<unsigned int, unsigned int> > counts; // (matched, required)
+    for(std::vector<RuleBody>::const_iterator body = bodies.begin(); body != bodies.end(); ++body) {
+      std::map<std::string, std::string> names; // Key of each slave, by the name the rule gives it
+      for(std::vector<RuleBody::Slave>::const_iterator it = body->slaves.begin(); it != body->slaves.end(); ++it) {
+        const Subgoal subgoal(it->predicate, it->relation);
+        std::deque<std::string>& candidates = unmatched[subgoal];
+        std::pair<unsigned int, unsigned int>& count = counts[subgoal];
+        count.second++;
+        if(candidates.empty()) {
+          names[it->name] = "";
+          continue;
+        }
+        count.first++;
+        names[it->name] = candidates.front();
+        candidates.pop_front();
+      }
+
+      // Each constraint is written as the plan would list it, and checked like one
+      for(std::vector<RuleBody::ConstraintSpec>::const_iterator it = body->constraints.begin();
+          it != body->constraints.end(); ++it) {
+        TiXmlElement constraint("constraint");
+        constraint.SetAttribute("name", it->name.c_str());
+        bool matched = true;
+        for(std::vector<RuleBody::Argument>::const_iterator arg = it->args.begin(); matched && arg != it->args.end(); ++arg) {
+          TiXmlElement* element = new TiXmlElement("arg");
+          constraint.LinkEndChild(element);
+          if(arg->path.empty()) {
+            element->SetAttribute("type", arg->type->getName().c_str());
+            if(!arg->type->isNumeric() || arg->type->isBool())
+              element->SetAttribute("value", arg->type->toString(arg->lb).c_str());
+            else if(arg->lb == arg->ub)
+              element->SetAttribute("value", numberAsString(arg->lb).c_str());
+            else {
+              element->SetAttribute("lb", numberAsString(arg->lb).c_str());
+              element->SetAttribute("ub", numberAsString(arg->ub).c_str());
+            }
+            continue;
+          }
+
+          // A path starts with a slave, or with a variable of the token or a global, which may be an object
+          const std::string::size_type dot = arg->path.find('.');
+          std::map<std::string, std::string>::const_iterator slave = names.find(arg->path.substr(0, dot));
+          if(slave != names.end()) {
+            // A slave that is missing is reported already
+            matched = !slave->second.empty();
+            element->SetAttribute("token", slave->second.c_str());
+            element->SetAttribute("var", (dot == std::string::npos ? std::string("state") : arg->path.substr(dot + 1)).c_str());
+          }
+          else if(m_tokens.find(key)->second.vars.count(arg->path.substr(0, dot)) == 0 &&
+                  m_globals.find(arg->path.substr(0, dot)) != m_globals.end())
+            element->SetAttribute("global", arg->path.substr(0, dot).c_str());
+          else {
+            element->SetAttribute("token", key.c_str());
+            element->SetAttribute("var", arg->path.substr(0, dot).c_str());
+          }
+        }
+        if(matched)
+          checkConstraint(constraint);
+      }
+    }
+
+    for(std::map<Subgoal, std::pair<unsigned int, unsigned int> >::const_iterator it = counts.begin();
+        it != counts.end(); ++it) {
+      if(it->second.first < it->second.second) {
+        std::ostringstream os;
+        os << "Token " << key << " (" << predicate << ") has " << it->second.first << " of the " << it->second.second <<
+            " " << it->first.first << " slaves related by " << it->first.second << " that its rules make";
+        report(os.str());
+      }
+    }
+  }
+
+  void PlanValidator::checkTimelines() {
+    typedef std::pair<std::pair<edouble, edouble>, std::string> Interval; // ((start, end), key)
+    std::map<std::string, std::vector<Interval> > timelines;
+    const SchemaId schema = m_db->getSchema();
+    for(std::map<std::string, TokenRecord>::const_iterator it = m_tokens.begin(); it != m_tokens.end(); ++it) {
+      if(it->second.element->Attribute("merged") != NULL)
+        continue;
+      std::map<std::string, std::string>::const_iterator object = m_objects.find(attribute(*it->second.element, "object"));
+      if(object != m_objects.end() && schema->isObjectType(object->second) && schema->isA(object->second, "Timeline"))
+        timelines[object->first].push_back(Interval(std::make_pair(it->second.start, it->second.end), it->first));
+    }
+
+    for(std::map<std::string, std::vector<Interval> >::iterator timeline = timelines.begin();
+        timeline != timelines.end(); ++timeline) {
+      std::vector<Interval>& tokens = timeline->second;
+      std::sort(tokens.begin(), tokens.end());
+      // Compare each token with the one that ends last before it, so a long token is caught against every later one
+      std::vector<Interval>::const_iterator latest = tokens.begin();
+      for(std::vector<Interval>::const_iterator it = tokens.begin(); it != tokens.end(); ++it) {
+        if(it == latest)
+          continue;
+        if(it->first.first < latest->first.second)
+          report("Tokens " + latest->second + " and " + it->second + " overlap on " + timeline->first);
+        if(it->first.second > latest->first.second)
+          latest = it;
+      }
+    }
+  }
+
+  void PlanValidator::checkResource(const TiXmlElement& resource) {
+    typedef std::map<edouble, std::pair<edouble, edouble> > Values;
+    const std::string name = attribute(resource, "name");
+    if(m_objects.find(name) == m_objects.end())
+      report("Resource " + name + " is not an object in the plan");
+
+    edouble maxInstConsumption = PLUS_INFINITY, maxInstProduction = PLUS_INFINITY;
+    edouble maxConsumption = PLUS_INFINITY, maxProduction = PLUS_INFINITY;
+    stringAsNumber(resource.Attribute("maxInstConsumption"), maxInstConsumption);
+    stringAsNumber(resource.Attribute("maxInstProduction"), maxInstProduction);
+    stringAsNumber(resource.Attribute("maxConsumption"), maxConsumption);
+    stringAsNumber(resource.Attribute("maxProduction"), maxProduction);
+
+    Values capacity, limits;
+    Values changes; // (production, consumption) at each time
+    for(const TiXmlElement* child = resource.FirstChildElement(); child != NULL; child = child->NextSiblingElement()) {
+      edouble time, first, second;
+      if(strcmp(child->Value(), "transaction") == 0) {
+        if(!stringAsNumber(child->Attribute("time"), time) || !stringAsNumber(child->Attribute("quantity"), first)) {
+          report("Resource " + name + " has a transaction that is not grounded");
+          continue;
+        }
+        std::pair<edouble, edouble>& change = changes[time];
+        if(strcmp(attribute(*child, "consumer"), "true") == 0)
+          change.second += first;
+        else
+          change.first += first;
+      }
+      else if(stringAsNumber(child->Attribute("time"), time) && stringAsNumber(child->Attribute("lb"), first) &&
+              stringAsNumber(child->Attribute("ub"), second))
+        (strcmp(child->Value(), "capacity") == 0 ? capacity : limits)[time] = std::make_pair(first, second);
+      else
+        report("Resource " + name + " has a malformed " + child->Value());
+    }
+
+    std::set<edouble> times;
+    for(Values::const_iterator it = changes.begin(); it != changes.end(); ++it)
+      times.insert(it->first);
+    for(Values::const_iterator it = capacity.begin(); it != capacity.end(); ++it)
+      if(it->first > MINUS_INFINITY)
+        times.insert(it->first);
+    for(Values::const_iterator it = limits.begin(); it != limits.end(); ++it)
+      if(it->first > MINUS_INFINITY)
+        times.insert(it->first);
+
+    const std::pair<edouble, edouble> noCapacity(0, 0);
+    const std::pair<edouble, edouble> noLimits(MINUS_INFINITY, PLUS_INFINITY);
+    edouble usage = 0, consumed = 0, produced = 0;
+    for(std::set<edouble>::const_iterator it = times.begin(); it != times.end(); ++it) {
+      const std::string at = " on " + name + " at " + numberAsString(*it);
+      Values::const_iterator change = changes.find(*it);
+      if(change != changes.end()) {
+        const edouble production = change->second.first, consumption = change->second.second;
+        if(consumption > maxInstConsumption)
+          report("Instantaneous consumption of " + numberAsString(consumption) + at + " exceeds " +
+                 numberAsString(maxInstConsumption));
+        if(production > maxInstProduction)
+          report("Instantaneous production of " + numberAsString(production) + at + " exceeds " +
+                 numberAsString(maxInstProduction));
+        if(consumed <= maxConsumption && consumed + consumption > maxConsumption)
+          report("Total consumption" + at + " exceeds " + numberAsString(maxConsumption));
+        if(produced <= maxProduction && produced + production > maxProduction)
+          report("Total production" + at + " exceeds " + numberAsString(maxProduction));
+        usage += production - consumption;
+        consumed += consumption;
+        produced += production;
+      }
+
+      // Consumption counts against the capacity
+      const std::pair<edouble, edouble> available = valueAt(capacity, *it, noCapacity);
+      const std::pair<edouble, edouble> limit = valueAt(limits, *it, noLimits);
+      if(available.second + usage < limit.first)
+        report("Level of " + numberAsString(available.second + usage) + at + " is below the limit of " +
+               numberAsString(limit.first));
+      if(available.first + usage > limit.second)
+        report("Level of " + numberAsString(available.first + usage) + at + " is above the limit of " +
+               numberAsString(limit.second));
+    }
+  }
+
+  ConstrainedVariableId PlanValidator::getVariable(const TiXmlElement& arg, std::string& problem, bool& scratch) {
+    scratch = false;
+    const TiXmlElement* value = &arg;
+    std::string name;
+    if(arg.Attribute("token") != NULL) {
+      const std::string key = attribute(arg, "token");
+      const std::string var = attribute(arg, "var");
+      std::map<std::string, TokenRecord>::const_iterator token = m_tokens.find(key);
+      if(token == m_tokens.end()) {
+        problem = "token " + key + " is not in the plan";
+        return ConstrainedVariableId::noId();
+      }
+      std::map<std::string, const TiXmlElement*>::const_iterator it = token->second.vars.find(var);
+      // Event tokens have a time instead of a start and an end
+      if(it == token->second.vars.end() && (var == "start" || var == "end"))
+        it = token->second.vars.find("time");
+      if(it == token->second.vars.end()) {
+        problem = "token " + key + " has no variable " + var;
+        return ConstrainedVariableId::noId();
+      }
+      value = it->second;
+      name = key + "." + var;
+    }
+    else if(arg.Attribute("global") != NULL) {
+      name = attribute(arg, "global");
+      std::map<std::string, const TiXmlElement*>::const_iterator it = m_globals.find(name);
+      if(it == m_globals.end()) {
+        problem = "global " + name + " is not in the plan";
+        return ConstrainedVariableId::noId();
+      }
+      value = it->second;
+    }
+    else {
+      scratch = true;
+      return makeVariable(arg, "PlanValidator", problem);
+    }
+
+    std::map<std::string, ConstrainedVariableId>::const_iterator it = m_variables.find(name);
+    if(it != m_variables.end())
+      return it->second;
+    ConstrainedVariableId var = makeVariable(*value, name, problem);
+    if(var.isId())
+      m_variables.insert(std::make_pair(name, var));
+    return var;
+  }
+
+  ConstrainedVariableId PlanValidator::makeVariable(const TiXmlElement& value, const std::string& name,
+                                                    std::string& problem) {
+    const std::string type = attribute(value, "type");
+    if(!m_ce->getCESchema()->isDataType(type)) {
+      problem = name + " has type " + type + ", which is not in the model";
+      return ConstrainedVariableId::noId();
+    }
+    const DataTypeId dt = m_ce->getCESchema()->getDataType(type);
+    // Objects only exist in the plan database, so constraints on them can't be evaluated here
+    if(dt->isEntity())
+      return ConstrainedVariableId::noId();
+
+    edouble lb, ub;
+    const char* str = value.Attribute("value");
+    if(str != NULL) {
+      if(!dt->isNumeric() || dt->isBool())
+        lb = dt->createValue(str);
+      else if(!stringAsNumber(str, lb)) {
+        problem = name + " has value " + str + ", which is not a number";
+        return ConstrainedVariableId::noId();
+      }
+      ub = lb;
+    }
+    else if(!dt->isNumeric() || !stringAsNumber(value.Attribute("lb"), lb) || !stringAsNumber(value.Attribute("ub"), ub))
+      return ConstrainedVariableId::noId();
+
+    Domain* domain = NULL;
+    if(dt->isNumeric()) {
+      domain = dt->baseDomain().copy();
+      domain->intersect(lb, ub);
+    }
+    else if(dt->baseDomain().isOpen() || dt->baseDomain().isMember(lb))
+      domain = new EnumeratedDomain(dt, lb);
+
+    if(domain == NULL || domain->isEmpty()) {
+      problem = name + " = " + (str != NULL ? std::string(str) : "[" + numberAsString(lb) + ", " + numberAsString(ub) + "]") +
+          " is not a " + type;
+      delete domain;
+      return ConstrainedVariableId::noId();
+    }
+
+    const ConstrainedVariableId var = m_ce->createVariable(type, *domain, true, false, name);
+    delete domain;
+    return var;
+  }
+
+  bool PlanValidator::hasRules(const std::string& predicate) {
+    std::map<std::string, bool>::const_iterator it = m_hasRules.find(predicate);
+    if(it != m_hasRules.end())
+      return it->second;
+    std::vector<RuleId> rules;
+    m_rules->getRules(m_db, predicate, rules);
+    m_hasRules.insert(std::make_pair(predicate, !rules.empty()));
+    return !rules.empty();
+  }
+
+  const std::vector<RuleBody>* PlanValidator::getBodies(const std::string& predicate) {
+    std::map<std::string, std::vector<RuleBody> >::const_iterator it = m_bodies.find(predicate);
+    if(it != m_bodies.end())
+      return &it->second;
+    if(m_undescribed.find(predicate) != m_undescribed.end())
+      return NULL;
+
+    std::vector<RuleId> rules;
+    m_rules->getRules(m_db, predicate, rules);
+    std::vector<RuleBody> bodies(rules.size());
+    for(unsigned int i = 0; i < rules.size(); i++) {
+      if(!rules[i]->describe(bodies[i])) {
+        m_undescribed.insert(predicate);
+        return NULL;
+      }
+    }
+    debugMsg("PlanValidator:getBodies", predicate << " has " << bodies.size() << " rules that describe their bodies");
+    return &(m_bodies[predicate] = bodies);
+  }
+
+  void PlanValidator::report(const std::string& violation) {
+    debugMsg("PlanValidator:report", violation);
+    m_violations.push_back(violation);
+  }
+}
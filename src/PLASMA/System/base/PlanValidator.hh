@@ -0,0 +1,136 @@
+#ifndef _H_PlanValidator
+#define _H_PlanValidator
+
+#include "ConstraintEngineDefs.hh"
+#include "PlanDatabaseDefs.hh"
+#include "RulesEngineDefs.hh"
+#include "Rule.hh"
+
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace EUROPA {
+
+  class TiXmlElement;
+
+  /**
+   * @class PlanValidator
+   * @brief Checks a grounded plan against the loaded model without loading the plan into the plan database.
+   *
+   * A grounded plan is one in which every token variable is a singleton. It is written as:
+   * @verbatim
+     <plan model="<model hash>">
+       <object name="..." type="..."/>
+       <global name="..." type="..." value="..."/>
+       <token key="..." predicate="..." object="..." [master="<key>" relation="..."] [merged="<key>"]>
+         <var name="..." type="..." value="..."/>
+       </token>
+       <constraint name="...">
+         <arg token="<key>" var="..."/> | <arg global="..."/> | <arg type="..." value="..."/> | <arg type="..." lb="..." ub="..."/>
+       </constraint>
+       <resource name="..." maxInstConsumption="..." maxInstProduction="..." maxConsumption="..." maxProduction="...">
+         <capacity time="..." lb="..." ub="..."/>
+         <limit time="..." lb="..." ub="..."/>
+         <transaction time="..." quantity="..." consumer="true|false"/>
+       </resource>
+     </plan>
+     @endverbatim
+   * Validation leaves the plan database and its constraint engine alone. Each constraint is evaluated on its
+   * own, over singleton variables in a constraint engine of the validator's, so no propagation reaches beyond
+   * it. Timelines and resources are checked with one sweep each. Rule expansion is checked against what each
+   * rule describes of its body: every active token needs the slaves its rules always make, and every constraint
+   * they always make must hold, whether or not the plan lists it. Slaves are matched to the ones a rule declares
+   * by predicate and relation, in key order. Slaves need an active master whose predicate has rules. Every
+   * violation is reported, not just the first.
+   */
+  class PlanValidator {
+  public:
+    PlanValidator(const PlanDatabaseId db, const RuleSchemaId rules);
+    ~PlanValidator();
+
+    /**
+     * @brief Write the plan in db as a grounded plan.
+     * @throws if a token or global variable is not a singleton.
+     */
+    static void write(const PlanDatabaseId db, std::ostream& os);
+
+    /**
+     * @brief Check a grounded plan, in the form written by write().
+     * @return A description of each violation found; empty if the plan is valid.
+     */
+    std::vector<std::string> validate(const char* plan);
+
+    /**
+     * @brief A description of each check the last validation could not make, such as constraints with
+     * object variables and guarded parts of rules.
+     */
+    const std::vector<std::string>& getUnchecked() const {return m_unchecked;}
+
+  private:
+    PlanValidator(const PlanValidator&);
+    PlanValidator& operator=(const PlanValidator&);
+
+    struct TokenRecord {
+      TokenRecord() : element(NULL), start(0), end(0), vars() {}
+
+      const TiXmlElement* element;
+      edouble start;
+      edouble end;
+      std::map<std::string, const TiXmlElement*> vars;
+    };
+
+    void checkObject(const TiXmlElement& object);
+    void checkToken(const std::string& key, TokenRecord& token);
+    void checkConstraint(const TiXmlElement& constraint);
+    void checkRules();
+
+    /**
+     * @brief Check that a token has the slaves its rules always make, and that the constraints they always make
+     * hold.
+     * @param slaves The keys of the token's slaves, in key order.
+     */
+    void checkExpansion(const std::string& key, const std::string& predicate, const std::vector<RuleBody>& bodies,
+                        const std::vector<std::string>& slaves);
+
+    void checkTimelines();
+    void checkResource(const TiXmlElement& resource);
+
+    /**
+     * @brief The variable an argument refers to, made on first use.
+     * @param problem Set to the reason if there is no variable. Left empty if the argument simply can't be
+     * evaluated, as for objects.
+     */
+    ConstrainedVariableId getVariable(const TiXmlElement& arg, std::string& problem, bool& scratch);
+
+    ConstrainedVariableId makeVariable(const TiXmlElement& value, const std::string& name, std::string& problem);
+
+    bool hasRules(const std::string& predicate);
+
+    /**
+     * @brief What each rule of a predicate describes of its body, learned on first use.
+     * @return NULL if a rule can't describe its body.
+     */
+    const std::vector<RuleBody>* getBodies(const std::string& predicate);
+
+    void report(const std::string& violation);
+
+    const PlanDatabaseId m_db;
+    const RuleSchemaId m_rules;
+    const ConstraintEngineId m_ce; /*!< Where constraints are evaluated, apart from the plan database */
+    std::map<std::string, std::string> m_objects; /*!< Type of each object, by name */
+    std::map<std::string, const TiXmlElement*> m_globals;
+    std::map<std::string, TokenRecord> m_tokens; /*!< By key */
+    std::map<std::string, ConstrainedVariableId> m_variables; /*!< Variables made for tokens and globals */
+    std::map<std::string, bool> m_hasRules; /*!< By predicate */
+    std::map<std::string, std::vector<RuleBody> > m_bodies; /*!< By predicate */
+    std::set<std::string> m_undescribed; /*!< Predicates with a rule that can't describe its body */
+    std::set<std::string> m_checked; /*!< Constraints evaluated, by description */
+    std::vector<std::string> m_violations;
+    std::vector<std::string> m_unchecked;
+  };
+}
+
+#endif
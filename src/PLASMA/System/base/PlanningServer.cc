@@ -0,0 +1,281 @@
+#include "PlanningServer.hh"
+#include "Debug.hh"
+#include "Error.hh"
+#include "PSLanguageException.hh"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <map>
+#include <sstream>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace EUROPA {
+
+namespace {
+
+/**
+ * @brief Buffered stream I/O on a socket.
+ */
+class FdStreamBuffer : public std::streambuf {
+public:
+  FdStreamBuffer(int fd) : std::streambuf(), m_fd(fd) {
+    setg(m_in, m_in, m_in);
+    setp(m_out, m_out + sizeof(m_out));
+  }
+  ~FdStreamBuffer() {sync();}
+
+protected:
+  int underflow() {
+    ssize_t count;
+    do {
+      count = read(m_fd, m_in, sizeof(m_in));
+    } while(count < 0 && errno == EINTR);
+    if(count <= 0)
+      return traits_type::eof();
+    setg(m_in, m_in, m_in + count);
+    return traits_type::to_int_type(*gptr());
+  }
+
+  int overflow(int c) {
+    if(sync() != 0)
+      return traits_type::eof();
+    if(c != traits_type::eof())
+      sputc(traits_type::to_char_type(c));
+    return traits_type::not_eof(c);
+  }
+
+  int sync() {
+    const char* data = pbase();
+    while(data < pptr()) {
+      ssize_t count = write(m_fd, data, static_cast<size_t>(pptr() - data));
+      if(count < 0 && errno == EINTR)
+        continue;
+      if(count <= 0)
+        return -1;
+      data += count;
+    }
+    setp(m_out, m_out + sizeof(m_out));
+    return 0;
+  }
+
+private:
+  int m_fd;
+  char m_in[4096];
+  char m_out[4096];
+};
+
+/**
+ * @return Empty if the request was read, otherwise why not.
+ */
+std::string readRequest(const std::string& header, std::istream& in,
+                        const std::string::size_type maxLength, PlanningRequest& request) {
+  std::istringstream is(header);
+  std::string command;
+  std::string::size_type length = 0;
+  if(!(is >> command >> request.horizonStart >> request.horizonEnd
+       >> request.maxSteps >> request.maxDepth >> length) || command != "plan")
+    return "Malformed request: " + header;
+
+  if(length > maxLength) {
+    std::ostringstream os;
+    os << "Request of " << length << " bytes exceeds the limit of " << maxLength << " bytes";
+    return os.str();
+  }
+
+  request.script.resize(length);
+  if(length > 0)
+    in.read(&request.script[0], static_cast<std::streamsize>(length));
+  if(in.gcount() != static_cast<std::streamsize>(length))
+    return "Truncated request: " + header;
+  return "";
+}
+
+const unsigned int MAX_RESTART_DELAY = 60; /*!< Seconds */
+
+}
+
+PlanningServer::PlanningServer(const std::string& solverConfig, const std::string& language)
+    : m_engine(PSEngine::makeInstance()), m_solverConfig(solverConfig), m_language(language),
+      m_maxRequestLength(16 * 1024 * 1024) {
+  m_engine->start();
+}
+
+PlanningServer::~PlanningServer() {
+  m_engine->shutdown();
+  delete m_engine;
+}
+
+std::string PlanningServer::loadModel(const std::string& file) {
+  debugMsg("PlanningServer:loadModel", "Loading " << file);
+  try {
+    return m_engine->executeScript(m_language, file, true);
+  }
+  catch(PSLanguageExceptionList& errors) {
+    std::ostringstream os;
+    for(int i = 0; i < errors.getExceptionCount(); ++i)
+      os << errors.getException(i) << std::endl;
+    return os.str();
+  }
+  catch(Error& e) {
+    return e.getMsg();
+  }
+  catch(std::exception& e) {
+    return e.what();
+  }
+}
+
+std::string PlanningServer::plan(const PlanningRequest& request, std::string& payload) {
+  std::string status;
+  PSSolver* solver = NULL;
+  try {
+    payload = m_engine->executeScript(m_language, request.script, false);
+    if(!payload.empty())
+      status = "error";
+    else {
+      solver = m_engine->createSolver(m_solverConfig);
+      solver->configure(request.horizonStart, request.horizonEnd);
+      if(solver->solve(request.maxSteps, request.maxDepth)) {
+        status = "plan";
+        payload = m_engine->planDatabaseToString();
+      }
+      else {
+        status = "noplan";
+        std::ostringstream os;
+        os << (solver->isExhausted() ? "exhausted" : (solver->isTimedOut() ? "timedout" : "incomplete"))
+           << " after " << solver->getStepCount() << " steps" << std::endl;
+        PSList<std::string> flaws = solver->getFlaws();
+        for(int i = 0; i < flaws.size(); ++i)
+          os << flaws.get(i) << std::endl;
+        payload = os.str();
+      }
+    }
+  }
+  catch(PSLanguageExceptionList& errors) {
+    status = "error";
+    std::ostringstream os;
+    for(int i = 0; i < errors.getExceptionCount(); ++i)
+      os << errors.getException(i) << std::endl;
+    payload = os.str();
+  }
+  catch(Error& e) {
+    status = "error";
+    payload = e.getMsg();
+  }
+  catch(std::exception& e) {
+    status = "error";
+    payload = e.what();
+  }
+
+  // The solver must release its decisions before the database is emptied
+  delete solver;
+  m_engine->resetPlanDatabase();
+
+  debugMsg("PlanningServer:plan", "Finished request with status " << status);
+  return status;
+}
+
+void PlanningServer::serve(std::istream& in, std::ostream& out) {
+  std::string header;
+  while(std::getline(in, header)) {
+    if(header.empty())
+      continue;
+
+    PlanningRequest request;
+    std::string status;
+    std::string payload = readRequest(header, in, m_maxRequestLength, request);
+    const bool valid = payload.empty();
+    if(valid)
+      status = plan(request, payload);
+    else
+      status = "error";
+
+    out << status << " " << payload.size() << "\n" << payload;
+    out.flush();
+
+    // The stream can't be resynchronized after a bad header or an unread payload
+    if(!valid)
+      return;
+  }
+}
+
+void PlanningServer::serve(const std::string& socketPath, unsigned int workers) {
+  sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  checkRuntimeError(socketPath.size() < sizeof(address.sun_path),
+                    "Socket path is too long: " << socketPath);
+  strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+  int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+  checkRuntimeError(listener >= 0, "Failed to create socket: " << strerror(errno));
+  unlink(socketPath.c_str());
+  checkRuntimeError(bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0,
+                    "Failed to bind " << socketPath << ": " << strerror(errno));
+  checkRuntimeError(listen(listener, SOMAXCONN) == 0,
+                    "Failed to listen on " << socketPath << ": " << strerror(errno));
+
+  // A client that hangs up should cost a connection, not a worker
+  signal(SIGPIPE, SIG_IGN);
+
+  std::map<pid_t, time_t> started;
+  for(unsigned int i = 0; i < (workers > 0 ? workers : 1); i++) {
+    pid_t pid = fork();
+    checkRuntimeError(pid >= 0, "Failed to start a worker: " << strerror(errno));
+    if(pid == 0)
+      runWorker(listener);
+    started[pid] = time(NULL);
+  }
+
+  unsigned int delay = 0;
+  for(;;) {
+    int status = 0;
+    pid_t pid = waitpid(-1, &status, 0);
+    if(pid < 0) {
+      if(errno == EINTR)
+        continue;
+      break;
+    }
+    debugMsg("PlanningServer:serve", "Worker " << pid << " exited with status " << status);
+
+    // Back off while workers keep failing as soon as they start
+    if(time(NULL) - started[pid] < 1)
+      delay = std::min(std::max(2 * delay, 1u), MAX_RESTART_DELAY);
+    else
+      delay = 0;
+    started.erase(pid);
+    for(unsigned int remaining = delay; remaining > 0; )
+      remaining = sleep(remaining);
+
+    pid = fork();
+    checkRuntimeError(pid >= 0, "Failed to replace a worker: " << strerror(errno));
+    if(pid == 0)
+      runWorker(listener);
+    started[pid] = time(NULL);
+  }
+  close(listener);
+}
+
+void PlanningServer::runWorker(int listener) {
+  for(;;) {
+    int connection = accept(listener, NULL, NULL);
+    if(connection < 0) {
+      if(errno == EINTR || errno == ECONNABORTED)
+        continue;
+      _exit(1);
+    }
+    {
+      FdStreamBuffer buffer(connection);
+      std::iostream stream(&buffer);
+      serve(stream, stream);
+    }
+    close(connection);
+  }
+}
+
+}
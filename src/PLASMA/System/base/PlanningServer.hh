@@ -0,0 +1,101 @@
+#ifndef _H_PlanningServer
+#define _H_PlanningServer
+
+#include "PSEngine.hh"
+
+#include <iostream>
+#include <string>
+
+namespace EUROPA {
+
+  /**
+   * @brief A problem instance to be solved against a preloaded model.
+   */
+  struct PlanningRequest {
+    PlanningRequest() : horizonStart(0), horizonEnd(0), maxSteps(0), maxDepth(0), script() {}
+
+    eint::basis_type horizonStart;
+    eint::basis_type horizonEnd;
+    int maxSteps;
+    int maxDepth;
+    std::string script; /*!< The initial state, in the server's language */
+  };
+
+  /**
+   * @class PlanningServer
+   * @brief Serves planning requests from an engine whose model is loaded once, up front.
+   *
+   * Requests and responses are a header line followed by a payload of the given length:
+   * @verbatim
+     request:  plan <horizonStart> <horizonEnd> <maxSteps> <maxDepth> <length>\n<initial state>
+     response: <status> <length>\n<payload>
+     @endverbatim
+   * The status is "plan", with the plan database as payload, "noplan", with the reason and
+   * remaining flaws, or "error", with a message. The plan database is reset after every request,
+   * so the schema and rules loaded by loadModel() are reused by the next one. A request longer
+   * than getMaxRequestLength() is answered with an error and ends the connection.
+   */
+  class PlanningServer {
+  public:
+    PlanningServer(const std::string& solverConfig, const std::string& language = "nddl");
+    ~PlanningServer();
+
+    PSEngine* getEngine() {return m_engine;}
+
+    /**
+     * @brief The longest initial state accepted, in bytes. 16MB unless set.
+     */
+    std::string::size_type getMaxRequestLength() const {return m_maxRequestLength;}
+    void setMaxRequestLength(std::string::size_type length) {m_maxRequestLength = length;}
+
+    /**
+     * @brief Load a model file into the engine. Must precede any request.
+     * @return Any errors reported by the interpreter, empty on success.
+     */
+    std::string loadModel(const std::string& file);
+
+    /**
+     * @brief Solve a single request and reset the plan database.
+     * @param payload Set to the response payload.
+     * @return The response status.
+     */
+    std::string plan(const PlanningRequest& request, std::string& payload);
+
+    /**
+     * @brief Serve requests read from in, writing responses to out, until the end of input or a
+     * malformed request.
+     */
+    void serve(std::istream& in, std::ostream& out);
+
+    /**
+     * @brief Serve connections on a Unix domain socket.
+     *
+     * Normally runs until the process is killed. Returns, after closing the socket, only if waiting
+     * for workers fails (e.g. none are left to wait for). Throws if the socket can't be set up or a
+     * worker can't be started or replaced. Workers never return from this call.
+     *
+     * Engines share global state (e.g. Entity garbage collection), so requests are served
+     * concurrently by forked worker processes rather than threads. Each worker starts from a
+     * copy of this server's engine, with the model already loaded, and serves one connection at
+     * a time. A worker that exits is replaced. Replacing a worker that ran for less than a
+     * second is delayed, by twice as long each time up to a minute, so a worker that keeps
+     * failing doesn't keep the server forking.
+     * @param workers The number of worker processes.
+     */
+    void serve(const std::string& socketPath, unsigned int workers);
+
+  private:
+    PlanningServer(const PlanningServer&);
+    PlanningServer& operator=(const PlanningServer&);
+
+    void runWorker(int listener);
+
+    PSEngine* m_engine;
+    const std::string m_solverConfig;
+    const std::string m_language;
+    std::string::size_type m_maxRequestLength;
+  };
+
+}
+
+#endif
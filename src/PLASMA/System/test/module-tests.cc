@@ -1,5 +1,19 @@
+#include "system-test-module.hh"
+#include "CppUnitUtils.hh"
+#include "DataTypes.hh"
+using namespace EUROPA;
 
-int main() 
+CPPUNIT_TEST_SUITE_REGISTRATION( SystemModuleTests );
+
+int main( int, char **)
 {
-  return 0;   
+    // Init data types so that id counts don't fail
+    VoidDT::instance();
+    BoolDT::instance();
+    IntDT::instance();
+    FloatDT::instance();
+    StringDT::instance();
+    SymbolDT::instance();
+
+    RUN_CPP_UNIT_MODULE(true);
 }
@@ -1,3 +1,7 @@
+if(simplify)
+  set(ENV{EUROPA_SIMPLIFY_MODEL} 1)
+endif(simplify)
+
 execute_process(COMMAND ${exec_plan} ${model} ${configFile} ${language}
   OUTPUT_FILE ${output_file}
   ERROR_FILE ${output_file}
@@ -0,0 +1,74 @@
+#include <iostream>
+#include <stdlib.h>
+#include <unistd.h>
+#include "Debug.hh"
+#include "Error.hh"
+#include "PlanningServer.hh"
+
+using namespace EUROPA;
+
+/**
+   Keeps a model loaded and solves initial states sent to it, either on stdin or on a
+   Unix domain socket.
+   @see PlanningServer for the protocol.
+ */
+int main(int argc, char** argv)
+{
+    const char* socketPath = NULL;
+    unsigned int workers = 1;
+    const char* includePath = NULL;
+    const char* language = "nddl";
+    long maxRequestLength = -1;
+
+    int option;
+    while((option = getopt(argc, argv, "s:w:I:l:m:")) != -1) {
+      switch(option) {
+        case 's': socketPath = optarg; break;
+        case 'w': workers = static_cast<unsigned int>(atoi(optarg)); break;
+        case 'I': includePath = optarg; break;
+        case 'l': language = optarg; break;
+        case 'm': maxRequestLength = atol(optarg); break;
+        default: optind = argc + 1; break;
+      }
+    }
+
+    if(argc - optind < 2) {
+      std::cerr << "usage: "
+                << "planServer "
+                << "[-s <socket path> [-w <workers>]] "
+                << "[-I <include path>] "
+                << "[-l <language>] "
+                << "[-m <max request bytes>] "
+                << "<solver config file> "
+                << "<model file>..."
+                << std::endl;
+      return 1;
+    }
+
+    try {
+      PlanningServer server(argv[optind], language);
+      if(maxRequestLength >= 0)
+        server.setMaxRequestLength(static_cast<std::string::size_type>(maxRequestLength));
+      if(includePath != NULL)
+        server.getEngine()->getConfig()->setProperty("nddl.includePath", includePath);
+
+      for(int i = optind + 1; i < argc; i++) {
+        std::string errors = server.loadModel(argv[i]);
+        if(!errors.empty()) {
+          std::cerr << "Failed to load " << argv[i] << ":" << std::endl << errors << std::endl;
+          return 1;
+        }
+      }
+
+      if(socketPath != NULL)
+        server.serve(socketPath, workers);
+      else
+        server.serve(std::cin, std::cout);
+    }
+    catch(Error& e) {
+      std::cerr << "planServer failed: " << e.getMsg() << std::endl;
+      return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,199 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <pthread.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/**
+   Load test client for planServer. Each client thread opens a connection and sends the
+   same initial state repeatedly, timing every round trip. Reports latency percentiles.
+ */
+namespace {
+
+struct Client {
+  Client() : socketPath(), request(), requests(0), latencies(), failures(0) {}
+
+  std::string socketPath;
+  std::string request;
+  unsigned int requests;
+  std::vector<double> latencies; /*!< In milliseconds */
+  unsigned int failures;
+};
+
+double now()
+{
+  timeval t;
+  gettimeofday(&t, NULL);
+  return t.tv_sec * 1000.0 + t.tv_usec / 1000.0;
+}
+
+bool writeAll(int fd, const std::string& data)
+{
+  std::string::size_type done = 0;
+  while(done < data.size()) {
+    ssize_t count = write(fd, data.data() + done, data.size() - done);
+    if(count < 0 && errno == EINTR)
+      continue;
+    if(count <= 0)
+      return false;
+    done += static_cast<std::string::size_type>(count);
+  }
+  return true;
+}
+
+/**
+ * @brief Read one response, returning its status, or an empty string if the connection failed.
+ */
+std::string readResponse(int fd)
+{
+  std::string header;
+  char c;
+  while(read(fd, &c, 1) == 1 && c != '\n')
+    header.push_back(c);
+
+  std::istringstream is(header);
+  std::string status;
+  std::string::size_type length = 0;
+  if(!(is >> status >> length))
+    return "";
+
+  std::vector<char> payload(4096);
+  while(length > 0) {
+    ssize_t count = read(fd, &payload[0], std::min(length, payload.size()));
+    if(count < 0 && errno == EINTR)
+      continue;
+    if(count <= 0)
+      return "";
+    length -= static_cast<std::string::size_type>(count);
+  }
+  return status;
+}
+
+void* runClient(void* arg)
+{
+  Client& client = *static_cast<Client*>(arg);
+
+  sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  strncpy(address.sun_path, client.socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if(fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+    std::cerr << "Failed to connect to " << client.socketPath << ": " << strerror(errno) << std::endl;
+    client.failures = client.requests;
+    if(fd >= 0)
+      close(fd);
+    return NULL;
+  }
+
+  for(unsigned int i = 0; i < client.requests; i++) {
+    double start = now();
+    if(!writeAll(fd, client.request)) {
+      client.failures += client.requests - i;
+      break;
+    }
+    std::string status = readResponse(fd);
+    if(status.empty()) {
+      client.failures += client.requests - i;
+      break;
+    }
+    if(status != "plan")
+      client.failures++;
+    client.latencies.push_back(now() - start);
+  }
+
+  close(fd);
+  return NULL;
+}
+
+double percentile(const std::vector<double>& sorted, double p)
+{
+  if(sorted.empty())
+    return 0;
+  std::vector<double>::size_type i = static_cast<std::vector<double>::size_type>(p * (sorted.size() - 1) + 0.5);
+  return sorted[i];
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    unsigned int clients = 1;
+    unsigned int requests = 100;
+    std::string horizon = "0 100";
+    std::string limits = "1000 1000";
+
+    int option;
+    while((option = getopt(argc, argv, "c:n:h:m:")) != -1) {
+      switch(option) {
+        case 'c': clients = static_cast<unsigned int>(atoi(optarg)); break;
+        case 'n': requests = static_cast<unsigned int>(atoi(optarg)); break;
+        case 'h': horizon = optarg; break;
+        case 'm': limits = optarg; break;
+        default: optind = argc + 1; break;
+      }
+    }
+
+    if(argc - optind != 2 || clients == 0) {
+      std::cerr << "usage: "
+                << "planServerLoad "
+                << "[-c <clients>] "
+                << "[-n <requests per client>] "
+                << "[-h \"<horizon start> <horizon end>\"] "
+                << "[-m \"<max steps> <max depth>\"] "
+                << "<socket path> "
+                << "<initial state file>"
+                << std::endl;
+      return 1;
+    }
+
+    std::ifstream in(argv[optind + 1]);
+    if(!in) {
+      std::cerr << "Failed to read " << argv[optind + 1] << std::endl;
+      return 1;
+    }
+    std::stringstream script;
+    script << in.rdbuf();
+
+    std::ostringstream request;
+    request << "plan " << horizon << " " << limits << " " << script.str().size() << "\n" << script.str();
+
+    std::vector<Client> state(clients);
+    std::vector<pthread_t> threads(clients);
+    double start = now();
+    for(unsigned int i = 0; i < clients; i++) {
+      state[i].socketPath = argv[optind];
+      state[i].request = request.str();
+      state[i].requests = requests;
+      pthread_create(&threads[i], NULL, &runClient, &state[i]);
+    }
+
+    std::vector<double> latencies;
+    unsigned int failures = 0;
+    for(unsigned int i = 0; i < clients; i++) {
+      pthread_join(threads[i], NULL);
+      latencies.insert(latencies.end(), state[i].latencies.begin(), state[i].latencies.end());
+      failures += state[i].failures;
+    }
+    double elapsed = now() - start;
+    std::sort(latencies.begin(), latencies.end());
+
+    std::cout << "requests: " << latencies.size() << " failures: " << failures << std::endl;
+    std::cout << "throughput: " << (elapsed > 0 ? latencies.size() * 1000.0 / elapsed : 0) << " requests/s" << std::endl;
+    std::cout << "latency (ms): p50 " << percentile(latencies, 0.5)
+              << " p90 " << percentile(latencies, 0.9)
+              << " p99 " << percentile(latencies, 0.99)
+              << " max " << (latencies.empty() ? 0 : latencies.back()) << std::endl;
+
+    return failures == 0 ? 0 : 1;
+}
@@ -28,6 +28,9 @@ class TestEngine : public EuropaEngine
     TestEngine()
     {
         m_config->setProperty("nddl.includePath","../../NDDL/test/nddl:../../NDDL/base:../../NDDL/nddl:../../NDDL:../../Resource/component/NDDL:../../Resource");
+        const char* simplify = getenv("EUROPA_SIMPLIFY_MODEL");
+        if (simplify != NULL && strcmp(simplify, "1") == 0)
+            m_config->setProperty("nddl.simplifyModel","true");
         doStart();
     }
 
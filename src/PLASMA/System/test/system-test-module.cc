@@ -0,0 +1,292 @@
+#include "system-test-module.hh"
+#include "PlanValidator.hh"
+#include "PlanDatabase.hh"
+#include "ConstraintEngine.hh"
+#include "DbClient.hh"
+#include "Schema.hh"
+#include "ObjectType.hh"
+#include "TokenType.hh"
+#include "IntervalToken.hh"
+#include "TokenVariable.hh"
+#include "Timeline.hh"
+#include "DataTypes.hh"
+#include "Domains.hh"
+#include "Engine.hh"
+#include "Rule.hh"
+#include "Interpreter.hh"
+#include "Error.hh"
+#include "TestUtils.hh"
+#include "tinyxml.h"
+
+#include "ModuleConstraintEngine.hh"
+#include "ModulePlanDatabase.hh"
+#include "ModuleRulesEngine.hh"
+#include "ModuleTemporalNetwork.hh"
+#include "ModuleSolvers.hh"
+#ifndef NO_RESOURCES
+#include "ModuleResource.hh"
+#include "Reservoir.hh"
+#include "InstantTokens.hh"
+#endif
+
+#include <cstring>
+#include <sstream>
+
+#include <boost/cast.hpp>
+
+/**
+ * @file Provides module tests for the System module.
+ */
+
+using namespace EUROPA;
+
+namespace {
+const std::string WORK = "Worker.Work";
+const std::string REST = "Worker.Rest";
+
+class WorkerTokenType : public TokenType {
+public:
+  WorkerTokenType(const ObjectTypeId ot, const std::string& predicate)
+    : TokenType(ot, predicate), m_hasEffort(predicate == WORK) {
+    if(m_hasEffort)
+      addArg(IntDT::instance(), "effort");
+  }
+private:
+  TokenId createInstance(const PlanDatabaseId planDb, const std::string& name, bool rejectable, bool isFact) const {
+    return init(new IntervalToken(planDb, name, rejectable, isFact, IntervalIntDomain(), IntervalIntDomain(),
+                                  IntervalIntDomain(1, PLUS_INFINITY), Token::noObject(), false));
+  }
+  TokenId createInstance(const TokenId master, const std::string& name, const std::string& relation) const {
+    return init(new IntervalToken(master, relation, name, IntervalIntDomain(), IntervalIntDomain(),
+                                  IntervalIntDomain(1, PLUS_INFINITY), Token::noObject(), false));
+  }
+  TokenId init(IntervalToken* token) const {
+    if(m_hasEffort)
+      token->addParameter(IntervalIntDomain(), "effort");
+    token->close();
+    return token->getId();
+  }
+  const bool m_hasEffort;
+};
+
+/**
+ * A worker whose work meets a rest, with an effort of at most 5. The rule is the one the interpreter would
+ * make of:
+ * @verbatim
+   Worker::Work {
+     meets(Rest rest);
+     leq(effort, 5);
+   }
+   @endverbatim
+ */
+class SystemTestEngine : public EngineBase {
+public:
+  SystemTestEngine() {
+    addModule((new ModuleConstraintEngine())->getId());
+    addModule((new ModuleConstraintLibrary())->getId());
+    addModule((new ModulePlanDatabase())->getId());
+    addModule((new ModuleRulesEngine())->getId());
+    addModule((new ModuleTemporalNetwork())->getId());
+    addModule((new ModuleSolvers())->getId());
+#ifndef NO_RESOURCES
+    addModule((new ModuleResource())->getId());
+#endif
+    doStart();
+
+    const SchemaId schema = getPlanDatabase()->getSchema();
+    ObjectType* objType = new ObjectType("Worker", schema->getObjectType("Timeline"));
+    objType->addObjectFactory((new TimelineObjectFactory(objType->getId()))->getId());
+    objType->addTokenType((new WorkerTokenType(objType->getId(), WORK))->getId());
+    objType->addTokenType((new WorkerTokenType(objType->getId(), REST))->getId());
+    schema->registerObjectType(objType->getId());
+
+    std::vector<PredicateInstanceRef*> rest;
+    rest.push_back(new PredicateInstanceRef(schema->getTokenType(REST), "Rest", "rest", ""));
+    std::vector<Expr*> limit;
+    limit.push_back(new ExprVarRef("effort", IntDT::instance()));
+    limit.push_back(new ExprConstant("int", new IntervalIntDomain(5, 5)));
+    std::vector<Expr*> body;
+    body.push_back(new ExprRelation("meets", NULL, rest));
+    body.push_back(new ExprConstraint("leq", limit, ""));
+    getRuleSchema()->registerRule((new InterpretedRuleFactory(WORK, "system-test-module", body))->getId());
+  }
+  virtual ~SystemTestEngine() {doShutdown();}
+
+  const PlanDatabaseId getPlanDatabase() const {
+    return boost::polymorphic_cast<const PlanDatabase*>(getComponent("PlanDatabase"))->getId();
+  }
+
+  const RuleSchemaId getRuleSchema() const {
+    return boost::polymorphic_cast<const RuleSchema*>(getComponent("RuleSchema"))->getId();
+  }
+};
+}
+
+class PlanValidatorTest {
+public:
+  static bool test() {
+    EUROPA_runTest(testViolations);
+    return true;
+  }
+
+private:
+  static std::string getKey(const TokenId token) {
+    std::ostringstream os;
+    os << token->getKey();
+    return os.str();
+  }
+
+  static TokenId createToken(const DbClientId client, const std::string& predicate, const ObjectId object,
+                             const eint start) {
+    TokenId token = client->createToken(predicate, "");
+    client->specify(token->getObject(), object->getKey());
+    client->specify(token->start(), start);
+    client->specify(token->end(), start + 10);
+    return token;
+  }
+
+  /**
+   * @brief The first child of parent with the given element name and attribute value.
+   */
+  static TiXmlElement* getChild(TiXmlNode* parent, const char* element, const char* attribute,
+                                const std::string& value) {
+    for(TiXmlElement* child = parent->FirstChildElement(element); child != NULL;
+        child = child->NextSiblingElement(element))
+      if(child->Attribute(attribute) != NULL && value == child->Attribute(attribute))
+        return child;
+    CPPUNIT_ASSERT_MESSAGE("The plan has no " + std::string(element) + " with " + attribute + " " + value, false);
+    return NULL;
+  }
+
+  static TiXmlElement* getVar(TiXmlElement* plan, const std::string& key, const std::string& name) {
+    return getChild(getChild(plan, "token", "key", key), "var", "name", name);
+  }
+
+  static bool reports(const std::vector<std::string>& violations, const std::string& violation) {
+    for(std::vector<std::string>::const_iterator it = violations.begin(); it != violations.end(); ++it)
+      if(it->find(violation) != std::string::npos)
+        return true;
+    return false;
+  }
+
+  static std::vector<std::string> validate(PlanValidator& validator, const TiXmlDocument& doc) {
+    std::ostringstream os;
+    os << doc;
+    return validator.validate(os.str().c_str());
+  }
+
+  /**
+   * Builds a grounded plan, checks that it validates, then breaks it in a different way each time and checks
+   * that the break is reported.
+   */
+  static bool testViolations() {
+    SystemTestEngine engine;
+    const PlanDatabaseId db = engine.getPlanDatabase();
+    const ConstraintEngineId ce = db->getConstraintEngine();
+    const DbClientId client = db->getClient();
+
+    const ObjectId worker = client->createObject("Worker", "worker");
+    const TokenId work = createToken(client, WORK, worker, 0);
+    client->specify(work->getVariable("effort"), 3);
+    client->activate(work);
+    const TokenId pause = createToken(client, REST, worker, 10);
+    client->activate(pause);
+    CPPUNIT_ASSERT(client->propagate());
+    CPPUNIT_ASSERT(work->slaves().size() == 1);
+    const TokenId slave = *work->slaves().begin();
+    client->merge(slave, pause);
+#ifndef NO_RESOURCES
+    Reservoir battery(db, "Reservoir", "battery", "OpenWorldFVDetector", "TimetableProfile", 10, 10, 0, 1000);
+    ConsumerToken consumer(db, "Reservoir.consume", IntervalIntDomain(5), IntervalDomain(4));
+    client->specify(consumer.getObject(), battery.getKey());
+#endif
+    CPPUNIT_ASSERT(client->propagate());
+
+    const std::string workKey = getKey(work), pauseKey = getKey(pause), slaveKey = getKey(slave);
+    std::ostringstream os;
+    PlanValidator::write(db, os);
+    const std::string plan = os.str();
+
+    const unsigned int tokenCount = db->getTokens().size();
+    const unsigned int constraintCount = ce->getConstraints().size();
+    const unsigned int variableCount = ce->getVariables().size();
+
+    PlanValidator validator(db, engine.getRuleSchema());
+    std::vector<std::string> violations = validator.validate(plan.c_str());
+    CPPUNIT_ASSERT_MESSAGE((violations.empty() ? "" : violations.front()), violations.empty());
+    CPPUNIT_ASSERT(!reports(validator.getUnchecked(), "rule of Worker.Work"));
+    CPPUNIT_ASSERT(!reports(validator.getUnchecked(), "rules of Worker.Work"));
+
+    {
+      TiXmlDocument doc;
+      doc.Parse(plan.c_str());
+      getVar(doc.RootElement(), pauseKey, "start")->SetAttribute("value", "5");
+      getVar(doc.RootElement(), pauseKey, "end")->SetAttribute("value", "15");
+      CPPUNIT_ASSERT(reports(validate(validator, doc), "Tokens " + workKey + " and " + pauseKey + " overlap on worker"));
+    }
+
+    {
+      TiXmlDocument doc;
+      doc.Parse(plan.c_str());
+      getVar(doc.RootElement(), workKey, "effort")->SetAttribute("value", "7");
+      CPPUNIT_ASSERT(reports(validate(validator, doc), "Constraint leq(" + workKey + ".effort, 5) is violated"));
+    }
+
+    // Constraints the rules make are checked even when the plan leaves them out
+    {
+      TiXmlDocument doc;
+      doc.Parse(plan.c_str());
+      getVar(doc.RootElement(), workKey, "effort")->SetAttribute("value", "7");
+      while(doc.RootElement()->FirstChildElement("constraint") != NULL)
+        doc.RootElement()->RemoveChild(doc.RootElement()->FirstChildElement("constraint"));
+      CPPUNIT_ASSERT(reports(validate(validator, doc), "Constraint leq(" + workKey + ".effort, 5) is violated"));
+    }
+
+    {
+      TiXmlDocument doc;
+      doc.Parse(plan.c_str());
+      getVar(doc.RootElement(), slaveKey, "start")->SetAttribute("value", "11");
+      CPPUNIT_ASSERT(reports(validate(validator, doc),
+                             "Constraint concurrent(" + workKey + ".end, " + slaveKey + ".start) is violated"));
+    }
+
+#ifndef NO_RESOURCES
+    {
+      TiXmlDocument doc;
+      doc.Parse(plan.c_str());
+      TiXmlElement* resource = getChild(doc.RootElement(), "resource", "name", "battery");
+      getChild(resource, "transaction", "consumer", "true")->SetAttribute("quantity", "20");
+      CPPUNIT_ASSERT(reports(validate(validator, doc), "on battery at 5 is below the limit"));
+    }
+#endif
+
+    {
+      TiXmlDocument doc;
+      doc.Parse(plan.c_str());
+      getChild(doc.RootElement(), "token", "key", slaveKey)->SetAttribute("merged", workKey.c_str());
+      CPPUNIT_ASSERT(reports(validate(validator, doc),
+                             "is merged into " + workKey + ", which has a different predicate"));
+    }
+
+    {
+      TiXmlDocument doc;
+      doc.Parse(plan.c_str());
+      doc.RootElement()->RemoveChild(getChild(doc.RootElement(), "token", "key", slaveKey));
+      CPPUNIT_ASSERT(reports(validate(validator, doc), "Token " + workKey +
+                             " (Worker.Work) has 0 of the 1 Worker.Rest slaves related by meets"));
+    }
+
+    // Validation leaves the plan database as it was
+    CPPUNIT_ASSERT(db->getTokens().size() == tokenCount);
+    CPPUNIT_ASSERT(ce->getConstraints().size() == constraintCount);
+    CPPUNIT_ASSERT(ce->getVariables().size() == variableCount);
+    CPPUNIT_ASSERT(work->getVariable("effort")->lastDomain().getSingletonValue() == 3);
+    CPPUNIT_ASSERT(ce->constraintConsistent());
+    return true;
+  }
+};
+
+void SystemModuleTests::planValidatorTests()
+{
+  PlanValidatorTest::test();
+}
@@ -0,0 +1,24 @@
+#ifndef H_SYSTEM_MODULE_TESTS
+#define H_SYSTEM_MODULE_TESTS
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class SystemModuleTests : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(SystemModuleTests);
+  CPPUNIT_TEST(planValidatorTests);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp()
+  {
+  }
+
+  void tearDown()
+  {
+  }
+
+  void planValidatorTests();
+};
+
+#endif /* H_SYSTEM_MODULE_TESTS */
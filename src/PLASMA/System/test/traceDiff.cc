@@ -0,0 +1,47 @@
+#include "SearchTrace.hh"
+
+#include <fstream>
+#include <iostream>
+
+/**
+   Compares two search traces written by SearchTrace::write and reports the first entry where they differ,
+   with the number of steps both searches took before it.
+   Exits with 0 if the traces are the same, 1 if they differ and 2 if either can't be read.
+ */
+int main(int argc, const char** argv)
+{
+  using EUROPA::SOLVERS::SearchTrace;
+
+  if(argc != 3) {
+    std::cerr << "Usage: " << argv[0] << " <trace> <trace>" << std::endl;
+    return 2;
+  }
+
+  SearchTrace traces[2];
+  for(int i = 0; i < 2; i++) {
+    std::ifstream in(argv[i + 1], std::ios::in | std::ios::binary);
+    if(!traces[i].read(in)) {
+      std::cerr << "Can't read a trace from " << argv[i + 1] << std::endl;
+      return 2;
+    }
+  }
+
+  unsigned long index;
+  if(!SearchTrace::findDivergence(traces[0], traces[1], index)) {
+    std::cout << "Traces are the same: " << traces[0].getEntries().size() << " entries" << std::endl;
+    return 0;
+  }
+
+  unsigned long steps = 0;
+  for(unsigned long i = 0; i < index; i++)
+    if(SearchTrace::isStep(traces[0].getEntries()[i]))
+      steps++;
+
+  std::cout << "Traces differ at entry " << index << ", after " << steps << " steps" << std::endl;
+  for(int i = 0; i < 2; i++) {
+    const std::vector<SearchTrace::Entry>& entries = traces[i].getEntries();
+    std::cout << argv[i + 1] << ": " <<
+        (index < entries.size() ? traces[i].toString(entries[index]) : std::string("<end of trace>")) << std::endl;
+  }
+  return 1;
+}
@@ -0,0 +1,208 @@
+/**
+ * Times validating a grounded plan against building the same plan through the plan database client. Each
+ * worker does a series of work tokens, each of whose slaves is merged into a rest token that follows it.
+ * Loading here leaves out parsing, which the validation includes. Not part of the tests; run
+ * validate-plan-benchmark by hand to compare changes to the PlanValidator.
+ */
+
+#include "PlanValidator.hh"
+#include "PlanDatabase.hh"
+#include "DbClient.hh"
+#include "Schema.hh"
+#include "ObjectType.hh"
+#include "TokenType.hh"
+#include "IntervalToken.hh"
+#include "TokenVariable.hh"
+#include "Timeline.hh"
+#include "CESchema.hh"
+#include "DataTypes.hh"
+#include "Domains.hh"
+#include "Constraints.hh"
+#include "Engine.hh"
+#include "Rule.hh"
+#include "RuleInstance.hh"
+#include "ModuleConstraintEngine.hh"
+#include "ModulePlanDatabase.hh"
+#include "ModuleRulesEngine.hh"
+
+#include <ctime>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <boost/cast.hpp>
+
+using namespace EUROPA;
+
+namespace {
+const std::string WORK = "Worker.Work";
+const std::string REST = "Worker.Rest";
+
+class WorkerTokenType : public TokenType {
+public:
+  WorkerTokenType(const ObjectTypeId ot, const std::string& predicate)
+    : TokenType(ot, predicate), m_hasEffort(predicate == WORK) {
+    if(m_hasEffort)
+      addArg(IntDT::instance(), "effort");
+  }
+private:
+  TokenId createInstance(const PlanDatabaseId planDb, const std::string& name, bool rejectable, bool isFact) const {
+    return init(new IntervalToken(planDb, name, rejectable, isFact, IntervalIntDomain(), IntervalIntDomain(),
+                                  IntervalIntDomain(1, PLUS_INFINITY), Token::noObject(), false));
+  }
+  TokenId createInstance(const TokenId master, const std::string& name, const std::string& relation) const {
+    return init(new IntervalToken(master, relation, name, IntervalIntDomain(), IntervalIntDomain(),
+                                  IntervalIntDomain(1, PLUS_INFINITY), Token::noObject(), false));
+  }
+  TokenId init(IntervalToken* token) const {
+    if(m_hasEffort)
+      token->addParameter(IntervalIntDomain(), "effort");
+    token->close();
+    return token->getId();
+  }
+  const bool m_hasEffort;
+};
+
+/**
+ * Work meets a rest, with an effort of at most 5.
+ */
+class WorkRuleRoot : public RuleInstance {
+public:
+  WorkRuleRoot(const RuleId rule, const TokenId token, const PlanDatabaseId pdb) : RuleInstance(rule, token, pdb) {}
+  void handleExecute() {
+    const TokenId slave = addSlave(new IntervalToken(m_token, "meets", REST));
+    addConstraint("concurrent", makeScope(m_token->end(), slave->start()));
+    const ConstrainedVariableId limit = addVariable(IntervalIntDomain(5, 5), false, "limit");
+    addConstraint("leq", makeScope(m_token->getVariable("effort"), limit));
+  }
+};
+
+class WorkRule : public Rule {
+public:
+  WorkRule() : Rule(WORK) {}
+  RuleInstanceId createInstance(const TokenId token, const PlanDatabaseId pdb, const RulesEngineId& rulesEngine) const {
+    RuleInstanceId rootInstance = (new WorkRuleRoot(m_id, token, pdb))->getId();
+    rootInstance->setRulesEngine(rulesEngine);
+    return rootInstance;
+  }
+  bool describe(RuleBody& body) const {
+    RuleBody::Slave rest;
+    rest.name = "rest";
+    rest.predicate = REST;
+    rest.relation = "meets";
+    body.slaves.push_back(rest);
+
+    RuleBody::ConstraintSpec concurrent;
+    concurrent.name = "concurrent";
+    concurrent.args.push_back(RuleBody::Argument("end"));
+    concurrent.args.push_back(RuleBody::Argument("rest.start"));
+    body.constraints.push_back(concurrent);
+
+    RuleBody::ConstraintSpec limit;
+    limit.name = "leq";
+    limit.args.push_back(RuleBody::Argument("effort"));
+    limit.args.push_back(RuleBody::Argument(IntDT::instance(), 5, 5));
+    body.constraints.push_back(limit);
+    return true;
+  }
+};
+
+class BenchmarkEngine : public EngineBase {
+public:
+  BenchmarkEngine() {
+    addModule((new ModuleConstraintEngine())->getId());
+    addModule((new ModuleConstraintLibrary())->getId());
+    addModule((new ModulePlanDatabase())->getId());
+    addModule((new ModuleRulesEngine())->getId());
+    doStart();
+
+    const SchemaId schema = boost::polymorphic_cast<Schema*>(getComponent("Schema"))->getId();
+    ObjectType* objType = new ObjectType("Worker", schema->getObjectType("Timeline"));
+    objType->addObjectFactory((new TimelineObjectFactory(objType->getId()))->getId());
+    objType->addTokenType((new WorkerTokenType(objType->getId(), WORK))->getId());
+    objType->addTokenType((new WorkerTokenType(objType->getId(), REST))->getId());
+    schema->registerObjectType(objType->getId());
+
+    CESchema* ces = boost::polymorphic_cast<CESchema*>(getComponent("CESchema"));
+    REGISTER_SYSTEM_CONSTRAINT(ces, AddEqualConstraint, "temporalDistance", "Default");
+    REGISTER_SYSTEM_CONSTRAINT(ces, EqualConstraint, "concurrent", "Default");
+    getRuleSchema()->registerRule((new WorkRule())->getId());
+  }
+  virtual ~BenchmarkEngine() {doShutdown();}
+
+  const PlanDatabaseId getPlanDatabase() const {
+    return boost::polymorphic_cast<const PlanDatabase*>(getComponent("PlanDatabase"))->getId();
+  }
+
+  const RuleSchemaId getRuleSchema() const {
+    return boost::polymorphic_cast<const RuleSchema*>(getComponent("RuleSchema"))->getId();
+  }
+};
+
+double secondsSince(const std::clock_t start) {
+  return static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+}
+
+TokenId createToken(const DbClientId client, const std::string& predicate, const ObjectId object,
+                    const eint start) {
+  TokenId token = client->createToken(predicate, "");
+  client->specify(token->getObject(), object->getKey());
+  client->specify(token->start(), start);
+  client->specify(token->end(), start + 10);
+  return token;
+}
+
+/**
+ * Builds a plan of workerCount workers with worksPerWorker work tokens each, then writes and validates it.
+ * Prints the time spent on each.
+ * @return false if the plan can't be built, or its validation finds violations.
+ */
+bool runValidation(const unsigned int workerCount, const unsigned int worksPerWorker) {
+  BenchmarkEngine engine;
+  const PlanDatabaseId db = engine.getPlanDatabase();
+  const DbClientId client = db->getClient();
+
+  std::clock_t start = std::clock();
+  for(unsigned int i = 0; i < workerCount; i++) {
+    std::stringstream name;
+    name << "worker" << i;
+    const ObjectId worker = client->createObject("Worker", name.str());
+    for(unsigned int j = 0; j < worksPerWorker; j++) {
+      const TokenId work = createToken(client, WORK, worker, 20 * j);
+      client->specify(work->getVariable("effort"), 3);
+      client->activate(work);
+      const TokenId rest = createToken(client, REST, worker, 20 * j + 10);
+      client->activate(rest);
+      if(!client->propagate())
+        return false;
+      client->merge(*work->slaves().begin(), rest);
+    }
+  }
+  if(!client->propagate())
+    return false;
+  const double load = secondsSince(start);
+
+  start = std::clock();
+  std::stringstream plan;
+  PlanValidator::write(db, plan);
+  const double write = secondsSince(start);
+
+  PlanValidator validator(db, engine.getRuleSchema());
+  start = std::clock();
+  const std::vector<std::string> violations = validator.validate(plan.str().c_str());
+  const double validation = secondsSince(start);
+
+  std::cout << db->getTokens().size() << " " << load << " " << write << " " << validation << std::endl;
+  for(std::vector<std::string>::const_iterator it = violations.begin(); it != violations.end(); ++it)
+    std::cout << *it << std::endl;
+  return violations.empty();
+}
+}
+
+int main(int, char**) {
+  std::cout << "tokens load(s) write(s) validate(s)" << std::endl;
+  bool ok = true;
+  for(unsigned int worksPerWorker = 50; worksPerWorker <= 3200; worksPerWorker *= 4)
+    ok = runValidation(10, worksPerWorker) && ok;
+  return (ok ? 0 : 1);
+}
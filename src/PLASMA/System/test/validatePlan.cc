@@ -0,0 +1,100 @@
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <stdlib.h>
+#include <unistd.h>
+#include "Debug.hh"
+#include "Error.hh"
+#include "PSEngine.hh"
+
+using namespace EUROPA;
+
+namespace {
+double secondsSince(const std::clock_t start) {
+  return static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+}
+}
+
+/**
+   Checks a grounded plan against a model, or with -w writes the plan database built by the
+   scripts given as a grounded plan. With -c, the plan database is then cleared and the given
+   script, which builds the plan, is loaded and propagated, to compare the time taken with the
+   validation.
+   @see PlanValidator for the plan format.
+ */
+int main(int argc, char** argv)
+{
+    const char* includePath = NULL;
+    const char* language = "nddl";
+    bool writePlan = false;
+    const char* loadScript = NULL;
+
+    int option;
+    while((option = getopt(argc, argv, "I:l:wc:")) != -1) {
+      switch(option) {
+        case 'I': includePath = optarg; break;
+        case 'l': language = optarg; break;
+        case 'w': writePlan = true; break;
+        case 'c': loadScript = optarg; break;
+        default: optind = argc + 1; break;
+      }
+    }
+
+    if(argc - optind < 2) {
+      std::cerr << "usage: "
+                << "validatePlan "
+                << "[-I <include path>] "
+                << "[-l <language>] "
+                << "[-w | -c <plan script>] "
+                << "<model file>... "
+                << "<plan file>"
+                << std::endl;
+      return 1;
+    }
+
+    PSEngine* engine = PSEngine::makeInstance();
+    int status = 0;
+    try {
+      engine->start();
+      if(includePath != NULL)
+        engine->getConfig()->setProperty("nddl.includePath", includePath);
+      for(int i = optind; i < argc - 1; i++)
+        engine->executeScript(language, argv[i], true);
+
+      const char* planFile = argv[argc - 1];
+      if(writePlan) {
+        std::ofstream os(planFile);
+        os << engine->groundedPlanToString();
+      }
+      else {
+        PSList<std::string> unchecked;
+        std::clock_t start = std::clock();
+        PSList<std::string> violations = engine->validatePlan(planFile, true, unchecked);
+        const double time = secondsSince(start);
+        for(long i = 0; i < violations.size(); i++)
+          std::cout << violations.get(i) << std::endl;
+        for(long i = 0; i < unchecked.size(); i++)
+          std::cout << "Unchecked: " << unchecked.get(i) << std::endl;
+        std::cout << planFile << ": " << violations.size() << " violations, " << unchecked.size() <<
+            " checks not made, checked in " << time << "s" << std::endl;
+        status = (violations.size() == 0 ? 0 : 2);
+
+        if(loadScript != NULL) {
+          engine->resetPlanDatabase();
+          start = std::clock();
+          engine->executeScript(language, loadScript, true);
+          const bool consistent = engine->propagate();
+          const double loadTime = secondsSince(start);
+          std::cout << loadScript << ": " << (consistent ? "loaded" : "inconsistent") << " in " << loadTime <<
+              "s, " << (time > 0 ? loadTime / time : 0) << " times the validation" << std::endl;
+        }
+      }
+    }
+    catch(Error& e) {
+      std::cerr << "validatePlan failed: " << e.getMsg() << std::endl;
+      status = 1;
+    }
+
+    delete engine;
+    return status;
+}
@@ -38,6 +38,7 @@ void ModuleTemporalNetwork::initialize(EngineId engine) {
   REGISTER_SYSTEM_CONSTRAINT(ces,LessThanEqualConstraint, "precedes", "Temporal");
   REGISTER_SYSTEM_CONSTRAINT(ces, LessThanConstraint, "strictlyPrecedes", "Temporal");
   REGISTER_SYSTEM_CONSTRAINT(ces,AddEqualConstraint, "temporalDistance", "Temporal");
+  REGISTER_SYSTEM_CONSTRAINT(ces,AddEqualConstraint, "contingentDistance", "Temporal");
 
   PlanDatabase* pdb =
       boost::polymorphic_cast<PlanDatabase*>(engine->getComponent("PlanDatabase"));
@@ -4,6 +4,7 @@
 #include "Error.hh"
 #include "Id.hh"
 #include <boost/shared_ptr.hpp>
+#include <set>
 
 /*!< Type definitions to map for ht ones we were using in Europa */
 namespace EUROPA {
@@ -31,6 +32,28 @@ typedef Tspec TemporalConstraint;
 //typedef Tspec* TemporalConstraintId;
 typedef boost::shared_ptr<Tspec> TemporalConstraintId;
 
+/**
+ * @brief Orders temporal constraints by entity key so that iteration over
+ * the constraints incident on a timepoint does not depend on heap layout.
+ */
+class TemporalConstraintComparator {
+public:
+  bool operator()(const TemporalConstraintId& c1, const TemporalConstraintId& c2) const;
+};
+
+typedef std::set<TemporalConstraintId, TemporalConstraintComparator> TemporalConstraintSet;
+
+/**
+ * @brief Orders timepoints by entity key, so that updates are passed on, and timepoints
+ * deleted, in the same order from one run to the next.
+ */
+class TimepointComparator {
+public:
+  bool operator()(const TimepointId& t1, const TimepointId& t2) const;
+};
+
+typedef std::set<TimepointId, TimepointComparator> TimepointSet;
+
 class TemporalNetwork;
 typedef TemporalNetwork* TemporalNetworkId; 
 
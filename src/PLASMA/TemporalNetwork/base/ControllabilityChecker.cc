@@ -0,0 +1,227 @@
+#include "ControllabilityChecker.hh"
+#include "TemporalNetwork.hh"
+#include "Debug.hh"
+
+#include <functional>
+#include <queue>
+
+namespace EUROPA {
+
+  namespace {
+    const unsigned int NO_LINK = static_cast<unsigned int>(-1);
+
+    typedef std::pair<Time, unsigned int> QueueEntry; /*!< Distance and state */
+    typedef std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry> > MinQueue;
+  }
+
+  ControllabilityChecker::ControllabilityChecker(TemporalNetwork& tnet)
+    : m_tnet(tnet), m_checkedChange(0), m_checkedRelaxation(0), m_controllable(true), m_derived(),
+      m_keys(), m_indices(), m_in(), m_ordinary(), m_upperLink(), m_states() {
+    // Nothing has been checked yet
+    m_checkedChange = m_tnet.m_changeCount - 1;
+    m_checkedRelaxation = m_tnet.m_relaxationCount - 1;
+  }
+
+  bool ControllabilityChecker::isControllable() {
+    if(m_tnet.m_changeCount == m_checkedChange)
+      return m_controllable;
+
+    if(m_tnet.m_relaxationCount != m_checkedRelaxation)
+      m_derived.clear();
+    else if(!m_controllable) {
+      // Tightening a network that can't be controlled can't help
+      m_checkedChange = m_tnet.m_changeCount;
+      return false;
+    }
+
+    build();
+    m_controllable = propagate(true);
+    m_checkedChange = m_tnet.m_changeCount;
+    m_checkedRelaxation = m_tnet.m_relaxationCount;
+    debugMsg("ControllabilityChecker:isControllable",
+             (m_controllable ? "Controllable" : "Not controllable") << " with " << m_keys.size() <<
+             " nodes and " << m_derived.size() << " derived edges");
+    return m_controllable;
+  }
+
+  bool ControllabilityChecker::isControllableWith(const TimepointId src, const TimepointId targ,
+                                                  const Time lb, const Time ub) {
+    if(!isControllable())
+      return false;
+
+    // The edges derived for the network as it is still hold with the new constraint
+    build();
+    addRequirement(addNode(NodeKey(src->Entity::getKey(), false)),
+                   addNode(NodeKey(targ->Entity::getKey(), false)), lb, ub);
+    bool result = propagate(false);
+    debugMsg("ControllabilityChecker:isControllableWith",
+             "[" << lb << ", " << ub << "] from " << src->Entity::getKey() << " to " <<
+             targ->Entity::getKey() << (result ? " is" : " is not") << " controllable");
+    return result;
+  }
+
+  void ControllabilityChecker::build() {
+    m_keys.clear();
+    m_indices.clear();
+    m_in.clear();
+    m_ordinary.clear();
+    m_upperLink.clear();
+
+    for(TemporalConstraintSet::const_iterator it = m_tnet.m_constraints.begin();
+        it != m_tnet.m_constraints.end(); ++it) {
+      const TemporalConstraintId spec = *it;
+      TimepointId head, foot;
+      m_tnet.getConstraintScope(spec, head, foot);
+      // Constraints left on deleted timepoints have no effect on the network
+      if(head->m_specs.find(spec) == head->m_specs.end())
+        continue;
+      unsigned int src = addNode(NodeKey(head->Entity::getKey(), false));
+      unsigned int targ = addNode(NodeKey(foot->Entity::getKey(), false));
+      if(!spec->isContingent()) {
+        addRequirement(src, targ, spec->getLowerBound(), spec->getUpperBound());
+        continue;
+      }
+
+      // Normal form: a rigid delay to the activation node, then a contingent duration starting at 0
+      unsigned int activation = addNode(NodeKey(spec->getKey(), true));
+      Time width = spec->getUpperBound() - spec->getLowerBound();
+      addRequirement(src, activation, spec->getLowerBound(), spec->getLowerBound());
+      addRequirement(activation, targ, 0, width);
+      addLabelled(activation, targ, 0, LOWER_CASE, activation);
+      addLabelled(targ, activation, -width, UPPER_CASE, activation);
+      m_upperLink[activation] = activation;
+    }
+
+    for(EdgeMap::const_iterator it = m_derived.begin(); it != m_derived.end(); ++it) {
+      std::map<NodeKey, unsigned int>::const_iterator from = m_indices.find(it->first.first);
+      std::map<NodeKey, unsigned int>::const_iterator to = m_indices.find(it->first.second);
+      checkError(from != m_indices.end() && to != m_indices.end(),
+                 "Derived edges should be dropped when the network is relaxed");
+      addOrdinary(from->second, to->second, it->second);
+    }
+  }
+
+  void ControllabilityChecker::addRequirement(const unsigned int src, const unsigned int targ,
+                                              const Time lb, const Time ub) {
+    if(ub < POS_INFINITY)
+      addOrdinary(src, targ, ub);
+    if(lb > NEG_INFINITY)
+      addOrdinary(targ, src, -lb);
+  }
+
+  bool ControllabilityChecker::addOrdinary(const unsigned int from, const unsigned int to, const Time length) {
+    std::map<unsigned int, unsigned int>::const_iterator it = m_ordinary[to].find(from);
+    if(it != m_ordinary[to].end()) {
+      Edge& edge = m_in[to][it->second];
+      if(edge.length <= length)
+        return false;
+      edge.length = length;
+      return true;
+    }
+    Edge edge = {from, length, ORDINARY, NO_LINK};
+    m_ordinary[to].insert(std::make_pair(from, m_in[to].size()));
+    m_in[to].push_back(edge);
+    return true;
+  }
+
+  void ControllabilityChecker::addLabelled(const unsigned int from, const unsigned int to, const Time length,
+                                           const EdgeKind kind, const unsigned int link) {
+    Edge edge = {from, length, kind, link};
+    m_in[to].push_back(edge);
+  }
+
+  unsigned int ControllabilityChecker::addNode(const NodeKey& key) {
+    std::map<NodeKey, unsigned int>::const_iterator it = m_indices.find(key);
+    if(it != m_indices.end())
+      return it->second;
+    unsigned int index = m_keys.size();
+    m_indices.insert(std::make_pair(key, index));
+    m_keys.push_back(key);
+    m_in.push_back(std::vector<Edge>());
+    m_ordinary.push_back(std::map<unsigned int, unsigned int>());
+    m_upperLink.push_back(NO_LINK);
+    return index;
+  }
+
+  bool ControllabilityChecker::propagate(const bool record) {
+    m_states.assign(m_keys.size(), UNVISITED);
+    for(unsigned int node = 0; node < m_keys.size(); node++) {
+      for(std::vector<Edge>::const_iterator it = m_in[node].begin(); it != m_in[node].end(); ++it) {
+        if(it->length < 0) {
+          if(!backPropagate(node, record))
+            return false;
+          break;
+        }
+      }
+    }
+    return true;
+  }
+
+  bool ControllabilityChecker::backPropagate(const unsigned int source, const bool record) {
+    if(m_states[source] == PROPAGATING)
+      return false;
+    if(m_states[source] == DONE)
+      return true;
+    m_states[source] = PROPAGATING;
+
+    // Paths are told apart by whether they start with the upper-case edge into the source, since those
+    // can't be extended by the lower-case edge of the same contingent constraint.  The state of a node
+    // reached on such a path is 2 * node + 1, and otherwise 2 * node.
+    std::vector<Time> distances(2 * m_keys.size(), POS_INFINITY);
+    distances[2 * source] = 0;
+    MinQueue queue;
+    for(std::vector<Edge>::const_iterator it = m_in[source].begin(); it != m_in[source].end(); ++it) {
+      unsigned int state = 2 * it->from + (it->kind == UPPER_CASE ? 1 : 0);
+      if(it->length < distances[state]) {
+        distances[state] = it->length;
+        queue.push(QueueEntry(it->length, state));
+      }
+    }
+
+    while(!queue.empty()) {
+      QueueEntry entry = queue.top();
+      queue.pop();
+      const Time distance = entry.first;
+      const unsigned int node = entry.second / 2;
+      const bool fromUpperCase = (entry.second % 2 == 1);
+      if(distance > distances[entry.second])
+        continue;
+
+      if(distance >= 0) {
+        if(node != source && addOrdinary(node, source, distance) && record)
+          m_derived[std::make_pair(m_keys[node], m_keys[source])] = distance;
+        continue;
+      }
+
+      // Edges into a negative node are covered by the edges its own propagation derives
+      for(std::vector<Edge>::const_iterator it = m_in[node].begin(); it != m_in[node].end(); ++it) {
+        if(it->length < 0) {
+          if(!backPropagate(node, record)) {
+            debugMsg("ControllabilityChecker:backPropagate", "Propagation from " << node << " reached itself");
+            return false;
+          }
+          break;
+        }
+      }
+
+      // Edges may have been added to the node above, so index rather than iterate
+      for(unsigned int i = 0; i < m_in[node].size(); i++) {
+        const Edge edge = m_in[node][i];
+        if(edge.length < 0)
+          continue;
+        if(fromUpperCase && edge.kind == LOWER_CASE && edge.link == m_upperLink[source])
+          continue;
+        const Time extended = distance + edge.length;
+        const unsigned int plain = 2 * edge.from;
+        const unsigned int state = plain + (fromUpperCase ? 1 : 0);
+        if(extended < distances[state] && extended < distances[plain]) {
+          distances[state] = extended;
+          queue.push(QueueEntry(extended, state));
+        }
+      }
+    }
+
+    m_states[source] = DONE;
+    return true;
+  }
+}
@@ -0,0 +1,121 @@
+#ifndef _H_ControllabilityChecker
+#define _H_ControllabilityChecker
+
+#include "TemporalNetworkDefs.hh"
+
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace EUROPA {
+
+  /**
+   * @class  ControllabilityChecker
+   * @brief  Decides whether a temporal network with contingent constraints is dynamically controllable:
+   *         whether the controllable timepoints can be scheduled as execution proceeds, knowing only
+   *         the contingent durations observed so far, so that every requirement constraint holds however
+   *         the contingent durations turn out.
+   *
+   * Uses Morris' O(n^3) algorithm (Morris 2014, "Dynamic Controllability and Dispatchability Relationships").
+   * The network is put in normal form, where each contingent constraint [l, u] from A to C becomes a rigid
+   * constraint [l, l] from A to an activation node A' and a contingent constraint [0, u - l] from A' to C,
+   * which is represented by a lower-case edge A' -> C of length 0 and an upper-case edge C -> A' of length
+   * l - u.  Every node with an incoming negative edge is then the source of a backwards Dijkstra
+   * propagation through non-negative edges that derives a non-negative edge from each node it reaches.
+   * The network is not dynamically controllable iff some propagation reaches its own source again.
+   *
+   * The graph is private to the checker, so the edges it derives do not tighten the temporal network.
+   * The edges derived are kept from one check to the next for as long as the network is only tightened,
+   * since they remain sound, and a network found not to be controllable stays so until it is relaxed.
+   * @see TemporalNetwork::addContingentConstraint
+   * @ingroup TemporalNetwork
+   */
+  class ControllabilityChecker {
+  public:
+    ControllabilityChecker(TemporalNetwork& tnet);
+
+    /**
+     * @brief Test if the network is dynamically controllable.
+     */
+    bool isControllable();
+
+    /**
+     * @brief Test if the network would be dynamically controllable with an additional requirement
+     * constraint [lb, ub] from src to targ.  The network itself is not changed.
+     */
+    bool isControllableWith(const TimepointId src, const TimepointId targ, const Time lb, const Time ub);
+
+    /**
+     * @brief The number of edges derived so far and kept for the next check.
+     */
+    unsigned long getDerivedEdgeCount() const {return m_derived.size();}
+
+  private:
+    ControllabilityChecker(const ControllabilityChecker&);
+    ControllabilityChecker& operator=(const ControllabilityChecker&);
+
+    enum EdgeKind {ORDINARY, LOWER_CASE, UPPER_CASE};
+
+    /**
+     * @brief An edge, held in the list of edges into its target.
+     */
+    struct Edge {
+      unsigned int from;
+      Time length;
+      EdgeKind kind;
+      unsigned int link; /*!< Contingent constraint labelling the edge, if not ordinary */
+    };
+
+    enum NodeState {UNVISITED, PROPAGATING, DONE};
+
+    typedef std::pair<eint, bool> NodeKey; /*!< Entity key of a timepoint, or (with true) of the contingent
+                                             constraint an activation node was made for */
+    typedef std::map<std::pair<NodeKey, NodeKey>, Time> EdgeMap;
+
+    /**
+     * @brief Build the graph in normal form from the constraints of the network and the edges derived before.
+     */
+    void build();
+
+    void addRequirement(const unsigned int src, const unsigned int targ, const Time lb, const Time ub);
+
+    /**
+     * @brief Add an ordinary edge, or shorten the one already there.
+     * @return true if the graph changed.
+     */
+    bool addOrdinary(const unsigned int from, const unsigned int to, const Time length);
+
+    void addLabelled(const unsigned int from, const unsigned int to, const Time length, const EdgeKind kind,
+                     const unsigned int link);
+
+    unsigned int addNode(const NodeKey& key);
+
+    /**
+     * @brief Propagate from every negative node.
+     * @param record iff true, keep the edges derived for later checks.
+     */
+    bool propagate(const bool record);
+
+    /**
+     * @brief The backwards propagation from one negative node.
+     * @return false if it reached its own source, or one of the propagations it started did.
+     */
+    bool backPropagate(const unsigned int source, const bool record);
+
+    TemporalNetwork& m_tnet;
+    unsigned long m_checkedChange; /*!< TemporalNetwork change count at the last check */
+    unsigned long m_checkedRelaxation; /*!< TemporalNetwork relaxation count at the last check */
+    bool m_controllable; /*!< Result of the last check */
+    EdgeMap m_derived; /*!< Edges derived by checks since the last relaxation */
+
+    // The graph of the current check
+    std::vector<NodeKey> m_keys;
+    std::map<NodeKey, unsigned int> m_indices;
+    std::vector<std::vector<Edge> > m_in; /*!< Edges into each node */
+    std::vector<std::map<unsigned int, unsigned int> > m_ordinary; /*!< Position in m_in of the ordinary edge from each node */
+    std::vector<unsigned int> m_upperLink; /*!< The contingent constraint whose upper-case edge enters a node, if any */
+    std::vector<NodeState> m_states;
+  };
+}
+
+#endif
@@ -14,6 +14,7 @@
 #include "TemporalNetworkDefs.hh"
 #include "Domains.hh"
 #include "TemporalNetwork.hh"
+#include "ControllabilityChecker.hh"
 #include "Debug.hh"
 
 #include <boost/cast.hpp>
@@ -21,6 +22,40 @@
 
 namespace EUROPA {
 
+  bool TemporalConstraintComparator::operator()(const TemporalConstraintId& c1,
+                                                const TemporalConstraintId& c2) const {
+    return c1->getKey() < c2->getKey();
+  }
+
+  bool TimepointComparator::operator()(const TimepointId& t1, const TimepointId& t2) const {
+    // Dnode::getKey is the priority used in propagation, so name the entity key explicitly
+    return t1->Entity::getKey() < t2->Entity::getKey();
+  }
+
+  /**
+   * @brief Shift a bound by a rigid offset, leaving infinities alone.
+   */
+  static Time shiftTime(const Time t, const Time shift) {
+    if (t >= POS_INFINITY)
+      return POS_INFINITY;
+    if (t <= NEG_INFINITY)
+      return NEG_INFINITY;
+    return t + shift;
+  }
+
+  /**
+   * @brief Shift an edge length by a rigid offset. Lengths pushed past the
+   * representable range behave like the infinite bounds they approach.
+   */
+  static Time shiftLength(const Time t, const Time shift) {
+    Time result = shiftTime(t, shift);
+    if (result > MAX_LENGTH)
+      return POS_INFINITY;
+    if (result < MIN_LENGTH)
+      return NEG_INFINITY;
+    return result;
+  }
+
   Bool TemporalNetwork::isValidId(const TimepointId id){
     return (id &&
 	    id->owner == this && hasNode(id) &&
@@ -32,8 +67,12 @@ namespace EUROPA {
   }
 
   bool TemporalNetwork::hasEdgeToOrigin(const TimepointId timepoint) {
+    TimepointId rep = getRigidRepresentative(timepoint);
+    TimepointId origin = getOrigin();
+    if (rep == origin)
+      return true;
     // Order of operands is important for speed. Should be faster to look towards the origin
-    DedgeId edgeToTheOrigin = findEdge(timepoint, getOrigin());
+    DedgeId edgeToTheOrigin = findEdge(rep, origin);
     checkError(edgeToTheOrigin == NULL || edgeToTheOrigin, edgeToTheOrigin);
     return edgeToTheOrigin != NULL;
   }
@@ -41,20 +80,30 @@ namespace EUROPA {
 TemporalNetwork::TemporalNetwork() : consistent(true), 
                                      hasDeletions(false), nodeCounter(0),
                                      incrementalSource(), m_constraints(), m_id(this),
-                                     m_refpoint(), m_updatedTimepoints() {
+                                     m_refpoint(), m_contingentCount(0), m_changeCount(0),
+                                     m_relaxationCount(0), m_controllability(), m_updatedTimepoints() {
 
   addTimepoint();
   fullPropagate();
+  m_controllability.reset(new ControllabilityChecker(*this));
 }
 
   TemporalNetwork::~TemporalNetwork()
   {
-    for(std::set<TemporalConstraintId>::const_iterator it = m_constraints.begin(); it != m_constraints.end(); ++it){
+    for(TemporalConstraintSet::const_iterator it = m_constraints.begin(); it != m_constraints.end(); ++it){
       TemporalConstraintId constraint = *it;
       check_error(constraint);
       constraint->discard(false);
     }
 
+    // Break the reference cycles between timepoints and their constraints
+    for(std::vector<DnodeId>::const_iterator it = nodes.begin(); it != nodes.end(); ++it){
+      TimepointId node = boost::dynamic_pointer_cast<Timepoint>(*it);
+      node->m_rigidRep.reset();
+      node->m_rigidFollowers.clear();
+      node->m_specs.clear();
+      node->m_contingentLink.reset();
+    }
   }
 
   DnodeId TemporalNetwork::makeNode()
@@ -129,7 +178,13 @@ TemporalNetwork::TemporalNetwork() : consistent(true),
     check_error(this->consistent,
                 "TemporalNetwork: Checking distance in inconsistent network",
                 TempNetErr::TempNetInconsistentError());
-    return DistanceGraph::isDistanceLessThan(from, to, bound);
+
+    TimepointId repFrom = getRigidRepresentative(from);
+    TimepointId repTo = getRigidRepresentative(to);
+    Time shift = getRigidOffset(to) - getRigidOffset(from);
+    if (repFrom == repTo)
+      return shift < bound;
+    return DistanceGraph::isDistanceLessThan(repFrom, repTo, bound - shift);
     // DistanceGraph* graph = boost::polymorphic_cast<DistanceGraph*>(this);
     // return graph->isDistanceLessThan(from, to, bound);
   }
@@ -235,17 +290,29 @@ TemporalNetwork::TemporalNetwork() : consistent(true),
                 TempNetErr::TempNetInvalidTimepointError());
     check_error(( this->isValidId(targ) ),
                 "TemporalNetwork: Invalid target timepoint identifier",
-                TempNetErr::TempNetInvalidTimepointError());    // Trying to simulate as best as possible the AKJ approximation
+                TempNetErr::TempNetInvalidTimepointError());
+
+    // Work on the rigid representatives and shift the result back.
+    TimepointId repSrc = getRigidRepresentative(src);
+    TimepointId repTarg = getRigidRepresentative(targ);
+    Time shift = getRigidOffset(targ) - getRigidOffset(src);
+    if (repSrc == repTarg) {
+      lb = shift;
+      ub = shift;
+      return;
+    }
+
+    // Trying to simulate as best as possible the AKJ approximation
     if(exact == false) {
-      DedgeId forwardEdge = findEdge (src,targ);
-      DedgeId reverseEdge = findEdge (targ,src);
+      DedgeId forwardEdge = findEdge (repSrc,repTarg);
+      DedgeId reverseEdge = findEdge (repTarg,repSrc);
       //      if (forwardEdge != nullptr || reverseEdge != nullptr) {
       if (forwardEdge != NULL)
-	ub = forwardEdge->length;
+	ub = forwardEdge->length + shift;
       else
 	ub = POS_INFINITY;
       if (reverseEdge != NULL)
-	lb = - (reverseEdge->length);
+	lb = - (reverseEdge->length) + shift;
       else
 	lb = NEG_INFINITY;
       return;
@@ -253,10 +320,10 @@ TemporalNetwork::TemporalNetwork() : consistent(true),
     }
 
     // Otherwise calculate from two single-source propagations
-    dijkstra(src,targ);
-    ub = getDistance(targ);
-    dijkstra(targ,src);
-    lb = - getDistance(src);
+    dijkstra(repSrc,repTarg);
+    ub = shiftTime(getDistance(repTarg), shift);
+    dijkstra(repTarg,repSrc);
+    lb = shiftTime(- getDistance(repSrc), shift);
   }
 
   Void TemporalNetwork::propagateBoundsFrom (const TimepointId src)
@@ -290,17 +357,21 @@ TemporalNetwork::TemporalNetwork() : consistent(true),
 
     checkError(this->consistent, "TemporalNetwork: calcDistanceBounds from inconsistent network");
 
-    propagateBoundsFrom(src);
+    TimepointId repSrc = getRigidRepresentative(src);
+    propagateBoundsFrom(repSrc);
 
     lbs.clear();
     ubs.clear();
 
     for (unsigned i=0; i<targs.size(); i++) {
-      lbs.push_back(targs[i]->lowerBound);
-      ubs.push_back(targs[i]->upperBound);
+      TimepointId repTarg = getRigidRepresentative(targs[i]);
+      Time shift = getRigidOffset(targs[i]) - getRigidOffset(src);
+      lbs.push_back(shiftTime(repTarg->lowerBound, shift));
+      ubs.push_back(shiftTime(repTarg->upperBound, shift));
     }
 
     propagateBoundsFrom(getOriginNode());
+    syncAllRigidMembers();
 
     return;
   }
@@ -330,22 +401,38 @@ TemporalNetwork::TemporalNetwork() : consistent(true),
     Time minPotential = POS_INFINITY;
     Time maxPotential = NEG_INFINITY;
 
+    // Distances are computed between rigid representatives. The search
+    // bounds are widened by the largest offset so that no target whose
+    // shifted distance is below 1 gets pruned.
+    TimepointId repSrc = getRigidRepresentative(src);
+    Time srcOffset = getRigidOffset(src);
+    Time forwardBound = 1;
+    Time backwardBound = 1;
+    std::vector<TimepointId> repTargs;
+    std::vector<Time> shifts;
+
     for (unsigned i=0; i<targs.size(); i++) {
-      if (targs[i]->potential < minPotential)
-        minPotential = targs[i]->potential;
-      if (targs[i]->potential > maxPotential)
-        maxPotential = targs[i]->potential;
+      TimepointId repTarg = getRigidRepresentative(targs[i]);
+      Time shift = getRigidOffset(targs[i]) - srcOffset;
+      repTargs.push_back(repTarg);
+      shifts.push_back(shift);
+      if (repTarg->potential < minPotential)
+        minPotential = repTarg->potential;
+      if (repTarg->potential > maxPotential)
+        maxPotential = repTarg->potential;
+      forwardBound = std::max(forwardBound, 1 - shift);
+      backwardBound = std::max(backwardBound, 1 + shift);
       ubs.push_back (1);
       lbs.push_back (-1);
     }
 
-    boundedDijkstraForward(src, 1, minPotential);
+    boundedDijkstraForward(repSrc, forwardBound, minPotential);
     for (unsigned i=0; i<targs.size(); i++)
-      ubs[i] = getDistance(targs[i]);//(targs[i]->distance);
+      ubs[i] = shiftTime(getDistance(repTargs[i]), shifts[i]);
 
-    boundedDijkstraBackward(src, 1, maxPotential);
+    boundedDijkstraBackward(repSrc, backwardBound, maxPotential);
     for (unsigned i=0; i<targs.size(); i++)
-      lbs[i] = (- getDistance(targs[i]));//(- targs[i]->distance);
+      lbs[i] = shiftTime(- getDistance(repTargs[i]), shifts[i]);
     
     //sanity check
     for(unsigned int i = 0; i < targs.size(); i++) {
@@ -445,29 +532,66 @@ TemporalConstraintId TemporalNetwork::addTemporalConstraint(const TimepointId sr
                TempNetErr::TempNetEmptyConstraintError());
   maintainTEQ (lb,ub,src,targ);
 
-  unsigned short edgeCount = 0;
+  TemporalConstraintId spec = boost::make_shared<Tspec>(this, src, targ, lb, ub, 0);
 
-  if (ub <= MAX_LENGTH){
-    addEdgeSpec(src, targ, ub);
-    edgeCount++;
-  }
+  m_constraints.insert(spec);
+  src->m_specs.insert(spec);
+  targ->m_specs.insert(spec);
+  m_changeCount++;
 
-  if(lb >= MIN_LENGTH){
-    edgeCount++;
-    addEdgeSpec(targ, src, -lb);
-  }
+  // As long as propagation is not turned off, we can process this constraint.
+  // A rigid constraint is only collapsed once its effect has been propagated.
+  realizeSpec(spec, _propagate, _propagate);
 
-  TemporalConstraintId spec = boost::make_shared<Tspec>(this, src, targ, lb, ub, edgeCount);
+  return(spec);
+}
 
-  m_constraints.insert(spec);
+TemporalConstraintId TemporalNetwork::addContingentConstraint(const TimepointId src,
+                                                              const TimepointId targ,
+                                                              const Time lb,
+                                                              const Time ub) {
+  check_error(isValidId(targ),
+              "addContingentConstraint:  Invalid target timepoint",
+              TempNetErr::TempNetInvalidTimepointError());
+  // Checked in every build, since the controllability checker subtracts the bounds
+  checkRuntimeError(lb >= 0 && ub >= lb && ub <= MAX_LENGTH,
+                    "addContingentConstraint:  bounds must be finite and not negative: [" << lb << ", " << ub << "]");
+  checkError(targ != getOriginNode() && targ->m_contingentLink == NULL,
+             "addContingentConstraint:  target is already the end of " << targ->m_contingentLink,
+             TempNetErr::TempNetInvalidConstraintError());
+
+  TemporalConstraintId spec = addTemporalConstraint(src, targ, lb, ub);
+  spec->m_contingent = true;
+  targ->m_contingentLink = spec;
+  m_contingentCount++;
+  // Any previous derivation assumed targ could be scheduled at will
+  m_relaxationCount++;
+  return spec;
+}
 
-  // As long as propagation is not turned off, we can process this constraint
-  if (_propagate){
-    incPropagate(src, targ);
+  Bool TemporalNetwork::isDynamicallyControllable() {
+    if (!propagate())
+      return false;
+    if (!hasContingentConstraints())
+      return true;
+    return m_controllability->isControllable();
   }
 
-  return(spec);
-}
+  Bool TemporalNetwork::isDynamicallyControllableWith(const TimepointId src, const TimepointId targ,
+                                                      const Time lb, const Time ub) {
+    check_error(isValidId(src) && isValidId(targ),
+                "isDynamicallyControllableWith:  Invalid timepoint",
+                TempNetErr::TempNetInvalidTimepointError());
+    if (!isDynamicallyControllable())
+      return false;
+    if (!hasContingentConstraints())
+      return true;
+    return m_controllability->isControllableWith(src, targ, mapToInternalInfinity(lb), mapToInternalInfinity(ub));
+  }
+
+  unsigned long TemporalNetwork::getDerivedControllabilityEdgeCount() const {
+    return m_controllability->getDerivedEdgeCount();
+  }
 
   Void TemporalNetwork::narrowTemporalConstraint(const TemporalConstraintId spec,
 						 const Time newLb, const Time newUb)
@@ -491,31 +615,58 @@ TemporalConstraintId TemporalNetwork::addTemporalConstraint(const TimepointId sr
     TimepointId targ = spec->foot;
     maintainTEQ (newLb,newUb,src,targ);
 
-    if (newUb <= MAX_LENGTH){
-      addEdgeSpec(src, targ, newUb);
+    // A narrower contingent constraint leaves the environment less choice
+    m_changeCount++;
+    if (spec->m_contingent)
+      m_relaxationCount++;
+
+    // Narrowing to a rigid constraint collapses the endpoints, as does a
+    // narrowing between timepoints that are already in one rigid component.
+    bool collapse = !this->hasDeletions && this->consistent && newLb == newUb &&
+      spec->m_repHead != spec->m_repFoot;
+    if (collapse || spec->m_repHead == spec->m_repFoot) {
+      unrealizeSpec(spec);
+      spec->lowerBound = newLb;
+      spec->upperBound = newUb;
+      realizeSpec(spec, !this->hasDeletions, collapse);
+      return;
+    }
+
+    // Otherwise add the new edge specs before removing the old ones so the
+    // edges themselves survive (they may be referenced by a nogood).
+    TimepointId repSrc = spec->m_repHead;
+    TimepointId repTarg = spec->m_repFoot;
+    Time shift = getRigidOffset(src) - getRigidOffset(targ);
+    Time newRepLb = shiftLength(newLb, shift);
+    Time newRepUb = shiftLength(newUb, shift);
+
+    if (newRepUb <= MAX_LENGTH){
+      addEdgeSpec(repSrc, repTarg, newRepUb);
       spec->m_edgeCount++;
     }
 
-    if (newLb >= MIN_LENGTH){
-      addEdgeSpec(targ, src, -newLb);
+    if (newRepLb >= MIN_LENGTH){
+      addEdgeSpec(repTarg, repSrc, -newRepLb);
       spec->m_edgeCount++;
     }
-    if (oldUb <= MAX_LENGTH){
-      removeEdgeSpec(src, targ, oldUb);
+    if (spec->m_repUb <= MAX_LENGTH){
+      removeEdgeSpec(repSrc, repTarg, spec->m_repUb);
       spec->m_edgeCount--;
     }
-    if (oldLb >= MIN_LENGTH){
-      removeEdgeSpec(targ, src, -oldLb);
+    if (spec->m_repLb >= MIN_LENGTH){
+      removeEdgeSpec(repTarg, repSrc, -spec->m_repLb);
       spec->m_edgeCount--;
     }
 
     spec->lowerBound = newLb;
     spec->upperBound = newUb;
+    spec->m_repLb = newRepLb;
+    spec->m_repUb = newRepUb;
 
     checkError(spec->m_edgeCount <= 2, "Invalied edge count" <<  spec->m_edgeCount);
 
     if(!this->hasDeletions)
-      incPropagate(src, targ);
+      incPropagate(repSrc, repTarg);
   }
 
   Void TemporalNetwork::removeTemporalConstraint(const TemporalConstraintId spec,
@@ -524,18 +675,32 @@ TemporalConstraintId TemporalNetwork::addTemporalConstraint(const TimepointId sr
     check_error(isValidId(spec),
                 "removeTemporalConstraint: invalid Id",
                 TempNetErr::TempNetInvalidConstraintError());
-    Time lb = spec->lowerBound;
-    Time ub = spec->upperBound;
     TimepointId src = spec->head;
     TimepointId targ = spec->foot;
     check_error(isValidId(src));
     check_error(isValidId(targ));
 
-    if (ub <= MAX_LENGTH)
-      removeEdgeSpec(src, targ, ub);
-    if (lb >= MIN_LENGTH)
-      removeEdgeSpec(targ, src, -lb);
-    this->hasDeletions = this->hasDeletions || markDeleted;
+    // A conflict inside a rigid component is invisible to Bellman-Ford, so
+    // its removal always calls for a full propagation.
+    bool conflicted = m_rigidConflicts.find(spec) != m_rigidConflicts.end();
+    bool rigidLink = spec->m_repHead && spec->m_repHead == spec->m_repFoot &&
+      spec->lowerBound == spec->upperBound;
+
+    unrealizeSpec(spec);
+    src->m_specs.erase(spec);
+    targ->m_specs.erase(spec);
+    if (spec->m_contingent) {
+      targ->m_contingentLink.reset();
+      m_contingentCount--;
+    }
+    m_changeCount++;
+    m_relaxationCount++;
+
+    // The constraint may have been what held the rigid component together.
+    if (rigidLink)
+      dissolveRigid(getRigidRepresentative(src));
+
+    this->hasDeletions = this->hasDeletions || markDeleted || conflicted;
     m_constraints.erase(spec);
   }
 
@@ -566,6 +731,25 @@ TimepointId TemporalNetwork::addTimepoint() {
 
     cleanupTEQ(node);
 
+    // Constraints are expected to be removed first. Any that remain lose
+    // their edges, as they always have, and are detached from this timepoint.
+    TemporalConstraintSet specs = node->m_specs;
+    for(TemporalConstraintSet::const_iterator it = specs.begin(); it != specs.end(); ++it){
+      TemporalConstraintId spec = *it;
+      unrealizeSpec(spec);
+      spec->head->m_specs.erase(spec);
+      spec->foot->m_specs.erase(spec);
+      if (spec->m_contingent) {
+        spec->foot->m_contingentLink.reset();
+        m_contingentCount--;
+      }
+    }
+    m_changeCount++;
+    m_relaxationCount++;
+
+    if (node->m_rigidRep || !node->m_rigidFollowers.empty())
+      dissolveRigid(getRigidRepresentative(node));
+
     m_updatedTimepoints.erase(node);
 
     // Note: following causes all constraints involving
@@ -612,6 +796,8 @@ TimepointId TemporalNetwork::addTimepoint() {
     this->incrementalSource.reset();   // Not applicable to a full prop.
     setConsistency(bellmanFord());
     this->hasDeletions = false;
+    if (this->consistent && !m_rigidConflicts.empty())
+      noteRigidConflict(*m_rigidConflicts.begin());
     if (this->consistent == false)
       return;
 
@@ -658,6 +844,10 @@ TimepointId TemporalNetwork::addTimepoint() {
 	incDijkstraRefBack(); // Backwards propagation
     }
 
+    // Followers of representatives that were never updated still carry
+    // the values from the reset above.
+    syncAllRigidMembers();
+
     debugMsg("TemporalNetwork:fullPropagate", "fullPropagate done");
  }
 
@@ -966,12 +1156,32 @@ Void TemporalNetwork::incDijkstraForward() {
     // Predecessors are computed dynamically.
     // Might be possible to cache these too.
 
-    std::list<TimepointId> ans;
-    int numedges = tpt->outCount;
+    // Edges live on rigid representatives, so enumerate the members of
+    // each neighbouring component (and of our own) at their true distance.
+    TimepointId rep = getRigidRepresentative(tpt);
+    Time offset = getRigidOffset(tpt);
+    std::vector<std::pair<TimepointId, Time> > candidates;
+    candidates.push_back(std::make_pair(rep, -offset));
+    for (std::vector<TimepointId>::const_iterator it = rep->m_rigidFollowers.begin();
+         it != rep->m_rigidFollowers.end(); ++it)
+      candidates.push_back(std::make_pair(*it, (*it)->m_rigidOffset - offset));
+    int numedges = rep->outCount;
     for (int i=0; i<numedges; i++) {
-      DedgeId e = tpt->outArray[i];
-      Time length = e->length;
+      DedgeId e = rep->outArray[i];
       TimepointId next = boost::dynamic_pointer_cast<Tnode>(e->to);
+      candidates.push_back(std::make_pair(next, e->length - offset));
+      for (std::vector<TimepointId>::const_iterator it = next->m_rigidFollowers.begin();
+           it != next->m_rigidFollowers.end(); ++it)
+        candidates.push_back(std::make_pair(*it, e->length + (*it)->m_rigidOffset - offset));
+    }
+
+    std::list<TimepointId> ans;
+    for (std::vector<std::pair<TimepointId, Time> >::const_iterator it = candidates.begin();
+         it != candidates.end(); ++it) {
+      TimepointId next = it->first;
+      Time length = it->second;
+      if (next == tpt)
+        continue;
       if (length < 0)   // Negative predecessors are enabling.
 	ans.push_back(next);
 
@@ -1045,15 +1255,235 @@ Void TemporalNetwork::incDijkstraForward() {
     return m_id;
   }
 
-  const std::set<TimepointId>& TemporalNetwork::getUpdatedTimepoints() const {
+  const TimepointSet& TemporalNetwork::getUpdatedTimepoints() const {
     return m_updatedTimepoints;
   }
 
+  void TemporalNetwork::takeUpdatedTimepoints(TimepointSet& timepoints) {
+    timepoints.clear();
+    timepoints.swap(m_updatedTimepoints);
+  }
+
   void TemporalNetwork::handleNodeUpdate(const DnodeId node){
     const TimepointId tnode = boost::dynamic_pointer_cast<Timepoint>(node);
     checkError(tnode, node);
     if(node != getOrigin())
       m_updatedTimepoints.insert(tnode);
+    if(!tnode->m_rigidFollowers.empty())
+      syncRigidMembers(tnode);
+  }
+
+  TimepointId TemporalNetwork::getRigidRepresentative(const TimepointId tpId) const {
+    check_error(tpId,
+                "TemporalNetwork:: accessing invalid timepoint.",
+                TempNetErr::TempNetInvalidTimepointError());
+    return (tpId->m_rigidRep ? tpId->m_rigidRep : tpId);
+  }
+
+  Time TemporalNetwork::getRigidOffset(const TimepointId tpId) const {
+    check_error(tpId,
+                "TemporalNetwork:: accessing invalid timepoint.",
+                TempNetErr::TempNetInvalidTimepointError());
+    return tpId->m_rigidOffset;
+  }
+
+  unsigned long TemporalNetwork::getRepresentativeCount() const {
+    unsigned long count = 0;
+    for(std::vector<DnodeId>::const_iterator it = nodes.begin(); it != nodes.end(); ++it){
+      TimepointId node = boost::dynamic_pointer_cast<Timepoint>(*it);
+      if (!node->m_rigidRep)
+        count++;
+    }
+    return count;
+  }
+
+  Void TemporalNetwork::realizeSpec(const TemporalConstraintId spec, bool propagate, bool collapse)
+  {
+    TimepointId src = spec->head;
+    TimepointId targ = spec->foot;
+    TimepointId repSrc = getRigidRepresentative(src);
+    TimepointId repTarg = getRigidRepresentative(targ);
+    Time shift = getRigidOffset(src) - getRigidOffset(targ);
+
+    spec->m_repHead = repSrc;
+    spec->m_repFoot = repTarg;
+    spec->m_repLb = shiftLength(spec->lowerBound, shift);
+    spec->m_repUb = shiftLength(spec->upperBound, shift);
+    spec->m_edgeCount = 0;
+
+    if (repSrc == repTarg) {
+      // The distance between the endpoints is already fixed, so no edges are
+      // needed; the constraint either holds or the network is inconsistent.
+      if (spec->lowerBound >= MIN_LENGTH)
+        spec->m_edgeCount++;
+      if (spec->upperBound <= MAX_LENGTH)
+        spec->m_edgeCount++;
+      if (spec->m_repLb > 0 || spec->m_repUb < 0) {
+        m_rigidConflicts.insert(spec);
+        noteRigidConflict(spec);
+      }
+      return;
+    }
+
+    if (spec->m_repUb <= MAX_LENGTH){
+      addEdgeSpec(repSrc, repTarg, spec->m_repUb);
+      spec->m_edgeCount++;
+    }
+
+    if (spec->m_repLb >= MIN_LENGTH){
+      addEdgeSpec(repTarg, repSrc, -spec->m_repLb);
+      spec->m_edgeCount++;
+    }
+
+    if (propagate)
+      incPropagate(repSrc, repTarg);
+
+    if (!collapse || spec->lowerBound != spec->upperBound)
+      return;
+
+    // If the edges made the network inconsistent, keep them so the nogood
+    // can be traced.
+    if (propagate && !this->consistent)
+      return;
+
+    Time delta = spec->m_repLb; // repTarg = repSrc + delta
+    unrealizeSpec(spec);
+
+    // Keep the origin as a representative, otherwise fold the smaller
+    // component into the larger one.
+    TimepointId origin = getOriginNode();
+    if (repSrc == origin ||
+        (repTarg != origin &&
+         repSrc->m_rigidFollowers.size() >= repTarg->m_rigidFollowers.size()))
+      mergeRigid(repSrc, repTarg, delta);
+    else
+      mergeRigid(repTarg, repSrc, -delta);
+
+    realizeSpec(spec, false, false);
+  }
+
+  Void TemporalNetwork::unrealizeSpec(const TemporalConstraintId spec)
+  {
+    if (!spec->m_repHead)
+      return;
+
+    if (spec->m_repHead == spec->m_repFoot)
+      m_rigidConflicts.erase(spec);
+    else {
+      if (spec->m_repUb <= MAX_LENGTH)
+        removeEdgeSpec(spec->m_repHead, spec->m_repFoot, spec->m_repUb);
+      if (spec->m_repLb >= MIN_LENGTH)
+        removeEdgeSpec(spec->m_repFoot, spec->m_repHead, -spec->m_repLb);
+    }
+
+    spec->m_repHead.reset();
+    spec->m_repFoot.reset();
+    spec->m_edgeCount = 0;
+  }
+
+  Void TemporalNetwork::mergeRigid(const TimepointId keep, const TimepointId drop, Time delta)
+  {
+    check_error(keep != drop && !keep->m_rigidRep && !drop->m_rigidRep);
+    debugMsg("TemporalNetwork:mergeRigid",
+             "Folding " << drop->getKey() << " into " << keep->getKey() << " at offset " << delta);
+
+    std::vector<TimepointId> members(1, drop);
+    members.insert(members.end(), drop->m_rigidFollowers.begin(), drop->m_rigidFollowers.end());
+
+    // Lift the edges leaving the component. Constraints inside it are
+    // unaffected since all offsets shift together.
+    std::vector<TemporalConstraintId> moved;
+    for(std::vector<TimepointId>::const_iterator it = members.begin(); it != members.end(); ++it){
+      const TimepointId member = *it;
+      for(TemporalConstraintSet::const_iterator sit = member->m_specs.begin(); sit != member->m_specs.end(); ++sit){
+        TemporalConstraintId spec = *sit;
+        if (!spec->m_repHead || (spec->m_repHead == drop && spec->m_repFoot == drop))
+          continue;
+        unrealizeSpec(spec);
+        moved.push_back(spec);
+      }
+    }
+
+    for(std::vector<TimepointId>::const_iterator it = members.begin(); it != members.end(); ++it){
+      const TimepointId member = *it;
+      member->m_rigidOffset += delta;
+      member->m_rigidRep = keep;
+      keep->m_rigidFollowers.push_back(member);
+    }
+    drop->m_rigidFollowers.clear();
+
+    for(std::vector<TemporalConstraintId>::const_iterator it = moved.begin(); it != moved.end(); ++it)
+      realizeSpec(*it, false, false);
+  }
+
+  Void TemporalNetwork::dissolveRigid(const TimepointId rep)
+  {
+    check_error(!rep->m_rigidRep);
+    if (rep->m_rigidFollowers.empty())
+      return;
+
+    debugMsg("TemporalNetwork:dissolveRigid",
+             "Splitting rigid component of " << rep->getKey() << " with " <<
+             rep->m_rigidFollowers.size() << " followers");
+
+    std::vector<TimepointId> members(1, rep);
+    members.insert(members.end(), rep->m_rigidFollowers.begin(), rep->m_rigidFollowers.end());
+
+    // Visit each constraint once: from its head, or from its foot when the
+    // head lies outside the component.
+    std::vector<TemporalConstraintId> specs;
+    for(std::vector<TimepointId>::const_iterator it = members.begin(); it != members.end(); ++it){
+      const TimepointId member = *it;
+      for(TemporalConstraintSet::const_iterator sit = member->m_specs.begin(); sit != member->m_specs.end(); ++sit){
+        TemporalConstraintId spec = *sit;
+        if (spec->head == member || getRigidRepresentative(spec->head) != rep)
+          specs.push_back(spec);
+      }
+    }
+
+    for(std::vector<TemporalConstraintId>::const_iterator it = specs.begin(); it != specs.end(); ++it)
+      unrealizeSpec(*it);
+
+    for(std::vector<TimepointId>::const_iterator it = members.begin(); it != members.end(); ++it){
+      (*it)->m_rigidRep.reset();
+      (*it)->m_rigidOffset = 0;
+    }
+    rep->m_rigidFollowers.clear();
+
+    // Bounds and potentials of the members still satisfy every remaining
+    // constraint, so the rigid ones can be collapsed again without propagation.
+    for(std::vector<TemporalConstraintId>::const_iterator it = specs.begin(); it != specs.end(); ++it)
+      realizeSpec(*it, false, true);
+  }
+
+  Void TemporalNetwork::noteRigidConflict(const TemporalConstraintId spec)
+  {
+    setConsistency(false);
+    // Make sure there is an updated timepoint to attribute the failure to.
+    m_updatedTimepoints.insert(spec->foot != getOriginNode() ? spec->foot : spec->head);
+  }
+
+  Void TemporalNetwork::syncRigidMembers(const TimepointId rep)
+  {
+    for(std::vector<TimepointId>::const_iterator it = rep->m_rigidFollowers.begin();
+        it != rep->m_rigidFollowers.end(); ++it){
+      const TimepointId member = *it;
+      Time offset = member->m_rigidOffset;
+      member->lowerBound = shiftTime(rep->lowerBound, offset);
+      member->upperBound = shiftTime(rep->upperBound, offset);
+      member->reftime = shiftTime(rep->reftime, offset);
+      member->potential = rep->potential + offset;
+      m_updatedTimepoints.insert(member);
+    }
+  }
+
+  Void TemporalNetwork::syncAllRigidMembers()
+  {
+    for(std::vector<DnodeId>::const_iterator it = nodes.begin(); it != nodes.end(); ++it){
+      TimepointId node = boost::dynamic_pointer_cast<Timepoint>(*it);
+      if (!node->m_rigidFollowers.empty())
+        syncRigidMembers(node);
+    }
   }
 
   void TemporalNetwork::resetUpdatedTimepoints() {
@@ -1068,7 +1498,8 @@ Void TemporalNetwork::incDijkstraForward() {
 Tnode::Tnode(TemporalNetwork* t) :
     Dnode(), lowerBound(NEG_INFINITY), upperBound(POS_INFINITY), reftime(0),
     prev_reftime(0), ordinal(0), m_baseDomainConstraint(), m_deletionMarker(true),
-    index(0), ringLeader(), ringFollowers(), owner(t) {}
+    m_rigidRep(), m_rigidOffset(0), m_rigidFollowers(), m_specs(),
+    m_contingentLink(), index(0), ringLeader(), ringFollowers(), owner(t) {}
 
   Tnode::~Tnode(){
     discard(false);
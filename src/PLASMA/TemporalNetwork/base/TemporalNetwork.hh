@@ -16,7 +16,10 @@
 #include "TemporalNetworkDefs.hh"
 #include "DistanceGraph.hh"
 #include "Error.hh"
+#include <boost/scoped_ptr.hpp>
 #include <list>
+#include <set>
+#include <vector>
 
 namespace EUROPA {
 
@@ -28,6 +31,8 @@ namespace EUROPA {
 
   class DispatchNode;
 
+  class ControllabilityChecker;
+
 
 const TimepointId noTimepointId(static_cast<Tnode*>(NULL));
 
@@ -60,6 +65,7 @@ const TimepointId noTimepointId(static_cast<Tnode*>(NULL));
     TimepointId incrementalSource;
 
     friend Void keepEdge (DispatchNode* x, DispatchNode* y, Time d);
+    friend class ControllabilityChecker;
     public:
 
    // The following are provided for backward compatibility with previous
@@ -223,6 +229,43 @@ const TimepointId noTimepointId(static_cast<Tnode*>(NULL));
      */
     TemporalConstraintId addTemporalConstraint(const TimepointId src, const TimepointId targ,
 						const Time lb, const Time ub, bool propagate = true);
+    /**
+     * @brief Add a contingent constraint to the network: the duration from src to targ is chosen by the
+     * environment within [lb, ub] and only observed once targ occurs.  For propagation it is treated like
+     * any other constraint, so it only matters to isDynamicallyControllable.
+     * @param src start or head of the constraint
+     * @param targ finish or tail of the constraint, which may end no other contingent constraint
+     * @param lb lower bound time, at least 0
+     * @param ub upper bound time, which must be finite
+     */
+    TemporalConstraintId addContingentConstraint(const TimepointId src, const TimepointId targ,
+                                                 const Time lb, const Time ub);
+
+    /**
+     * @brief True iff the network holds any contingent constraints.
+     */
+    bool hasContingentConstraints() const {return m_contingentCount > 0;}
+
+    /**
+     * @brief Test if the network is dynamically controllable, i.e. if the other timepoints can be scheduled
+     * as execution proceeds so that every constraint holds whatever durations the contingent constraints
+     * turn out to have. Without contingent constraints this is the same as consistency.
+     * @see ControllabilityChecker
+     */
+    Bool isDynamicallyControllable();
+
+    /**
+     * @brief Test if the network would stay dynamically controllable with an additional constraint
+     * [lb, ub] from src to targ, without adding it.
+     */
+    Bool isDynamicallyControllableWith(const TimepointId src, const TimepointId targ,
+                                       const Time lb, const Time ub);
+
+    /**
+     * @brief The number of edges the dynamic controllability check has derived and kept.
+     */
+    unsigned long getDerivedControllabilityEdgeCount() const;
+
     /**
      * @brief Tighten the temporal constraint to new bounds iff they are tighter.
      * @param tcId Constraint to tighten
@@ -313,7 +356,13 @@ const TimepointId noTimepointId(static_cast<Tnode*>(NULL));
      * @brief Returns the set of updated timepoints.
      * @return the set of updated timepoints.
      */
-     const std::set<TimepointId>& getUpdatedTimepoints() const;
+     const TimepointSet& getUpdatedTimepoints() const;
+
+    /**
+     * @brief Moves the set of updated timepoints into the given set and clears it here.
+     * @param timepoints receives the updated timepoints. Any prior content is discarded.
+     */
+    void takeUpdatedTimepoints(TimepointSet& timepoints);
 
     /**
      * @brief Identify if timepoint is connected to the origin of the STN through edges in the network
@@ -336,6 +385,27 @@ const TimepointId noTimepointId(static_cast<Tnode*>(NULL));
 
     TimepointId getRingLeader(TimepointId tpId);
 
+    /**
+     * @brief Get the timepoint that represents the rigid component of tpId.
+     *
+     * Timepoints joined by constraints with lb == ub are collapsed into a
+     * single node of the distance graph. Only the representative carries
+     * edges; every other member is at a fixed offset from it.
+     * @return tpId itself if it is not rigidly bound to any other timepoint.
+     */
+    TimepointId getRigidRepresentative(const TimepointId tpId) const;
+
+    /**
+     * @brief Get the fixed offset of tpId from its rigid representative,
+     * i.e. tpId = getRigidRepresentative(tpId) + getRigidOffset(tpId).
+     */
+    Time getRigidOffset(const TimepointId tpId) const;
+
+    /**
+     * @brief Number of timepoints that currently carry edges in the distance graph.
+     */
+    unsigned long getRepresentativeCount() const;
+
     std::list<TimepointId> getRingFollowers (TimepointId tpId);
 
     std::list<TimepointId> getRingPredecessors (TimepointId tpId);
@@ -426,6 +496,51 @@ const TimepointId noTimepointId(static_cast<Tnode*>(NULL));
 
     Void cleanupTEQ(TimepointId tpt);
 
+    /**
+     * @brief Install the edges for a constraint between the rigid representatives
+     * of its endpoints.
+     * @param spec the constraint to realize
+     * @param propagate iff true, incrementally propagate the new edges.
+     * @param collapse iff true and spec is rigid, merge the rigid components of
+     *        its endpoints. Without propagation this is only safe when the
+     *        endpoints' bounds already agree with the constraint.
+     */
+    Void realizeSpec(const TemporalConstraintId spec, bool propagate, bool collapse);
+
+    /**
+     * @brief Remove whatever realizeSpec installed for spec.
+     */
+    Void unrealizeSpec(const TemporalConstraintId spec);
+
+    /**
+     * @brief Fold the rigid component of drop into that of keep, where
+     * drop = keep + delta. Edges incident on drop are rewritten onto keep.
+     */
+    Void mergeRigid(const TimepointId keep, const TimepointId drop, Time delta);
+
+    /**
+     * @brief Split the rigid component of rep back into single timepoints and
+     * re-collapse it using the rigid constraints that remain.
+     */
+    Void dissolveRigid(const TimepointId rep);
+
+    /**
+     * @brief Mark the network inconsistent because spec conflicts with the
+     * fixed offsets of a rigid component.
+     */
+    Void noteRigidConflict(const TemporalConstraintId spec);
+
+    /**
+     * @brief Copy the bounds, potential and reftime of a representative onto
+     * its followers and mark the followers as updated.
+     */
+    Void syncRigidMembers(const TimepointId rep);
+
+    /**
+     * @brief syncRigidMembers for every representative with followers.
+     */
+    Void syncAllRigidMembers();
+
     /**
      * @brief check if node is valid
      * @return true iff node is valid.
@@ -445,7 +560,14 @@ const TimepointId noTimepointId(static_cast<Tnode*>(NULL));
     /**
      * @brief set of constraints in the temporal network
      */
-    std::set<TemporalConstraintId> m_constraints;
+    TemporalConstraintSet m_constraints;
+
+    /**
+     * @brief Constraints whose endpoints were collapsed into the same rigid
+     * component but whose bounds exclude the fixed offset between them.
+     * These have no edges, so Bellman-Ford cannot see them.
+     */
+    TemporalConstraintSet m_rigidConflicts;
 
     /**
      * @brief Unique ID of this temporal network instance
@@ -460,6 +582,11 @@ const TimepointId noTimepointId(static_cast<Tnode*>(NULL));
      */
     TimepointId m_refpoint;
 
+    unsigned int m_contingentCount; /*!< Contingent constraints in the network */
+    unsigned long m_changeCount; /*!< Changes to the constraints, so controllability is rechecked only when needed */
+    unsigned long m_relaxationCount; /*!< Changes that may make the network more controllable */
+    boost::scoped_ptr<ControllabilityChecker> m_controllability;
+
    protected:                          // Overridden virtual functions
 
    /**
@@ -477,7 +604,7 @@ const TimepointId noTimepointId(static_cast<Tnode*>(NULL));
     /**
      * @brief Stores the changes made to nodes during propogation for more efficent incremental update
      */
-    std::set<TimepointId> m_updatedTimepoints;
+    TimepointSet m_updatedTimepoints;
   };
 
 
@@ -494,6 +621,7 @@ private:
   Tnode(const Tnode&);
   Tnode& operator=(const Tnode&);
     friend class TemporalNetwork;
+    friend class ControllabilityChecker;
     friend Void keepEdge (DispatchNode* x, DispatchNode* y, Time d);
     // PHM Support for reftime calculations
   protected:
@@ -505,6 +633,11 @@ private:
     Int ordinal;
     TemporalConstraintId m_baseDomainConstraint; /*!< Constraint used to enforce timepoint bounds input.*/
     bool m_deletionMarker;
+    TimepointId m_rigidRep; /*!< Representative of the rigid component, noId if this is the representative.*/
+    Time m_rigidOffset; /*!< this = m_rigidRep + m_rigidOffset */
+    std::vector<TimepointId> m_rigidFollowers; /*!< Other members, if this is the representative.*/
+    TemporalConstraintSet m_specs; /*!< Constraints with this timepoint as head or foot.*/
+    TemporalConstraintId m_contingentLink; /*!< The contingent constraint ending here, if any.*/
     void handleDiscard();
   public:
     Int index;          // PHM 5/9/2000 Used for matching TPs to dispatch nodes.
@@ -556,6 +689,11 @@ private:
     TimepointId foot;
     TemporalNetwork* owner;
     unsigned int m_edgeCount;
+    TimepointId m_repHead; /*!< Representative of head when the edges were installed.*/
+    TimepointId m_repFoot; /*!< Representative of foot when the edges were installed.*/
+    Time m_repLb; /*!< Bounds shifted onto the representatives. */
+    Time m_repUb;
+    bool m_contingent; /*!< The duration is chosen by the environment */
     void handleDiscard();
 
   public:
@@ -570,7 +708,7 @@ private:
      */
     Tspec(TemporalNetwork* t, TimepointId src,TimepointId targ,Time lb,Time ub, unsigned short edgeCount)
         : lowerBound(lb), upperBound(ub), head(src), foot(targ), owner(t),
-          m_edgeCount(edgeCount)
+          m_edgeCount(edgeCount), m_repHead(), m_repFoot(), m_repLb(lb), m_repUb(ub), m_contingent(false)
     {}
 
     virtual ~Tspec();
@@ -585,6 +723,12 @@ private:
     inline Time getLowerBound() const {return lowerBound;}
     inline Time getUpperBound() const {return upperBound;}
 
+    /**
+     * @brief test if the duration of the constraint is chosen by the environment
+     * @see TemporalNetwork::addContingentConstraint
+     */
+    inline bool isContingent() const {return m_contingent;}
+
     /**
      * @brief test if Tspec is complete
      * @return returns true if Tspec is complete, false otherwise.
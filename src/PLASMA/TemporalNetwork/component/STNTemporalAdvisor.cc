@@ -46,6 +46,10 @@ namespace EUROPA {
 	    m_propagator->canBeConcurrent(first->end(), second->end()));
   }
 
+  bool STNTemporalAdvisor::isDynamicallyControllable(){
+    return m_propagator->isDynamicallyControllable();
+  }
+
   /**
    * @brief Gets the temporal distance between two temporal variables. 
    * @param exact if set to true makes this distance calculation exact.
@@ -300,12 +300,10 @@ ConstraintId getConstraint(ConstrainedVariableId fromvar,
 
   void TemporalPropagator::handleViolations()
   {
-      const std::set<TimepointId>& updatedTimepoints = m_tnet->getUpdatedTimepoints();
+      const TimepointSet& updatedTimepoints = m_tnet->getUpdatedTimepoints();
       checkError(!updatedTimepoints.empty(), "updated timepoints are expected if tnet is not consistent");
-      std::map<TimepointId, ConstrainedVariableId>::const_iterator it =
-          m_timepointToVar.find(*(updatedTimepoints.begin()));
-      check_error(it != m_timepointToVar.end());
-      ConstrainedVariableId var = it->second;
+      ConstrainedVariableId var = getVariable(*updatedTimepoints.begin());
+      check_error(var.isId());
       
       if (getConstraintEngine()->getAllowViolations())
           collectViolations(var);
@@ -415,6 +413,7 @@ ConstraintId getConstraint(ConstrainedVariableId fromvar,
     static const std::string sl_precedes("precedes");
     static const std::string sl_strictlyPrecedes("strictlyPrecedes");
     static const std::string sl_before("before");
+    static const std::string sl_contingentDistance("contingentDistance");
 
     checkError(constraint->isActive(), constraint->toString());
 
@@ -427,7 +426,8 @@ ConstraintId getConstraint(ConstrainedVariableId fromvar,
                constraint->getName() == sl_concurrent ||
                constraint->getName() == sl_precedes ||
                constraint->getName() == sl_strictlyPrecedes ||
-               constraint->getName() == sl_before,
+               constraint->getName() == sl_before ||
+               constraint->getName() == sl_contingentDistance,
                "Invalid constraint name " << constraint->getName() << " for temporal propagation.");
 
     ConstrainedVariableId start = constraint->getScope()[0];
@@ -455,10 +455,14 @@ ConstraintId getConstraint(ConstrainedVariableId fromvar,
     check_error(endTp);
 
 
-    TemporalConstraintId c = m_tnet->addTemporalConstraint(startTp,
-                                                           endTp,
-                                                           lb,
-                                                           ub);
+    TemporalConstraintId c;
+    if(constraint->getName() == sl_contingentDistance) {
+      checkRuntimeError(lb >= 0 && ub < cast_int(PLUS_INFINITY),
+                        "The duration of " << constraint->toString() << " must be finite and not negative");
+      c = m_tnet->addContingentConstraint(startTp, endTp, lb, ub);
+    }
+    else
+      c = m_tnet->addTemporalConstraint(startTp, endTp, lb, ub);
 
     mapConstraint(constraint, c);
     debugMsg("TemporalPropagator:addTemporalConstraint",
@@ -487,7 +491,7 @@ void TemporalPropagator::processConstraintDeletions() {
 
 void TemporalPropagator::processVariableDeletions() {
   debugMsg("TemporalPropagator:updateTnet", "Processing variables for deletion... ");
-  for(std::set<TimepointId>::const_iterator it = m_variablesForDeletion.begin();
+  for(TimepointSet::const_iterator it = m_variablesForDeletion.begin();
       it != m_variablesForDeletion.end(); ++it) {
     TimepointId tp = *it;
     TemporalConstraintId baseDomainConstraint = tp->getBaseDomainConstraint();
@@ -577,8 +581,9 @@ void TemporalPropagator::updateCnet() {
   debugMsg("TemporalPropagator:updateCnet", "In updateCnet");
 
   std::vector<TokenId> updatedTokens; // Used to push update to duration
-  const std::set<TimepointId> updatedTimepoints = m_tnet->getUpdatedTimepoints();
-  for(std::set<TimepointId>::const_iterator it = updatedTimepoints.begin();
+  TimepointSet updatedTimepoints;
+  m_tnet->takeUpdatedTimepoints(updatedTimepoints);
+  for(TimepointSet::const_iterator it = updatedTimepoints.begin();
       it != updatedTimepoints.end(); ++it){
     const TimepointId tp = *it;
     check_error(tp);
@@ -587,10 +592,9 @@ void TemporalPropagator::updateCnet() {
 
     check_error(lb <= ub);
 
-    std::map<TimepointId, ConstrainedVariableId>::const_iterator mIt = m_timepointToVar.find(tp);
-    check_error(mIt != m_timepointToVar.end(),
+    ConstrainedVariableId var = getVariable(tp);
+    check_error(var.isId(),
                 "Ensure the connection between TempVar and Timepoint is correct");
-    ConstrainedVariableId var = mIt->second;
     if(!var->isActive()){
       handleVariableDeactivated(var);
       continue;
@@ -618,6 +622,11 @@ void TemporalPropagator::updateCnet() {
 
     dom.intersect(mapToExternalInfinity(lb), mapToExternalInfinity(ub));
 
+    // The domain now matches the timepoint exactly, so the notification we just caused
+    // carries nothing back to the tnet. Drop it rather than narrow the base domain
+    // constraint to bounds it already entails.
+    m_changedVariables.erase(var->getKey());
+
     if(TokenId::convertable(var->parent())){
       TokenId token = var->parent();
       // If we get a hit, then buffer the token for later update to duration (so we only do it once with updated bounds
@@ -628,8 +637,6 @@ void TemporalPropagator::updateCnet() {
 
   for(std::vector<TokenId>::const_iterator it = updatedTokens.begin(); it != updatedTokens.end(); ++it)
     updateCnetDuration(*it);
-
-  m_tnet->resetUpdatedTimepoints();
 }
 
   /*
@@ -697,7 +704,21 @@ void TemporalPropagator::updateCnet() {
     bool result=m_tnet->isDistanceLessThan(fir,sec,0);
     condDebugMsg(result, "TemporalPropagator:canPrecede", " calculated distance between first and second < 0");
     condDebugMsg(!result, "TemporalPropagator:canPrecede", " calculated distance between first and second >= 0");
-    return !result;
+    if(result)
+      return false;
+
+    // With contingent durations, an ordering that is consistent may still not be executable
+    if(m_tnet->hasContingentConstraints() &&
+       !m_tnet->isDynamicallyControllableWith(fir, sec, 0, POS_INFINITY)) {
+      debugMsg("TemporalPropagator:canPrecede", " ordering is not dynamically controllable");
+      return false;
+    }
+    return true;
+  }
+
+  bool TemporalPropagator::isDynamicallyControllable() {
+    check_error(!updateRequired());
+    return m_tnet->isDynamicallyControllable();
   }
 
   bool TemporalPropagator::canFitBetween(const ConstrainedVariableId start, const ConstrainedVariableId end,
@@ -849,14 +870,16 @@ void TemporalPropagator::updateTnetDuration(const ConstraintId constraint) {
   // Update for the distance variable
   if(constraint->getScope().size() == 3) { // TODO JRB: this seems brittle, what if we get other temporal constraints with 3 parameters?
     const ConstrainedVariableId distance = constraint->getScope()[1];
+    const std::map<ConstraintId, TemporalConstraintId>::const_iterator mapped = m_constrToTempConstr.find(constraint);
 
     // In order to avoid the unhappy situation where temporalDistance does not maintain the semantics of addEq
     // we now apply the distance bounds to the distance variable.
     const IntervalIntDomain& sourceDom = constraint->getScope()[0]->lastDomain();
     const IntervalIntDomain& targetDom = constraint->getScope()[2]->lastDomain();
 
-    // Checks for finiteness are to avoid overflow or underflow.
-    if(sourceDom.isFinite() && targetDom.isFinite()){
+    // Checks for finiteness are to avoid overflow or underflow.  A contingent duration is chosen by the
+    // environment, so it is not narrowed to fit the timepoints.
+    if(sourceDom.isFinite() && targetDom.isFinite() && !mapped->second->isContingent()){
       IntervalIntDomain& distanceDom = static_cast<IntervalIntDomain&>(Propagator::getCurrentDomain(distance));
       Time minDistance = cast_int(targetDom.getLowerBound() - sourceDom.getUpperBound());
       Time maxDistance = cast_int(targetDom.getUpperBound() - sourceDom.getLowerBound());
@@ -873,7 +896,7 @@ void TemporalPropagator::updateTnetDuration(const ConstraintId constraint) {
 
     checkError(distance->lastDomain().isInterval(), constraint->getKey() << " is invalid");
     
-    const TemporalConstraintId tnetConstraint = m_constrToTempConstr.find(constraint)->second;
+    const TemporalConstraintId tnetConstraint = mapped->second;
     const IntervalIntDomain& dom = static_cast<const IntervalIntDomain&>(distance->lastDomain());
     Time lb= cast_int(dom.getLowerBound());
     Time ub= cast_int(dom.getUpperBound());
@@ -934,7 +957,10 @@ TemporalConstraintId TemporalPropagator::updateConstraint(const ConstrainedVaria
     unmap(tnetConstraint);
 
     m_tnet->removeTemporalConstraint(tnetConstraint);
-    newConstraint = m_tnet->addTemporalConstraint(source, target, lb, ub);
+    if(tnetConstraint->isContingent())
+      newConstraint = m_tnet->addContingentConstraint(source, target, lb, ub);
+    else
+      newConstraint = m_tnet->addTemporalConstraint(source, target, lb, ub);
     if(!cnetConstraint.isNoId()){
       mapConstraint(cnetConstraint, newConstraint);
       
@@ -1041,7 +1067,7 @@ bool TemporalPropagator::isValidForPropagation() const {
 
   // For all buffered constraints for deletion, none should have any dangling external entities. This is because
   // we will have already deleted the TempVar for which this timepoint shadows it.
-  for(std::set<TimepointId>::const_iterator it = m_variablesForDeletion.begin();
+  for(TimepointSet::const_iterator it = m_variablesForDeletion.begin();
       it != m_variablesForDeletion.end(); ++it){
     TimepointId timepoint = *it;
     if(m_timepointToVar.find(timepoint) != m_timepointToVar.end()) {
@@ -1272,11 +1298,11 @@ bool TemporalPropagator::isValidForPropagation() const {
       if (from == origin)
         fromvar = originvar;
       else
-        fromvar = m_timepointToVar.find(from)->second;
+        fromvar = getVariable(from);
       if (to == origin)
         tovar = originvar;
       else
-        tovar = m_timepointToVar.find(to)->second;
+        tovar = getVariable(to);
       fromvars.push_back(fromvar);
       tovars.push_back(tovar);
       lengths.push_back(length);
@@ -1297,6 +1323,11 @@ void TemporalPropagator::mapVariable(const ConstrainedVariableId var,
   m_timepointToVar.insert(std::make_pair(tp, var));
 }
 
+ConstrainedVariableId TemporalPropagator::getVariable(const TimepointId tp) const {
+  std::map<TimepointId, ConstrainedVariableId>::const_iterator it = m_timepointToVar.find(tp);
+  return (it == m_timepointToVar.end() ? ConstrainedVariableId::noId() : it->second);
+}
+
 void TemporalPropagator::unmap(const ConstrainedVariableId var) {
   std::map<ConstrainedVariableId, TimepointId>::iterator it = m_varToTimepoint.find(var);
   if(it != m_varToTimepoint.end()) {
@@ -31,6 +31,11 @@ namespace EUROPA {
     bool canPrecede(const ConstrainedVariableId first, const ConstrainedVariableId second);
     bool mustPrecede(const ConstrainedVariableId first, const ConstrainedVariableId second);
 
+    /**
+     * @see TemporalAdvisor::isDynamicallyControllable
+     */
+    bool isDynamicallyControllable();
+
     /**
      * @see TemporalAdvisor::canFitBetween
      */
@@ -196,6 +201,7 @@ namespace EUROPA {
     void collectViolations(ConstrainedVariableId var);
 
     void mapVariable(const ConstrainedVariableId var, const TimepointId tp);
+    ConstrainedVariableId getVariable(const TimepointId tp) const; /*!< noId if tp is not mapped */
     void unmap(const ConstrainedVariableId var);
     void unmap(const TimepointId tp);
     void mapConstraint(const ConstraintId constr, const TemporalConstraintId temp);
@@ -215,10 +221,10 @@ namespace EUROPA {
     typedef std::set<ConstraintId, EntityComparator<EntityId> > ConstraintsSet;
     ConstraintsSet m_changedConstraints; /*!< Constraint Agenda */
 
-    typedef  std::set<TemporalConstraintId> TemporalConstraintsSet;
+    typedef TemporalConstraintSet TemporalConstraintsSet;
     TemporalConstraintsSet m_constraintsForDeletion; /*!< Buffer deletions till you have to propagate. */
 
-    std::set<TimepointId> m_variablesForDeletion; /*!< Buffer timepoints for deletion till we propagate. */
+    TimepointSet m_variablesForDeletion; /*!< Buffer timepoints for deletion till we propagate. */
     std::set<TemporalNetworkListenerId> m_listeners;
     std::map<ConstrainedVariableId, TimepointId> m_varToTimepoint;
     std::map<TimepointId, ConstrainedVariableId> m_timepointToVar;
@@ -0,0 +1,73 @@
+/**
+ * Times dynamic controllability checks on random networks of activities with contingent durations, each
+ * started within a bounded delay of the end of an earlier one.  The full check is followed by one after a
+ * tightening, which keeps the edges the first derived.  Not part of the unit tests; run
+ * tn-controllability-benchmark by hand to compare changes to the controllability checker.
+ */
+
+#include "TemporalNetwork.hh"
+
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+using namespace EUROPA;
+
+namespace {
+unsigned int next(unsigned int& seed) {
+  seed = seed * 1103515245 + 12345;
+  return (seed / 65536) % 32768;
+}
+
+double secondsSince(const std::clock_t start) {
+  return static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+}
+
+/**
+ * Builds a network of the given number of activities and prints the result and time of each check.
+ * @return false if the network is inconsistent, or the checks disagree.
+ */
+bool runControllability(const unsigned int size) {
+  TemporalNetwork tn;
+  TimepointId origin = tn.getOrigin();
+  std::vector<TimepointId> ends;
+  std::vector<TemporalConstraintId> releases;
+  unsigned int seed = size;
+  for(unsigned int i = 0; i < size; i++) {
+    TimepointId start = tn.addTimepoint();
+    TimepointId end = tn.addTimepoint();
+    Time lb = 1 + next(seed) % 10;
+    tn.addContingentConstraint(start, end, lb, lb + next(seed) % 6);
+    releases.push_back(tn.addTemporalConstraint(origin, start, 0, 1000));
+    if(!ends.empty())
+      tn.addTemporalConstraint(ends[next(seed) % ends.size()], start, 0, 20 + next(seed) % 30);
+    ends.push_back(end);
+  }
+  if(!tn.propagate()) {
+    std::cout << size << " inconsistent" << std::endl;
+    return false;
+  }
+
+  std::clock_t start = std::clock();
+  bool controllable = tn.isDynamicallyControllable();
+  const double fullTime = secondsSince(start);
+
+  tn.narrowTemporalConstraint(releases.back(), 0, 999);
+  start = std::clock();
+  bool agrees = (tn.isDynamicallyControllable() == controllable);
+  const double incrementalTime = secondsSince(start);
+  std::cout << size << " " << controllable << " " << tn.getDerivedControllabilityEdgeCount() << " " <<
+      fullTime << " " << incrementalTime << std::endl;
+  if(!agrees)
+    std::cout << "The incremental check disagrees with the full check" << std::endl;
+  return agrees;
+}
+}
+
+int main(int, char**) {
+  std::cout << "activities controllable derived full(s) incremental(s)" << std::endl;
+  bool ok = true;
+  for(unsigned int size = 25; size <= 1600; size *= 2)
+    ok = runControllability(size) && ok;
+  return (ok ? 0 : 1);
+}
@@ -3,6 +3,7 @@
 #include "TestUtils.hh"
 #include "TemporalNetwork.hh"
 #include "TemporalPropagator.hh"
+#include "TemporalNetworkListener.hh"
 #include "STNTemporalAdvisor.hh"
 #include "TemporalAdvisor.hh"
 #include "Constraints.hh"
@@ -109,6 +110,8 @@ public:
     EUROPA_runTest(testTemporalConstraints);
     EUROPA_runTest(testFixForReversingEndpoints);
     EUROPA_runTest(testMemoryCleanups);
+    EUROPA_runTest(testRigidComponents);
+    EUROPA_runTest(testDynamicControllability);
     return true;
   }
 
@@ -215,6 +218,161 @@ private:
     }
     return true;
   }
+
+  static bool testRigidComponents(){
+    TemporalNetwork tn;
+    TimepointId origin = tn.getOrigin();
+    TimepointId a = tn.addTimepoint();
+    TimepointId b = tn.addTimepoint();
+    TimepointId c = tn.addTimepoint();
+    TimepointId d = tn.addTimepoint();
+    tn.addTemporalConstraint(origin, a, 0, 100);
+    tn.addTemporalConstraint(origin, b, 0, 100);
+    TemporalConstraintId ab = tn.addTemporalConstraint(a, b, 10, 10);
+    TemporalConstraintId bc = tn.addTemporalConstraint(b, c, 5, 5);
+    TemporalConstraintId cd = tn.addTemporalConstraint(c, d, 0, 20);
+    CPPUNIT_ASSERT(tn.propagate());
+
+    // a, b and c collapse into one node of the distance graph
+    CPPUNIT_ASSERT(tn.getRigidRepresentative(a) == tn.getRigidRepresentative(b));
+    CPPUNIT_ASSERT(tn.getRigidRepresentative(a) == tn.getRigidRepresentative(c));
+    CPPUNIT_ASSERT(tn.getRepresentativeCount() == 3);
+
+    Time lb, ub;
+    tn.getTimepointBounds(b, lb, ub);
+    CPPUNIT_ASSERT(lb == 10 && ub == 100);
+    tn.getTimepointBounds(c, lb, ub);
+    CPPUNIT_ASSERT(lb == 15 && ub == 105);
+    tn.calcDistanceBounds(a, c, lb, ub);
+    CPPUNIT_ASSERT(lb == 15 && ub == 15);
+    tn.calcDistanceBounds(a, d, lb, ub);
+    CPPUNIT_ASSERT(lb == 15 && ub == 35);
+    CPPUNIT_ASSERT(tn.isDistanceLessThan(a, d, 36));
+    CPPUNIT_ASSERT(!tn.isDistanceLessThan(a, d, 35));
+
+    std::vector<TimepointId> targs;
+    targs.push_back(c);
+    targs.push_back(d);
+    std::vector<Time> lbs, ubs;
+    tn.calcDistanceBounds(a, targs, lbs, ubs);
+    CPPUNIT_ASSERT(lbs[0] == 15 && ubs[0] == 15);
+    CPPUNIT_ASSERT(lbs[1] == 15 && ubs[1] == 35);
+
+    // A constraint inside the component that contradicts its offsets
+    TemporalConstraintId bad = tn.addTemporalConstraint(a, c, 0, 10);
+    CPPUNIT_ASSERT(!tn.propagate());
+    tn.removeTemporalConstraint(bad);
+    CPPUNIT_ASSERT(tn.propagate());
+
+    // Relaxing a rigid constraint splits the component
+    tn.removeTemporalConstraint(ab);
+    CPPUNIT_ASSERT(tn.getRigidRepresentative(a) != tn.getRigidRepresentative(b));
+    CPPUNIT_ASSERT(tn.getRigidRepresentative(b) == tn.getRigidRepresentative(c));
+    CPPUNIT_ASSERT(tn.propagate());
+    tn.getTimepointBounds(a, lb, ub);
+    CPPUNIT_ASSERT(lb == 0 && ub == 100);
+    tn.getTimepointBounds(c, lb, ub);
+    CPPUNIT_ASSERT(lb == 5 && ub == 105);
+
+    // Fixing a timepoint folds its component into the origin
+    TemporalConstraintId fixB = tn.addTemporalConstraint(origin, b, 50, 50);
+    CPPUNIT_ASSERT(tn.getRigidRepresentative(c) == origin);
+    tn.narrowTemporalConstraint(cd, 10, 10);
+    CPPUNIT_ASSERT(tn.getRigidRepresentative(d) == origin);
+    tn.getTimepointBounds(d, lb, ub);
+    CPPUNIT_ASSERT(lb == 65 && ub == 65);
+
+    tn.removeTemporalConstraint(fixB);
+    CPPUNIT_ASSERT(tn.propagate());
+    tn.getTimepointBounds(d, lb, ub);
+    CPPUNIT_ASSERT(lb == 15 && ub == 115);
+
+    tn.removeTemporalConstraint(bc);
+    tn.removeTemporalConstraint(cd);
+    tn.deleteTimepoint(d);
+    tn.deleteTimepoint(c);
+    return true;
+  }
+
+  /**
+   * c ends a contingent duration of [2, 5] from a.  b may follow c closely, since it can wait to see c, but
+   * can't be required to precede it closely.  Narrowing the contingent duration makes that controllable.
+   */
+  static bool testDynamicControllability(){
+    TemporalNetwork tn;
+    TimepointId origin = tn.getOrigin();
+    TimepointId a = tn.addTimepoint();
+    TimepointId b = tn.addTimepoint();
+    TimepointId c = tn.addTimepoint();
+    TemporalConstraintId startA = tn.addTemporalConstraint(origin, a, 0, 10);
+    TemporalConstraintId duration = tn.addContingentConstraint(a, c, 2, 5);
+    CPPUNIT_ASSERT(duration->isContingent() && tn.hasContingentConstraints());
+    CPPUNIT_ASSERT(tn.isDynamicallyControllable());
+
+    // b waits for c, and has a deadline that c must be able to meet
+    TemporalConstraintId follows = tn.addTemporalConstraint(c, b, 0, 1);
+    TemporalConstraintId deadline = tn.addTemporalConstraint(origin, b, 0, 12);
+    CPPUNIT_ASSERT(tn.propagate());
+    CPPUNIT_ASSERT(tn.isDynamicallyControllable());
+    // a must start by 7 so that c is seen in time, which consistency alone doesn't require
+    CPPUNIT_ASSERT(tn.getUpperTimepointBound(a) == 10);
+    CPPUNIT_ASSERT(tn.getDerivedControllabilityEdgeCount() > 0);
+    CPPUNIT_ASSERT(tn.isDynamicallyControllableWith(origin, a, 0, 7));
+    CPPUNIT_ASSERT(!tn.isDynamicallyControllableWith(origin, a, 8, 10));
+
+    // Derived edges are kept while the network is only tightened
+    unsigned long derived = tn.getDerivedControllabilityEdgeCount();
+    tn.narrowTemporalConstraint(startA, 0, 9);
+    CPPUNIT_ASSERT(tn.getDerivedControllabilityEdgeCount() == derived);
+    CPPUNIT_ASSERT(tn.isDynamicallyControllable());
+    CPPUNIT_ASSERT(tn.getDerivedControllabilityEdgeCount() >= derived);
+
+    // b must come 1 to 2 before c, so it must be decided before c is seen.  Consistent, but not controllable.
+    tn.removeTemporalConstraint(follows);
+    CPPUNIT_ASSERT(tn.isDynamicallyControllable());
+    CPPUNIT_ASSERT(!tn.isDynamicallyControllableWith(b, c, 1, 2));
+    CPPUNIT_ASSERT(tn.isDynamicallyControllable());
+    TemporalConstraintId precedes = tn.addTemporalConstraint(b, c, 1, 2);
+    CPPUNIT_ASSERT(tn.propagate());
+    CPPUNIT_ASSERT(!tn.isDynamicallyControllable());
+    tn.narrowTemporalConstraint(startA, 0, 8);
+    CPPUNIT_ASSERT(!tn.isDynamicallyControllable());
+
+    // With less uncertainty, b can be set 1 after a
+    tn.narrowTemporalConstraint(duration, 2, 3);
+    CPPUNIT_ASSERT(tn.isDynamicallyControllable());
+
+    // An upper bound on a contingent duration that the environment may exceed
+    TemporalConstraintId tooShort = tn.addTemporalConstraint(a, c, 0, 2);
+    CPPUNIT_ASSERT(tn.propagate());
+    CPPUNIT_ASSERT(!tn.isDynamicallyControllable());
+    tn.removeTemporalConstraint(tooShort);
+    CPPUNIT_ASSERT(tn.isDynamicallyControllable());
+
+    // A duration the checker can't take the width of is refused in every build
+    const bool throwing = Error::throwEnabled();
+    Error::doThrowExceptions();
+    bool refused = false;
+    try {
+      tn.addContingentConstraint(a, b, 0, MAX_LENGTH + 1);
+    }
+    catch(Error&) {
+      refused = true;
+    }
+    if(!throwing)
+      Error::doNotThrowExceptions();
+    CPPUNIT_ASSERT(refused);
+
+    tn.removeTemporalConstraint(precedes);
+    tn.removeTemporalConstraint(deadline);
+    tn.removeTemporalConstraint(duration);
+    CPPUNIT_ASSERT(!tn.hasContingentConstraints());
+    tn.removeTemporalConstraint(startA);
+    tn.deleteTimepoint(c);
+    tn.deleteTimepoint(b);
+    tn.deleteTimepoint(a);
+    return true;
+  }
 };
 
 class TemporalPropagatorTest {
@@ -806,6 +964,21 @@ private:
 };
 
 
+/**
+ * @brief Counts restrictions pushed from the constraint network into the tnet.
+ */
+class BoundsRestrictionCounter : public TemporalNetworkListener {
+public:
+  BoundsRestrictionCounter(const TemporalPropagatorId prop)
+    : TemporalNetworkListener(prop), m_restrictions() {}
+
+  void notifyBoundsRestricted(const ConstrainedVariableId v, Time, Time) {
+    m_restrictions.push_back(v);
+  }
+
+  std::vector<ConstrainedVariableId> m_restrictions;
+};
+
 class TemporalNetworkConstraintEngineOnlyTest {
 public:
   static bool test() {
@@ -813,6 +986,8 @@ public:
     EUROPA_runTest(testTemporalPropagation);
     EUROPA_runTest(testTemporalNogood);
     EUROPA_runTest(testMinPerturbTimes);
+    EUROPA_runTest(testBoundsSynchronization);
+    EUROPA_runTest(testContingentDistance);
     return true;
   }
 private:
@@ -985,6 +1160,92 @@ private:
     DEFAULT_TEARDOWN_CE_ONLY();
     return true;
   }
+
+  /**
+   * Bounds inferred by the tnet are written to the variables once and are not
+   * pushed back into the tnet as base domain restrictions.
+   */
+  static bool testBoundsSynchronization() {
+    DEFAULT_SETUP_CE_ONLY(ce);
+    TemporalPropagator* tp =
+        id_cast<TemporalPropagator>(ce.getPropagatorByName("Temporal"));
+    BoundsRestrictionCounter counter(tp);
+
+    ConstrainedVariableId v1 = (new Variable<IntervalIntDomain> (ce.getId(), IntervalIntDomain(0, 10), false, true, "v1"))->getId();
+    ConstrainedVariableId v2 = (new Variable<IntervalIntDomain> (ce.getId(), IntervalIntDomain(0, 20), false, true, "v2"))->getId();
+
+    std::vector<ConstrainedVariableId> temp;
+    temp.push_back(v1);
+    temp.push_back(v2);
+    ConstraintId beforeConstraint = ce.getId()->createConstraint("precedes", temp);
+    CPPUNIT_ASSERT(ce.propagate());
+    CPPUNIT_ASSERT(counter.m_restrictions.empty());
+
+    // Restricting v1 is pushed into the tnet. The inferred bound on v2 is not.
+    v1->restrictBaseDomain(IntervalIntDomain(5, 10));
+    CPPUNIT_ASSERT(ce.propagate());
+    CPPUNIT_ASSERT(v2->lastDomain() == IntervalIntDomain(5, 20));
+    CPPUNIT_ASSERT(counter.m_restrictions.size() == 1);
+    CPPUNIT_ASSERT(counter.m_restrictions[0] == v1);
+
+    // The tnet still holds v2 at its inferred bounds when it is restricted further.
+    v2->restrictBaseDomain(IntervalIntDomain(0, 8));
+    CPPUNIT_ASSERT(ce.propagate());
+    CPPUNIT_ASSERT(v1->lastDomain() == IntervalIntDomain(5, 8));
+    CPPUNIT_ASSERT(v2->lastDomain() == IntervalIntDomain(5, 8));
+    CPPUNIT_ASSERT(tp->getTemporalDistanceDomain(v1, v2, true) == IntervalIntDomain(0, 3));
+
+    delete static_cast<Constraint*>(beforeConstraint);
+    delete static_cast<ConstrainedVariable*>(v1);
+    delete static_cast<ConstrainedVariable*>(v2);
+    DEFAULT_TEARDOWN_CE_ONLY();
+    return true;
+  }
+
+  /**
+   * c ends a contingent duration of [2, 5] from a, and b must be done by 4.  b can precede c, but c can only
+   * precede b if the environment chooses a short duration, so that ordering is ruled out.
+   */
+  static bool testContingentDistance() {
+    CD_DEFAULT_SETUP(ce, db, false);
+    TemporalPropagator* tp =
+        id_cast<TemporalPropagator>(ce.getPropagatorByName("Temporal"));
+
+    ConstrainedVariableId a = (new Variable<IntervalIntDomain> (ce.getId(), IntervalIntDomain(0, 0), false, true, "a"))->getId();
+    ConstrainedVariableId d = (new Variable<IntervalIntDomain> (ce.getId(), IntervalIntDomain(2, 5), false, true, "d"))->getId();
+    ConstrainedVariableId c = (new Variable<IntervalIntDomain> (ce.getId(), IntervalIntDomain(0, 100), false, true, "c"))->getId();
+    ConstrainedVariableId b = (new Variable<IntervalIntDomain> (ce.getId(), IntervalIntDomain(0, 4), false, true, "b"))->getId();
+
+    std::vector<ConstrainedVariableId> temp;
+    temp.push_back(a);
+    temp.push_back(d);
+    temp.push_back(c);
+    ConstraintId duration = ce.getId()->createConstraint("contingentDistance", temp);
+    temp.clear();
+    temp.push_back(a);
+    temp.push_back(b);
+    ConstraintId afterA = ce.getId()->createConstraint("precedes", temp);
+    CPPUNIT_ASSERT(ce.propagate());
+    CPPUNIT_ASSERT(c->lastDomain() == IntervalIntDomain(2, 5));
+    CPPUNIT_ASSERT(db.getTemporalAdvisor()->isDynamicallyControllable());
+    CPPUNIT_ASSERT(tp->canPrecede(b, c));
+    CPPUNIT_ASSERT(!tp->canPrecede(c, b));
+
+    // Requiring c by 4 is consistent, but the environment decides when c happens
+    c->restrictBaseDomain(IntervalIntDomain(0, 4));
+    CPPUNIT_ASSERT(ce.propagate());
+    CPPUNIT_ASSERT(d->lastDomain() == IntervalIntDomain(2, 5));
+    CPPUNIT_ASSERT(!db.getTemporalAdvisor()->isDynamicallyControllable());
+
+    delete static_cast<Constraint*>(afterA);
+    delete static_cast<Constraint*>(duration);
+    delete static_cast<ConstrainedVariable*>(a);
+    delete static_cast<ConstrainedVariable*>(b);
+    delete static_cast<ConstrainedVariable*>(c);
+    delete static_cast<ConstrainedVariable*>(d);
+    TN_DEFAULT_TEARDOWN();
+    return true;
+  }
 };
 
 void TemporalNetworkModuleTests::cppSetup()
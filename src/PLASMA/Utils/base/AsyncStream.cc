@@ -0,0 +1,174 @@
+#include "AsyncStream.hh"
+#include "Error.hh"
+#include "Mutex.hh"
+
+namespace EUROPA {
+
+/**
+ * Text a thread has written but not yet flushed, with the buffer it is for, so that it can
+ * still be queued when the thread exits.
+ */
+struct AsyncStreamBuffer::Pending {
+  Pending(AsyncStreamBuffer& owner) : buffer(owner), text() {}
+  AsyncStreamBuffer& buffer;
+  std::string text;
+};
+
+AsyncStreamBuffer::AsyncStreamBuffer(std::ostream& target, Policy policy, unsigned int capacity)
+    : std::streambuf(), m_target(target), m_policy(policy), m_capacity(capacity > 0 ? capacity : 1),
+      m_pendingKey(), m_mutex(), m_notEmpty(), m_notFull(), m_written(), m_queue(),
+      m_queued(0), m_writtenCount(0), m_dropped(0), m_droppedReported(0), m_stopping(false),
+      m_writer() {
+  pthread_key_create(&m_pendingKey, &AsyncStreamBuffer::deletePending);
+  pthread_mutex_init(&m_mutex, NULL);
+  pthread_cond_init(&m_notEmpty, NULL);
+  pthread_cond_init(&m_notFull, NULL);
+  pthread_cond_init(&m_written, NULL);
+  int status = pthread_create(&m_writer, NULL, &AsyncStreamBuffer::run, this);
+  checkError(status == 0, "Failed to start the asynchronous stream writer: " << status);
+}
+
+AsyncStreamBuffer::~AsyncStreamBuffer() {
+  sync();
+  {
+    MutexGrabber grabber(m_mutex);
+    m_stopping = true;
+    pthread_cond_broadcast(&m_notEmpty);
+    pthread_cond_broadcast(&m_notFull);
+  }
+  pthread_join(m_writer, NULL);
+
+  // Only the calling thread's pending text is reachable here. Other threads queue theirs as
+  // they exit, and text they leave after the key is deleted is not written.
+  Pending* pending = static_cast<Pending*>(pthread_getspecific(m_pendingKey));
+  pthread_setspecific(m_pendingKey, NULL);
+  delete pending;
+  pthread_key_delete(m_pendingKey);
+
+  pthread_cond_destroy(&m_written);
+  pthread_cond_destroy(&m_notFull);
+  pthread_cond_destroy(&m_notEmpty);
+  pthread_mutex_destroy(&m_mutex);
+}
+
+unsigned long AsyncStreamBuffer::getDropCount() const {
+  MutexGrabber grabber(m_mutex);
+  return m_dropped;
+}
+
+void AsyncStreamBuffer::drain() {
+  sync();
+  MutexGrabber grabber(m_mutex);
+  const unsigned long target = m_queued;
+  while(m_writtenCount < target && !m_stopping)
+    pthread_cond_wait(&m_written, &m_mutex);
+}
+
+std::string& AsyncStreamBuffer::pending() {
+  Pending* pending = static_cast<Pending*>(pthread_getspecific(m_pendingKey));
+  if(pending == NULL) {
+    pending = new Pending(*this);
+    pthread_setspecific(m_pendingKey, pending);
+  }
+  return pending->text;
+}
+
+int AsyncStreamBuffer::overflow(int c) {
+  if(c != traits_type::eof())
+    pending().push_back(traits_type::to_char_type(c));
+  return traits_type::not_eof(c);
+}
+
+std::streamsize AsyncStreamBuffer::xsputn(const char* s, std::streamsize n) {
+  pending().append(s, n);
+  return n;
+}
+
+int AsyncStreamBuffer::sync() {
+  std::string& text = pending();
+  if(!text.empty())
+    enqueue(text);
+  return 0;
+}
+
+void AsyncStreamBuffer::enqueue(std::string& message) {
+  MutexGrabber grabber(m_mutex);
+  if(m_policy == BLOCK) {
+    while(m_queue.size() >= m_capacity && !m_stopping)
+      pthread_cond_wait(&m_notFull, &m_mutex);
+  }
+  else if(m_queue.size() >= m_capacity) {
+    m_dropped++;
+    message.clear();
+    return;
+  }
+
+  // Swap rather than copy, leaving the caller's buffer empty for the next message
+  m_queue.push_back(std::string());
+  m_queue.back().swap(message);
+  m_queued++;
+  pthread_cond_signal(&m_notEmpty);
+}
+
+void AsyncStreamBuffer::write() {
+  std::deque<std::string> batch;
+  pthread_mutex_lock(&m_mutex);
+  for(;;) {
+    while(m_queue.empty() && !m_stopping)
+      pthread_cond_wait(&m_notEmpty, &m_mutex);
+    if(m_queue.empty())
+      break;
+
+    batch.swap(m_queue);
+    const unsigned long dropped = m_dropped - m_droppedReported;
+    m_droppedReported = m_dropped;
+    pthread_cond_broadcast(&m_notFull);
+    pthread_mutex_unlock(&m_mutex);
+
+    if(dropped > 0)
+      m_target << "[AsyncStream] dropped " << dropped << " messages\n";
+    for(std::deque<std::string>::const_iterator it = batch.begin(); it != batch.end(); ++it)
+      m_target << *it;
+    m_target.flush();
+
+    pthread_mutex_lock(&m_mutex);
+    m_writtenCount += batch.size();
+    pthread_cond_broadcast(&m_written);
+    batch.clear();
+  }
+  pthread_mutex_unlock(&m_mutex);
+}
+
+void* AsyncStreamBuffer::run(void* buffer) {
+  static_cast<AsyncStreamBuffer*>(buffer)->write();
+  return NULL;
+}
+
+void AsyncStreamBuffer::deletePending(void* pending) {
+  Pending* exiting = static_cast<Pending*>(pending);
+  if(!exiting->text.empty())
+    exiting->buffer.enqueue(exiting->text);
+  delete exiting;
+}
+
+AsyncStream::AsyncStream(std::ostream& target, AsyncStreamBuffer::Policy policy,
+                         unsigned int capacity)
+    : std::ostream(NULL), m_buffer(target, policy, capacity) {
+  rdbuf(&m_buffer);
+}
+
+AsyncStream::~AsyncStream() {
+  rdbuf(NULL);
+}
+
+bool AsyncStream::parsePolicy(const std::string& name, AsyncStreamBuffer::Policy& policy) {
+  if(name == "drop")
+    policy = AsyncStreamBuffer::DROP;
+  else if(name == "block")
+    policy = AsyncStreamBuffer::BLOCK;
+  else
+    return false;
+  return true;
+}
+
+}
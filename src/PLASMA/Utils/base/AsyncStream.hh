@@ -0,0 +1,119 @@
+#ifndef _H_EUROPA_ASYNC_STREAM
+#define _H_EUROPA_ASYNC_STREAM
+
+#include <deque>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <pthread.h>
+
+namespace EUROPA {
+
+/**
+ * @class AsyncStreamBuffer
+ * @brief Stream buffer that hands complete messages to a background writer thread.
+ *
+ * Characters are gathered in a buffer owned by the writing thread. On flush (e.g. std::endl)
+ * the pending text is queued as one message, and the writer thread moves queued messages to the
+ * target stream in batches, flushing the target once per batch. No I/O happens on the
+ * calling thread. Text a thread has not flushed when it exits is queued as its last message.
+ * @see AsyncStream
+ */
+class AsyncStreamBuffer : public std::streambuf {
+ public:
+  /**
+   * @brief What to do with a message when the queue is full.
+   */
+  enum Policy {
+    DROP, /*!< Discard the message. The number discarded is reported in the output. */
+    BLOCK /*!< Wait for the writer thread to make room. */
+  };
+
+  /**
+   * @param target The stream messages are written to. Only the writer thread writes to it.
+   * @param policy The back-pressure policy.
+   * @param capacity The maximum number of queued messages.
+   */
+  AsyncStreamBuffer(std::ostream& target, Policy policy, unsigned int capacity);
+
+  /**
+   * @brief Queues the calling thread's pending text, drains the queue and stops the writer thread.
+   */
+  ~AsyncStreamBuffer();
+
+  std::ostream& getTarget() const {return m_target;}
+  Policy getPolicy() const {return m_policy;}
+  unsigned int getCapacity() const {return m_capacity;}
+
+  /**
+   * @brief The number of messages discarded under the DROP policy so far.
+   */
+  unsigned long getDropCount() const;
+
+  /**
+   * @brief Blocks until every message queued so far has been written to the target.
+   */
+  void drain();
+
+ protected:
+  int overflow(int c);
+  std::streamsize xsputn(const char* s, std::streamsize n);
+  int sync();
+
+ private:
+  AsyncStreamBuffer(const AsyncStreamBuffer&);
+  AsyncStreamBuffer& operator=(const AsyncStreamBuffer&);
+
+  struct Pending;
+
+  std::string& pending();
+  void enqueue(std::string& message);
+  void write();
+
+  static void* run(void* buffer);
+  static void deletePending(void* pending);
+
+  std::ostream& m_target;
+  const Policy m_policy;
+  const unsigned int m_capacity;
+  pthread_key_t m_pendingKey; /*!< Per thread Pending text not yet flushed */
+  mutable pthread_mutex_t m_mutex;
+  pthread_cond_t m_notEmpty;
+  pthread_cond_t m_notFull;
+  pthread_cond_t m_written;
+  std::deque<std::string> m_queue;
+  unsigned long m_queued; /*!< Messages queued since construction */
+  unsigned long m_writtenCount; /*!< Messages written since construction */
+  unsigned long m_dropped;
+  unsigned long m_droppedReported;
+  bool m_stopping;
+  pthread_t m_writer;
+};
+
+/**
+ * @class AsyncStream
+ * @brief An output stream whose writes are performed by a background thread.
+ * @see AsyncStreamBuffer, DebugMessage::setAsync
+ */
+class AsyncStream : public std::ostream {
+ public:
+  AsyncStream(std::ostream& target,
+              AsyncStreamBuffer::Policy policy = AsyncStreamBuffer::BLOCK,
+              unsigned int capacity = 4096);
+  ~AsyncStream();
+
+  AsyncStreamBuffer& buffer() {return m_buffer;}
+
+  /**
+   * @brief Parses a policy name, "drop" or "block".
+   * @return false if the name is not recognized, leaving policy unchanged.
+   */
+  static bool parsePolicy(const std::string& name, AsyncStreamBuffer::Policy& policy);
+
+ private:
+  AsyncStreamBuffer m_buffer;
+};
+
+}
+
+#endif
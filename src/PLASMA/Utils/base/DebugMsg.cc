@@ -10,6 +10,7 @@
 // #include "europa-config.h"
 
 #include <fstream>
+#include <sstream>
 #include <algorithm>
 #include <functional>
 #include <utility>
@@ -19,6 +20,7 @@
 
 #include "DebugMsg.hh"
 #include "Mutex.hh"
+#include "AsyncStream.hh"
 /**
  * @class DebugPattern Debug.hh
  * @brief Used to store the "patterns" of presently enabled debug messages.
@@ -313,6 +315,22 @@ typedef std::pair<EUROPA::MutexGrabber,
                   boost::reference_wrapper<DebugMessage::DebugInternals> >
 internals_accessor;
 
+/**
+ * @brief Owns the asynchronous debug stream, if any, so that queued messages
+ * are written out at exit.
+ */
+class AsyncDebugStream {
+ public:
+  AsyncDebugStream() : m_stream(NULL) {}
+  ~AsyncDebugStream() {
+    if(m_stream != NULL)
+      DebugMessage::setAsync(false);
+  }
+  EUROPA::AsyncStream* m_stream;
+};
+
+static AsyncDebugStream asyncDebugStream;
+
 internals_accessor internals() {
   EUROPA::MutexGrabber grabber(debugMutex);
   return std::make_pair<EUROPA::MutexGrabber,
@@ -379,6 +397,70 @@ bool DebugMessage::matches(const DebugPattern& pattern) const {
       markerMatches(getMarker(), pattern.m_pattern);
 }
 
+void DebugMessage::setStream(std::ostream& os) {
+  internals_accessor i = internals();
+  EUROPA::AsyncStream*& async = asyncDebugStream.m_stream;
+  if(async != NULL) {
+    const EUROPA::AsyncStreamBuffer::Policy policy = async->buffer().getPolicy();
+    const unsigned int capacity = async->buffer().getCapacity();
+    streamPtr() = &os;
+    delete async;
+    async = new EUROPA::AsyncStream(os, policy, capacity);
+    streamPtr() = async;
+  }
+  else
+    streamPtr() = &os;
+}
+
+void DebugMessage::setAsync(bool async,
+                            const std::string& policyName,
+                            unsigned int capacity) {
+  EUROPA::AsyncStreamBuffer::Policy policy = EUROPA::AsyncStreamBuffer::BLOCK;
+  checkRuntimeError(EUROPA::AsyncStream::parsePolicy(policyName, policy),
+                    "Unknown asynchronous output policy " << policyName);
+  internals_accessor i = internals();
+  EUROPA::AsyncStream*& stream = asyncDebugStream.m_stream;
+  std::ostream& target = (stream != NULL ? stream->buffer().getTarget() : getStream());
+
+  // Restore the target before the writer is stopped, so nothing is written to a dead stream
+  if(stream != NULL) {
+    streamPtr() = &target;
+    delete stream;
+    stream = NULL;
+  }
+
+  if(async) {
+    stream = new EUROPA::AsyncStream(target, policy, capacity);
+    streamPtr() = stream;
+  }
+}
+
+bool DebugMessage::isAsync() {
+  internals_accessor i = internals();
+  return asyncDebugStream.m_stream != NULL;
+}
+
+bool DebugMessage::configureAsync(const std::string& spec) {
+  std::istringstream is(spec);
+  std::string policyName;
+  is >> policyName;
+  if(policyName == "off") {
+    setAsync(false);
+    return true;
+  }
+
+  EUROPA::AsyncStreamBuffer::Policy policy;
+  if(!EUROPA::AsyncStream::parsePolicy(policyName, policy))
+    return false;
+
+  unsigned int capacity = 4096;
+  if(!(is >> capacity) && !is.eof())
+    return false;
+
+  setAsync(true, policyName, capacity);
+  return true;
+}
+
 bool DebugMessage::readConfigFile(std::istream& is) {
   check_error(is.good(), "cannot read debug config from invalid/error'd stream",
               DebugErr::DebugConfigError());
@@ -404,6 +486,11 @@ bool DebugMessage::readConfigFile(std::istream& is) {
     if (i <= 0)
       continue; // should be impossible
     input = input.substr(0, i);
+    if (input.compare(0, 6, "@async") == 0) {
+      checkRuntimeError(configureAsync(input.substr(6)),
+                        "invalid asynchronous output configuration: " << input);
+      continue;
+    }
     i = input.find(":");
     std::string pattern;
     if (i < input.length() && input[i] == ':') {
@@ -13,6 +13,10 @@
 
 #include "Error.hh"
 
+namespace EUROPA {
+  class AsyncStream;
+}
+
 /**
    @brief Returns the current level of the given marker.  If no level is provided
    in a configuration file for this marker, this method attempts to emulate
@@ -247,10 +251,37 @@ class DebugMessage {
   /**
      @brief Assign a stream to which all debug messages will be sent.
      @param os The output stream to send messages to
+     @note If output is asynchronous, os becomes the target of the background writer.
   */
-  inline static void setStream(std::ostream& os) {
-    streamPtr() = &os;
-  }
+  static void setStream(std::ostream& os);
+
+  /**
+     @brief Write debug messages on a background thread, or stop doing so.
+     @param async If true, messages are formatted on the calling thread and
+     written to the current stream by a background thread.
+     @param policy What to do when capacity messages are waiting to be written,
+     "drop" or "block".
+     @param capacity The maximum number of messages waiting to be written.
+     @par Errors thrown:
+     @li If the policy is not recognized.
+     @see AsyncStream
+  */
+  static void setAsync(bool async,
+                       const std::string& policy = "block",
+                       unsigned int capacity = 4096);
+
+  /**
+     @brief Whether debug messages are written on a background thread.
+  */
+  static bool isAsync();
+
+  /**
+     @brief Configure asynchronous output from a specification of the form
+     "<policy> [capacity]", where policy is "drop", "block" or "off".
+     @return false if the specification could not be parsed.
+     @see setAsync
+  */
+  static bool configureAsync(const std::string& spec);
 
   /**
      @brief Return the stream being used for debug messages.
@@ -267,6 +298,9 @@ class DebugMessage {
      @li If the stream is not good.
      @li If setStream() has not been called
      and some existing debug messages should be enabled.
+     @note A line of the form "@async <policy> [capacity]" configures
+     asynchronous output.
+     @see configureAsync
   */
   static bool readConfigFile(std::istream& is);
 
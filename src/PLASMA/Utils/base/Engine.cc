@@ -248,6 +248,13 @@ void EngineBase::uninitializeModules() {
     {
     	if(!m_started)
     	{
+#if !defined(ALL_LOGGING_DISABLED) && !defined(USE_EUROPA_LOGGER)
+            // e.g. Debug.async="drop 10000" writes debug output on a background thread
+            const std::string& async = getConfig()->getProperty("Debug.async");
+            if (!async.empty())
+              checkRuntimeError(DebugMessage::configureAsync(async),
+                                "Invalid value for Debug.async: " << async);
+#endif
             initializeModules();
     		initializeByModules();
     		m_started = true;
@@ -58,7 +58,7 @@ class EntityInternals {
     
     unsigned int count(0);
     while(!m_discardedEntities.empty()){
-      std::set<Entity*>::iterator it = m_discardedEntities.begin();
+      std::set<Entity*, EntityComparator<Entity*> >::iterator it = m_discardedEntities.begin();
       Entity* entity = *it;
       m_discardedEntities.erase(entity);
       checkError(isPurging() || entity->canBeDeleted(),
@@ -87,7 +87,7 @@ class EntityInternals {
   EntityInternals(const EntityInternals& o);
 
   std::map<eint, unsigned long int> m_entitiesByKey;
-  std::set<Entity*> m_discardedEntities;
+  std::set<Entity*, EntityComparator<Entity*> > m_discardedEntities; /*!< Deleted in order of key, whatever the heap layout */
   bool m_purgeStatus, m_gcActive, m_gcRequired;
   int m_key;
 };
@@ -136,7 +136,7 @@ void Entity::handleDiscard(){
     //client code to get executed
     i.first.release();
     // Notify dependents
-    for(std::set<Entity*>::const_iterator it = m_dependents.begin(); it != m_dependents.end(); ++it){
+    for(std::set<Entity*, EntityComparator<Entity*> >::const_iterator it = m_dependents.begin(); it != m_dependents.end(); ++it){
       Entity* entity = *it;
       entity->notifyDiscarded(this);
     }
@@ -23,6 +23,31 @@ namespace EUROPA{
     return entityTypeName(); \
   } \
 
+  /**
+   * @brief Key comparator class for ordering in stl containers
+   */
+  template <class T>
+  class EntityComparator{
+  public:
+    bool operator() (const T& t1, const T& t2) const {
+      checkError(t1.isValid(), t1);
+      checkError(t2.isValid(), t2);
+      return t1->getKey() < t2->getKey();
+    }
+
+    bool operator==(const EntityComparator&){return true;}
+  };
+
+template<typename T>
+class EntityComparator<T*> {
+ public:
+  bool operator() (const T* t1, const T* t2) const {
+    checkError(t1);
+    checkError(t2);
+    return t1->getKey() < t2->getKey();
+  }
+};
+
 /**
  * @class Entity
  * @brief Basic entity in system
@@ -188,34 +213,9 @@ namespace EUROPA{
     
     unsigned int m_refCount;
     bool m_discarded;
-    std::set<Entity*> m_dependents;
+    std::set<Entity*, EntityComparator<Entity*> > m_dependents; /*!< Notified of discard in order of key */
   };
 
-  /**
-   * @brief Key comparator class for ordering in stl containers
-   */
-  template <class T>
-  class EntityComparator{
-  public:
-    bool operator() (const T& t1, const T& t2) const {
-      checkError(t1.isValid(), t1);
-      checkError(t2.isValid(), t2);
-      return t1->getKey() < t2->getKey();
-    }
-
-    bool operator==(const EntityComparator&){return true;}
-  };
-
-template<typename T>
-class EntityComparator<T*> {
- public:
-  bool operator() (const T* t1, const T* t2) const {
-    checkError(t1);
-    checkError(t2);
-    return t1->getKey() < t2->getKey();
-  }
-};
-
 /** 
  * @struct Discard
  * Custom deallocator for shared pointers of Entity instances.
@@ -34,6 +34,7 @@
 #include "Engine.hh"
 #include "tinyxml.h"
 #include "CommonDefs.hh"
+#include "AsyncStream.hh"
 
 #include <list>
 #include <sstream>
@@ -172,6 +173,7 @@ public:
   static bool test() {
     EUROPA_runTest(testDebugError);
     EUROPA_runTest(testDebugFiles);
+    EUROPA_runTest(testAsyncStream);
 //     EUROPA_runTest(testLog4cpp);
 //     EUROPA_runTest(testLogger);
     return true;
@@ -197,6 +199,63 @@ private:
       runDebugTest(i);
     return(true);
   }
+  static bool testAsyncStream() {
+    // Everything written under the blocking policy arrives, in order
+    std::stringstream blocked;
+    {
+      AsyncStream os(blocked, AsyncStreamBuffer::BLOCK, 2);
+      for(int i = 0; i < 100; i++)
+        os << "message " << i << std::endl;
+      os.buffer().drain();
+      CPPUNIT_ASSERT(os.buffer().getDropCount() == 0);
+    }
+    std::stringstream expected;
+    for(int i = 0; i < 100; i++)
+      expected << "message " << i << std::endl;
+    CPPUNIT_ASSERT(blocked.str() == expected.str());
+
+    // Under the dropping policy every message is either written or counted as dropped
+    std::stringstream dropped;
+    unsigned long dropCount = 0;
+    {
+      AsyncStream os(dropped, AsyncStreamBuffer::DROP, 1);
+      for(int i = 0; i < 1000; i++)
+        os << "message " << i << std::endl;
+      os.buffer().drain();
+      dropCount = os.buffer().getDropCount();
+    }
+    unsigned long written = 0;
+    std::string line;
+    while(std::getline(dropped, line))
+      if(line.compare(0, 8, "message ") == 0)
+        written++;
+    CPPUNIT_ASSERT(written + dropCount == 1000);
+    CPPUNIT_ASSERT(dropCount == 0 || dropped.str().find("[AsyncStream] dropped") != std::string::npos);
+
+    // Text a thread leaves unflushed is written when the thread exits
+    std::stringstream exited;
+    {
+      AsyncStream os(exited);
+      pthread_t thread;
+      CPPUNIT_ASSERT(pthread_create(&thread, NULL, &DebugTest::writeWithoutFlush, &os) == 0);
+      pthread_join(thread, NULL);
+      os.buffer().drain();
+    }
+    CPPUNIT_ASSERT(exited.str() == "last words");
+
+    AsyncStreamBuffer::Policy policy = AsyncStreamBuffer::BLOCK;
+    CPPUNIT_ASSERT(AsyncStream::parsePolicy("drop", policy));
+    CPPUNIT_ASSERT(policy == AsyncStreamBuffer::DROP);
+    CPPUNIT_ASSERT(!AsyncStream::parsePolicy("sometimes", policy));
+    CPPUNIT_ASSERT(policy == AsyncStreamBuffer::DROP);
+    return true;
+  }
+
+  static void* writeWithoutFlush(void* os) {
+    *static_cast<std::ostream*>(os) << "last words";
+    return NULL;
+  }
+
 //   /** Tests that log4cpp functionality is installed and working */
 //   static bool testLog4cpp() {
 //     bool success = true;